@@ -0,0 +1,57 @@
+"""Times the emitter's CRC32 of a chirp on the DSU against the CRC32 library it replaced.
+
+Uploads chirps of a few lengths and has the emitter CRC each one again with both engines
+through CHIRP_CRC_START and CHIRP_CRC_POLL. The emitter times itself, so USB latency is
+not in the numbers. Both must give the upload's zlib.crc32. Needs the emitter:
+
+    python3 bench_chirp_crc.py port [repeats]
+"""
+import contextlib
+import io
+import os
+import sys
+
+import numpy as np
+from serial import Serial
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "../../src/batbot_bringup/sonar"))
+from bb_emitter import EchoEmitter  # noqa: E402
+
+
+def main():
+    if len(sys.argv) < 2:
+        print(__doc__)
+        return 1
+    port = sys.argv[1]
+    repeats = int(sys.argv[2]) if len(sys.argv) > 2 else 5
+
+    with contextlib.redirect_stdout(io.StringIO()):
+        emitter = EchoEmitter(Serial(port, baudrate=960000))
+    print(f"{'samples':>8} {'kB':>7} {'library us':>11} {'DSU us':>8} {'speedup':>8}")
+
+    rng = np.random.default_rng(0)
+    # odd lengths leave a half word for the CPU after the DSU's whole words
+    for n in (1001, 10000, 30000, 65000):
+        chirp = rng.integers(2048, 2048 + 512, n, dtype=np.uint16)
+        with contextlib.redirect_stdout(io.StringIO()):
+            ok = emitter.upload_chirp(chirp)
+        if not ok:
+            print(f"upload of {n} samples failed")
+            return 1
+
+        best = {}
+        for software in (True, False):
+            times = []
+            for _ in range(repeats):
+                match, us = emitter.verify_chirp(software=software)
+                if not match:
+                    print(f"{'library' if software else 'DSU'} CRC of {n} samples does not match the upload")
+                    return 1
+                times.append(us)
+            best[software] = min(times)
+        print(f"{n:8d} {2 * n / 1e3:7.1f} {best[True]:11d} {best[False]:8d} {best[True] / max(best[False], 1):7.1f}x")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
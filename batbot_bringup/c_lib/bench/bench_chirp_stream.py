@@ -0,0 +1,130 @@
+"""Streams a sweep longer than the emitter's buffer at a few DAC rates and counts underruns.
+
+With a port it streams to the emitter, which counts the blocks of silence it had to play
+because the samples came late. Without one it streams to a stand-in on a pty that plays
+the blocks on a clock of its own, which only shows whether the host side keeps up.
+
+    python3 bench_chirp_stream.py [port] [seconds]
+
+The DAC takes 2 bytes a sample, 2000 kB/s at 1 MHz, and full speed bulk moves at most
+1216 kB/s, so only a divider of 2 or more can play without gaps over USB.
+"""
+import collections
+import contextlib
+import io
+import os
+import sys
+import threading
+import time
+import tty
+
+import numpy as np
+from scipy import signal
+from serial import Serial
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "../../src/batbot_bringup/sonar"))
+from bb_emitter import CHIRP_STREAM_BLOCKS, CHIRP_UPLOAD_BLOCK, ECHO_SERIAL_CMD, EchoEmitter  # noqa: E402
+
+USB_FS_BULK_KBPS = 1216
+
+
+def read_exact(fd, n):
+    out = bytearray()
+    while len(out) < n:
+        chunk = os.read(fd, n - len(out))
+        if not chunk:
+            raise EOFError
+        out += chunk
+    return bytes(out)
+
+
+def fake_emitter(fd):
+    """Answers STREAM_START like echo_main.cpp: playback starts once all but two blocks of
+    the ring are full, a block plays every CHIRP_UPLOAD_BLOCK / 2 * divider us, and an
+    empty ring plays a block of silence. ACK_REQ for the connection check."""
+    ack = bytes([ECHO_SERIAL_CMD.ACK.value])
+    try:
+        while True:
+            cmd = read_exact(fd, 1)[0]
+            if cmd == ECHO_SERIAL_CMD.ACK_REQ.value:
+                os.write(fd, ack)
+                continue
+            if cmd != ECHO_SERIAL_CMD.STREAM_START.value:
+                continue
+            args = read_exact(fd, 5)
+            total = 2 * int.from_bytes(args[:4], "little")
+            block_s = CHIRP_UPLOAD_BLOCK / 2 * args[4] / 1e6
+            ring = collections.deque()
+            lock = threading.Condition()
+            state = {"received": 0, "underruns": 0}
+
+            def play():
+                with lock:
+                    lock.wait_for(lambda: len(ring) >= CHIRP_STREAM_BLOCKS - 2 or state["received"] >= total)
+                tick = time.perf_counter()
+                while True:
+                    tick += block_s
+                    time.sleep(max(0, tick - time.perf_counter()))
+                    with lock:
+                        if ring:
+                            ring.popleft()
+                            lock.notify_all()
+                        elif state["received"] >= total:
+                            return
+                        else:
+                            state["underruns"] += 1
+
+            player = threading.Thread(target=play, daemon=True)
+            player.start()
+            os.write(fd, ack)
+            while state["received"] < total:
+                n = min(CHIRP_UPLOAD_BLOCK, total - state["received"])
+                read_exact(fd, n)
+                with lock:
+                    lock.wait_for(lambda: len(ring) < CHIRP_STREAM_BLOCKS - 1)
+                    ring.append(n)
+                    state["received"] += n
+                    lock.notify_all()
+                os.write(fd, ack)
+            player.join()
+            os.write(fd, bytes([cmd]) + state["underruns"].to_bytes(4, "little"))
+    except (EOFError, OSError):
+        pass
+
+
+def main():
+    port = sys.argv[1] if len(sys.argv) > 1 and not sys.argv[1].replace(".", "").isdigit() else None
+    seconds = float(sys.argv[-1]) if len(sys.argv) > 1 and sys.argv[-1].replace(".", "").isdigit() else 1.0
+
+    if port is None:
+        master, slave = os.openpty()
+        tty.setraw(slave)
+        threading.Thread(target=fake_emitter, args=(master,), daemon=True).start()
+        port = os.ttyname(slave)
+        print(f"no port given, streaming to a stand-in on {port}\n")
+
+    with contextlib.redirect_stdout(io.StringIO()):
+        emitter = EchoEmitter(Serial(port, baudrate=960000))
+    print(f"{'divider':>7} {'kS/s':>6} {'samples':>8} {'kB/s':>7} {'of USB FS':>9} {'s':>6} {'underruns':>9}")
+
+    for divider in (1, 2, 3, 4):
+        rate = 1e6 / divider
+        t = np.arange(int(seconds * rate)) / rate
+        sweep = signal.chirp(t, 20e3, seconds, min(100e3, rate / 2.5), "logarithmic")
+        data = (2048 + 512 * (sweep + 1) / 2).astype(np.uint16)
+
+        with contextlib.redirect_stdout(io.StringIO()):
+            start = time.perf_counter()
+            underruns = emitter.stream_chirp(data, divider)
+            elapsed = time.perf_counter() - start
+        if underruns is None:
+            print(f"stream at 1 MHz / {divider} failed")
+            return 1
+        need = 2 * rate / 1e3
+        print(f"{divider:7d} {rate / 1e3:6.0f} {len(data):8d} {need:7.0f} {need / USB_FS_BULK_KBPS * 100:8.0f}% "
+              f"{elapsed:6.2f} {underruns:9d}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,102 @@
+"""Times EchoEmitter.upload_chirp, the windowed block upload, against USB full speed.
+
+With a port it uploads to the emitter. Without one it uploads to a stand-in on a pty
+that speaks the same CHIRP_DATA protocol, which only shows what the host side costs.
+
+    python3 bench_chirp_upload.py [port] [repeats]
+
+Full speed bulk moves at most 19 packets of 64 bytes per 1 ms frame, 1216 kB/s; the old
+upload, a Serial.available() spin and two Serial.read() calls per sample behind 20 byte
+host writes, took seconds for a full buffer.
+"""
+import contextlib
+import io
+import os
+import sys
+import threading
+import time
+import tty
+import zlib
+
+import numpy as np
+from serial import Serial
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "../../src/batbot_bringup/sonar"))
+import bb_emitter  # noqa: E402
+from bb_emitter import CHIRP_UPLOAD_BLOCK, ECHO_SERIAL_CMD, EchoEmitter  # noqa: E402
+
+USB_FS_BULK_KBPS = 1216
+EMIT_BUF_LEN = 65000
+
+
+def read_exact(fd, n):
+    out = bytearray()
+    while len(out) < n:
+        chunk = os.read(fd, n - len(out))
+        if not chunk:
+            raise EOFError
+        out += chunk
+    return bytes(out)
+
+
+def fake_emitter(fd):
+    """Answers like echo_main.cpp: ACK_REQ, GET_MAX_UINT16_CHIRP_LEN and CHIRP_DATA, and
+    CHIRP_BANK_QUERY with an empty bank so every upload goes over the wire."""
+    ack = bytes([ECHO_SERIAL_CMD.ACK.value])
+    try:
+        while True:
+            cmd = read_exact(fd, 1)[0]
+            if cmd == ECHO_SERIAL_CMD.ACK_REQ.value:
+                os.write(fd, ack)
+            elif cmd == ECHO_SERIAL_CMD.GET_MAX_UINT16_CHIRP_LEN.value:
+                os.write(fd, bytes([cmd, EMIT_BUF_LEN & 0xFF, EMIT_BUF_LEN >> 8]))
+            elif cmd == ECHO_SERIAL_CMD.CHIRP_BANK_QUERY.value:
+                os.write(fd, bytes([cmd, 8, 0xFF]) + bytes(6 * 8))
+            elif cmd == ECHO_SERIAL_CMD.CHIRP_DATA.value:
+                length = read_exact(fd, 2)
+                os.write(fd, length + ack)
+                total = 2 * (length[0] | length[1] << 8)
+                crc = 0
+                for i in range(0, total, CHIRP_UPLOAD_BLOCK):
+                    crc = zlib.crc32(read_exact(fd, min(CHIRP_UPLOAD_BLOCK, total - i)), crc)
+                    os.write(fd, ack)
+                os.write(fd, crc.to_bytes(4, "little"))
+    except (EOFError, OSError):
+        pass
+
+
+def main():
+    port = sys.argv[1] if len(sys.argv) > 1 and not sys.argv[1].isdigit() else None
+    repeats = int(sys.argv[-1]) if len(sys.argv) > 1 and sys.argv[-1].isdigit() else 5
+
+    if port is None:
+        master, slave = os.openpty()
+        tty.setraw(slave)
+        threading.Thread(target=fake_emitter, args=(master,), daemon=True).start()
+        port = os.ttyname(slave)
+        print(f"no port given, uploading to a stand-in on {port}\n")
+
+    with contextlib.redirect_stdout(io.StringIO()):
+        emitter = EchoEmitter(Serial(port, baudrate=960000))
+    print(f"{'samples':>8} {'kB':>7} {'best ms':>8} {'kB/s':>7}  of USB FS bulk")
+
+    rng = np.random.default_rng(0)
+    for n in (1000, 10000, 30000, EMIT_BUF_LEN):
+        chirp = rng.integers(2048, 2048 + 512, n, dtype=np.uint16)
+        times = []
+        for _ in range(repeats):
+            with contextlib.redirect_stdout(io.StringIO()):
+                start = time.perf_counter()
+                ok = emitter.upload_chirp(chirp)
+                times.append(time.perf_counter() - start)
+            if not ok or emitter.chirp_crc != zlib.crc32(chirp.tobytes()):
+                print(f"upload of {n} samples failed")
+                return 1
+        best = min(times)
+        kbps = 2 * n / 1e3 / best
+        print(f"{n:8d} {2 * n / 1e3:7.1f} {best * 1e3:8.1f} {kbps:7.0f}  {kbps / USB_FS_BULK_KBPS * 100:5.1f}%")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,54 @@
+"""Compares sonardsp.deinterleave with the numpy split, cast and mean subtraction on
+pair interleaved data (the layout from before the framed stream), on a 30 ms ping and
+on a 1 s capture.
+
+Run from a build directory that contains the sonardsp module, or with it on PYTHONPATH:
+    python3 bench_deinterleave.py [repeats]
+"""
+import sys
+import timeit
+
+import numpy as np
+
+import sonardsp
+
+
+def numpy_path(raw):
+    left = raw[::2].astype(np.float32)
+    right = raw[1::2].astype(np.float32)
+    return left - np.mean(left), right - np.mean(right)
+
+
+def main():
+    repeats = int(sys.argv[1]) if len(sys.argv) > 1 else 50
+    rng = np.random.default_rng(0)
+
+    print(f"sonardsp uses {sonardsp.best_isa()}\n")
+
+    # 2 MS/s per ear
+    for pairs in (60_000, 2_000_000):
+        raw = rng.integers(0, 4096, 2 * pairs, dtype=np.uint16)
+        left = np.empty(pairs, dtype=np.float32)
+        right = np.empty(pairs, dtype=np.float32)
+
+        ref_l, ref_r = numpy_path(raw)
+        l, r = sonardsp.deinterleave(raw)
+        assert np.allclose(l, ref_l, atol=1e-2) and np.allclose(r, ref_r, atol=1e-2)
+
+        cases = {
+            "numpy": lambda: numpy_path(raw),
+            "sonardsp": lambda: sonardsp.deinterleave(raw),
+            "sonardsp, reused out": lambda: sonardsp.deinterleave(raw, left=left, right=right),
+        }
+
+        print(f"{pairs} pairs ({pairs / 2000:.0f} ms)")
+        base = None
+        for name, fn in cases.items():
+            t = min(timeit.repeat(fn, number=repeats, repeat=3)) / repeats
+            base = base or t
+            print(f"  {name:22s} {t * 1e6:9.1f} us  {base / t:5.2f}x")
+        print()
+
+
+if __name__ == "__main__":
+    main()
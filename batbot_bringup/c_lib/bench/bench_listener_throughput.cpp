@@ -0,0 +1,59 @@
+/**
+ * @file
+ * @brief Measures the sustained rate the listener streams at
+ *
+ * Starts a continuous capture and pulls both ears through EchoRecorder for a while,
+ * then reports the rate against the 8 MB/s the two 2 MS/s ADCs produce.
+ *
+ * usage: bench_listener_throughput <port> [seconds]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "echo_recorder.hpp"
+
+int main(int argc, char** argv)
+{
+  if (argc < 2) {
+    printf("usage: bench_listener_throughput <port> [seconds]\n");
+    return 1;
+  }
+  double seconds = argc > 2 ? atof(argv[2]) : 10.0;
+
+  EchoRecorder rec(argv[1]);
+  if (!rec.isOpen() || rec.ackRequest() < 0) {
+    printf("listener not responding on %s\n", argv[1]);
+    return 1;
+  }
+
+  // 30 ms pieces, the length of a ping
+  const std::size_t piece = 30000;
+  std::vector<uint16_t> left(piece), right(piece);
+  std::size_t samples = 0;
+
+  if (rec.startStream() < 0)
+    return 1;
+
+  auto start = std::chrono::steady_clock::now();
+  double elapsed = 0;
+  while (elapsed < seconds) {
+    if (rec.readSamples(left.data(), right.data(), piece) < 0)
+      break;
+    samples += piece;
+    elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+  rec.stopStream();
+
+  double mb = samples * 4 / 1e6;
+  printf("%.1f MB in %.2f s: %.2f MB/s (%.1f%% of 8 MB/s)\n", mb, elapsed, mb / elapsed, mb / elapsed / 8 * 100);
+  printf("received %zu bytes, dropped %zu bytes\n", rec.receivedBytes(), rec.droppedBytes());
+
+  const SonarStreamStats& s = rec.streamStats();
+  printf("%llu frames, %llu missed, %llu CRC errors, %llu ear mismatches\n",
+         (unsigned long long)s.frames, (unsigned long long)s.missed_frames,
+         (unsigned long long)s.crc_errors, (unsigned long long)s.ear_mismatches);
+  return rec.droppedBytes() == 0 && s.missed_frames == 0 ? 0 : 1;
+}
@@ -0,0 +1,58 @@
+/**
+ * @file
+ * @brief Times the deinterleave kernels on a 30 ms ping and on a 1 s capture of pair
+ * interleaved data
+ *
+ * usage: bench_lr_deinterleave [repeats]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "lr_deinterleave.hpp"
+
+int main(int argc, char** argv)
+{
+  int repeats = argc > 1 ? atoi(argv[1]) : 200;
+
+  // 2 MS/s per ear
+  const std::size_t captures[] = {60000, 2000000};
+  const LRCalibration cal = {0.0f, 1.0f / 2048.0f, 0.0f, 1.0f / 2048.0f};
+  const lr_isa_t isas[] = {LR_ISA_SCALAR, LR_ISA_SSE2, LR_ISA_AVX2, LR_ISA_NEON};
+
+  std::vector<uint16_t> in(2 * captures[1]);
+  uint32_t rng = 1;
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    rng = rng * 1664525 + 1013904223;
+    in[i] = 2048 + (rng >> 22);
+  }
+  std::vector<float> left(captures[1]), right(captures[1]);
+
+  printf("auto picks %s\n\n", lrIsaName(lrBestIsa()));
+
+  for (std::size_t n : captures) {
+    // keep the total work roughly even between the short and long capture
+    int reps = n < 100000 ? repeats * 30 : repeats;
+    printf("%zu pairs (%.0f ms), remove DC + calibrate\n", n, n / 2000.0);
+
+    double scalar_us = 0;
+    for (lr_isa_t isa : isas) {
+      if (!lrIsaAvailable(isa))
+        continue;
+
+      auto start = std::chrono::steady_clock::now();
+      for (int r = 0; r < reps; ++r)
+        lrDeinterleave(in.data(), n, left.data(), right.data(), &cal, true, isa);
+      double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / reps;
+
+      if (isa == LR_ISA_SCALAR)
+        scalar_us = us;
+      printf("  %-7s %9.1f us  %7.1f MS/s  %5.2fx\n", lrIsaName(isa), us, 2 * n / us, scalar_us / us);
+    }
+    printf("\n");
+  }
+
+  return 0;
+}
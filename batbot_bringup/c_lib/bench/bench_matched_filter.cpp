@@ -0,0 +1,78 @@
+/**
+ * @file
+ * @brief Times pulse compression of a batch of pings against a default length chirp,
+ * and a direct correlation of one channel for scale
+ *
+ * usage: bench_matched_filter [pings] [listen_ms] [repeats]
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "matched_filter.hpp"
+
+int main(int argc, char** argv)
+{
+  std::size_t pings = argc > 1 ? atoi(argv[1]) : 10;
+  std::size_t listen_ms = argc > 2 ? atoi(argv[2]) : 30;
+  int repeats = argc > 3 ? atoi(argv[3]) : 20;
+
+  // 3 ms chirp like default_chirp.npy, 1 MS/s
+  std::vector<float> chirp(3000);
+  for (std::size_t i = 0; i < chirp.size(); ++i) {
+    double t = i / 1e6;
+    chirp[i] = (float)(2048 + 512 * sin(2 * M_PI * (100e3 * t - 0.5 * 50e3 / 3e-3 * t * t)));
+  }
+
+  std::size_t n = listen_ms * 1000;
+  std::size_t channels = 2 * pings;
+  std::vector<std::vector<uint16_t>> raw(channels, std::vector<uint16_t>(n));
+  std::vector<std::vector<float>> profiles(channels, std::vector<float>(n));
+  std::vector<const uint16_t*> in(channels);
+  std::vector<float*> out(channels);
+  uint32_t rng = 1;
+  for (std::size_t c = 0; c < channels; ++c) {
+    for (std::size_t i = 0; i < n; ++i) {
+      rng = rng * 1664525 + 1013904223;
+      raw[c][i] = 2048 + (rng >> 24);
+    }
+    in[c] = raw[c].data();
+    out[c] = profiles[c].data();
+  }
+
+  std::size_t cores = std::thread::hardware_concurrency();
+  printf("%zu pings x 2 ears x %zu ms, %zu sample chirp, %zu cores\n", pings, listen_ms, chirp.size(), cores);
+
+  double single_ms = 0;
+  for (std::size_t threads = 1; threads <= (cores > 1 ? cores : 1); threads *= 2) {
+    MatchedFilter mf(chirp.data(), chirp.size(), true, threads);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; ++r)
+      mf.process(in.data(), channels, n, out.data(), true, true);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / repeats;
+
+    if (threads == 1)
+      single_ms = ms;
+    printf("  %2zu threads  fft %zu  %8.2f ms per batch  %6.2f ms per ping  %5.2fx\n",
+           threads, mf.fftSize(n), ms, ms / pings, single_ms / ms);
+  }
+
+  // the same profile the slow way, one channel
+  std::vector<float> direct(n);
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t k = 0; k < n; ++k) {
+    float acc = 0;
+    for (std::size_t j = 0; j < chirp.size() && k + j < n; ++j)
+      acc += raw[0][k + j] * (chirp[j] - 2048.0f);
+    direct[k] = acc;
+  }
+  double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  printf("  direct correlation, one ear  %8.2f ms  (%g)\n", ms, direct[n / 2]);
+
+  return 0;
+}
@@ -0,0 +1,61 @@
+"""Runs the emitter's ping train and measures the period from its own ping timestamps.
+
+The pings start on the timer through the event system, the timestamps are micros() in
+the timer's interrupt, so the jitter shown bounds the emission jitter from above. Pings
+missing from the log, because it was polled too late, are counted apart. Needs the
+emitter, with a chirp on it:
+
+    python3 bench_ping_train.py port [interval_ms] [pings]
+"""
+import contextlib
+import io
+import os
+import sys
+import time
+
+import numpy as np
+from serial import Serial
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "../../src/batbot_bringup/sonar"))
+from bb_emitter import EchoEmitter  # noqa: E402
+
+
+def main():
+    if len(sys.argv) < 2:
+        print(__doc__)
+        return 1
+    port = sys.argv[1]
+    interval_ms = float(sys.argv[2]) if len(sys.argv) > 2 else 10.0
+    count = int(sys.argv[3]) if len(sys.argv) > 3 else 500
+
+    with contextlib.redirect_stdout(io.StringIO()):
+        emitter = EchoEmitter(Serial(port, baudrate=960000))
+    emitter.chirp_uploaded = True
+    if not emitter.start_ping_train(interval_ms, count):
+        return 1
+
+    # gather the timestamps as they come, ping number -> micros()
+    stamps = {}
+    running = True
+    while running:
+        time.sleep(interval_ms * 1e-3 * 8)
+        running, pings, first, times = emitter.ping_train_status(max(stamps, default=-1) + 1)
+        if pings is None:
+            print("emitter stopped answering")
+            return 1
+        stamps.update(zip(range(first, first + len(times)), times.tolist()))
+
+    seq = np.array(sorted(stamps))
+    t = np.array([stamps[s] for s in seq], dtype=np.int64)
+    # consecutive pings only, micros() wraps after 71 minutes
+    step = np.diff(seq) == 1
+    periods = np.diff(t)[step] % (1 << 32)
+    err = periods - interval_ms * 1e3
+
+    print(f"{pings} pings every {interval_ms} ms, {len(seq)} timestamps, {pings - len(seq)} not polled in time")
+    print(f"  period mean {periods.mean():.2f} us, std {periods.std():.2f} us, worst {np.abs(err).max():.0f} us off")
+    return 0 if pings == count else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,75 @@
+/**
+ * @file
+ * @brief Times the unpacking kernels on one second of packed echo frames
+ *
+ * usage: bench_sonar_unpack [repeats]
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "sonar_pack.hpp"
+#include "sonar_unpack.hpp"
+
+int main(int argc, char** argv)
+{
+  int repeats = argc > 1 ? atoi(argv[1]) : 20;
+
+  // one second of one ear at 1 MS/s, in frame sized ears
+  const std::size_t frames = 1000000 / SONAR_FRAME_SAMPLES;
+  const std::size_t n = frames * SONAR_FRAME_SAMPLES;
+  const lr_isa_t isas[] = {LR_ISA_SCALAR, LR_ISA_SSE2, LR_ISA_AVX2, LR_ISA_NEON};
+  const uint16_t formats[] = {SONAR_FRAME_FLAG_PACK10, SONAR_FRAME_FLAG_DELTA};
+
+  // decaying echoes every 30 ms over a little noise
+  std::vector<uint16_t> x(n);
+  uint32_t rng = 1;
+  for (std::size_t i = 0; i < n; ++i) {
+    rng = rng * 1664525 + 1013904223;
+    double t = (double)(i % 30000);
+    x[i] = (uint16_t)(512 + 400 * std::sin(2 * M_PI * 0.04 * i) * std::exp(-t / 2000) + (int)(rng >> 29) - 4);
+  }
+
+  printf("auto picks %s\n\n", lrIsaName(lrBestIsa()));
+
+  for (uint16_t format : formats) {
+    std::vector<uint8_t> packed(frames * SONAR_FRAME_PAYLOAD_BYTES);
+    std::vector<std::size_t> offsets(frames + 1, 0);
+    for (std::size_t f = 0; f < frames; ++f) {
+      const uint16_t* ear = &x[f * SONAR_FRAME_SAMPLES];
+      uint8_t* out = &packed[offsets[f]];
+      std::size_t len = format == SONAR_FRAME_FLAG_PACK10
+                          ? sonarPack10(ear, SONAR_FRAME_SAMPLES, out)
+                          : sonarDeltaEncode(ear, SONAR_FRAME_SAMPLES, out, SONAR_FRAME_PAYLOAD_BYTES);
+      offsets[f + 1] = offsets[f] + len;
+    }
+    std::vector<uint16_t> out(n);
+
+    printf("%s, %zu samples in %zu bytes (%.1f bits a sample)\n",
+           format == SONAR_FRAME_FLAG_PACK10 ? "PACK10" : "DELTA", n, offsets[frames], 8.0 * offsets[frames] / n);
+
+    double scalar_us = 0;
+    for (lr_isa_t isa : isas) {
+      if (!lrIsaAvailable(isa))
+        continue;
+
+      auto start = std::chrono::steady_clock::now();
+      for (int r = 0; r < repeats; ++r) {
+        for (std::size_t f = 0; f < frames; ++f)
+          sonarUnpackEar(format, &packed[offsets[f]], offsets[f + 1] - offsets[f], &out[f * SONAR_FRAME_SAMPLES],
+                         SONAR_FRAME_SAMPLES, isa);
+      }
+      double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / repeats;
+
+      if (isa == LR_ISA_SCALAR)
+        scalar_us = us;
+      printf("  %-7s %9.1f us  %7.1f MS/s  %5.2fx\n", lrIsaName(isa), us, n / us, scalar_us / us);
+    }
+    printf("\n");
+  }
+
+  return 0;
+}
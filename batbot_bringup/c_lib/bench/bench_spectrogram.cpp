@@ -0,0 +1,53 @@
+/**
+ * @file
+ * @brief Times the spectrogram of one ping, both ears, against the number of threads
+ *
+ * usage: bench_spectrogram [listen_ms] [repeats]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "spectrogram.hpp"
+
+int main(int argc, char** argv)
+{
+  std::size_t listen_ms = argc > 1 ? atoi(argv[1]) : 30;
+  int repeats = argc > 2 ? atoi(argv[2]) : 200;
+
+  // the settings bb_repl plots with, 1 MS/s, a 3000 sample time offset
+  std::size_t n = listen_ms * 1000;
+  std::size_t offset = 3000;
+  std::vector<uint16_t> left(n), right(n);
+  uint32_t rng = 1;
+  for (std::size_t i = 0; i < n; ++i) {
+    rng = rng * 1664525 + 1013904223;
+    left[i] = 2048 + (rng >> 24);
+    right[i] = 2048 - (rng >> 24);
+  }
+
+  std::size_t cores = std::thread::hardware_concurrency();
+  printf("%zu ms ping, both ears, %zu cores\n", listen_ms, cores);
+
+  double single_us = 0;
+  for (std::size_t threads = 1; threads <= (cores > 1 ? cores : 1); threads *= 2) {
+    Spectrogram spec(1e6, 512, 400, 30e3, 100e3, threads);
+    std::size_t frames = spec.numFrames(n - offset);
+    std::vector<float> ldb(spec.numBins() * frames), rdb(spec.numBins() * frames);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; ++r)
+      spec.compute(left.data(), right.data(), n, ldb.data(), rdb.data(), true, offset, 40);
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / repeats;
+
+    if (threads == 1)
+      single_us = us;
+    printf("  %2zu threads  %zu frames x %zu bins x 2 ears  %8.1f us  %5.2fx\n",
+           threads, frames, spec.numBins(), us, single_us / us);
+  }
+
+  return 0;
+}
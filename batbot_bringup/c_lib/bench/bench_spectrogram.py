@@ -0,0 +1,61 @@
+"""Compares sonardsp.Spectrogram with the mlab.specgram + 20 log10 + crop + clip steps
+process() and plot_spec() in bb_repl do for each ear, on one ping.
+
+Run from a build directory that contains the sonardsp module, or with it on PYTHONPATH:
+    python3 bench_spectrogram.py [listen_ms] [repeats]
+"""
+import sys
+import timeit
+
+import matplotlib.mlab as mlab
+import numpy as np
+from scipy import signal
+
+import sonardsp
+
+FS = 1e6
+NFFT = 512
+NOVERLAP = 400
+FBOUNDS = (30e3, 100e3)
+DB_RANGE = 40
+TIME_OFFS = 3000
+
+
+def numpy_path(L, R, window):
+    out = []
+    for ear in (L, R):
+        x = ear - np.mean(ear)
+        s, f, t = mlab.specgram(x[TIME_OFFS:], Fs=FS, NFFT=NFFT, noverlap=NOVERLAP, window=window)
+        rows = (f >= FBOUNDS[0]) & (f <= FBOUNDS[1])
+        s = 20 * np.log10(s[rows])
+        out.append(np.maximum(s - s.max(), -DB_RANGE))
+    return out
+
+
+def main():
+    listen_ms = int(sys.argv[1]) if len(sys.argv) > 1 else 30
+    repeats = int(sys.argv[2]) if len(sys.argv) > 2 else 20
+
+    rng = np.random.default_rng(0)
+    n = listen_ms * 1000
+    L = rng.integers(1800, 2300, n, dtype=np.uint16)
+    R = rng.integers(1800, 2300, n, dtype=np.uint16)
+
+    window = signal.windows.hann(NFFT)
+    spec = sonardsp.Spectrogram(FS, NFFT, NOVERLAP, FBOUNDS[0], FBOUNDS[1])
+
+    ref_l, ref_r = numpy_path(L, R, window)
+    l, r = spec.compute(L, R, time_offset=TIME_OFFS, db_range=DB_RANGE)
+    print(f"max difference {max(np.abs(l - ref_l).max(), np.abs(r - ref_r).max()):.4f} dB")
+
+    t_np = min(timeit.repeat(lambda: numpy_path(L, R, window), number=repeats, repeat=3)) / repeats
+    t_native = min(timeit.repeat(lambda: spec.compute(L, R, time_offset=TIME_OFFS, db_range=DB_RANGE),
+                                 number=repeats, repeat=3)) / repeats
+
+    print(f"{listen_ms} ms ping, both ears, {spec.threads} threads")
+    print(f"  mlab.specgram  {t_np * 1e3:8.2f} ms")
+    print(f"  sonardsp       {t_native * 1e3:8.2f} ms  {t_np / t_native:5.1f}x")
+
+
+if __name__ == "__main__":
+    main()
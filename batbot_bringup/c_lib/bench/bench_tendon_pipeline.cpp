@@ -0,0 +1,166 @@
+/**
+ * @file
+ * @brief Commands per second through TendonHardwareInterface versus in-flight window size
+ *
+ * The tendon controller is played by a thread on the master side of a pty. It answers
+ * every request with an ECHO of the whole frame (same sequence number, so the CRC still
+ * holds), handling one request at a time with a fixed processing time and releasing each
+ * response only after a fixed link latency, which is roughly what a USB CDC round trip
+ * to the SAMD51 looks like. With a window of 1 the host pays the full round trip for
+ * every command; larger windows hide the latency until processing time is the limit.
+ *
+ * usage: bench_tendon_pipeline [num_commands] [latency_us] [processing_us]
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "tendon_hardware_interface.hpp"
+
+typedef std::chrono::steady_clock bench_clock;
+
+typedef struct {
+  bench_clock::time_point due;
+  std::vector<uint8_t> frame;
+} PendingReply;
+
+static std::atomic<bool> device_running(true);
+
+static void device(int fd, std::chrono::microseconds latency, std::chrono::microseconds processing)
+{
+  std::vector<uint8_t> stream;
+  std::deque<PendingReply> replies;
+  bench_clock::time_point busy_until = bench_clock::now();
+  uint8_t buf[512];
+
+  while (device_running) {
+    int timeout_ms = 10;
+    if (!replies.empty()) {
+      auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(replies.front().due - bench_clock::now());
+      timeout_ms = wait.count() > 0 ? (int)wait.count() : 0;
+    }
+
+    struct pollfd pfd = {fd, POLLIN, 0};
+    if (poll(&pfd, 1, timeout_ms) > 0 && (pfd.revents & POLLIN)) {
+      ssize_t n = read(fd, buf, sizeof buf);
+      if (n > 0)
+        stream.insert(stream.end(), buf, buf + n);
+    }
+
+    // requests are well formed here, so framing only needs the length byte
+    std::size_t pos = 0;
+    while (stream.size() - pos >= 3 && stream.size() - pos >= (std::size_t)stream[pos + 2] + 3) {
+      std::size_t len = stream[pos + 2] + 3;
+
+      bench_clock::time_point now = bench_clock::now();
+      if (busy_until < now)
+        busy_until = now;
+      busy_until += processing;
+
+      PendingReply r;
+      r.due = busy_until + latency;
+      r.frame.assign(stream.begin() + pos, stream.begin() + pos + len);
+      replies.push_back(r);
+      pos += len;
+    }
+    stream.erase(stream.begin(), stream.begin() + pos);
+
+    // spin out the last few hundred microseconds, poll() only has ms resolution
+    while (!replies.empty() && replies.front().due <= bench_clock::now() + std::chrono::microseconds(500)) {
+      while (bench_clock::now() < replies.front().due);
+      if (write(fd, replies.front().frame.data(), replies.front().frame.size()) < 0)
+        return;
+      replies.pop_front();
+    }
+  }
+}
+
+int main(int argc, char** argv)
+{
+  int num_commands = argc > 1 ? atoi(argv[1]) : 1000;
+  std::chrono::microseconds latency(argc > 2 ? atoi(argv[2]) : 1000);
+  std::chrono::microseconds processing(argc > 3 ? atoi(argv[3]) : 50);
+
+  int master = posix_openpt(O_RDWR | O_NOCTTY);
+  if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+    std::cout << "Error creating pty\n";
+    return 1;
+  }
+
+  // no termios here, it defines ECHO. The interface puts the pty into raw mode when it opens the slave.
+  std::thread dev(device, master, latency, processing);
+
+  int ret = 0;
+  {
+    TendonHardwareInterface th(ptsname(master));
+
+    std::size_t matched = 0;
+    th.SetResponseCallback([&matched](uint8_t seq, const TendonHardwareInterface::TendonHardwareResponse& resp) {
+      (void)seq;
+      if (resp.opcode == ECHO && resp.numParams == 2)
+        matched++;
+    });
+
+    std::cout << num_commands << " ECHO commands, " << latency.count() << " us latency, "
+              << processing.count() << " us processing per command\n";
+    std::cout << "window   commands/s   speedup\n";
+
+    double base_rate = 0;
+    const std::size_t windows[] = {1, 2, 4, 8, 16, 32};
+    for (std::size_t w : windows) {
+      th.SetWindowSize(w);
+      matched = 0;
+
+      uint8_t params[2];
+      auto start = bench_clock::now();
+      for (int i = 0; i < num_commands; ++i) {
+        params[0] = (uint8_t)i;
+        params[1] = (uint8_t)(i >> 8);
+        if (th.Submit(1, ECHO, params, sizeof params) < 0) {
+          ret = 1;
+          break;
+        }
+      }
+      th.Flush();
+      double secs = std::chrono::duration<double>(bench_clock::now() - start).count();
+
+      // drain the completed responses, the callback already counted them
+      TendonHardwareInterface::TendonHardwareResponse resp;
+      for (int seq = 0; seq < 256; ++seq)
+        th.GetResponse((uint8_t)seq, &resp);
+
+      double rate = matched / secs;
+      if (w == 1)
+        base_rate = rate;
+
+      printf("%6zu   %10.0f   %6.1fx\n", w, rate, rate / base_rate);
+
+      if (matched != (std::size_t)num_commands) {
+        std::cout << "only " << matched << " of " << num_commands << " responses matched\n";
+        ret = 1;
+      }
+    }
+
+    if (th.Timeouts() > 0) {
+      std::cout << th.Timeouts() << " requests timed out\n";
+      ret = 1;
+    }
+  }
+
+  device_running = false;
+  dev.join();
+  close(master);
+  return ret;
+}
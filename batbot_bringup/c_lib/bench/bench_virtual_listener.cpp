@@ -0,0 +1,162 @@
+/**
+ * @file
+ * @brief Measures EchoRecorder against the listener emulator, no Teensy needed
+ *
+ * throughput: the emulator streams as fast as the host takes it, in each packing and
+ * in baseband, where the rate is of the raw samples filtered
+ * latency: 30 ms pings at the real rate, the time listen() takes beyond the 30 ms, most
+ * of it the ECHO_RECORDER_QUIET_MS the recorder waits for the stream to go quiet, and the
+ * time capture() takes beyond a 30 ms window
+ * drops: frames left out and corrupted at random must come back exactly as counted
+ *
+ * Fails if a clean stream loses anything or the drop accounting is off.
+ *
+ * usage: bench_virtual_listener [seconds]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "echo_recorder.hpp"
+#include "virtual_listener.hpp"
+
+static int throughput(double seconds)
+{
+  VirtualListenerConfig config = virtualListenerDefaults();
+  config.rateScale = 0;
+  VirtualListener dev(config);
+  EchoRecorder rec(dev.portName());
+  if (!dev.isOpen() || !rec.isOpen() || rec.ackRequest() < 0)
+    return 1;
+
+  // the last pass is baseband, where each I, Q pair stands for SONAR_DDC_DECIMATION raw samples
+  const char* names[] = {"plain", "10 bit", "delta", "IQ"};
+  const listener_packing_t packings[] = {LISTENER_PACKING_NONE, LISTENER_PACKING_10BIT, LISTENER_PACKING_DELTA,
+                                         LISTENER_PACKING_NONE};
+  const std::size_t piece = 30000;
+  std::vector<uint16_t> left(piece), right(piece);
+
+  printf("throughput, unpaced\n");
+  for (int p = 0; p < 4; ++p) {
+    bool iq = p == 3;
+    if (rec.setPacking(packings[p]) < 0 || rec.setBaseband(iq) < 0 || rec.startStream() < 0)
+      return 1;
+
+    std::size_t samples = 0;
+    std::size_t before = rec.receivedBytes();
+    auto start = std::chrono::steady_clock::now();
+    double elapsed = 0;
+    while (elapsed < seconds) {
+      if (rec.readSamples(left.data(), right.data(), piece) < 0)
+        return 1;
+      samples += iq ? piece / 2 * SONAR_DDC_DECIMATION : piece;
+      elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    std::size_t wire = rec.receivedBytes() - before;
+    rec.stopStream();
+
+    const SonarStreamStats& s = rec.streamStats();
+    printf("  %-7s %7.1f MS/s per ear (%5.1fx real time), %6.1f MB/s on the wire, %llu missed\n", names[p],
+           samples / elapsed / 1e6, samples / elapsed / config.sampleRate, wire / elapsed / 1e6,
+           (unsigned long long)s.missed_frames);
+    if (s.missed_frames || s.crc_errors || rec.droppedBytes())
+      return 1;
+  }
+  return rec.setBaseband(false);
+}
+
+static int latency(int pings)
+{
+  VirtualListenerConfig config = virtualListenerDefaults();
+  VirtualListener dev(config);
+  EchoRecorder rec(dev.portName());
+  if (!dev.isOpen() || !rec.isOpen() || rec.ackRequest() < 0)
+    return 1;
+
+  const std::size_t n = (std::size_t)(0.03 * config.sampleRate);
+  std::vector<uint16_t> left(n), right(n);
+  std::vector<double> extra, captureExtra;
+  for (int i = 0; i < pings; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    if (rec.listen(left.data(), right.data(), n) < 0)
+      return 1;
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    extra.push_back(ms - n / config.sampleRate * 1e3);
+    if (rec.streamStats().missed_frames)
+      return 1;
+  }
+
+  // 1 ms before the trigger, the rest after
+  const std::size_t pre = (std::size_t)(0.001 * config.sampleRate);
+  for (int i = 0; i < pings; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    if (rec.capture(left.data(), right.data(), pre, n - pre) < 0)
+      return 1;
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    captureExtra.push_back(ms - n / config.sampleRate * 1e3);
+  }
+
+  std::sort(extra.begin(), extra.end());
+  std::sort(captureExtra.begin(), captureExtra.end());
+  printf("latency, %d pings of 30 ms at the real rate\n", pings);
+  printf("  beyond the ping: median %.2f ms, worst %.2f ms\n", extra[extra.size() / 2], extra.back());
+  printf("  capture beyond the window: median %.2f ms, worst %.2f ms\n", captureExtra[captureExtra.size() / 2],
+         captureExtra.back());
+  return 0;
+}
+
+static int drops(double seconds)
+{
+  VirtualListenerConfig config = virtualListenerDefaults();
+  config.rateScale = 0;
+  config.dropRate = 0.01;
+  config.corruptRate = 0.005;
+  VirtualListener dev(config);
+  EchoRecorder rec(dev.portName());
+  if (!dev.isOpen() || !rec.isOpen() || rec.ackRequest() < 0)
+    return 1;
+
+  std::size_t frames = (std::size_t)(seconds * config.sampleRate / SONAR_FRAME_SAMPLES);
+  std::vector<uint16_t> left(frames * SONAR_FRAME_SAMPLES), right(frames * SONAR_FRAME_SAMPLES);
+  if (rec.listen(left.data(), right.data(), left.size()) < 0)
+    return 1;
+
+  // the recorder stops at the first whole frame past the end, a lost tail is only counted
+  // once the frame after it shows up
+  std::vector<uint32_t> lost = dev.lostFrames();
+  std::vector<uint32_t> corrupted = dev.corruptedFrames();
+  uint32_t last = (uint32_t)frames - 1;
+  while (std::count(lost.begin(), lost.end(), last) || std::count(corrupted.begin(), corrupted.end(), last))
+    last++;
+  uint64_t expected_crc = std::count_if(corrupted.begin(), corrupted.end(), [&](uint32_t s) { return s < last; });
+  uint64_t expected_missed =
+    expected_crc + std::count_if(lost.begin(), lost.end(), [&](uint32_t s) { return s < last; });
+
+  const SonarStreamStats& s = rec.streamStats();
+  printf("drops, %zu frames\n", frames);
+  printf("  missed %llu of %llu lost, %llu CRC errors of %llu corrupted\n", (unsigned long long)s.missed_frames,
+         (unsigned long long)expected_missed, (unsigned long long)s.crc_errors, (unsigned long long)expected_crc);
+  return s.missed_frames == expected_missed && s.crc_errors == expected_crc ? 0 : 1;
+}
+
+int main(int argc, char** argv)
+{
+  double seconds = argc > 1 ? atof(argv[1]) : 5.0;
+
+  if (throughput(seconds)) {
+    printf("throughput run failed\n");
+    return 1;
+  }
+  if (latency(20)) {
+    printf("latency run failed\n");
+    return 1;
+  }
+  if (drops(seconds)) {
+    printf("drop accounting is off\n");
+    return 1;
+  }
+  return 0;
+}
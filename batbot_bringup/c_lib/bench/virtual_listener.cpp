@@ -0,0 +1,82 @@
+/**
+ * @file
+ * @brief Runs the listener emulator until interrupted, for pointing bb_listener, the GUI
+ * or bench_listener_throughput at a listener that is not there
+ *
+ * usage: virtual_listener [--rate scale] [--noise counts] [--drop fraction]
+ *                         [--corrupt fraction] [--silent] [--echo delay_ms,amplitude ...]
+ *
+ * --rate 0 streams as fast as the host reads. Each --echo replaces the default echoes
+ * with an 80 to 30 kHz, 3 ms sweep at that delay and peak amplitude.
+ */
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#include "virtual_listener.hpp"
+
+static volatile std::sig_atomic_t stop = 0;
+
+static void on_signal(int)
+{
+  stop = 1;
+}
+
+int main(int argc, char** argv)
+{
+  VirtualListenerConfig config = virtualListenerDefaults();
+  bool silent = false;
+  bool ownEchoes = false;
+
+  for (int i = 1; i < argc; ++i) {
+    bool more = i + 1 < argc;
+    if (!strcmp(argv[i], "--rate") && more) {
+      config.rateScale = atof(argv[++i]);
+    } else if (!strcmp(argv[i], "--noise") && more) {
+      config.noise = atof(argv[++i]);
+    } else if (!strcmp(argv[i], "--drop") && more) {
+      config.dropRate = atof(argv[++i]);
+    } else if (!strcmp(argv[i], "--corrupt") && more) {
+      config.corruptRate = atof(argv[++i]);
+    } else if (!strcmp(argv[i], "--silent")) {
+      silent = true;
+    } else if (!strcmp(argv[i], "--echo") && more) {
+      double delay_ms, amplitude;
+      if (sscanf(argv[++i], "%lf,%lf", &delay_ms, &amplitude) != 2) {
+        printf("--echo takes delay_ms,amplitude\n");
+        return 1;
+      }
+      if (!ownEchoes)
+        config.echoes.clear();
+      ownEchoes = true;
+      config.echoes.push_back({delay_ms * 1e-3, 0, amplitude, 80e3, 30e3, 0.003});
+    } else {
+      printf("usage: virtual_listener [--rate scale] [--noise counts] [--drop fraction] "
+             "[--corrupt fraction] [--silent] [--echo delay_ms,amplitude ...]\n");
+      return 1;
+    }
+  }
+
+  VirtualListener dev(config);
+  if (!dev.isOpen())
+    return 1;
+  dev.setEmitterSilent(silent);
+
+  signal(SIGINT, on_signal);
+  signal(SIGTERM, on_signal);
+  printf("virtual listener on %s, ctrl-c to stop\n", dev.portName().c_str());
+  fflush(stdout);
+
+  while (!stop)
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  VirtualListenerStats s = dev.stats();
+  printf("\nlast stream: %llu frames sent (%llu bytes), %llu dropped, %llu corrupted, %llu overrun\n",
+         (unsigned long long)s.frames_sent, (unsigned long long)s.bytes_sent, (unsigned long long)s.frames_dropped,
+         (unsigned long long)s.frames_corrupted, (unsigned long long)s.frames_overrun);
+  return 0;
+}
@@ -0,0 +1,277 @@
+#ifndef ECHO_RECORDER_HPP
+#define ECHO_RECORDER_HPP
+
+/**
+ * @file
+ * @brief Native echo recorder for the Teensy listener (Linux)
+ *
+ * The port is opened once and kept open. A dedicated reader thread pulls everything the
+ * Teensy sends into a lock-free ring buffer, so the USB endpoint is drained at full
+ * speed no matter what the caller is doing. The caller cuts CRC checked frames out of
+ * the ring and splits the ears straight into its own arrays, filling in for any frames
+ * that went missing so the time base and the two ears stay aligned.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <thread>
+
+#include "sonar_frame_decoder.hpp"
+#include "spsc_ring_buffer.hpp"
+#include "stdint.h"
+
+/**
+ * @brief Value written in place of samples from missing frames, mid scale of the 10 bit
+ * ADCs so a gap does not pull the DC offset. Missing baseband frames read as 0.
+ */
+#define ECHO_RECORDER_GAP_FILL 512
+
+/**
+ * @brief Size of the ring between the reader thread and the caller. 1 s of the
+ * 2 x 2 MS/s x 16 bit stream, far more than the caller should ever fall behind.
+ */
+#define ECHO_RECORDER_RING_LEN (8 * 1024 * 1024)
+
+/**
+ * @brief Largest single read() from the port
+ */
+#define ECHO_RECORDER_READ_CHUNK_LEN 65536
+
+/**
+ * @brief How long the stream must be silent after STOP_LISTEN before it counts as drained
+ */
+#define ECHO_RECORDER_QUIET_MS 20
+
+/**
+ * @brief How long to wait for the Teensy to answer a command, or for the next sample
+ */
+#define ECHO_RECORDER_TIMEOUT_MS 500
+
+/**
+ * @brief Host serial commands understood by the listener firmware
+ */
+typedef enum {
+  LISTENER_CMD_NONE = 0,
+  LISTENER_CMD_START_LISTEN = 1,
+  LISTENER_CMD_STOP_LISTEN = 2,
+  LISTENER_CMD_ACK_REQ = 3,
+  LISTENER_CMD_ACK = 4,
+  LISTENER_CMD_CAPTURE = 5,
+  LISTENER_CMD_BASEBAND = 6,
+  LISTENER_CMD_PACKING = 7,
+  LISTENER_CMD_ERROR = 100
+} listener_serial_cmd_t;
+
+/**
+ * @brief How the listener packs the ears of raw frames, see sonar_pack.hpp
+ */
+typedef enum {
+  LISTENER_PACKING_NONE = 0,   // plain 16 bit samples
+  LISTENER_PACKING_10BIT = 1,  // PACK10, 37.5% smaller
+  LISTENER_PACKING_DELTA = 2   // DELTA where it beats PACK10, PACK10 otherwise
+} listener_packing_t;
+
+class EchoRecorder {
+
+public:
+  /**
+   * @brief Opens the listener port and starts the reader thread
+   *
+   * @param portName the linux device port
+   * @param leftChannelFirst true if the left ear is ADC 0, the first half of each frame
+   */
+  EchoRecorder(std::string portName, bool leftChannelFirst = true);
+
+  /**
+   * @brief Stops the reader thread and closes the port
+   */
+  ~EchoRecorder();
+
+  /**
+   * @brief Returns true if the port opened and the reader thread is running
+   */
+  bool isOpen() const { return _fd >= 0; }
+
+  /**
+   * @brief Sends ACK_REQ and waits for ACK
+   *
+   * @return int 0 if the listener answered, -1 otherwise
+   */
+  int ackRequest();
+
+  /**
+   * @brief Records a fixed number of samples per ear
+   *
+   * @param left filled with samplesPerEar samples of the left ear
+   * @param right filled with samplesPerEar samples of the right ear
+   * @param samplesPerEar the number of samples to record per ear
+   * @return int 0 on success, -1 on error or if the stream stalled
+   *
+   * Equivalent to startStream(), readSamples(), stopStream().
+   */
+  int listen(uint16_t* left, uint16_t* right, std::size_t samplesPerEar);
+
+  /**
+   * @brief Starts streaming. Anything received before this is discarded.
+   *
+   * @return int 0 on success, -1 on error
+   *
+   * The listener requests the chirp and streams from the frame its trigger falls in. If
+   * the emitter does not answer it replies ERROR instead, and the first readSamples()
+   * fails.
+   */
+  int startStream();
+
+  /**
+   * @brief Takes the next samples of a running stream
+   *
+   * @param left filled with samplesPerEar samples of the left ear
+   * @param right filled with samplesPerEar samples of the right ear
+   * @param samplesPerEar the number of samples to take per ear
+   * @return int 0 on success, -1 if no data arrived for ECHO_RECORDER_TIMEOUT_MS
+   *
+   * Can be called repeatedly for continuous capture of any length; the stream picks up
+   * exactly where the previous call stopped. Samples of frames that were lost or failed
+   * their CRC are ECHO_RECORDER_GAP_FILL, see streamStats().
+   */
+  int readSamples(uint16_t* left, uint16_t* right, std::size_t samplesPerEar);
+
+  /**
+   * @brief Records a window around the chirp trigger
+   *
+   * @param left filled with preSamples + postSamples samples of the left ear
+   * @param right filled with preSamples + postSamples samples of the right ear
+   * @param preSamples samples per ear before the trigger
+   * @param postSamples samples per ear from the trigger on, the trigger is sample preSamples
+   * @return int 0 on success, -1 if the listener refused the window or did not deliver it
+   *
+   * The listener records into its own ring, starts the chirp once the pre-trigger part
+   * is full and sends the window only once it is complete, so a USB stall during the
+   * ping costs nothing and the window can be longer than USB sustains live.
+   */
+  int capture(uint16_t* left, uint16_t* right, std::size_t preSamples, std::size_t postSamples);
+
+  /**
+   * @brief Switches the stream between raw samples and complex baseband
+   *
+   * @param on true for baseband, false for raw ADC samples
+   * @return int 0 if the listener acknowledged, -1 otherwise
+   *
+   * In baseband the listener bandpass filters each ear around the echo band and decimates
+   * by SONAR_DDC_DECIMATION. Each ear then arrives as int16 I, Q pairs, so readSamples()
+   * fills the uint16 arrays with interleaved I and Q to be read as int16, two values per
+   * complex sample. Triggered captures stay raw. Only takes effect on the next
+   * startStream().
+   */
+  int setBaseband(bool on);
+
+  /**
+   * @brief Chooses how the listener packs raw samples on the wire
+   *
+   * @param packing the packed form
+   * @return int 0 if the listener acknowledged, -1 otherwise
+   *
+   * Packed frames are unpacked as they are taken from the ring, so readSamples() and
+   * listen() hand back the same samples either way. Baseband frames and triggered
+   * captures are never packed.
+   */
+  int setPacking(listener_packing_t packing);
+
+  /**
+   * @brief Stops streaming and throws away whatever the Teensy sends after
+   *
+   * @return int 0 on success, -1 on error
+   */
+  int stopStream();
+
+  /**
+   * @brief Returns the number of bytes lost because the ring was full
+   */
+  std::size_t droppedBytes() const { return _dropped.load(); }
+
+  /**
+   * @brief Returns the number of bytes received since the port was opened
+   */
+  std::size_t receivedBytes() const { return _received.load(); }
+
+  /**
+   * @brief Returns the frame counters since the last startStream()
+   */
+  const SonarStreamStats& streamStats() const { return _decoder.stats(); }
+
+  /**
+   * @brief Returns where the listener saw the chirp trigger, -1 if it did not say
+   *
+   * An index into the samples handed out since the last startStream(), or into the
+   * window of the last capture(), where it is preSamples. The listener reads it off the
+   * ADC DMA address, so it is exact to the sample.
+   */
+  int64_t triggerSample() const { return _trigger; }
+
+private:
+  void readerLoop();
+
+  int writeCmd(uint8_t cmd);
+
+  int writeBytes(const uint8_t* data, std::size_t len);
+
+  /**
+   * @brief Takes n bytes out of the ring, waiting for them to arrive
+   */
+  int readBytes(void* dst, std::size_t n, int timeout_ms);
+
+  /**
+   * @brief Waits until the ring holds at least n bytes
+   */
+  int waitReadable(std::size_t n, int timeout_ms);
+
+  /**
+   * @brief Waits for the next good frame and makes it the current one
+   */
+  int nextFrame();
+
+  /**
+   * @brief Throws away everything received so far, including a partly read frame
+   */
+  void discard();
+
+  int _fd;
+
+  bool _leftFirst;
+
+  std::string _portName;
+
+  SpscRingBuffer _ring;
+
+  std::thread _reader;
+
+  std::atomic<bool> _running;
+
+  std::atomic<std::size_t> _dropped;
+
+  std::atomic<std::size_t> _received;
+
+  SonarFrameDecoder _decoder;
+
+  // samples of the frame being taken apart, in the ring or in the decoder if it wrapped
+  // around the end of the ring
+  const uint8_t* _frame;
+  std::size_t _framePos;
+  // ring bytes to release once the frame is used up, 0 if it is in the decoder
+  std::size_t _frameCommit;
+  // samples per ear still to fill in for missing frames before the current one
+  std::size_t _fill;
+  // ECHO_RECORDER_GAP_FILL, or 0 when the frames are baseband
+  uint16_t _fillValue;
+  // the ears of the current frame if it came packed
+  uint16_t _unpacked[2 * SONAR_FRAME_SAMPLES];
+  // index of the next sample handed out, from the start of the stream or capture window
+  int64_t _samplePos;
+  // sample index of the chirp trigger, -1 if none was reported
+  int64_t _trigger;
+  // START_LISTEN went out and nothing has come back yet
+  bool _streamStarting;
+};
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef LR_DEINTERLEAVE_HPP
+#define LR_DEINTERLEAVE_HPP
+
+/**
+ * @file
+ * @brief Splits a pair interleaved left/right ADC stream into calibrated float channels
+ *
+ * For data in the old GetData() layout, little endian uint16 pairs [ L0 ][ R0 ][ L1 ][ R1 ]...,
+ * e.g. captures saved before the framed stream. The current listener sends frames of
+ * [ ADC 0 block ][ ADC 1 block ], which EchoRecorder already splits into uint16 ears, and
+ * Spectrogram and MatchedFilter take those ears as they are, so the capture path does not
+ * go through these kernels.
+ *
+ * The kernels deinterleave, apply a per channel offset and gain and convert to float32 in
+ * one pass, instead of the strided copies, casts and subtraction the numpy path does one
+ * after another. Removing the DC offset needs the means first, so it adds a read-only
+ * pass over the input (lrChannelSums) before the conversion.
+ *
+ * SSE2, AVX2 and NEON versions are built alongside a scalar fallback. AVX2 is compiled
+ * with a function target attribute and only used if the CPU reports it, so the library
+ * still runs on any x86-64.
+ */
+
+#include <cstddef>
+
+#include "stdint.h"
+
+/**
+ * @brief Per channel calibration, out = (in - offset) * gain
+ */
+typedef struct {
+  float left_offset;
+  float left_gain;
+  float right_offset;
+  float right_gain;
+} LRCalibration;
+
+/**
+ * @brief Kernel implementations, in order of preference
+ */
+typedef enum {
+  LR_ISA_SCALAR,
+  LR_ISA_SSE2,
+  LR_ISA_AVX2,
+  LR_ISA_NEON,
+  LR_ISA_AUTO
+} lr_isa_t;
+
+/**
+ * @brief Deinterleaves, calibrates and converts an interleaved stream
+ *
+ * @param in the interleaved samples, 2 * numPairs uint16 values
+ * @param numPairs the number of left/right pairs
+ * @param left numPairs floats for the left channel
+ * @param right numPairs floats for the right channel
+ * @param cal the calibration to apply, NULL for offset 0 and gain 1
+ * @param removeDC if true, each channel's mean is used as its offset instead of cal's offset
+ * @param isa the implementation to use, LR_ISA_AUTO picks the best one available
+ * @return int 0 on success, -1 if the requested implementation is not available
+ */
+int lrDeinterleave(const uint16_t* in, std::size_t numPairs, float* left, float* right,
+                   const LRCalibration* cal, bool removeDC, lr_isa_t isa = LR_ISA_AUTO);
+
+/**
+ * @brief Sums each channel of an interleaved stream
+ *
+ * @param in the interleaved samples
+ * @param numPairs the number of left/right pairs
+ * @param leftSum set to the sum of the left channel
+ * @param rightSum set to the sum of the right channel
+ * @param isa the implementation to use, LR_ISA_AUTO picks the best one available
+ * @return int 0 on success, -1 if the requested implementation is not available
+ */
+int lrChannelSums(const uint16_t* in, std::size_t numPairs, uint64_t* leftSum, uint64_t* rightSum,
+                  lr_isa_t isa = LR_ISA_AUTO);
+
+/**
+ * @brief Returns true if the implementation can run on this machine
+ */
+bool lrIsaAvailable(lr_isa_t isa);
+
+/**
+ * @brief Returns the implementation LR_ISA_AUTO resolves to
+ */
+lr_isa_t lrBestIsa();
+
+/**
+ * @brief Returns a printable name for an implementation
+ */
+const char* lrIsaName(lr_isa_t isa);
+
+#endif
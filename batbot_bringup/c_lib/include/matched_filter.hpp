@@ -0,0 +1,123 @@
+#ifndef MATCHED_FILTER_HPP
+#define MATCHED_FILTER_HPP
+
+/**
+ * @file
+ * @brief Pulse compression of echoes against the emitted chirp
+ *
+ * Each channel is correlated with the chirp by overlap-save FFT convolution. The block size
+ * is picked from the chirp and capture lengths, and the FFT plan and the chirp's conjugate
+ * spectrum for it are made on first use and kept, so a block costs one forward transform,
+ * a complex multiply and one inverse transform. A batch of channels,
+ * typically pings x 2 ears, is split into (channel, block) tasks over a persistent pool
+ * of worker threads.
+ */
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "real_fft.hpp"
+#include "stdint.h"
+#include "worker_pool.hpp"
+
+/**
+ * @brief Largest FFT size considered when picking one automatically, as a multiple of the
+ * chirp length
+ */
+#define MATCHED_FILTER_MAX_FFT_RATIO 16
+
+class MatchedFilter {
+
+public:
+  /**
+   * @brief Makes the filter
+   *
+   * @param chirp the emitted chirp, as played by the DAC
+   * @param chirpLen the number of chirp samples
+   * @param removeChirpDC subtract the chirp's mean first, DAC codes sit on a mid scale offset
+   * @param numThreads worker threads including the caller, 0 for one per core
+   * @param fftSize the block transform size, a power of two above the chirp length, 0 to
+   * pick the one with the least work for each call's capture length
+   */
+  MatchedFilter(const float* chirp, std::size_t chirpLen, bool removeChirpDC = true,
+                std::size_t numThreads = 0, std::size_t fftSize = 0);
+
+  std::size_t chirpLen() const { return _chirp.size(); }
+  std::size_t numThreads() const { return _pool.size(); }
+
+  /**
+   * @brief Returns the block transform size process() uses for numSamples per channel
+   */
+  std::size_t fftSize(std::size_t numSamples) const;
+
+  /**
+   * @brief Compresses a batch of channels
+   *
+   * out[c][k] = sum over n of x[c][k + n] * chirp[n], with x taken as 0 past its end, so
+   * index k is the round trip delay in samples. This is
+   * scipy.signal.correlate(x, chirp, 'full')[chirpLen - 1 : chirpLen - 1 + numSamples].
+   *
+   * @param in numChannels pointers to numSamples samples each
+   * @param numChannels the number of channels, e.g. 2 * pings
+   * @param numSamples the samples per channel
+   * @param out numChannels pointers to numSamples outputs each, may not alias the inputs
+   * @param removeDC subtract each channel's mean first
+   * @param normalize scale each channel to abs(out) / max(abs(out)), like autocorr()
+   * @return int 0 on success, -1 if there is nothing to do
+   */
+  int process(const float* const* in, std::size_t numChannels, std::size_t numSamples,
+              float* const* out, bool removeDC = true, bool normalize = false);
+
+  /**
+   * @brief process() straight from the raw ADC samples
+   */
+  int process(const uint16_t* const* in, std::size_t numChannels, std::size_t numSamples,
+              float* const* out, bool removeDC = true, bool normalize = false);
+
+  /**
+   * @brief Returns the FFT size with the least transform work for a capture
+   *
+   * @param chirpLen the chirp length
+   * @param numSamples the capture length, 0 for the least work per output sample of an
+   * endless capture
+   */
+  static std::size_t bestFFTSize(std::size_t chirpLen, std::size_t numSamples = 0);
+
+private:
+  /**
+   * @brief One block size, its FFT plan and conj(FFT(chirp zero padded to the block))
+   */
+  struct Plan {
+    explicit Plan(std::size_t n) : fft(n) {}
+
+    RealFFT fft;
+    std::vector<cfloat_t> chirpSpectrum;
+  };
+
+  const Plan& plan(std::size_t fftSize);
+
+  template <typename T>
+  int processChannels(const T* const* in, std::size_t numChannels, std::size_t numSamples,
+                      float* const* out, bool removeDC, bool normalize);
+
+  template <typename T>
+  void processBlock(const Plan& p, const T* in, float mean, std::size_t numSamples,
+                    std::size_t start, float* out, std::size_t worker);
+
+  // the chirp, its mean already removed if asked to
+  std::vector<float> _chirp;
+  std::size_t _fixedFFTSize;
+  std::map<std::size_t, std::unique_ptr<Plan>> _plans;
+
+  // per worker block, spectrum, FFT scratch and block output, sized for the largest plan
+  std::vector<std::vector<float>> _block;
+  std::vector<std::vector<cfloat_t>> _spectrum;
+  std::vector<std::vector<cfloat_t>> _scratch;
+  std::vector<std::vector<float>> _result;
+
+  WorkerPool _pool;
+};
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef REAL_FFT_HPP
+#define REAL_FFT_HPP
+
+/**
+ * @file
+ * @brief Planned FFT of real float data, for power of two sizes
+ *
+ * An n point real transform is done as an n/2 point complex radix-2 transform plus a
+ * split step. Twiddles and the bit reversal order are computed once when the plan is
+ * made, so a plan kept around for every ping costs nothing per call. A plan is read only
+ * after construction and can be shared between threads; each thread passes its own
+ * scratch buffer.
+ */
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+#include "stdint.h"
+
+typedef std::complex<float> cfloat_t;
+
+class RealFFT {
+
+public:
+  /**
+   * @brief Makes a plan
+   *
+   * @param n the transform size, a power of two of at least 4
+   */
+  explicit RealFFT(std::size_t n);
+
+  std::size_t size() const { return _n; }
+
+  /**
+   * @brief Returns the number of output bins, n / 2 + 1
+   */
+  std::size_t numBins() const { return _n / 2 + 1; }
+
+  /**
+   * @brief Returns the scratch length, in complex values, forward() and inverse() need
+   */
+  std::size_t scratchLen() const { return _n / 2; }
+
+  /**
+   * @brief Forward transform, X[k] = sum x[j] e^(-2 pi i jk / n) for k = 0 .. n/2
+   *
+   * @param in n real samples
+   * @param out n / 2 + 1 bins
+   * @param scratch scratchLen() values, may not alias in or out
+   */
+  void forward(const float* in, cfloat_t* out, cfloat_t* scratch) const;
+
+  /**
+   * @brief Inverse of forward(), including the 1 / n scaling
+   *
+   * @param in n / 2 + 1 bins of a real signal's spectrum
+   * @param out n real samples
+   * @param scratch scratchLen() values, may not alias in or out
+   */
+  void inverse(const cfloat_t* in, float* out, cfloat_t* scratch) const;
+
+  /**
+   * @brief Returns true if n is a size a plan can be made for
+   */
+  static bool validSize(std::size_t n) { return n >= 4 && (n & (n - 1)) == 0; }
+
+private:
+  void complexForward(cfloat_t* z) const;
+
+  std::size_t _n;
+  std::vector<uint32_t> _bitrev;
+  // per stage twiddles of the n/2 point transform
+  std::vector<cfloat_t> _twiddle;
+  // _twiddle rearranged for the SSE2 butterflies
+  std::vector<float> _twiddleSSE;
+  // e^(-2 pi i k / n) for the split step
+  std::vector<cfloat_t> _split;
+};
+
+#endif
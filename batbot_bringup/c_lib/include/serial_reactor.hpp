@@ -0,0 +1,194 @@
+#ifndef SERIAL_REACTOR_HPP
+#define SERIAL_REACTOR_HPP
+
+/**
+ * @file
+ * @brief Event driven serial engine (Linux)
+ *
+ * The reactor owns every open serial port in non-blocking mode and services all of
+ * them from a single thread using epoll. Incoming bytes are accumulated per port and
+ * cut into frames by a per-port splitter, and each complete frame is handed to the
+ * port's callback directly out of the receive buffer (no intermediate copies).
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "stdint.h"
+
+/**
+ * @brief Maximum number of epoll events serviced per wakeup
+ */
+#define SERIAL_REACTOR_MAX_EVENTS 16
+
+/**
+ * @brief Initial size of each port's receive buffer. A full high speed USB
+ * CDC transfer fits several times over, so one read() per wakeup usually drains the tty.
+ */
+#define SERIAL_REACTOR_RX_BUF_LEN 65536
+
+class SerialReactor {
+
+public:
+  /**
+   * @brief Finds the end of the frame at the start of a buffer
+   *
+   * @param data pointer to the oldest unconsumed byte of the port
+   * @param len number of unconsumed bytes
+   * @return std::size_t the length of the complete frame at the start of data, or 0 if more bytes are needed
+   */
+  typedef std::function<std::size_t(const uint8_t* data, std::size_t len)> FrameSplitter;
+
+  /**
+   * @brief Receives a complete frame
+   *
+   * @param port the port id returned by openPort/addFd
+   * @param frame pointer to the frame, only valid for the duration of the call
+   * @param len the number of bytes in the frame
+   */
+  typedef std::function<void(int port, const uint8_t* frame, std::size_t len)> FrameCallback;
+
+  /**
+   * @brief Told that a port hung up, after the reactor has closed it
+   *
+   * @param port the port id, free to be reused by the next openPort/addFd
+   */
+  typedef std::function<void(int port)> DisconnectCallback;
+
+  /**
+   * @brief Construct a new serial reactor
+   */
+  SerialReactor();
+
+  /**
+   * @brief Closes every port owned by the reactor
+   */
+  ~SerialReactor();
+
+  /**
+   * @brief Opens a tty in raw, non-blocking mode and registers it with the reactor
+   *
+   * @param portName the linux device port
+   * @param speed the termios baudrate constant (e.g. B115200). Ignored by USB CDC devices.
+   * @param splitter the framing function for this port
+   * @param callback called once for every complete frame
+   * @return int the port id, or -1 on error
+   */
+  int openPort(std::string portName, int speed, FrameSplitter splitter, FrameCallback callback);
+
+  /**
+   * @brief Registers an already open file descriptor (e.g. one end of an openpty() pair)
+   *
+   * @param fd the file descriptor, switched to non-blocking mode. The reactor does not close it.
+   * @param splitter the framing function for this port
+   * @param callback called once for every complete frame
+   * @return int the port id, or -1 on error
+   */
+  int addFd(int fd, FrameSplitter splitter, FrameCallback callback);
+
+  /**
+   * @brief Unregisters a port, closing it if it was opened by the reactor
+   *
+   * @param port the port id
+   */
+  void closePort(int port);
+
+  /**
+   * @brief Sets what is called when a port goes away, e.g. a USB device being unplugged
+   *
+   * @param callback called from poll() once the port is closed
+   */
+  void setDisconnectCallback(DisconnectCallback callback) { _onDisconnect = callback; }
+
+  /**
+   * @brief Queues bytes for transmission on a port
+   *
+   * @param port the port id
+   * @param bytes the buffer to write
+   * @param numBytes the number of bytes in the buffer to write
+   * @return int 0 on success, -1 on error
+   *
+   * As much as possible is written immediately. Whatever the tty does not accept is
+   * buffered and flushed by the reactor when the port becomes writable again.
+   */
+  int writeBytes(int port, const uint8_t* bytes, std::size_t numBytes);
+
+  /**
+   * @brief Waits for and services port events once
+   *
+   * @param timeout_ms the maximum time to wait in ms, -1 waits forever
+   * @return int the number of events serviced, or -1 on error
+   */
+  int poll(int timeout_ms);
+
+  /**
+   * @brief Services port events until stop() is called
+   */
+  void run();
+
+  /**
+   * @brief Makes run() return. Safe to call from any thread or from a callback.
+   */
+  void stop();
+
+  /**
+   * @brief Splitter for streams made of equally sized frames
+   *
+   * @param frameLen the size of each frame in bytes
+   */
+  static FrameSplitter fixedLengthSplitter(std::size_t frameLen);
+
+  /**
+   * @brief Splitter that delivers every chunk of bytes as soon as it is read
+   */
+  static FrameSplitter passthroughSplitter();
+
+private:
+  /**
+   * @brief Per-port state
+   *
+   * rx holds unconsumed bytes in [rx_head, rx_tail), tx holds unsent bytes in [tx_head, tx.size()).
+   */
+  typedef struct {
+    int fd;
+    bool owns_fd;
+    bool want_write;
+    FrameSplitter splitter;
+    FrameCallback callback;
+    std::vector<uint8_t> rx;
+    std::size_t rx_head;
+    std::size_t rx_tail;
+    std::vector<uint8_t> tx;
+    std::size_t tx_head;
+  } Port;
+
+  int registerPort(int fd, bool owns_fd, FrameSplitter splitter, FrameCallback callback);
+
+  void handleReadable(int port);
+
+  void handleWritable(int port);
+
+  /**
+   * @brief Closes a port whose device went away and reports it
+   */
+  void hangUp(int port);
+
+  int flushTx(int port);
+
+  void updateInterest(int port);
+
+  int _epfd;
+
+  int _wakefd;
+
+  std::atomic<bool> _running;
+
+  std::vector<Port> _ports;
+
+  DisconnectCallback _onDisconnect;
+};
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef SONAR_FRAME_DECODER_HPP
+#define SONAR_FRAME_DECODER_HPP
+
+/**
+ * @file
+ * @brief Streaming decoder for the framed listener stream
+ *
+ * Works like the tendon frame decoder: it is fed whatever chunks the port hands back
+ * and cuts complete, CRC checked frames out of them. A frame that sits entirely inside
+ * a chunk is returned in place, only a frame split across chunks is assembled in the
+ * decoder's own buffer.
+ *
+ * Frames are variable length: plain frames are SONAR_FRAME_BYTES, packed ones shorter,
+ * as their header says.
+ *
+ * After a bad magic, length or CRC the decoder drops one byte and searches for the next
+ * magic, including inside the bytes it has already buffered, so corrupted bytes cost
+ * only the frame they hit. The sequence numbers of good frames are followed to count
+ * the frames that went missing in between, and frames whose ears were taken from
+ * different DMA blocks are rejected so the two ears never slip against each other.
+ * Frames are still returned when the listener did not flag both ears' sample counts as
+ * matching, they are only counted.
+ */
+
+#include <cstddef>
+
+#include "stdint.h"
+
+#include "sonar_frame.hpp"
+
+/**
+ * @brief Counters over everything fed since the decoder was created or restarted
+ */
+typedef struct {
+  uint64_t frames;         // good frames returned
+  uint64_t missed_frames;  // frames skipped by the sequence numbers, including rejected ones
+  uint64_t bytes_dropped;  // bytes discarded while searching for a frame
+  uint64_t crc_errors;     // frames with a good magic and a bad CRC
+  uint64_t ear_mismatches; // good frames rejected because the ears came from different blocks
+  uint64_t unmatched_frames; // good frames not flagged SONAR_FRAME_FLAG_SAME_COUNT
+} SonarStreamStats;
+
+class SonarFrameDecoder {
+
+public:
+  SonarFrameDecoder();
+
+  /**
+   * @brief Starts a new stream: clears the counters and expects firstSeq next
+   */
+  void restart(uint32_t firstSeq = 0);
+
+  /**
+   * @brief Discards any partially received frame, keeps the counters and sequence
+   */
+  void reset();
+
+  /**
+   * @brief Feeds bytes to the decoder, stopping at the first complete frame
+   *
+   * @param data the received bytes
+   * @param len the number of received bytes
+   * @param frame set to the start of the complete frame, or NULL if there is none yet
+   * @return std::size_t the number of bytes of data consumed
+   *
+   * The frame is frameBytes() long, points either into data or into the decoder and
+   * stays valid until the next call. header() and gap() then describe it. Call again
+   * with the unconsumed remainder until everything is consumed.
+   */
+  std::size_t feed(const uint8_t* data, std::size_t len, const uint8_t** frame);
+
+  /**
+   * @brief Header of the frame just returned
+   */
+  const SonarFrameHeader& header() const { return _header; }
+
+  /**
+   * @brief Length of the frame just returned, header included
+   */
+  std::size_t frameBytes() const { return _frameLen; }
+
+  /**
+   * @brief Frames missing between the previous frame and the one just returned
+   */
+  uint32_t gap() const { return _gap; }
+
+  /**
+   * @brief Bytes of a partial frame held in the decoder
+   */
+  std::size_t buffered() const { return _bufLen; }
+
+  /**
+   * @brief True if the frame just returned points into the decoder rather than into data
+   */
+  bool frameBuffered() const { return _emitted; }
+
+  const SonarStreamStats& stats() const { return _stats; }
+
+private:
+  typedef enum {
+    FRAME_GOOD,
+    FRAME_BAD,   // not a frame, drop a byte and search again
+    FRAME_SKIP   // a real frame that cannot be used, drop all of it
+  } frame_check_t;
+
+  /**
+   * @brief Checks a complete candidate frame of len bytes, updating the counters and the sequence
+   */
+  frame_check_t check(const uint8_t* p, std::size_t len);
+
+  /**
+   * @brief Drops bytes from the front of the buffer up to the next possible magic
+   */
+  void resync();
+
+  uint8_t _buf[SONAR_FRAME_BYTES];
+  std::size_t _bufLen;
+  bool _emitted;
+
+  SonarFrameHeader _header;
+  std::size_t _frameLen;
+  bool _haveSeq;
+  uint32_t _nextSeq;
+  uint32_t _gap;
+
+  SonarStreamStats _stats;
+};
+
+#endif
@@ -0,0 +1,216 @@
+#ifndef SONAR_RUN_FILE_HPP
+#define SONAR_RUN_FILE_HPP
+
+/**
+ * @file
+ * @brief Append-only container for the pings of a sonar run
+ *
+ * One file holds a whole run instead of a pair of .npy files per ping:
+ *
+ *   [ file header ][ ping header | left | right | pad ] ... [ index ][ trailer ]
+ *
+ * Each ping record is its header followed by the left and then the right ear as little
+ * endian uint16, padded so the next record starts on a SONAR_RUN_ALIGN boundary. Every
+ * record carries its own header, so the index footer written on close is only a shortcut:
+ * a run cut short by a crash or a pulled cable is recovered by walking the records.
+ * Reopening a run to append drops the footer and writes a new one on close.
+ *
+ * The reader maps the file and hands out pointers into the mapping, so a ping range can
+ * be looked at without reading or copying it.
+ */
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "stdint.h"
+
+#define SONAR_RUN_MAGIC "BBSONRUN"
+#define SONAR_RUN_INDEX_MAGIC "BBRUNIDX"
+#define SONAR_RUN_PING_MAGIC 0x474E4950 // "PING"
+#define SONAR_RUN_VERSION 1
+
+/**
+ * @brief Record alignment, so the ears of every ping start cache line aligned
+ */
+#define SONAR_RUN_ALIGN 64
+
+/**
+ * @brief Most pinna angles a ping header holds, both pinnae
+ */
+#define SONAR_RUN_MAX_ANGLES 16
+
+typedef struct {
+  char magic[8];
+  uint32_t version;
+  uint32_t header_size;
+  uint32_t ping_header_size;
+  uint32_t align;
+  uint64_t created_ns;
+  uint8_t reserved[32];
+} SonarRunFileHeader;
+
+typedef struct {
+  uint32_t magic;
+  uint32_t header_size;
+  uint64_t index;
+  // wall clock, ns since the unix epoch
+  uint64_t timestamp_ns;
+  // header, both ears and padding
+  uint64_t record_size;
+  double sample_rate;
+  // CRC32 of the chirp that was played, as the emitter checks it after an upload
+  uint32_t chirp_id;
+  uint32_t samples_per_ear;
+  uint32_t num_angles;
+  uint32_t flags;
+  int16_t angles[SONAR_RUN_MAX_ANGLES];
+  uint8_t reserved[40];
+} SonarPingHeader;
+
+typedef struct {
+  uint64_t offset;
+  uint64_t timestamp_ns;
+  uint32_t chirp_id;
+  uint32_t samples_per_ear;
+} SonarRunIndexEntry;
+
+typedef struct {
+  uint64_t index_offset;
+  uint64_t num_pings;
+  uint64_t reserved;
+  char magic[8];
+} SonarRunTrailer;
+
+static_assert(sizeof(SonarRunFileHeader) == 64, "file header layout");
+static_assert(sizeof(SonarPingHeader) == 128, "ping header layout");
+static_assert(sizeof(SonarRunIndexEntry) == 24, "index entry layout");
+static_assert(sizeof(SonarRunTrailer) == 32, "trailer layout");
+
+/**
+ * @brief What the caller knows about a ping besides its samples
+ */
+typedef struct {
+  // 0 for now
+  uint64_t timestamp_ns;
+  double sample_rate;
+  uint32_t chirp_id;
+  uint32_t num_angles;
+  int16_t angles[SONAR_RUN_MAX_ANGLES];
+} SonarPingInfo;
+
+class SonarRunWriter {
+
+public:
+  /**
+   * @brief Opens a run for writing
+   *
+   * @param path the run file
+   * @param append keep the pings already in an existing file and add to them, otherwise
+   * the file is truncated
+   */
+  SonarRunWriter(std::string path, bool append = false);
+
+  /**
+   * @brief Writes the index footer and closes the file
+   */
+  ~SonarRunWriter();
+
+  bool isOpen() const { return _fd >= 0; }
+  std::size_t numPings() const { return _index.size(); }
+
+  /**
+   * @brief Appends one ping
+   *
+   * @param info the ping header fields
+   * @param left samplesPerEar left ear samples
+   * @param right samplesPerEar right ear samples
+   * @param samplesPerEar the samples per ear
+   * @return int 0 on success, -1 on a write error
+   */
+  int appendPing(const SonarPingInfo& info, const uint16_t* left, const uint16_t* right,
+                 std::size_t samplesPerEar);
+
+  /**
+   * @brief Flushes the pings written so far to the disk
+   */
+  int sync();
+
+  /**
+   * @brief Writes the index footer and closes the file
+   */
+  int close();
+
+private:
+  std::string _path;
+  int _fd;
+  uint64_t _end;
+  std::vector<SonarRunIndexEntry> _index;
+};
+
+class SonarRunReader {
+
+public:
+  /**
+   * @brief Maps a run read only
+   *
+   * @param path the run file
+   */
+  SonarRunReader(std::string path);
+
+  /**
+   * @brief Unmaps the file
+   */
+  ~SonarRunReader();
+
+  SonarRunReader(const SonarRunReader&) = delete;
+  SonarRunReader& operator=(const SonarRunReader&) = delete;
+
+  bool isOpen() const { return _base != NULL; }
+  std::size_t numPings() const { return _index.size(); }
+
+  /**
+   * @brief Returns true if the index footer was there, false if the records were walked
+   * because the writer never closed the run
+   */
+  bool indexed() const { return _indexed; }
+
+  const SonarPingHeader* header(std::size_t ping) const;
+  const uint16_t* left(std::size_t ping) const;
+  const uint16_t* right(std::size_t ping) const;
+
+  /**
+   * @brief Returns the bytes from one ping record to the next if every ping in
+   * [first, last) has the same record size, so the range can be seen as one strided
+   * array, 0 otherwise
+   */
+  std::size_t uniformStride(std::size_t first, std::size_t last) const;
+
+private:
+  const uint8_t* _base;
+  std::size_t _size;
+  bool _indexed;
+  std::vector<SonarRunIndexEntry> _index;
+};
+
+/**
+ * @brief Reads the index of a mapped or loaded run
+ *
+ * Uses the footer if there is a valid one, otherwise walks the records and stops at the
+ * first incomplete one.
+ *
+ * @param data the file contents
+ * @param size the file size
+ * @param index set to the pings found
+ * @param end set to the end of the last complete record, where an append continues
+ * @return int 1 if the footer was used, 0 if the records were walked, -1 if this is not a run file
+ */
+int sonarRunReadIndex(const uint8_t* data, std::size_t size, std::vector<SonarRunIndexEntry>* index,
+                      uint64_t* end);
+
+/**
+ * @brief Returns the size of a ping record, header, both ears and padding
+ */
+uint64_t sonarRunRecordSize(std::size_t samplesPerEar);
+
+#endif
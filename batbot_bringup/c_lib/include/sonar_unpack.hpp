@@ -0,0 +1,58 @@
+#ifndef SONAR_UNPACK_HPP
+#define SONAR_UNPACK_HPP
+
+/**
+ * @file
+ * @brief Expands packed listener frames back into 16 bit ears
+ *
+ * The formats are defined, and the reference decoders live, next to the firmware's
+ * encoders in sonar_pack.hpp. The kernels here produce exactly the same samples:
+ *
+ * PACK10 takes 8 samples per byte shuffle, each 16 bit lane gathering the two bytes its
+ * sample straddles, then a per lane multiply and shift lines the 10 bits up.
+ *
+ * DELTA gathers the 8 values of a group into 32 bit lanes with a shuffle picked by the
+ * group's width, shifts and masks them per lane, undoes the zigzag and adds the 8
+ * deltas up with a log-step prefix sum.
+ *
+ * AVX2 and NEON versions are built alongside the scalar reference and picked the same
+ * way as the lr_deinterleave kernels. Both need a byte shuffle SSE2 does not have, so
+ * LR_ISA_SSE2 runs the scalar code.
+ */
+
+#include <cstddef>
+
+#include "stdint.h"
+
+#include "lr_deinterleave.hpp"
+#include "sonar_frame.hpp"
+
+/**
+ * @brief Unpacks one ear
+ *
+ * @param flags SONAR_FRAME_FLAG_PACK10 or SONAR_FRAME_FLAG_DELTA, 0 for plain samples
+ * @param in the packed ear
+ * @param len bytes available at in
+ * @param out n samples
+ * @param n the number of samples, a multiple of 8
+ * @param isa the implementation to use, LR_ISA_AUTO picks the best one available
+ * @return int the number of bytes read, -1 if in is not a valid packing of n samples or
+ * the implementation is not available
+ */
+int sonarUnpackEar(uint16_t flags, const uint8_t* in, std::size_t len, uint16_t* out, std::size_t n,
+                   lr_isa_t isa = LR_ISA_AUTO);
+
+/**
+ * @brief Unpacks both ears of a frame
+ *
+ * @param header the frame header
+ * @param payload the sonarFramePayloadBytes(header) bytes after the header
+ * @param first header->count samples of ADC 0
+ * @param second header->count samples of ADC 1
+ * @param isa the implementation to use, LR_ISA_AUTO picks the best one available
+ * @return int 0 on success, -1 if the payload does not unpack to exactly two ears
+ */
+int sonarUnpackFrame(const SonarFrameHeader* header, const uint8_t* payload, uint16_t* first, uint16_t* second,
+                     lr_isa_t isa = LR_ISA_AUTO);
+
+#endif
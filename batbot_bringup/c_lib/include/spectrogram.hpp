@@ -0,0 +1,137 @@
+#ifndef SPECTROGRAM_HPP
+#define SPECTROGRAM_HPP
+
+/**
+ * @file
+ * @brief Spectrogram of both ears, matching the mlab.specgram calls in the plotting code
+ *
+ * Frames are windowed, transformed and scaled to a one sided PSD the way mlab.specgram
+ * does with its defaults (no detrend, scale_by_freq), then converted to dB and cropped to
+ * the band of interest. The FFT plan and the window are made once per engine, and the
+ * frames of both ears are shared out over a persistent pool of worker threads.
+ */
+
+#include <cstddef>
+#include <vector>
+
+#include "real_fft.hpp"
+#include "stdint.h"
+#include "worker_pool.hpp"
+
+/**
+ * @brief Frames handed to a worker at a time
+ */
+#define SPECTROGRAM_FRAMES_PER_TASK 8
+
+/**
+ * @brief Floor applied to the PSD before taking the log, so silent frames give a finite dB
+ */
+#define SPECTROGRAM_MIN_POWER 1e-30f
+
+class Spectrogram {
+
+public:
+  /**
+   * @brief Makes the plan, the window and the worker pool
+   *
+   * @param fs the sample rate in Hz
+   * @param nfft the frame length, a power of two
+   * @param noverlap samples shared by consecutive frames, below nfft
+   * @param fmin the lowest frequency kept in the output, in Hz
+   * @param fmax the highest frequency kept in the output, in Hz
+   * @param numThreads worker threads including the caller, 0 for one per core
+   */
+  Spectrogram(double fs, std::size_t nfft, std::size_t noverlap, double fmin, double fmax,
+              std::size_t numThreads = 0);
+
+  /**
+   * @brief Replaces the default window, a symmetric Hann window like
+   * scipy.signal.windows.hann(nfft)
+   *
+   * @param window nfft values
+   */
+  void setWindow(const float* window);
+
+  std::size_t nfft() const { return _nfft; }
+  std::size_t step() const { return _nfft - _noverlap; }
+  std::size_t numThreads() const { return _pool.size(); }
+
+  /**
+   * @brief Returns the number of frames in numSamples samples, 0 if there is not even one
+   */
+  std::size_t numFrames(std::size_t numSamples) const;
+
+  /**
+   * @brief Returns the number of frequency rows in the cropped output
+   */
+  std::size_t numBins() const { return _lastBin - _firstBin; }
+
+  /**
+   * @brief Returns the frequency of output row i, in Hz
+   */
+  double binFrequency(std::size_t i) const { return (_firstBin + i) * _fs / _nfft; }
+
+  /**
+   * @brief Returns the time of output column i, the centre of the frame, in seconds
+   * from the first analysed sample
+   */
+  double frameTime(std::size_t i) const { return (_nfft / 2 + i * step()) / _fs; }
+
+  /**
+   * @brief Computes the cropped spectrogram of both ears
+   *
+   * Each output is numBins() rows by numFrames(numSamples - timeOffset) columns, row
+   * major, frequency by time like mlab.specgram, in 20 log10 of the PSD as plot_spec()
+   * has always shown it.
+   *
+   * @param left numSamples samples of the left ear
+   * @param right numSamples samples of the right ear, or NULL to only do the left ear
+   * @param numSamples the samples per ear
+   * @param leftDB the left ear output
+   * @param rightDB the right ear output, unused if right is NULL
+   * @param removeDC subtract each ear's mean, taken over all numSamples, first
+   * @param timeOffset samples skipped at the start of each ear after the mean is taken
+   * @param dBRange if above 0, each ear is shifted so its peak is 0 dB and clipped at -dBRange
+   * @return int 0 on success, -1 if there is not a single frame after timeOffset
+   */
+  int compute(const float* left, const float* right, std::size_t numSamples,
+              float* leftDB, float* rightDB, bool removeDC = true,
+              std::size_t timeOffset = 0, float dBRange = 0);
+
+  /**
+   * @brief compute() straight from the raw ADC samples
+   */
+  int compute(const uint16_t* left, const uint16_t* right, std::size_t numSamples,
+              float* leftDB, float* rightDB, bool removeDC = true,
+              std::size_t timeOffset = 0, float dBRange = 0);
+
+private:
+  template <typename T>
+  int computeEars(const T* left, const T* right, std::size_t numSamples,
+                  float* leftDB, float* rightDB, bool removeDC,
+                  std::size_t timeOffset, float dBRange);
+
+  template <typename T>
+  void computeFrame(const T* in, float mean, std::size_t frame, std::size_t numFrames,
+                    float* out, std::size_t worker);
+
+  double _fs;
+  std::size_t _nfft;
+  std::size_t _noverlap;
+  std::size_t _firstBin;
+  std::size_t _lastBin;
+
+  RealFFT _fft;
+  std::vector<float> _window;
+  // the PSD scaling of each output row, one sided doubling included
+  std::vector<float> _binScale;
+
+  // per worker frame, spectrum and FFT scratch
+  std::vector<std::vector<float>> _frame;
+  std::vector<std::vector<cfloat_t>> _spectrum;
+  std::vector<std::vector<cfloat_t>> _scratch;
+
+  WorkerPool _pool;
+};
+
+#endif
@@ -0,0 +1,119 @@
+#ifndef SPSC_RING_BUFFER_HPP
+#define SPSC_RING_BUFFER_HPP
+
+/**
+ * @file
+ * @brief Lock-free single producer, single consumer byte ring
+ *
+ * One thread writes and one thread reads, with no locks between them. Both sides work on
+ * contiguous regions of the ring directly, so the producer can read() from a device
+ * straight into the ring and the consumer can parse straight out of it.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include "stdint.h"
+
+class SpscRingBuffer {
+
+public:
+  /**
+   * @brief Construct a new ring
+   *
+   * @param capacity the size in bytes, rounded up to a power of two
+   */
+  explicit SpscRingBuffer(std::size_t capacity)
+  {
+    std::size_t size = 1;
+    while (size < capacity)
+      size <<= 1;
+
+    _buf.assign(size, 0);
+    _mask = size - 1;
+    _head = 0;
+    _tail = 0;
+  }
+
+  std::size_t capacity() const { return _buf.size(); }
+
+  /**
+   * @brief Producer: returns the contiguous free space at the write position
+   *
+   * @param ptr set to the start of the free space
+   * @return std::size_t the number of bytes that may be written at ptr
+   */
+  std::size_t writableRegion(uint8_t** ptr)
+  {
+    std::size_t head = _head.load(std::memory_order_relaxed);
+    std::size_t tail = _tail.load(std::memory_order_acquire);
+    std::size_t free_bytes = _buf.size() - (head - tail);
+    std::size_t to_end = _buf.size() - (head & _mask);
+
+    *ptr = &_buf[head & _mask];
+    return free_bytes < to_end ? free_bytes : to_end;
+  }
+
+  /**
+   * @brief Producer: publishes n bytes written into the writable region
+   */
+  void commitWrite(std::size_t n)
+  {
+    _head.store(_head.load(std::memory_order_relaxed) + n, std::memory_order_release);
+  }
+
+  /**
+   * @brief Consumer: returns the number of bytes ready to read
+   */
+  std::size_t readable() const
+  {
+    return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Consumer: returns the contiguous readable bytes at the read position
+   *
+   * @param ptr set to the oldest unread byte
+   * @return std::size_t the number of bytes that may be read at ptr. If this is less than
+   * readable() the rest starts at the beginning of the ring.
+   */
+  std::size_t readableRegion(const uint8_t** ptr) const
+  {
+    std::size_t tail = _tail.load(std::memory_order_relaxed);
+    std::size_t avail = _head.load(std::memory_order_acquire) - tail;
+    std::size_t to_end = _buf.size() - (tail & _mask);
+
+    *ptr = &_buf[tail & _mask];
+    return avail < to_end ? avail : to_end;
+  }
+
+  /**
+   * @brief Consumer: releases n bytes back to the producer
+   */
+  void commitRead(std::size_t n)
+  {
+    _tail.store(_tail.load(std::memory_order_relaxed) + n, std::memory_order_release);
+  }
+
+  /**
+   * @brief Consumer: throws away everything written so far
+   */
+  void discard()
+  {
+    _tail.store(_head.load(std::memory_order_acquire), std::memory_order_release);
+  }
+
+private:
+  std::vector<uint8_t> _buf;
+
+  std::size_t _mask;
+
+  // written by the producer only, on its own cache line
+  alignas(64) std::atomic<std::size_t> _head;
+
+  // written by the consumer only
+  alignas(64) std::atomic<std::size_t> _tail;
+};
+
+#endif
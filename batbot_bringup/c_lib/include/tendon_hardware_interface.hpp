@@ -8,8 +8,13 @@
  * 
  */
 
+#include <chrono>
+#include <cstddef>
+#include <functional>
+
 #include "serial_object.hpp"
 #include "stdint.h"
+#include "tendon_frame_decoder.hpp"
 
 /**
  * @brief Maximum packet size acceptable for this application
@@ -41,15 +46,51 @@
  */
 #define TENDON_CONTROL_PKT_NUM_CRC_BYTES 2
 
+/**
+ * @brief Number of bytes used for the sequence number
+ */
+#define TENDON_CONTROL_PKT_NUM_SEQ_BYTES 1
+
+/**
+ * @brief Number of bytes counted by the length field on top of the params
+ */
+#define TENDON_CONTROL_PKT_LEN_OVERHEAD  (TENDON_CONTROL_PKT_NUM_SEQ_BYTES + \
+                                          TENDON_CONTROL_PKT_NUM_ID_BYTES + \
+                                          TENDON_CONTROL_PKT_NUM_OPCODE_BYTES + \
+                                          TENDON_CONTROL_PKT_NUM_CRC_BYTES)
+
+/**
+ * @brief Number of params in a packet with the given length field
+ */
+#define TENDON_CONTROL_PKT_NUM_PARAMS(len) ((len) - TENDON_CONTROL_PKT_LEN_OVERHEAD)
+
 /**
  * @brief Maximum number of bytes in the parameters array
  */
 #define TENDON_CONTROL_PKT_MAX_NUM_PARAM_BYTES    TENDON_CONTROL_PKT_MAX_NUM_BYTES_IN_FRAME - \
                                                     TENDON_CONTROL_PKT_NUM_HEADER_BYTES - \
+                                                    TENDON_CONTROL_PKT_NUM_SEQ_BYTES - \
                                                     TENDON_CONTROL_PKT_NUM_OPCODE_BYTES - \
                                                     TENDON_CONTROL_PKT_NUM_ID_BYTES - \
                                                     TENDON_CONTROL_PKT_NUM_LEN_BYTES
 
+/**
+ * @brief Largest number of requests that may be in flight at once. Must stay well below
+ * the 256 sequence numbers so a late response can never be matched to a newer request.
+ */
+#define TENDON_CONTROL_MAX_WINDOW 64
+
+/**
+ * @brief How long a request may stay in flight after it is sent before Poll() fails it,
+ * whatever else the controller sends meanwhile
+ */
+#define TENDON_CONTROL_REQUEST_TIMEOUT_MS 500
+
+/**
+ * @brief Maximum number of bytes read from the port per Poll()
+ */
+#define TENDON_CONTROL_RX_CHUNK_LEN 256
+
 #define TENDON_CONTROL_MAKE_16B_WORD(a, b) ((uint16_t)a << 8) | ((uint16_t)b)
 #define TENDON_CONTROL_GET_UPPER_16B(a) (uint8_t)(((uint16_t)a >> 8) & 0xFF)
 #define TENDON_CONTROL_GET_LOWER_16B(a) (uint8_t)((uint16_t)a & 0xFF)
@@ -142,15 +183,157 @@ public:
         uint8_t pkt_params[TENDON_CONTROL_PKT_MAX_NUM_PARAM_BYTES];
     } TendonHardwareResponse;
 
-    void BuildPacket(uint8_t id, uint8_t opcode, uint8_t* params, std::size_t num_params);
+    /**
+     * @brief Called from Poll() for every response that matches an in-flight request
+     * 
+     * @param seq the sequence number of the request
+     * @param response the decoded response, only valid for the duration of the call
+     */
+    typedef std::function<void(uint8_t seq, const TendonHardwareResponse& response)> ResponseCallback;
 
-    void SendTxRx();
+    /**
+     * @brief Builds a packet into the preallocated tx buffer, including CRC
+     * 
+     * @param id the motor id
+     * @param opcode the opcode
+     * @param params the parameters. May point into TxParams(), in which case nothing is copied.
+     * @param num_params the number of parameters
+     * 
+     * Every packet is given the next sequence number, see TxSeq().
+     */
+    void BuildPacket(uint8_t id, uint8_t opcode, const uint8_t* params, std::size_t num_params);
+
+    /**
+     * @brief Sends the tx packet and waits for its response in the preallocated rx buffer
+     * 
+     * @return int the number of bytes received, or -1 on error
+     * 
+     * Any requests still in flight are flushed first, so this can be mixed with Submit().
+     */
+    int SendTxRx();
 
     void SendTx();
+
+    /**
+     * @brief Builds and sends a request without waiting for its response
+     * 
+     * @param id the motor id
+     * @param opcode the opcode
+     * @param params the parameters. May point into TxParams().
+     * @param num_params the number of parameters
+     * @return int the sequence number of the request, or -1 on error
+     * 
+     * If the window is full this first polls until a slot frees up, so at most
+     * GetWindowSize() requests are ever outstanding.
+     */
+    int Submit(uint8_t id, uint8_t opcode, const uint8_t* params, std::size_t num_params);
+
+    /**
+     * @brief Reads whatever the controller has sent and matches responses to requests
+     * 
+     * @return int the number of requests completed, 0 on timeout, -1 on error
+     * 
+     * Waits up to the port read timeout for the first byte. If nothing at all arrives
+     * every in-flight request is marked as failed and counted in Timeouts(). Requests
+     * sent more than TENDON_CONTROL_REQUEST_TIMEOUT_MS ago fail the same way even while
+     * bytes keep arriving, so a noisy line cannot hold a request forever.
+     */
+    int Poll();
+
+    /**
+     * @brief Polls until no request is in flight
+     * 
+     * @return int 0 if every request was answered, -1 if any timed out
+     */
+    int Flush();
+
+    /**
+     * @brief Fetches the response to a completed request
+     * 
+     * @param seq the sequence number returned by Submit()
+     * @param response filled with the response
+     * @return int 0 on success, -1 if the request is still in flight, failed or unknown
+     * 
+     * A response can only be fetched once.
+     */
+    int GetResponse(uint8_t seq, TendonHardwareResponse* response);
+
+    /**
+     * @brief Sets the maximum number of requests in flight, clamped to [1, TENDON_CONTROL_MAX_WINDOW]
+     */
+    void SetWindowSize(std::size_t window);
+
+    std::size_t GetWindowSize() const { return window_size; }
+
+    /**
+     * @brief Sets a callback run for every matched response, pass nullptr to remove it
+     */
+    void SetResponseCallback(ResponseCallback callback) { response_callback = callback; }
+
+    /**
+     * @brief Returns the number of requests sent but not yet answered
+     */
+    std::size_t InFlight() const { return in_flight; }
+
+    /**
+     * @brief Returns the number of requests that were never answered
+     */
+    std::size_t Timeouts() const { return timeouts; }
+
+    /**
+     * @brief Returns the sequence number of the packet in the tx buffer
+     */
+    uint8_t TxSeq() const { return tx.data_packet_u.data_packet_s.seq; }
+
+    /**
+     * @brief Returns the parameter section of the tx buffer, TENDON_CONTROL_PKT_MAX_NUM_PARAM_BYTES long
+     * 
+     * Callers can write parameters here directly and pass this pointer back to BuildPacket.
+     */
+    uint8_t* TxParams() { return tx.data_packet_u.data_packet_s.pkt_params; }
+
+    /**
+     * @brief Returns the rx buffer holding the response to the last SendTxRx(), TENDON_CONTROL_PKT_MAX_NUM_BYTES_IN_FRAME long
+     */
+    uint8_t* RxBuffer() { return rx.data_packet_u.data_packet; }
+
+    /**
+     * @brief Returns the number of valid bytes in the rx buffer
+     */
+    std::size_t RxLength() const { return rx_len; }
     
 private:
 
-    uint16_t CRC16(uint16_t crc_accum, uint8_t *data, uint16_t data_blk_size);
+    static uint16_t CRC16(uint16_t crc_accum, const uint8_t *data, uint16_t data_blk_size);
+
+    /**
+     * @brief Sends the tx packet and marks its sequence number as in flight
+     */
+    void SendPending();
+
+    /**
+     * @brief Completes the request matching a received frame
+     */
+    int HandleFrame(const uint8_t* frame, std::size_t len);
+
+    /**
+     * @brief Fails every in-flight request whose deadline is before now
+     */
+    void ExpireRequests(std::chrono::steady_clock::time_point now);
+
+    typedef enum {
+        REQUEST_FREE,
+        REQUEST_IN_FLIGHT,
+        REQUEST_DONE,
+        REQUEST_FAILED
+    } request_state_t;
+
+    typedef struct {
+        request_state_t state;
+        // when Poll() gives up on the request, set by SendPending()
+        std::chrono::steady_clock::time_point deadline;
+        TendonHardwareResponse response;
+    } PendingRequest;
 
     SerialObject* ser;
 
@@ -160,12 +343,14 @@ private:
      * This struct defines the data packets defined by the tendon control communication protocol
      * The structure of a packet is as follows:
      * 
-     * [ HEADER 1 ][ HEADER 2 ][ LENGTH ][ MOTOR ID ][ OPCODE ][ PARAMS ][ CRC HIGH ][ CRC LOW ]
+     * [ HEADER 1 ][ HEADER 2 ][ LENGTH ][ SEQ ][ MOTOR ID ][ OPCODE ][ PARAMS ][ CRC HIGH ][ CRC LOW ]
      * 
      * HEADER 1+2: Used as a packet delimiter to signifify the start of a new packet. Always the bytes 0xFF 0x00.
      * LENGTH: 8-bit integer used to specify the length of the packet. The header and length fields
      *          are not taken into account when calculating length, so the length is calculated as
-     *          4 + number of params (4 comes from opcode, params, and both CRC fields).
+     *          5 + number of params (5 comes from seq, motor id, opcode, and both CRC fields).
+     * SEQ: 8-bit sequence number chosen by the host. The response to a request echoes its
+     *         sequence number, so several requests can be outstanding at once.
      * MOTOR ID: The id of the motor to read/write. Motors are assumed to be 1 indexed, so 0x00
      *            is used to read/write all motors.
      * OPCODE: 8-bit integer used to command the tendon controller to perform a certain action
@@ -188,6 +373,7 @@ private:
             struct {
                 uint8_t header[TENDON_CONTROL_PKT_NUM_HEADER_BYTES];
                 uint8_t len;
+                uint8_t seq;
                 uint8_t motorId;
                 uint8_t opcode;
                 uint8_t pkt_params[TENDON_CONTROL_PKT_MAX_NUM_PARAM_BYTES];
@@ -197,6 +383,22 @@ private:
 
     TendonControl_data_packet_s rx;
     TendonControl_data_packet_s tx;
+
+    std::size_t rx_len;
+    // sequence number SendTxRx() waits on, only its response goes into rx. -1 if none
+    int rx_seq;
+
+    uint8_t tx_seq;
+
+    uint8_t rx_chunk[TENDON_CONTROL_RX_CHUNK_LEN];
+    TendonControl_frame_decoder_t decoder;
+
+    PendingRequest pending[256];
+    std::size_t in_flight;
+    std::size_t window_size;
+    std::size_t timeouts;
+
+    ResponseCallback response_callback;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,258 @@
+#ifndef VIRTUAL_LISTENER_HPP
+#define VIRTUAL_LISTENER_HPP
+
+/**
+ * @file
+ * @brief Emulates the Teensy listener on a pseudo terminal (Linux)
+ *
+ * Anything that talks to the listener, EchoRecorder, bb_listener or a benchmark, can be
+ * pointed at portName() instead of the real device. The emulator answers ACK_REQ,
+ * PACKING and BASEBAND, and between START_LISTEN and STOP_LISTEN streams frames exactly
+ * as the firmware does: sequence numbers, the trigger in frame 0, SAME_COUNT flags, CRCs,
+ * packing with the firmware's own encoders and baseband through the firmware's SonarDDC.
+ * CAPTURE records the window from the command on and sends it once the post-trigger
+ * part would have been converted, behind its SonarCaptureHeader.
+ *
+ * The ears hear a train of synthetic echoes, one ping every pingInterval after the
+ * trigger, over gaussian noise around mid scale. Frames can be left out or corrupted at
+ * random, and when pacing at the real rate the emulator overruns like the firmware's
+ * DMA ring if the host stops reading. Every lost frame is recorded, so a test can work
+ * out exactly what the host should have seen. Captures come from the firmware's own
+ * ring and are never lost.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "echo_recorder.hpp"
+#include "sonar_ddc.hpp"
+#include "stdint.h"
+
+/**
+ * @brief Mid scale of the emulated 10 bit ADCs
+ */
+#define VIRTUAL_LISTENER_MID_SCALE 512
+
+/**
+ * @brief Length of the table the noise is drawn from
+ */
+#define VIRTUAL_LISTENER_NOISE_LEN 65536
+
+/**
+ * @brief How long START_LISTEN waits for a trigger from a silent emitter, as
+ * CHIRP_TRIGGER_TIMEOUT_MS in the firmware
+ */
+#define VIRTUAL_LISTENER_TRIGGER_TIMEOUT_MS 200
+
+/**
+ * @brief Raw blocks per baseband frame, as IQ_BLOCKS_PER_FRAME in the firmware
+ */
+#define VIRTUAL_LISTENER_IQ_BLOCKS (SONAR_DDC_DECIMATION / 2)
+
+/**
+ * @brief One echo of every ping, a Hann windowed linear sweep
+ */
+typedef struct {
+  // from the trigger to the start of the echo at ADC 0
+  double delay;
+  // how much later the echo reaches ADC 1, negative if earlier
+  double earDelay;
+  // peak amplitude in ADC counts
+  double amplitude;
+  double f0;
+  double f1;
+  double duration;
+} VirtualEcho;
+
+typedef struct {
+  // samples per second per ear the stream is made of, the listener's 2 MS/s by default
+  double sampleRate;
+  // 1 paces frames at the real rate, 2 twice as fast, 0 as fast as the host reads
+  double rateScale;
+  double pingInterval;
+  // where in frame 0 the trigger falls
+  uint32_t triggerOffset;
+  // rms of the noise in ADC counts
+  double noise;
+  std::vector<VirtualEcho> echoes;
+  // fractions of frames left out and corrupted
+  double dropRate;
+  double corruptRate;
+  // frames the firmware can fall behind by before its ring overruns
+  uint32_t ringFrames;
+  // frames the firmware's capture ring holds, CAPTURE_EXT_FRAMES with PSRAM
+  uint32_t captureFrames;
+  uint32_t seed;
+} VirtualListenerConfig;
+
+/**
+ * @brief The real listener's timing, two echoes of a 3 ms 80 to 30 kHz sweep per 30 ms
+ * ping and a couple of counts of noise, nothing lost
+ */
+VirtualListenerConfig virtualListenerDefaults();
+
+typedef struct {
+  uint64_t frames_sent;
+  uint64_t frames_dropped;   // left out on purpose
+  uint64_t frames_corrupted; // sent with a flipped payload bit
+  uint64_t frames_overrun;   // lost because the host fell ringFrames behind
+  uint64_t bytes_sent;
+} VirtualListenerStats;
+
+class VirtualListener {
+
+public:
+  /**
+   * @brief Opens the pseudo terminal, puts its slave side in raw mode and starts the
+   * device thread
+   *
+   * @param config the stream to emulate
+   */
+  VirtualListener(const VirtualListenerConfig& config);
+
+  /**
+   * @brief Stops the device thread and closes the pseudo terminal
+   */
+  ~VirtualListener();
+
+  /**
+   * @brief Returns true if the pseudo terminal is open and the device is running
+   */
+  bool isOpen() const { return _master >= 0; }
+
+  /**
+   * @brief The slave device to open in place of the listener's port
+   */
+  const std::string& portName() const { return _portName; }
+
+  /**
+   * @brief While set, START_LISTEN and CAPTURE are answered with ERROR after the
+   * firmware's trigger timeout, as if the emitter never chirped
+   */
+  void setEmitterSilent(bool silent) { _emitterSilent = silent; }
+
+  /**
+   * @brief Returns the counters since the last START_LISTEN or CAPTURE
+   */
+  VirtualListenerStats stats() const;
+
+  /**
+   * @brief Returns the sequence numbers of frames lost since the last START_LISTEN,
+   * dropped or overrun, in order
+   */
+  std::vector<uint32_t> lostFrames() const;
+
+  /**
+   * @brief Returns the sequence numbers of frames corrupted since the last START_LISTEN,
+   * in order
+   */
+  std::vector<uint32_t> corruptedFrames() const;
+
+  /**
+   * @brief Returns the clean signal of one ear over a ping, index 0 at the trigger
+   *
+   * @param ear 0 for ADC 0, 1 for ADC 1
+   */
+  const std::vector<float>& ping(int ear) const { return _ping[ear]; }
+
+private:
+  void run();
+
+  /**
+   * @brief Reads and answers one command, returns false if the port failed
+   */
+  bool command();
+
+  /**
+   * @brief Clears the counters and lost frames for a new stream or capture
+   */
+  void resetStats();
+
+  /**
+   * @brief Fills both ears with block seq of the signal
+   */
+  void makeEars(uint32_t seq, uint16_t ears[2][SONAR_FRAME_SAMPLES]);
+
+  /**
+   * @brief Makes frame seq into _frame, returns its length
+   *
+   * @param packed false for a capture frame, which goes out raw whatever the packing
+   */
+  std::size_t makeFrame(uint32_t seq, double elapsed, bool packed);
+
+  /**
+   * @brief Makes baseband frame seq, raw blocks seq * VIRTUAL_LISTENER_IQ_BLOCKS on, into
+   * _frame, returns its length
+   */
+  std::size_t makeBasebandFrame(uint32_t seq, double elapsed);
+
+  /**
+   * @brief Sends the finished capture window, or ERROR if the emitter never chirped
+   */
+  bool sendCapture();
+
+  /**
+   * @brief Writes all of data unless the device is stopped, returns false if it was
+   */
+  bool writeAll(const uint8_t* data, std::size_t len);
+
+  /**
+   * @brief Reads exactly len bytes of a command argument within ECHO_RECORDER_TIMEOUT_MS
+   */
+  bool readArg(uint8_t* data, std::size_t len);
+
+  /**
+   * @brief Draws from the device's generator, uniform in [0, 1)
+   */
+  double uniform();
+
+  VirtualListenerConfig _config;
+  std::string _portName;
+  int _master;
+  int _slave;
+
+  std::vector<float> _ping[2];
+  std::vector<float> _noise;
+  uint64_t _rng;
+
+  bool _streaming;
+  uint32_t _seq;
+  std::chrono::steady_clock::time_point _start;
+  std::chrono::steady_clock::time_point _next;
+  // how long writes have been blocked by a host that stopped reading since the stream
+  // last caught up, only that time fills the firmware's ring
+  std::chrono::steady_clock::duration _stalled;
+  // sample index of the trigger from the start of the stream or capture
+  uint32_t _triggerSample;
+  listener_packing_t _packing;
+
+  bool _baseband;
+  // BASEBAND as of the last START_LISTEN
+  bool _streamBaseband;
+  bool _ddcReady;
+  SonarDDC _ddc[2];
+
+  // a capture is being recorded and goes out at _captureDue
+  bool _capturing;
+  bool _captureFailed;
+  uint32_t _capturePre;
+  uint32_t _capturePost;
+  std::chrono::steady_clock::time_point _captureDue;
+  std::vector<uint8_t> _frame;
+  std::atomic<bool> _emitterSilent;
+
+  mutable std::mutex _statsMutex;
+  VirtualListenerStats _stats;
+  std::vector<uint32_t> _lost;
+  std::vector<uint32_t> _corrupted;
+
+  std::atomic<bool> _running;
+  std::thread _thread;
+};
+
+#endif
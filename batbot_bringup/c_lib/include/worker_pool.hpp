@@ -0,0 +1,74 @@
+#ifndef WORKER_POOL_HPP
+#define WORKER_POOL_HPP
+
+/**
+ * @file
+ * @brief Small persistent thread pool for splitting a batch of independent tasks
+ *
+ * The threads are started once and sleep between batches, so a per ping batch does not
+ * pay for thread creation. The calling thread works on the batch too.
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "stdint.h"
+
+class WorkerPool {
+
+public:
+  /**
+   * @brief Task body, called with the task index and the index of the worker running it.
+   * Worker indices are below size(), so they can select per worker scratch buffers.
+   */
+  typedef std::function<void(std::size_t task, std::size_t worker)> task_fn_t;
+
+  /**
+   * @brief Starts the pool
+   *
+   * @param numWorkers workers including the calling thread, 0 for one per core
+   */
+  explicit WorkerPool(std::size_t numWorkers = 0);
+
+  /**
+   * @brief Stops and joins the threads
+   */
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  /**
+   * @brief Returns the number of workers, including the calling thread
+   */
+  std::size_t size() const { return _threads.size() + 1; }
+
+  /**
+   * @brief Runs fn for every task in [0, numTasks) and returns once all are done
+   */
+  void run(std::size_t numTasks, const task_fn_t& fn);
+
+private:
+  void threadLoop(std::size_t worker);
+  void work(std::size_t worker);
+
+  std::vector<std::thread> _threads;
+
+  std::mutex _lock;
+  std::condition_variable _start;
+  std::condition_variable _done;
+  uint64_t _generation;
+  std::size_t _busy;
+  bool _stop;
+
+  const task_fn_t* _fn;
+  std::size_t _numTasks;
+  std::atomic<std::size_t> _next;
+};
+
+#endif
@@ -0,0 +1,449 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <string.h>
+#include <iostream>
+
+#include "echo_recorder.hpp"
+#include "sonar_unpack.hpp"
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+EchoRecorder::EchoRecorder(std::string portName, bool leftChannelFirst)
+  : _ring(ECHO_RECORDER_RING_LEN)
+{
+  _portName = portName;
+  _leftFirst = leftChannelFirst;
+  _running = false;
+  _dropped = 0;
+  _received = 0;
+  _frame = NULL;
+  _framePos = 0;
+  _frameCommit = 0;
+  _fill = 0;
+  _fillValue = ECHO_RECORDER_GAP_FILL;
+  _samplePos = 0;
+  _trigger = -1;
+  _streamStarting = false;
+
+  _fd = open(_portName.c_str(), O_RDWR | O_NOCTTY | O_CLOEXEC);
+  if (_fd < 0) {
+    std::cout << "Error opening " << portName << ": " << strerror(errno) << "\n";
+    return;
+  }
+
+  struct termios tty;
+  if (tcgetattr(_fd, &tty) < 0) {
+    std::cout << "Error" << errno << " from tcgettatr\n";
+    close(_fd);
+    _fd = -1;
+    return;
+  }
+
+  // raw 8N1, the reader thread waits with poll() so reads never wait on VMIN/VTIME
+  cfmakeraw(&tty);
+  tty.c_cflag |= (CLOCAL | CREAD);
+  tty.c_cflag &= ~CRTSCTS;
+  tty.c_cc[VMIN] = 0;
+  tty.c_cc[VTIME] = 0;
+
+  if (tcsetattr(_fd, TCSANOW, &tty) != 0) {
+    std::cout << "Error " << errno << " from tcsetattr\n";
+    close(_fd);
+    _fd = -1;
+    return;
+  }
+  tcflush(_fd, TCIOFLUSH);
+
+  _running = true;
+  _reader = std::thread(&EchoRecorder::readerLoop, this);
+
+  std::cout << "Successfully opened " << portName << "\n";
+}
+
+EchoRecorder::~EchoRecorder()
+{
+  _running = false;
+  if (_reader.joinable())
+    _reader.join();
+
+  if (_fd >= 0) {
+    close(_fd);
+    std::cout << "Closed port " << _portName << "\n";
+  }
+}
+
+void EchoRecorder::readerLoop()
+{
+  uint8_t scratch[4096];
+
+  while (_running) {
+    struct pollfd pfd = {_fd, POLLIN, 0};
+    int ret = poll(&pfd, 1, 50);
+    if (ret < 0) {
+      if (errno == EINTR)
+        continue;
+      std::cout << "Error " << errno << " from poll\n";
+      break;
+    }
+    if (ret == 0)
+      continue;
+
+    if (pfd.revents & (POLLERR | POLLHUP | POLLNVAL)) {
+      std::cout << "Listener port " << _portName << " hung up\n";
+      break;
+    }
+
+    // read straight into the ring, the region may be short right before the wrap
+    uint8_t* region;
+    std::size_t room = _ring.writableRegion(&region);
+    if (room > ECHO_RECORDER_READ_CHUNK_LEN)
+      room = ECHO_RECORDER_READ_CHUNK_LEN;
+
+    ssize_t n;
+    if (room > 0) {
+      n = read(_fd, region, room);
+    } else {
+      // the caller has fallen a whole ring (1 s of stream) behind, keep the tty drained
+      // and count the loss
+      n = read(_fd, scratch, sizeof scratch);
+      if (n > 0)
+        _dropped += n;
+    }
+
+    if (n < 0) {
+      if (errno == EINTR || errno == EAGAIN)
+        continue;
+      std::cout << "Error reading " << _portName << ": " << strerror(errno) << "\n";
+      break;
+    }
+
+    if (room > 0)
+      _ring.commitWrite(n);
+    _received += n;
+  }
+
+  _running = false;
+}
+
+int EchoRecorder::writeCmd(uint8_t cmd)
+{
+  return writeBytes(&cmd, 1);
+}
+
+int EchoRecorder::writeBytes(const uint8_t* data, std::size_t len)
+{
+  if (_fd < 0)
+    return -1;
+
+  if (write(_fd, data, len) != (ssize_t)len) {
+    std::cout << "Error writing " << _portName << ": " << strerror(errno) << "\n";
+    return -1;
+  }
+  return 0;
+}
+
+int EchoRecorder::readBytes(void* dst, std::size_t n, int timeout_ms)
+{
+  if (waitReadable(n, timeout_ms) < 0)
+    return -1;
+
+  uint8_t* out = (uint8_t*)dst;
+  while (n > 0) {
+    const uint8_t* p;
+    std::size_t avail = std::min(_ring.readableRegion(&p), n);
+    memcpy(out, p, avail);
+    _ring.commitRead(avail);
+    out += avail;
+    n -= avail;
+  }
+  return 0;
+}
+
+int EchoRecorder::waitReadable(std::size_t n, int timeout_ms)
+{
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+  std::size_t last = _ring.readable();
+
+  while (_ring.readable() < n) {
+    if (!_running)
+      return -1;
+
+    // only give up once the stream has gone quiet, not on a long capture
+    std::size_t now_readable = _ring.readable();
+    if (now_readable != last) {
+      last = now_readable;
+      deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    } else if (std::chrono::steady_clock::now() > deadline) {
+      return -1;
+    }
+
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+  return 0;
+}
+
+void EchoRecorder::discard()
+{
+  _ring.discard();
+  _decoder.reset();
+  _frame = NULL;
+  _fill = 0;
+}
+
+int EchoRecorder::ackRequest()
+{
+  discard();
+  if (writeCmd(LISTENER_CMD_ACK_REQ) < 0)
+    return -1;
+
+  if (waitReadable(1, ECHO_RECORDER_TIMEOUT_MS) < 0)
+    return -1;
+
+  const uint8_t* p;
+  _ring.readableRegion(&p);
+  bool ack = p[0] == LISTENER_CMD_ACK;
+  discard();
+
+  return ack ? 0 : -1;
+}
+
+int EchoRecorder::setBaseband(bool on)
+{
+  discard();
+  uint8_t cmd[2] = {LISTENER_CMD_BASEBAND, (uint8_t)on};
+  if (writeBytes(cmd, sizeof(cmd)) < 0)
+    return -1;
+
+  if (waitReadable(1, ECHO_RECORDER_TIMEOUT_MS) < 0)
+    return -1;
+
+  const uint8_t* p;
+  _ring.readableRegion(&p);
+  bool ack = p[0] == LISTENER_CMD_ACK;
+  discard();
+
+  return ack ? 0 : -1;
+}
+
+int EchoRecorder::setPacking(listener_packing_t packing)
+{
+  discard();
+  uint8_t cmd[2] = {LISTENER_CMD_PACKING, (uint8_t)packing};
+  if (writeBytes(cmd, sizeof(cmd)) < 0)
+    return -1;
+
+  if (waitReadable(1, ECHO_RECORDER_TIMEOUT_MS) < 0)
+    return -1;
+
+  const uint8_t* p;
+  _ring.readableRegion(&p);
+  bool ack = p[0] == LISTENER_CMD_ACK;
+  discard();
+
+  return ack ? 0 : -1;
+}
+
+int EchoRecorder::startStream()
+{
+  discard();
+  _decoder.restart();
+  _samplePos = 0;
+  _trigger = -1;
+  _streamStarting = true;
+  return writeCmd(LISTENER_CMD_START_LISTEN);
+}
+
+int EchoRecorder::stopStream()
+{
+  if (writeCmd(LISTENER_CMD_STOP_LISTEN) < 0)
+    return -1;
+
+  // the Teensy finishes the block it is sending, wait for the line to go quiet
+  std::size_t last = _received.load();
+  do {
+    last = _received.load();
+    std::this_thread::sleep_for(std::chrono::milliseconds(ECHO_RECORDER_QUIET_MS));
+  } while (_running && _received.load() != last);
+
+  discard();
+  return 0;
+}
+
+int EchoRecorder::nextFrame()
+{
+  // the listener answers START_LISTEN with ERROR instead of frames if the emitter never
+  // sent the trigger
+  if (_streamStarting) {
+    if (waitReadable(1, ECHO_RECORDER_TIMEOUT_MS) < 0)
+      return -1;
+    const uint8_t* p;
+    _ring.readableRegion(&p);
+    if (p[0] == LISTENER_CMD_ERROR) {
+      std::cout << "Listener got no chirp trigger from the emitter\n";
+      discard();
+      return -1;
+    }
+    _streamStarting = false;
+  }
+
+  while (true) {
+    if (waitReadable(SONAR_FRAME_BYTES - _decoder.buffered(), ECHO_RECORDER_TIMEOUT_MS) < 0)
+      return -1;
+
+    const uint8_t* p;
+    std::size_t avail = _ring.readableRegion(&p);
+    const uint8_t* frame;
+    std::size_t used = _decoder.feed(p, avail, &frame);
+
+    // a frame in the ring is only released once its samples have been copied out
+    if (frame == NULL || _decoder.frameBuffered()) {
+      _ring.commitRead(used);
+      _frameCommit = 0;
+    } else {
+      _frameCommit = used;
+    }
+
+    if (frame != NULL) {
+      const SonarFrameHeader& header = _decoder.header();
+      _frame = frame + SONAR_FRAME_HEADER_BYTES;
+      _framePos = 0;
+      _fill = (std::size_t)_decoder.gap() * SONAR_FRAME_SAMPLES;
+      _fillValue = (header.flags & SONAR_FRAME_FLAG_IQ) ? 0 : ECHO_RECORDER_GAP_FILL;
+
+      int trigger = sonarFrameTriggerOffset(&header);
+      if (trigger >= 0)
+        _trigger = _samplePos + (int64_t)_fill + trigger;
+
+      // packed frames are expanded right away, which frees their ring bytes
+      if (header.payload != 0) {
+        int ret = sonarUnpackFrame(&header, _frame, _unpacked, _unpacked + SONAR_FRAME_SAMPLES);
+        _ring.commitRead(_frameCommit);
+        _frameCommit = 0;
+        _frame = (const uint8_t*)_unpacked;
+
+        if (ret < 0) {
+          // passed its CRC but does not unpack, fill in for it to keep the time base
+          std::cout << "Listener sent a frame that does not unpack\n";
+          _fill += SONAR_FRAME_SAMPLES;
+          _frame = NULL;
+        }
+      }
+      return 0;
+    }
+  }
+}
+
+int EchoRecorder::readSamples(uint16_t* left, uint16_t* right, std::size_t samplesPerEar)
+{
+  uint16_t* first = _leftFirst ? left : right;
+  uint16_t* second = _leftFirst ? right : left;
+  std::size_t done = 0;
+
+  while (done < samplesPerEar) {
+    if (_fill > 0) {
+      std::size_t n = std::min(_fill, samplesPerEar - done);
+      std::fill(first + done, first + done + n, _fillValue);
+      std::fill(second + done, second + done + n, _fillValue);
+      done += n;
+      _fill -= n;
+      _samplePos += n;
+      continue;
+    }
+
+    if (_frame == NULL) {
+      if (nextFrame() < 0) {
+        std::cout << "Listener stream stalled after " << done << " of " << samplesPerEar << " samples\n";
+        return -1;
+      }
+      continue;
+    }
+
+    std::size_t n = std::min(SONAR_FRAME_SAMPLES - _framePos, samplesPerEar - done);
+
+    // the listener and every host this runs on are little endian, each ear is a plain copy
+    memcpy(first + done, _frame + 2 * _framePos, 2 * n);
+    memcpy(second + done, _frame + SONAR_FRAME_PAYLOAD_BYTES / 2 + 2 * _framePos, 2 * n);
+    done += n;
+    _framePos += n;
+    _samplePos += n;
+
+    if (_framePos == SONAR_FRAME_SAMPLES) {
+      _ring.commitRead(_frameCommit);
+      _frame = NULL;
+    }
+  }
+
+  return 0;
+}
+
+int EchoRecorder::capture(uint16_t* left, uint16_t* right, std::size_t preSamples, std::size_t postSamples)
+{
+  discard();
+
+  uint8_t cmd[9];
+  uint32_t window[2] = {(uint32_t)preSamples, (uint32_t)postSamples};
+  cmd[0] = LISTENER_CMD_CAPTURE;
+  memcpy(cmd + 1, window, sizeof(window));
+  if (writeBytes(cmd, sizeof(cmd)) < 0)
+    return -1;
+
+  // nothing arrives until the whole window is recorded, allow for that at 1 MS/s, twice
+  // what the listener takes at its 2 MS/s
+  int timeout_ms = ECHO_RECORDER_TIMEOUT_MS + (int)((preSamples + postSamples) / 1000);
+  if (waitReadable(1, timeout_ms) < 0) {
+    std::cout << "Listener did not deliver the capture\n";
+    return -1;
+  }
+
+  const uint8_t* p;
+  _ring.readableRegion(&p);
+  if (p[0] == LISTENER_CMD_ERROR) {
+    std::cout << "Listener refused a capture of " << preSamples << " + " << postSamples << " samples\n";
+    discard();
+    return -1;
+  }
+
+  SonarCaptureHeader header;
+  if (readBytes(&header, sizeof(header), ECHO_RECORDER_TIMEOUT_MS) < 0 ||
+      header.magic != SONAR_CAPTURE_MAGIC || header.crc != sonarCaptureCRC(&header) ||
+      header.pre_samples != window[0] || header.post_samples != window[1] ||
+      header.window_offset >= SONAR_FRAME_SAMPLES) {
+    std::cout << "Bad capture header from listener\n";
+    discard();
+    return -1;
+  }
+
+  _decoder.restart(header.first_seq);
+  _samplePos = -(int64_t)header.window_offset;
+  _trigger = -1;
+
+  // the window starts part way into the first frame
+  uint16_t skip[2][SONAR_FRAME_SAMPLES];
+  int ret = readSamples(skip[0], skip[1], header.window_offset);
+  if (ret == 0)
+    ret = readSamples(left, right, preSamples + postSamples);
+
+  discard();
+  return ret;
+}
+
+int EchoRecorder::listen(uint16_t* left, uint16_t* right, std::size_t samplesPerEar)
+{
+  if (startStream() < 0)
+    return -1;
+
+  int ret = readSamples(left, right, samplesPerEar);
+
+  if (stopStream() < 0)
+    return -1;
+  return ret;
+}
+
+#endif
@@ -0,0 +1,175 @@
+/**
+ * @file
+ * @brief Python bindings for EchoRecorder
+ *
+ * listen() records into a pair of numpy arrays owned by the recorder. They are allocated
+ * once and only reallocated when a longer recording is asked for, and the arrays handed
+ * back are views onto them, so back to back pings do not allocate. listen_into() and
+ * read_into() fill caller owned arrays instead. The GIL is released while recording.
+ */
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+
+#include "echo_recorder.hpp"
+
+namespace py = pybind11;
+
+/**
+ * @brief Contiguous uint16 array. Output arguments are taken with noconvert(), so a
+ * mismatched array raises instead of silently filling a temporary copy.
+ */
+typedef py::array_t<uint16_t, py::array::c_style> u16_array_t;
+
+/**
+ * @brief EchoRecorder plus the preallocated output arrays
+ */
+class PyEchoRecorder : public EchoRecorder {
+
+public:
+  PyEchoRecorder(std::string portName, bool leftChannelFirst, std::size_t samplesPerEar)
+    : EchoRecorder(portName, leftChannelFirst),
+      left((py::ssize_t)samplesPerEar), right((py::ssize_t)samplesPerEar)
+  {
+  }
+
+  /**
+   * @brief Grows the preallocated arrays to hold at least n samples
+   */
+  void reserve(std::size_t n)
+  {
+    if ((std::size_t)left.size() < n) {
+      left = u16_array_t((py::ssize_t)n);
+      right = u16_array_t((py::ssize_t)n);
+    }
+  }
+
+  u16_array_t left;
+  u16_array_t right;
+};
+
+static void check_pair(u16_array_t& left, u16_array_t& right)
+{
+  if (left.ndim() != 1 || right.ndim() != 1 || left.size() != right.size())
+    throw py::value_error("left and right must be 1D uint16 arrays of the same length");
+}
+
+PYBIND11_MODULE(echorecorder, m) {
+  py::class_<PyEchoRecorder>(m, "EchoRecorder")
+    .def(py::init<std::string, bool, std::size_t>(),
+      py::arg("port"), py::arg("left_channel_first") = true, py::arg("samples_per_ear") = 1000000,
+      "Open the listener port and start the reader thread. samples_per_ear sizes the preallocated output arrays.")
+    .def_property_readonly("is_open", &PyEchoRecorder::isOpen)
+    .def("connection_status",
+      [](PyEchoRecorder& self) {
+        py::gil_scoped_release release;
+        return self.ackRequest() == 0;
+      },
+      "Send ACK_REQ and return True if the listener answered")
+    .def("listen",
+      [](PyEchoRecorder& self, std::size_t samples_per_ear) -> py::object {
+        self.reserve(samples_per_ear);
+        uint16_t* l = self.left.mutable_data();
+        uint16_t* r = self.right.mutable_data();
+
+        int ret;
+        {
+          py::gil_scoped_release release;
+          ret = self.listen(l, r, samples_per_ear);
+        }
+        if (ret < 0)
+          return py::none();
+
+        // based on the arrays themselves, not the recorder: a later reserve() replaces
+        // them, and views handed out before must keep the memory they point into
+        return py::make_tuple(
+          u16_array_t({(py::ssize_t)samples_per_ear}, {sizeof(uint16_t)}, l, self.left),
+          u16_array_t({(py::ssize_t)samples_per_ear}, {sizeof(uint16_t)}, r, self.right));
+      },
+      py::arg("samples_per_ear"),
+      "Record one ping and return (left, right) views onto the preallocated arrays, or None on error. "
+      "The views are overwritten by the next recording, copy them to keep them.")
+    .def("listen_into",
+      [](PyEchoRecorder& self, u16_array_t left, u16_array_t right) {
+        check_pair(left, right);
+        uint16_t* l = left.mutable_data();
+        uint16_t* r = right.mutable_data();
+        std::size_t n = left.size();
+
+        py::gil_scoped_release release;
+        return self.listen(l, r, n) == 0;
+      },
+      py::arg("left").noconvert(), py::arg("right").noconvert(),
+      "Record one ping into caller owned uint16 arrays, filling them completely")
+    .def("capture",
+      [](PyEchoRecorder& self, std::size_t pre_samples, std::size_t post_samples) -> py::object {
+        u16_array_t left((py::ssize_t)(pre_samples + post_samples));
+        u16_array_t right((py::ssize_t)(pre_samples + post_samples));
+        uint16_t* l = left.mutable_data();
+        uint16_t* r = right.mutable_data();
+
+        int ret;
+        {
+          py::gil_scoped_release release;
+          ret = self.capture(l, r, pre_samples, post_samples);
+        }
+        if (ret < 0)
+          return py::none();
+        return py::make_tuple(left, right);
+      },
+      py::arg("pre_samples"), py::arg("post_samples"),
+      "Triggered capture: the listener records into its own ring and sends the window around the chirp "
+      "trigger once it is complete. Returns new (left, right) arrays with the trigger at index pre_samples, "
+      "or None if the listener refused the window or did not deliver it.")
+    .def("set_baseband",
+      [](PyEchoRecorder& self, bool on) {
+        py::gil_scoped_release release;
+        return self.setBaseband(on) == 0;
+      },
+      py::arg("on"),
+      "Switch the stream to complex baseband (True) or raw samples (False), returns True if the listener "
+      "acknowledged. In baseband every pair of values is one int16 I, Q sample, view the arrays as int16.")
+    .def("set_packing",
+      [](PyEchoRecorder& self, int mode) {
+        py::gil_scoped_release release;
+        return self.setPacking((listener_packing_t)mode) == 0;
+      },
+      py::arg("mode"),
+      "Pack raw frames on the link: 0 plain, 1 10 bit, 2 delta coded (10 bit where that is smaller). "
+      "Returns True if the listener acknowledged. Samples come back unpacked, cut to the ADCs' 10 bits.")
+    .def("start_stream", &PyEchoRecorder::startStream, py::call_guard<py::gil_scoped_release>(),
+      "Start continuous capture")
+    .def("read_into",
+      [](PyEchoRecorder& self, u16_array_t left, u16_array_t right) {
+        check_pair(left, right);
+        uint16_t* l = left.mutable_data();
+        uint16_t* r = right.mutable_data();
+        std::size_t n = left.size();
+
+        py::gil_scoped_release release;
+        return self.readSamples(l, r, n) == 0;
+      },
+      py::arg("left").noconvert(), py::arg("right").noconvert(),
+      "Take the next samples of a running capture into caller owned uint16 arrays")
+    .def("stop_stream", &PyEchoRecorder::stopStream, py::call_guard<py::gil_scoped_release>(),
+      "Stop continuous capture and drain the port")
+    .def_property_readonly("dropped_bytes", &PyEchoRecorder::droppedBytes)
+    .def_property_readonly("received_bytes", &PyEchoRecorder::receivedBytes)
+    .def_property_readonly("stream_stats",
+      [](PyEchoRecorder& self) {
+        const SonarStreamStats& s = self.streamStats();
+        py::dict d;
+        d["frames"] = s.frames;
+        d["missed_frames"] = s.missed_frames;
+        d["bytes_dropped"] = s.bytes_dropped;
+        d["crc_errors"] = s.crc_errors;
+        d["ear_mismatches"] = s.ear_mismatches;
+        d["unmatched_frames"] = s.unmatched_frames;
+        int64_t t = self.triggerSample();
+        d["trigger_sample"] = t < 0 ? py::object(py::none()) : py::object(py::int_(t));
+        return d;
+      },
+      "Frame counters of the last capture, and trigger_sample, the index of the chirp trigger or None "
+      "(counted in interleaved I, Q values for baseband). "
+      "Samples of missed frames read as the gap fill value.");
+}
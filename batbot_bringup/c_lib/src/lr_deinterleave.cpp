@@ -0,0 +1,330 @@
+#include "lr_deinterleave.hpp"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#define LR_HAVE_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define LR_HAVE_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if defined(LR_HAVE_X86) && (defined(__GNUC__) || defined(__clang__))
+#define LR_HAVE_AVX2 1
+#endif
+
+/**
+ * @brief Pairs summed in 32-bit lanes before flushing to 64 bits. 65536 * 0xFFFF still fits.
+ */
+#define LR_SUM_BLOCK_PAIRS 65536
+
+/*
+ * Scalar
+ */
+
+static void convertScalar(const uint16_t* in, std::size_t n, float* left, float* right,
+                          float ol, float gl, float orr, float gr)
+{
+  // same x * gain + bias form as the vector kernels, so the tails round the same way
+  float bl = -ol * gl;
+  float br = -orr * gr;
+  for (std::size_t i = 0; i < n; ++i) {
+    left[i] = (float)in[2 * i] * gl + bl;
+    right[i] = (float)in[2 * i + 1] * gr + br;
+  }
+}
+
+static void sumScalar(const uint16_t* in, std::size_t n, uint64_t* sl, uint64_t* sr)
+{
+  uint64_t l = 0, r = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    l += in[2 * i];
+    r += in[2 * i + 1];
+  }
+  *sl += l;
+  *sr += r;
+}
+
+/*
+ * SSE2: each 32-bit lane holds one pair, left in the low half and right in the high half
+ */
+
+#ifdef LR_HAVE_X86
+
+static void convertSSE2(const uint16_t* in, std::size_t n, float* left, float* right,
+                        float ol, float gl, float orr, float gr)
+{
+  const __m128i lo_mask = _mm_set1_epi32(0xFFFF);
+  // (x - offset) * gain as x * gain + bias
+  const __m128 vgl = _mm_set1_ps(gl), vbl = _mm_set1_ps(-ol * gl);
+  const __m128 vgr = _mm_set1_ps(gr), vbr = _mm_set1_ps(-orr * gr);
+
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m128i a = _mm_loadu_si128((const __m128i*)(in + 2 * i));
+    __m128i b = _mm_loadu_si128((const __m128i*)(in + 2 * i + 8));
+
+    __m128 la = _mm_cvtepi32_ps(_mm_and_si128(a, lo_mask));
+    __m128 lb = _mm_cvtepi32_ps(_mm_and_si128(b, lo_mask));
+    __m128 ra = _mm_cvtepi32_ps(_mm_srli_epi32(a, 16));
+    __m128 rb = _mm_cvtepi32_ps(_mm_srli_epi32(b, 16));
+
+    _mm_storeu_ps(left + i, _mm_add_ps(_mm_mul_ps(la, vgl), vbl));
+    _mm_storeu_ps(left + i + 4, _mm_add_ps(_mm_mul_ps(lb, vgl), vbl));
+    _mm_storeu_ps(right + i, _mm_add_ps(_mm_mul_ps(ra, vgr), vbr));
+    _mm_storeu_ps(right + i + 4, _mm_add_ps(_mm_mul_ps(rb, vgr), vbr));
+  }
+
+  convertScalar(in + 2 * i, n - i, left + i, right + i, ol, gl, orr, gr);
+}
+
+static void sumSSE2(const uint16_t* in, std::size_t n, uint64_t* sl, uint64_t* sr)
+{
+  const __m128i lo_mask = _mm_set1_epi32(0xFFFF);
+  std::size_t i = 0;
+
+  while (n - i >= 4) {
+    std::size_t block = n - i < LR_SUM_BLOCK_PAIRS ? n - i : LR_SUM_BLOCK_PAIRS;
+    std::size_t end = i + (block & ~(std::size_t)3);
+
+    __m128i accl = _mm_setzero_si128();
+    __m128i accr = _mm_setzero_si128();
+    for (; i < end; i += 4) {
+      __m128i v = _mm_loadu_si128((const __m128i*)(in + 2 * i));
+      accl = _mm_add_epi32(accl, _mm_and_si128(v, lo_mask));
+      accr = _mm_add_epi32(accr, _mm_srli_epi32(v, 16));
+    }
+
+    uint32_t l[4], r[4];
+    _mm_storeu_si128((__m128i*)l, accl);
+    _mm_storeu_si128((__m128i*)r, accr);
+    *sl += (uint64_t)l[0] + l[1] + l[2] + l[3];
+    *sr += (uint64_t)r[0] + r[1] + r[2] + r[3];
+  }
+
+  sumScalar(in + 2 * i, n - i, sl, sr);
+}
+
+#endif
+
+/*
+ * AVX2: same lane layout, eight pairs per register
+ */
+
+#ifdef LR_HAVE_AVX2
+
+__attribute__((target("avx2,fma")))
+static void convertAVX2(const uint16_t* in, std::size_t n, float* left, float* right,
+                        float ol, float gl, float orr, float gr)
+{
+  const __m256i lo_mask = _mm256_set1_epi32(0xFFFF);
+  const __m256 vgl = _mm256_set1_ps(gl), vbl = _mm256_set1_ps(-ol * gl);
+  const __m256 vgr = _mm256_set1_ps(gr), vbr = _mm256_set1_ps(-orr * gr);
+
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m256i a = _mm256_loadu_si256((const __m256i*)(in + 2 * i));
+    __m256i b = _mm256_loadu_si256((const __m256i*)(in + 2 * i + 16));
+
+    __m256 la = _mm256_cvtepi32_ps(_mm256_and_si256(a, lo_mask));
+    __m256 lb = _mm256_cvtepi32_ps(_mm256_and_si256(b, lo_mask));
+    __m256 ra = _mm256_cvtepi32_ps(_mm256_srli_epi32(a, 16));
+    __m256 rb = _mm256_cvtepi32_ps(_mm256_srli_epi32(b, 16));
+
+    _mm256_storeu_ps(left + i, _mm256_fmadd_ps(la, vgl, vbl));
+    _mm256_storeu_ps(left + i + 8, _mm256_fmadd_ps(lb, vgl, vbl));
+    _mm256_storeu_ps(right + i, _mm256_fmadd_ps(ra, vgr, vbr));
+    _mm256_storeu_ps(right + i + 8, _mm256_fmadd_ps(rb, vgr, vbr));
+  }
+
+  convertScalar(in + 2 * i, n - i, left + i, right + i, ol, gl, orr, gr);
+}
+
+__attribute__((target("avx2")))
+static void sumAVX2(const uint16_t* in, std::size_t n, uint64_t* sl, uint64_t* sr)
+{
+  const __m256i lo_mask = _mm256_set1_epi32(0xFFFF);
+  std::size_t i = 0;
+
+  while (n - i >= 8) {
+    std::size_t block = n - i < LR_SUM_BLOCK_PAIRS ? n - i : LR_SUM_BLOCK_PAIRS;
+    std::size_t end = i + (block & ~(std::size_t)7);
+
+    __m256i accl = _mm256_setzero_si256();
+    __m256i accr = _mm256_setzero_si256();
+    for (; i < end; i += 8) {
+      __m256i v = _mm256_loadu_si256((const __m256i*)(in + 2 * i));
+      accl = _mm256_add_epi32(accl, _mm256_and_si256(v, lo_mask));
+      accr = _mm256_add_epi32(accr, _mm256_srli_epi32(v, 16));
+    }
+
+    uint32_t l[8], r[8];
+    _mm256_storeu_si256((__m256i*)l, accl);
+    _mm256_storeu_si256((__m256i*)r, accr);
+    for (int k = 0; k < 8; ++k) {
+      *sl += l[k];
+      *sr += r[k];
+    }
+  }
+
+  sumScalar(in + 2 * i, n - i, sl, sr);
+}
+
+#endif
+
+/*
+ * NEON: vld2 deinterleaves in the load itself
+ */
+
+#ifdef LR_HAVE_NEON
+
+static void convertNEON(const uint16_t* in, std::size_t n, float* left, float* right,
+                        float ol, float gl, float orr, float gr)
+{
+  const float32x4_t vgl = vdupq_n_f32(gl), vbl = vdupq_n_f32(-ol * gl);
+  const float32x4_t vgr = vdupq_n_f32(gr), vbr = vdupq_n_f32(-orr * gr);
+
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    uint16x8x2_t v = vld2q_u16(in + 2 * i);
+
+    float32x4_t l0 = vcvtq_f32_u32(vmovl_u16(vget_low_u16(v.val[0])));
+    float32x4_t l1 = vcvtq_f32_u32(vmovl_u16(vget_high_u16(v.val[0])));
+    float32x4_t r0 = vcvtq_f32_u32(vmovl_u16(vget_low_u16(v.val[1])));
+    float32x4_t r1 = vcvtq_f32_u32(vmovl_u16(vget_high_u16(v.val[1])));
+
+    vst1q_f32(left + i, vmlaq_f32(vbl, l0, vgl));
+    vst1q_f32(left + i + 4, vmlaq_f32(vbl, l1, vgl));
+    vst1q_f32(right + i, vmlaq_f32(vbr, r0, vgr));
+    vst1q_f32(right + i + 4, vmlaq_f32(vbr, r1, vgr));
+  }
+
+  convertScalar(in + 2 * i, n - i, left + i, right + i, ol, gl, orr, gr);
+}
+
+static void sumNEON(const uint16_t* in, std::size_t n, uint64_t* sl, uint64_t* sr)
+{
+  std::size_t i = 0;
+  uint64x2_t accl = vdupq_n_u64(0);
+  uint64x2_t accr = vdupq_n_u64(0);
+
+  for (; i + 8 <= n; i += 8) {
+    uint16x8x2_t v = vld2q_u16(in + 2 * i);
+    // pairwise widening adds, 16 -> 32 -> 64 bits, never overflow
+    accl = vpadalq_u32(accl, vpaddlq_u16(v.val[0]));
+    accr = vpadalq_u32(accr, vpaddlq_u16(v.val[1]));
+  }
+
+  *sl += vgetq_lane_u64(accl, 0) + vgetq_lane_u64(accl, 1);
+  *sr += vgetq_lane_u64(accr, 0) + vgetq_lane_u64(accr, 1);
+  sumScalar(in + 2 * i, n - i, sl, sr);
+}
+
+#endif
+
+bool lrIsaAvailable(lr_isa_t isa)
+{
+  switch (isa) {
+    case LR_ISA_SCALAR:
+    case LR_ISA_AUTO:
+      return true;
+#ifdef LR_HAVE_X86
+    case LR_ISA_SSE2:
+      return true;
+#endif
+#ifdef LR_HAVE_AVX2
+    case LR_ISA_AVX2:
+      return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+#ifdef LR_HAVE_NEON
+    case LR_ISA_NEON:
+      return true;
+#endif
+    default:
+      return false;
+  }
+}
+
+lr_isa_t lrBestIsa()
+{
+  static const lr_isa_t preference[] = {LR_ISA_AVX2, LR_ISA_NEON, LR_ISA_SSE2};
+  for (lr_isa_t isa : preference) {
+    if (lrIsaAvailable(isa))
+      return isa;
+  }
+  return LR_ISA_SCALAR;
+}
+
+const char* lrIsaName(lr_isa_t isa)
+{
+  switch (isa) {
+    case LR_ISA_SCALAR: return "scalar";
+    case LR_ISA_SSE2: return "sse2";
+    case LR_ISA_AVX2: return "avx2";
+    case LR_ISA_NEON: return "neon";
+    case LR_ISA_AUTO: return "auto";
+  }
+  return "unknown";
+}
+
+int lrChannelSums(const uint16_t* in, std::size_t numPairs, uint64_t* leftSum, uint64_t* rightSum, lr_isa_t isa)
+{
+  if (isa == LR_ISA_AUTO)
+    isa = lrBestIsa();
+  if (!lrIsaAvailable(isa))
+    return -1;
+
+  *leftSum = 0;
+  *rightSum = 0;
+
+  switch (isa) {
+#ifdef LR_HAVE_X86
+    case LR_ISA_SSE2: sumSSE2(in, numPairs, leftSum, rightSum); break;
+#endif
+#ifdef LR_HAVE_AVX2
+    case LR_ISA_AVX2: sumAVX2(in, numPairs, leftSum, rightSum); break;
+#endif
+#ifdef LR_HAVE_NEON
+    case LR_ISA_NEON: sumNEON(in, numPairs, leftSum, rightSum); break;
+#endif
+    default: sumScalar(in, numPairs, leftSum, rightSum); break;
+  }
+  return 0;
+}
+
+int lrDeinterleave(const uint16_t* in, std::size_t numPairs, float* left, float* right,
+                   const LRCalibration* cal, bool removeDC, lr_isa_t isa)
+{
+  if (isa == LR_ISA_AUTO)
+    isa = lrBestIsa();
+  if (!lrIsaAvailable(isa))
+    return -1;
+
+  float ol = cal ? cal->left_offset : 0.0f;
+  float gl = cal ? cal->left_gain : 1.0f;
+  float orr = cal ? cal->right_offset : 0.0f;
+  float gr = cal ? cal->right_gain : 1.0f;
+
+  // the sums only read the input, so this pass costs a fraction of the conversion
+  if (removeDC && numPairs > 0) {
+    uint64_t sl, sr;
+    lrChannelSums(in, numPairs, &sl, &sr, isa);
+    ol = (float)((double)sl / numPairs);
+    orr = (float)((double)sr / numPairs);
+  }
+
+  switch (isa) {
+#ifdef LR_HAVE_X86
+    case LR_ISA_SSE2: convertSSE2(in, numPairs, left, right, ol, gl, orr, gr); break;
+#endif
+#ifdef LR_HAVE_AVX2
+    case LR_ISA_AVX2: convertAVX2(in, numPairs, left, right, ol, gl, orr, gr); break;
+#endif
+#ifdef LR_HAVE_NEON
+    case LR_ISA_NEON: convertNEON(in, numPairs, left, right, ol, gl, orr, gr); break;
+#endif
+    default: convertScalar(in, numPairs, left, right, ol, gl, orr, gr); break;
+  }
+  return 0;
+}
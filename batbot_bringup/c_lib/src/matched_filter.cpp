@@ -0,0 +1,173 @@
+#include <cmath>
+#include <stdexcept>
+
+#include "matched_filter.hpp"
+
+std::size_t MatchedFilter::bestFFTSize(std::size_t chirpLen, std::size_t numSamples)
+{
+  std::size_t first = 4;
+  while (first < 2 * chirpLen)
+    first <<= 1;
+
+  // n log n of work per block, for n - chirpLen + 1 outputs per block
+  std::size_t best = first;
+  double best_cost = -1;
+  for (std::size_t n = first; n <= first * MATCHED_FILTER_MAX_FFT_RATIO / 2; n <<= 1) {
+    std::size_t step = n - chirpLen + 1;
+    double per_block = n * log2((double)n);
+    double cost = numSamples > 0 ? per_block * ((numSamples + step - 1) / step) : per_block / step;
+    if (best_cost < 0 || cost < best_cost) {
+      best = n;
+      best_cost = cost;
+    }
+  }
+  return best;
+}
+
+MatchedFilter::MatchedFilter(const float* chirp, std::size_t chirpLen, bool removeChirpDC,
+                             std::size_t numThreads, std::size_t fftSize)
+  : _pool(numThreads)
+{
+  if (chirpLen == 0)
+    throw std::invalid_argument("MatchedFilter needs a chirp");
+  if (fftSize != 0 && (!RealFFT::validSize(fftSize) || fftSize <= chirpLen))
+    throw std::invalid_argument("MatchedFilter fftSize must be a power of two above the chirp length");
+
+  double mean = 0;
+  if (removeChirpDC) {
+    for (std::size_t i = 0; i < chirpLen; ++i)
+      mean += chirp[i];
+    mean /= chirpLen;
+  }
+
+  _chirp.resize(chirpLen);
+  for (std::size_t i = 0; i < chirpLen; ++i)
+    _chirp[i] = (float)(chirp[i] - mean);
+
+  _fixedFFTSize = fftSize;
+  _block.resize(_pool.size());
+  _spectrum.resize(_pool.size());
+  _scratch.resize(_pool.size());
+  _result.resize(_pool.size());
+}
+
+std::size_t MatchedFilter::fftSize(std::size_t numSamples) const
+{
+  return _fixedFFTSize ? _fixedFFTSize : bestFFTSize(_chirp.size(), numSamples);
+}
+
+const MatchedFilter::Plan& MatchedFilter::plan(std::size_t fftSize)
+{
+  std::unique_ptr<Plan>& p = _plans[fftSize];
+  if (p)
+    return *p;
+
+  p.reset(new Plan(fftSize));
+
+  std::vector<float> padded(fftSize, 0.0f);
+  std::copy(_chirp.begin(), _chirp.end(), padded.begin());
+
+  std::vector<cfloat_t> scratch(p->fft.scratchLen());
+  p->chirpSpectrum.resize(p->fft.numBins());
+  p->fft.forward(padded.data(), p->chirpSpectrum.data(), scratch.data());
+  for (cfloat_t& v : p->chirpSpectrum)
+    v = std::conj(v);
+
+  for (std::size_t w = 0; w < _pool.size(); ++w) {
+    if (_block[w].size() < fftSize) {
+      _block[w].resize(fftSize);
+      _spectrum[w].resize(p->fft.numBins());
+      _scratch[w].resize(p->fft.scratchLen());
+      _result[w].resize(fftSize);
+    }
+  }
+  return *p;
+}
+
+template <typename T>
+void MatchedFilter::processBlock(const Plan& p, const T* in, float mean, std::size_t numSamples,
+                                 std::size_t start, float* out, std::size_t worker)
+{
+  std::size_t n = p.fft.size();
+  float* x = _block[worker].data();
+  cfloat_t* X = _spectrum[worker].data();
+  float* y = _result[worker].data();
+
+  // the block runs past the end of the channel for the last outputs, pad with zeros
+  std::size_t avail = numSamples - start < n ? numSamples - start : n;
+  for (std::size_t i = 0; i < avail; ++i)
+    x[i] = (float)in[start + i] - mean;
+  for (std::size_t i = avail; i < n; ++i)
+    x[i] = 0.0f;
+
+  p.fft.forward(x, X, _scratch[worker].data());
+
+  const cfloat_t* H = p.chirpSpectrum.data();
+  for (std::size_t k = 0; k < p.fft.numBins(); ++k) {
+    float re = X[k].real() * H[k].real() - X[k].imag() * H[k].imag();
+    float im = X[k].real() * H[k].imag() + X[k].imag() * H[k].real();
+    X[k] = cfloat_t(re, im);
+  }
+
+  p.fft.inverse(X, y, _scratch[worker].data());
+
+  // the first n - chirpLen + 1 lags do not wrap around the block
+  std::size_t valid = n - _chirp.size() + 1;
+  if (valid > numSamples - start)
+    valid = numSamples - start;
+  for (std::size_t i = 0; i < valid; ++i)
+    out[start + i] = y[i];
+}
+
+template <typename T>
+int MatchedFilter::processChannels(const T* const* in, std::size_t numChannels, std::size_t numSamples,
+                                   float* const* out, bool removeDC, bool normalize)
+{
+  if (numChannels == 0 || numSamples == 0)
+    return -1;
+
+  const Plan& p = plan(fftSize(numSamples));
+  std::size_t step = p.fft.size() - _chirp.size() + 1;
+  std::size_t blocks = (numSamples + step - 1) / step;
+  std::vector<float> mean(numChannels, 0.0f);
+
+  if (removeDC) {
+    _pool.run(numChannels, [&](std::size_t c, std::size_t) {
+      double sum = 0;
+      for (std::size_t i = 0; i < numSamples; ++i)
+        sum += in[c][i];
+      mean[c] = (float)(sum / numSamples);
+    });
+  }
+
+  _pool.run(numChannels * blocks, [&](std::size_t task, std::size_t worker) {
+    std::size_t c = task / blocks;
+    processBlock(p, in[c], mean[c], numSamples, (task % blocks) * step, out[c], worker);
+  });
+
+  if (normalize) {
+    _pool.run(numChannels, [&](std::size_t c, std::size_t) {
+      float peak = 0;
+      for (std::size_t i = 0; i < numSamples; ++i)
+        peak = std::fabs(out[c][i]) > peak ? std::fabs(out[c][i]) : peak;
+
+      float scale = peak > 0 ? 1.0f / peak : 0.0f;
+      for (std::size_t i = 0; i < numSamples; ++i)
+        out[c][i] = std::fabs(out[c][i]) * scale;
+    });
+  }
+
+  return 0;
+}
+
+int MatchedFilter::process(const float* const* in, std::size_t numChannels, std::size_t numSamples,
+                           float* const* out, bool removeDC, bool normalize)
+{
+  return processChannels(in, numChannels, numSamples, out, removeDC, normalize);
+}
+
+int MatchedFilter::process(const uint16_t* const* in, std::size_t numChannels, std::size_t numSamples,
+                           float* const* out, bool removeDC, bool normalize)
+{
+  return processChannels(in, numChannels, numSamples, out, removeDC, normalize);
+}
@@ -0,0 +1,188 @@
+#include <cmath>
+#include <stdexcept>
+
+#include "real_fft.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define REAL_FFT_SSE2 1
+#include <emmintrin.h>
+#endif
+
+/*
+ * std::complex multiplication checks for infinities unless built with -ffast-math, which
+ * is several times slower than the plain formula in the inner loop
+ */
+static inline cfloat_t cmul(cfloat_t a, cfloat_t b)
+{
+  return cfloat_t(a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real());
+}
+
+RealFFT::RealFFT(std::size_t n)
+{
+  if (!validSize(n))
+    throw std::invalid_argument("RealFFT size must be a power of two of at least 4");
+
+  _n = n;
+  std::size_t m = n / 2;
+
+  std::size_t bits = 0;
+  while (((std::size_t)1 << bits) < m)
+    bits++;
+
+  _bitrev.resize(m);
+  for (std::size_t i = 0; i < m; ++i) {
+    std::size_t r = 0;
+    for (std::size_t b = 0; b < bits; ++b)
+      r |= ((i >> b) & 1) << (bits - 1 - b);
+    _bitrev[i] = (uint32_t)r;
+  }
+
+  // computed in double so the tables are accurate to the last float bit. One run of
+  // e^(-2 pi i j / (2 half)), j < half, per stage from half = 4 on, back to back
+  for (std::size_t half = 4; half < m; half <<= 1) {
+    for (std::size_t j = 0; j < half; ++j) {
+      double a = -M_PI * j / half;
+      _twiddle.push_back(cfloat_t((float)cos(a), (float)sin(a)));
+    }
+  }
+
+  // the same twiddles two at a time as wr0 wr0 wr1 wr1, -wi0 wi0 -wi1 wi1
+  for (std::size_t j = 0; j + 1 < _twiddle.size(); j += 2) {
+    const cfloat_t& a = _twiddle[j];
+    const cfloat_t& b = _twiddle[j + 1];
+    const float quad[8] = {a.real(), a.real(), b.real(), b.real(), -a.imag(), a.imag(), -b.imag(), b.imag()};
+    _twiddleSSE.insert(_twiddleSSE.end(), quad, quad + 8);
+  }
+
+  _split.resize(m + 1);
+  for (std::size_t k = 0; k <= m; ++k) {
+    double a = -2.0 * M_PI * k / n;
+    _split[k] = cfloat_t((float)cos(a), (float)sin(a));
+  }
+}
+
+void RealFFT::complexForward(cfloat_t* z) const
+{
+  std::size_t m = _n / 2;
+
+  for (std::size_t i = 0; i < m; ++i) {
+    std::size_t r = _bitrev[i];
+    if (r > i)
+      std::swap(z[i], z[r]);
+  }
+
+  // the first two stages only need twiddles of 1 and -i, done together as radix-4
+  if (m >= 4) {
+    for (std::size_t s = 0; s < m; s += 4) {
+      cfloat_t a = z[s] + z[s + 1], b = z[s] - z[s + 1];
+      cfloat_t c = z[s + 2] + z[s + 3], d = z[s + 2] - z[s + 3];
+      cfloat_t d_i(d.imag(), -d.real());
+      z[s] = a + c;
+      z[s + 2] = a - c;
+      z[s + 1] = b + d_i;
+      z[s + 3] = b - d_i;
+    }
+  } else {
+    for (std::size_t s = 0; s < m; s += 2) {
+      cfloat_t u = z[s];
+      z[s] = u + z[s + 1];
+      z[s + 1] = u - z[s + 1];
+    }
+  }
+
+  // later stages read their twiddles contiguously, see the constructor
+#ifdef REAL_FFT_SSE2
+  // two butterflies per register, twiddles stored as (wr, wr) and (-wi, wi) pairs
+  const float* tw = _twiddleSSE.data();
+  for (std::size_t half = 4; half < m; half <<= 1) {
+    for (std::size_t start = 0; start < m; start += 2 * half) {
+      float* lo = reinterpret_cast<float*>(z + start);
+      float* hi = reinterpret_cast<float*>(z + start + half);
+      for (std::size_t j = 0; j < 2 * half; j += 4) {
+        __m128 h = _mm_loadu_ps(hi + j);
+        __m128 wr = _mm_loadu_ps(tw + 2 * j);
+        __m128 wi = _mm_loadu_ps(tw + 2 * j + 4);
+        __m128 hs = _mm_shuffle_ps(h, h, _MM_SHUFFLE(2, 3, 0, 1));
+        __m128 t = _mm_add_ps(_mm_mul_ps(h, wr), _mm_mul_ps(hs, wi));
+        __m128 u = _mm_loadu_ps(lo + j);
+        _mm_storeu_ps(lo + j, _mm_add_ps(u, t));
+        _mm_storeu_ps(hi + j, _mm_sub_ps(u, t));
+      }
+    }
+    tw += 4 * half;
+  }
+#else
+  const cfloat_t* tw = _twiddle.data();
+  for (std::size_t half = 4; half < m; half <<= 1) {
+    for (std::size_t start = 0; start < m; start += 2 * half) {
+      float* lo = reinterpret_cast<float*>(z + start);
+      float* hi = reinterpret_cast<float*>(z + start + half);
+      const float* w = reinterpret_cast<const float*>(tw);
+      for (std::size_t j = 0; j < 2 * half; j += 2) {
+        float tr = hi[j] * w[j] - hi[j + 1] * w[j + 1];
+        float ti = hi[j] * w[j + 1] + hi[j + 1] * w[j];
+        float ur = lo[j], ui = lo[j + 1];
+        lo[j] = ur + tr;
+        lo[j + 1] = ui + ti;
+        hi[j] = ur - tr;
+        hi[j + 1] = ui - ti;
+      }
+    }
+    tw += half;
+  }
+#endif
+}
+
+void RealFFT::forward(const float* in, cfloat_t* out, cfloat_t* scratch) const
+{
+  std::size_t m = _n / 2;
+
+  // even samples in the real part, odd samples in the imaginary part
+  for (std::size_t j = 0; j < m; ++j)
+    scratch[j] = cfloat_t(in[2 * j], in[2 * j + 1]);
+
+  complexForward(scratch);
+
+  // X[k] = E[k] + W^k O[k], with E and O recovered from Z[k] and conj(Z[m - k])
+  const float* z = reinterpret_cast<const float*>(scratch);
+  const float* w = reinterpret_cast<const float*>(_split.data());
+  float* x = reinterpret_cast<float*>(out);
+
+  x[0] = z[0] + z[1];
+  x[1] = 0;
+  x[2 * m] = z[0] - z[1];
+  x[2 * m + 1] = 0;
+
+  for (std::size_t k = 1; k < m; ++k) {
+    float ar = z[2 * k], ai = z[2 * k + 1];
+    float br = z[2 * (m - k)], bi = -z[2 * (m - k) + 1];
+    float er = 0.5f * (ar + br), ei = 0.5f * (ai + bi);
+    // -i/2 (a - b)
+    float or_ = 0.5f * (ai - bi), oi = -0.5f * (ar - br);
+    float wr = w[2 * k], wi = w[2 * k + 1];
+    x[2 * k] = er + or_ * wr - oi * wi;
+    x[2 * k + 1] = ei + or_ * wi + oi * wr;
+  }
+}
+
+void RealFFT::inverse(const cfloat_t* in, float* out, cfloat_t* scratch) const
+{
+  std::size_t m = _n / 2;
+
+  // undo the split step, Z[k] = E[k] + i O[k], then an inverse transform by conjugation
+  for (std::size_t k = 0; k < m; ++k) {
+    cfloat_t a = in[k];
+    cfloat_t b = std::conj(in[m - k]);
+    cfloat_t even = 0.5f * (a + b);
+    cfloat_t odd = cmul(0.5f * (a - b), std::conj(_split[k]));
+    scratch[k] = std::conj(even + cfloat_t(-odd.imag(), odd.real()));
+  }
+
+  complexForward(scratch);
+
+  float scale = 1.0f / m;
+  for (std::size_t j = 0; j < m; ++j) {
+    out[2 * j] = scratch[j].real() * scale;
+    out[2 * j + 1] = -scratch[j].imag() * scale;
+  }
+}
@@ -50,6 +50,7 @@ int SerialObject_UART_Linux::set_attributes(int speed, int parity) {
   tty.c_cc[VTIME] = 5; // 0.5 seconds read timeout
 
   tty.c_iflag &= ~(IXON | IXOFF | IXANY); // shut off xon/xoff ctrl
+  tty.c_iflag &= ~(ICRNL | INLCR | IGNCR | ISTRIP); // binary data, never translate 0x0D/0x0A
   tty.c_cflag |= PARENB;
   tty.c_cflag |= (CLOCAL | CREAD);
   tty.c_cflag |= parity;
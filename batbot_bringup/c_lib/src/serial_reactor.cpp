@@ -0,0 +1,362 @@
+#include <cstring>
+#include <string.h>
+#include <iostream>
+
+#include "serial_reactor.hpp"
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <termios.h>
+#include <unistd.h>
+
+/**
+ * @brief epoll user data used for the wakeup eventfd, port ids are never this large
+ */
+#define SERIAL_REACTOR_WAKE_ID 0xFFFFFFFFu
+
+SerialReactor::SerialReactor()
+{
+  _running = false;
+
+  _epfd = epoll_create1(EPOLL_CLOEXEC);
+  if (_epfd < 0) {
+    std::cout << "Error creating epoll instance: " << strerror(errno) << "\n";
+  }
+
+  _wakefd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (_wakefd < 0) {
+    std::cout << "Error creating eventfd: " << strerror(errno) << "\n";
+  }
+
+  struct epoll_event ev;
+  memset(&ev, 0, sizeof ev);
+  ev.events = EPOLLIN;
+  ev.data.u32 = SERIAL_REACTOR_WAKE_ID;
+  epoll_ctl(_epfd, EPOLL_CTL_ADD, _wakefd, &ev);
+}
+
+SerialReactor::~SerialReactor()
+{
+  for (std::size_t i = 0; i < _ports.size(); ++i) {
+    closePort((int)i);
+  }
+  close(_wakefd);
+  close(_epfd);
+}
+
+int SerialReactor::openPort(std::string portName, int speed, FrameSplitter splitter, FrameCallback callback)
+{
+  int fd = open(portName.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+  if (fd < 0) {
+    std::cout << "Error opening " << portName << ": " << strerror(errno) << "\n";
+    return -1;
+  }
+
+  struct termios tty;
+  if (tcgetattr(fd, &tty) < 0) {
+    std::cout << "Error" << errno << " from tcgettatr\n";
+    close(fd);
+    return -1;
+  }
+
+  // raw 8N1, reads never wait on VMIN/VTIME since epoll tells us when data is there
+  cfmakeraw(&tty);
+  cfsetospeed(&tty, speed);
+  cfsetispeed(&tty, speed);
+  tty.c_cflag |= (CLOCAL | CREAD);
+  tty.c_cflag &= ~CRTSCTS;
+  tty.c_cc[VMIN] = 0;
+  tty.c_cc[VTIME] = 0;
+
+  if (tcsetattr(fd, TCSANOW, &tty) != 0) {
+    std::cout << "Error " << errno << " from tcsetattr\n";
+    close(fd);
+    return -1;
+  }
+
+  int port = registerPort(fd, true, splitter, callback);
+  if (port < 0) {
+    close(fd);
+    return -1;
+  }
+
+  std::cout << "Successfully opened " << portName << "\n";
+  return port;
+}
+
+int SerialReactor::addFd(int fd, FrameSplitter splitter, FrameCallback callback)
+{
+  int flags = fcntl(fd, F_GETFL, 0);
+  if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+    std::cout << "Error setting fd " << fd << " non-blocking: " << strerror(errno) << "\n";
+    return -1;
+  }
+
+  return registerPort(fd, false, splitter, callback);
+}
+
+int SerialReactor::registerPort(int fd, bool owns_fd, FrameSplitter splitter, FrameCallback callback)
+{
+  // reuse the slot of a closed port if there is one
+  std::size_t port = 0;
+  for (; port < _ports.size(); ++port) {
+    if (_ports[port].fd < 0)
+      break;
+  }
+  if (port == _ports.size())
+    _ports.push_back(Port());
+
+  Port& p = _ports[port];
+  p.fd = fd;
+  p.owns_fd = owns_fd;
+  p.want_write = false;
+  p.splitter = splitter;
+  p.callback = callback;
+  p.rx.assign(SERIAL_REACTOR_RX_BUF_LEN, 0);
+  p.rx_head = 0;
+  p.rx_tail = 0;
+  p.tx.clear();
+  p.tx_head = 0;
+
+  struct epoll_event ev;
+  memset(&ev, 0, sizeof ev);
+  ev.events = EPOLLIN;
+  ev.data.u32 = (uint32_t)port;
+  if (epoll_ctl(_epfd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+    std::cout << "Error adding fd " << fd << " to epoll: " << strerror(errno) << "\n";
+    p.fd = -1;
+    return -1;
+  }
+
+  return (int)port;
+}
+
+void SerialReactor::closePort(int port)
+{
+  if (port < 0 || (std::size_t)port >= _ports.size() || _ports[port].fd < 0)
+    return;
+
+  Port& p = _ports[port];
+  epoll_ctl(_epfd, EPOLL_CTL_DEL, p.fd, NULL);
+  if (p.owns_fd)
+    close(p.fd);
+
+  p.fd = -1;
+  p.rx.clear();
+  p.rx.shrink_to_fit();
+  p.tx.clear();
+}
+
+int SerialReactor::writeBytes(int port, const uint8_t* bytes, std::size_t numBytes)
+{
+  if (port < 0 || (std::size_t)port >= _ports.size() || _ports[port].fd < 0)
+    return -1;
+
+  Port& p = _ports[port];
+  p.tx.insert(p.tx.end(), bytes, bytes + numBytes);
+
+  // only try the fast path if nothing is already waiting, to keep byte order
+  if (!p.want_write && flushTx(port) < 0)
+    return -1;
+
+  updateInterest(port);
+  return 0;
+}
+
+int SerialReactor::flushTx(int port)
+{
+  Port& p = _ports[port];
+
+  while (p.tx_head < p.tx.size()) {
+    ssize_t n = write(p.fd, &p.tx[p.tx_head], p.tx.size() - p.tx_head);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      if (errno == EAGAIN || errno == EWOULDBLOCK)
+        break;
+      std::cout << "Error writing port " << port << ": " << strerror(errno) << "\n";
+      return -1;
+    }
+    p.tx_head += n;
+  }
+
+  if (p.tx_head == p.tx.size()) {
+    p.tx.clear();
+    p.tx_head = 0;
+  }
+  return 0;
+}
+
+void SerialReactor::updateInterest(int port)
+{
+  Port& p = _ports[port];
+  bool want_write = p.tx_head < p.tx.size();
+  if (want_write == p.want_write)
+    return;
+
+  struct epoll_event ev;
+  memset(&ev, 0, sizeof ev);
+  ev.events = EPOLLIN | (want_write ? (uint32_t)EPOLLOUT : 0u);
+  ev.data.u32 = (uint32_t)port;
+  epoll_ctl(_epfd, EPOLL_CTL_MOD, p.fd, &ev);
+  p.want_write = want_write;
+}
+
+void SerialReactor::handleReadable(int port)
+{
+  while (_ports[port].fd >= 0) {
+    Port& p = _ports[port];
+
+    // make room at the end of the buffer: first by dropping consumed bytes,
+    // then by growing if a single frame is bigger than the whole buffer
+    if (p.rx_tail == p.rx.size()) {
+      if (p.rx_head > 0) {
+        memmove(&p.rx[0], &p.rx[p.rx_head], p.rx_tail - p.rx_head);
+        p.rx_tail -= p.rx_head;
+        p.rx_head = 0;
+      } else {
+        p.rx.resize(p.rx.size() * 2);
+      }
+    }
+
+    ssize_t n = read(p.fd, &p.rx[p.rx_tail], p.rx.size() - p.rx_tail);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        std::cout << "Error reading port " << port << ": " << strerror(errno) << "\n";
+        hangUp(port);
+      }
+      return;
+    }
+
+    // a non-blocking tty only reads 0 once it has hung up, an unplugged USB device
+    // comes as EPOLLIN | EPOLLHUP and then this. Level triggered, it would come again
+    // on every epoll_wait() until the port is closed
+    if (n == 0) {
+      hangUp(port);
+      return;
+    }
+
+    p.rx_tail += n;
+
+    // dispatch every complete frame straight out of the receive buffer. The
+    // callback may close this port or open others, so re-check through the index.
+    while (_ports[port].fd >= 0) {
+      Port& q = _ports[port];
+      std::size_t avail = q.rx_tail - q.rx_head;
+      if (avail == 0)
+        break;
+
+      std::size_t frame_len = q.splitter(&q.rx[q.rx_head], avail);
+      if (frame_len == 0 || frame_len > avail)
+        break;
+
+      const uint8_t* frame = &q.rx[q.rx_head];
+      q.rx_head += frame_len;
+      q.callback(port, frame, frame_len);
+    }
+
+    if (_ports[port].fd >= 0 && _ports[port].rx_head == _ports[port].rx_tail) {
+      _ports[port].rx_head = 0;
+      _ports[port].rx_tail = 0;
+    }
+  }
+}
+
+void SerialReactor::hangUp(int port)
+{
+  std::cout << "Port " << port << " hung up\n";
+  closePort(port);
+  if (_onDisconnect)
+    _onDisconnect(port);
+}
+
+void SerialReactor::handleWritable(int port)
+{
+  if (flushTx(port) < 0) {
+    closePort(port);
+    return;
+  }
+  updateInterest(port);
+}
+
+int SerialReactor::poll(int timeout_ms)
+{
+  struct epoll_event events[SERIAL_REACTOR_MAX_EVENTS];
+
+  int n = epoll_wait(_epfd, events, SERIAL_REACTOR_MAX_EVENTS, timeout_ms);
+  if (n < 0) {
+    if (errno == EINTR)
+      return 0;
+    std::cout << "Error " << errno << " from epoll_wait\n";
+    return -1;
+  }
+
+  for (int i = 0; i < n; ++i) {
+    uint32_t id = events[i].data.u32;
+
+    if (id == SERIAL_REACTOR_WAKE_ID) {
+      uint64_t count;
+      while (read(_wakefd, &count, sizeof count) > 0);
+      continue;
+    }
+
+    int port = (int)id;
+    if ((std::size_t)port >= _ports.size() || _ports[port].fd < 0)
+      continue;
+
+    if (events[i].events & EPOLLIN)
+      handleReadable(port);
+
+    if (_ports[port].fd >= 0 && (events[i].events & EPOLLOUT))
+      handleWritable(port);
+
+    // the device went away, whatever it sent before has been read above
+    if (_ports[port].fd >= 0 && (events[i].events & (EPOLLERR | EPOLLHUP)))
+      hangUp(port);
+  }
+
+  return n;
+}
+
+void SerialReactor::run()
+{
+  _running = true;
+  while (_running) {
+    if (poll(-1) < 0)
+      break;
+  }
+}
+
+void SerialReactor::stop()
+{
+  _running = false;
+  uint64_t one = 1;
+  if (write(_wakefd, &one, sizeof one) < 0) {
+    std::cout << "Error waking reactor: " << strerror(errno) << "\n";
+  }
+}
+
+SerialReactor::FrameSplitter SerialReactor::fixedLengthSplitter(std::size_t frameLen)
+{
+  return [frameLen](const uint8_t* data, std::size_t len) -> std::size_t {
+    (void)data;
+    return len >= frameLen ? frameLen : 0;
+  };
+}
+
+SerialReactor::FrameSplitter SerialReactor::passthroughSplitter()
+{
+  return [](const uint8_t* data, std::size_t len) -> std::size_t {
+    (void)data;
+    return len;
+  };
+}
+
+#endif
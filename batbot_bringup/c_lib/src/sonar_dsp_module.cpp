@@ -0,0 +1,270 @@
+/**
+ * @file
+ * @brief Python bindings for the sonar signal processing kernels
+ *
+ * deinterleave() turns pair interleaved uint16 data, the layout of captures from before the
+ * framed stream, into calibrated float32 ears. Output arrays can be passed in to reuse them between pings. Spectrogram
+ * keeps its FFT plan, window and threads between pings and does both ears in one call.
+ * MatchedFilter compresses a whole batch of pings x ears against the chirp per call.
+ * The GIL is released while the kernels run.
+ */
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "lr_deinterleave.hpp"
+#include "matched_filter.hpp"
+#include "spectrogram.hpp"
+
+namespace py = pybind11;
+
+typedef py::array_t<uint16_t, py::array::c_style> u16_array_t;
+typedef py::array_t<float, py::array::c_style> f32_array_t;
+
+/**
+ * @brief Returns out if it is a 1D array of n floats, or a new array if out is None
+ */
+static f32_array_t output_array(py::object out, std::size_t n, const char* name)
+{
+  if (out.is_none())
+    return f32_array_t((py::ssize_t)n);
+
+  // no conversion, a mismatched array would silently fill a temporary copy
+  if (!f32_array_t::check_(out))
+    throw py::type_error(std::string(name) + " must be a contiguous float32 array");
+  f32_array_t arr = py::reinterpret_borrow<f32_array_t>(out);
+  if (arr.ndim() != 1 || (std::size_t)arr.size() != n)
+    throw py::value_error(std::string(name) + " must be 1D with one element per sample pair");
+  return arr;
+}
+
+static lr_isa_t isa_from_name(const std::string& name)
+{
+  const lr_isa_t isas[] = {LR_ISA_SCALAR, LR_ISA_SSE2, LR_ISA_AVX2, LR_ISA_NEON, LR_ISA_AUTO};
+  for (lr_isa_t isa : isas) {
+    if (name == lrIsaName(isa))
+      return isa;
+  }
+  throw py::value_error("unknown isa " + name);
+}
+
+/**
+ * @brief Runs Spectrogram::compute on uint16 ears as they are, anything else as float32
+ */
+static py::tuple compute_spectrogram(Spectrogram& self, py::array left, py::object right,
+                                     bool remove_dc, std::size_t time_offset, float db_range)
+{
+  bool raw = py::isinstance<u16_array_t>(left) && (right.is_none() || py::isinstance<u16_array_t>(right));
+  py::array l, r;
+  if (raw) {
+    l = u16_array_t::ensure(left);
+    r = right.is_none() ? py::array() : u16_array_t::ensure(right);
+  } else {
+    l = f32_array_t::ensure(left);
+    r = right.is_none() ? py::array() : f32_array_t::ensure(right);
+  }
+  if (!l || (!right.is_none() && !r))
+    throw py::type_error("left and right must be numeric arrays");
+
+  std::size_t n = l.size();
+  if (l.ndim() != 1 || (!right.is_none() && (r.ndim() != 1 || (std::size_t)r.size() != n)))
+    throw py::value_error("left and right must be 1D and the same length");
+
+  std::size_t frames = time_offset < n ? self.numFrames(n - time_offset) : 0;
+  if (frames == 0)
+    throw py::value_error("not enough samples after time_offset for one frame");
+
+  f32_array_t ldb({(py::ssize_t)self.numBins(), (py::ssize_t)frames});
+  f32_array_t rdb = right.is_none() ? f32_array_t() : f32_array_t({(py::ssize_t)self.numBins(), (py::ssize_t)frames});
+  float* lout = ldb.mutable_data();
+  float* rout = right.is_none() ? NULL : rdb.mutable_data();
+
+  {
+    py::gil_scoped_release release;
+    if (raw) {
+      self.compute((const uint16_t*)l.data(), right.is_none() ? NULL : (const uint16_t*)r.data(), n,
+                   lout, rout, remove_dc, time_offset, db_range);
+    } else {
+      self.compute((const float*)l.data(), right.is_none() ? NULL : (const float*)r.data(), n,
+                   lout, rout, remove_dc, time_offset, db_range);
+    }
+  }
+
+  return py::make_tuple(ldb, right.is_none() ? py::object(py::none()) : py::object(rdb));
+}
+
+/**
+ * @brief Runs MatchedFilter::process over every row of an array of any shape, the last
+ * axis being time, uint16 rows as they are and anything else as float32
+ */
+static f32_array_t compress_echoes(MatchedFilter& self, py::array echoes, bool remove_dc,
+                                   bool normalize, py::object out)
+{
+  bool raw = py::isinstance<u16_array_t>(echoes);
+  py::array in = raw ? py::array(u16_array_t::ensure(echoes)) : py::array(f32_array_t::ensure(echoes));
+  if (!in || in.ndim() < 1 || in.shape(in.ndim() - 1) == 0)
+    throw py::value_error("echoes must be a numeric array with time on the last axis");
+
+  std::size_t n = in.shape(in.ndim() - 1);
+  std::size_t channels = in.size() / n;
+  std::vector<py::ssize_t> shape(in.shape(), in.shape() + in.ndim());
+
+  f32_array_t result;
+  if (out.is_none()) {
+    result = f32_array_t(shape);
+  } else {
+    if (!f32_array_t::check_(out))
+      throw py::type_error("out must be a contiguous float32 array");
+    result = py::reinterpret_borrow<f32_array_t>(out);
+    if (result.ndim() != in.ndim() || !std::equal(shape.begin(), shape.end(), result.shape()))
+      throw py::value_error("out must be the same shape as echoes");
+  }
+
+  std::vector<float*> outs(channels);
+  for (std::size_t c = 0; c < channels; ++c)
+    outs[c] = result.mutable_data() + c * n;
+
+  if (raw) {
+    std::vector<const uint16_t*> ins(channels);
+    for (std::size_t c = 0; c < channels; ++c)
+      ins[c] = (const uint16_t*)in.data() + c * n;
+
+    py::gil_scoped_release release;
+    self.process(ins.data(), channels, n, outs.data(), remove_dc, normalize);
+  } else {
+    std::vector<const float*> ins(channels);
+    for (std::size_t c = 0; c < channels; ++c)
+      ins[c] = (const float*)in.data() + c * n;
+
+    py::gil_scoped_release release;
+    self.process(ins.data(), channels, n, outs.data(), remove_dc, normalize);
+  }
+
+  return result;
+}
+
+PYBIND11_MODULE(sonardsp, m) {
+  m.def("deinterleave",
+    [](u16_array_t raw, float left_offset, float left_gain, float right_offset, float right_gain,
+       bool remove_dc, bool left_channel_first, py::object left, py::object right, const std::string& isa) {
+      if (raw.ndim() != 1 || raw.size() % 2 != 0)
+        throw py::value_error("raw must be a 1D uint16 array of interleaved sample pairs");
+      std::size_t n = raw.size() / 2;
+
+      f32_array_t l = output_array(left, n, "left");
+      f32_array_t r = output_array(right, n, "right");
+      lr_isa_t which = isa_from_name(isa);
+
+      // the kernel sees the stream in wire order
+      LRCalibration cal = {left_offset, left_gain, right_offset, right_gain};
+      float* first = l.mutable_data();
+      float* second = r.mutable_data();
+      if (!left_channel_first) {
+        cal = {right_offset, right_gain, left_offset, left_gain};
+        std::swap(first, second);
+      }
+
+      int ret;
+      {
+        py::gil_scoped_release release;
+        ret = lrDeinterleave(raw.data(), n, first, second, &cal, remove_dc, which);
+      }
+      if (ret < 0)
+        throw py::value_error(isa + " is not available on this machine");
+
+      return py::make_tuple(l, r);
+    },
+    py::arg("raw"),
+    py::arg("left_offset") = 0.0f, py::arg("left_gain") = 1.0f,
+    py::arg("right_offset") = 0.0f, py::arg("right_gain") = 1.0f,
+    py::arg("remove_dc") = true, py::arg("left_channel_first") = true,
+    py::arg("left") = py::none(), py::arg("right") = py::none(),
+    py::arg("isa") = "auto",
+    "Split a pair interleaved uint16 capture (the old [L0 R0 L1 R1 ...] layout, not the framed stream) "
+    "into float32 (left, right) ears, (x - offset) * gain. remove_dc uses each ear's mean as its offset, "
+    "taking one extra read of raw. left and right may be preallocated float32 arrays.");
+
+  m.def("best_isa", []() { return std::string(lrIsaName(lrBestIsa())); },
+    "Name of the kernel isa='auto' uses");
+  m.def("isa_available", [](const std::string& isa) { return lrIsaAvailable(isa_from_name(isa)); },
+    py::arg("isa"));
+
+  py::class_<Spectrogram>(m, "Spectrogram")
+    .def(py::init([](double fs, std::size_t nfft, std::size_t noverlap, double fmin, double fmax,
+                     std::size_t threads, py::object window) {
+        if (!RealFFT::validSize(nfft))
+          throw py::value_error("nfft must be a power of two");
+        if (noverlap >= nfft)
+          throw py::value_error("noverlap must be below nfft");
+
+        f32_array_t w;
+        if (!window.is_none()) {
+          w = f32_array_t::ensure(window);
+          if (!w || w.ndim() != 1 || (std::size_t)w.size() != nfft)
+            throw py::value_error("window must have nfft values");
+        }
+
+        Spectrogram* spec = new Spectrogram(fs, nfft, noverlap, fmin, fmax, threads);
+        if (!window.is_none())
+          spec->setWindow(w.data());
+        return spec;
+      }),
+      py::arg("fs") = 1e6, py::arg("nfft") = 512, py::arg("noverlap") = 400,
+      py::arg("fmin") = 30e3, py::arg("fmax") = 100e3, py::arg("threads") = 0,
+      py::arg("window") = py::none(),
+      "Plan a spectrogram. The default window is scipy.signal.windows.hann(nfft), threads=0 uses every core.")
+    .def("compute", &compute_spectrogram,
+      py::arg("left"), py::arg("right") = py::none(), py::arg("remove_dc") = true,
+      py::arg("time_offset") = 0, py::arg("db_range") = 0.0f,
+      "Return (left_dB, right_dB), each (bins, frames) like mlab.specgram, in 20 log10 of the PSD and "
+      "cropped to [fmin, fmax]. uint16 ears are used as they are. With db_range > 0 each ear is "
+      "shifted to peak at 0 dB and clipped at -db_range, as plot_spec does.")
+    .def("freqs",
+      [](Spectrogram& self) {
+        f32_array_t f((py::ssize_t)self.numBins());
+        for (std::size_t i = 0; i < self.numBins(); ++i)
+          f.mutable_data()[i] = (float)self.binFrequency(i);
+        return f;
+      },
+      "Frequency of each output row in Hz")
+    .def("times",
+      [](Spectrogram& self, std::size_t num_samples, std::size_t time_offset) {
+        std::size_t frames = time_offset < num_samples ? self.numFrames(num_samples - time_offset) : 0;
+        f32_array_t t((py::ssize_t)frames);
+        for (std::size_t i = 0; i < frames; ++i)
+          t.mutable_data()[i] = (float)self.frameTime(i);
+        return t;
+      },
+      py::arg("num_samples"), py::arg("time_offset") = 0,
+      "Time of each output column in seconds from the first analysed sample")
+    .def_property_readonly("num_bins", &Spectrogram::numBins)
+    .def_property_readonly("threads", &Spectrogram::numThreads);
+
+  py::class_<MatchedFilter>(m, "MatchedFilter")
+    .def(py::init([](py::array chirp, bool remove_chirp_dc, std::size_t threads, std::size_t fft_size) {
+        f32_array_t c = f32_array_t::ensure(chirp);
+        if (!c || c.ndim() != 1 || c.size() == 0)
+          throw py::value_error("chirp must be a non empty 1D array");
+        if (fft_size != 0 && (!RealFFT::validSize(fft_size) || fft_size <= (std::size_t)c.size()))
+          throw py::value_error("fft_size must be a power of two above the chirp length");
+        return new MatchedFilter(c.data(), c.size(), remove_chirp_dc, threads, fft_size);
+      }),
+      py::arg("chirp"), py::arg("remove_chirp_dc") = true, py::arg("threads") = 0, py::arg("fft_size") = 0,
+      "Plan pulse compression against the emitted chirp, e.g. np.load('default_chirp.npy'). "
+      "threads=0 uses every core, fft_size=0 picks the block size per capture length.")
+    .def("compress", &compress_echoes,
+      py::arg("echoes"), py::arg("remove_dc") = true, py::arg("normalize") = false, py::arg("out") = py::none(),
+      "Correlate every row of echoes, e.g. shape (pings, 2, samples), with the chirp. Returns float32 of the "
+      "same shape where index k is the round trip delay in samples, "
+      "scipy.signal.correlate(x, chirp, 'full')[len(chirp) - 1:][:len(x)]. normalize gives abs(x) / max(abs(x)) "
+      "per row like autocorr().")
+    .def("fft_size", &MatchedFilter::fftSize, py::arg("num_samples"),
+      "Block transform size used for captures of num_samples")
+    .def_property_readonly("chirp_len", &MatchedFilter::chirpLen)
+    .def_property_readonly("threads", &MatchedFilter::numThreads);
+}
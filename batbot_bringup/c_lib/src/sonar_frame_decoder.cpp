@@ -0,0 +1,218 @@
+#include <cstring>
+#include <string.h>
+
+#include "sonar_frame_decoder.hpp"
+
+static const uint8_t magic_bytes[4] = {
+  SONAR_FRAME_MAGIC & 0xFF, (SONAR_FRAME_MAGIC >> 8) & 0xFF,
+  (SONAR_FRAME_MAGIC >> 16) & 0xFF, SONAR_FRAME_MAGIC >> 24};
+
+/*
+ * True if the n bytes at p could be the start of a frame
+ */
+static bool magicPrefix(const uint8_t* p, std::size_t n)
+{
+  return memcmp(p, magic_bytes, n < 4 ? n : 4) == 0;
+}
+
+/*
+ * Number of bytes before the next position that could start a frame, at least 1
+ */
+static std::size_t skipToCandidate(const uint8_t* p, std::size_t n)
+{
+  const void* next = n > 1 ? memchr(p + 1, magic_bytes[0], n - 1) : NULL;
+  return next != NULL ? (const uint8_t*)next - p : n;
+}
+
+/*
+ * Length of the frame whose header is at p, 0 if the header cannot start a frame
+ */
+static std::size_t frameLength(const uint8_t* p)
+{
+  SonarFrameHeader h;
+  memcpy(&h, p, sizeof(h));
+  if (h.magic != SONAR_FRAME_MAGIC || h.count != SONAR_FRAME_SAMPLES)
+    return 0;
+
+  std::size_t payload = sonarFramePayloadBytes(&h);
+  if (payload > SONAR_FRAME_PAYLOAD_BYTES)
+    return 0;
+  return SONAR_FRAME_HEADER_BYTES + payload;
+}
+
+SonarFrameDecoder::SonarFrameDecoder()
+{
+  _bufLen = 0;
+  _emitted = false;
+  memset(&_header, 0, sizeof(_header));
+  _frameLen = 0;
+  _haveSeq = false;
+  _nextSeq = 0;
+  _gap = 0;
+  memset(&_stats, 0, sizeof(_stats));
+}
+
+void SonarFrameDecoder::restart(uint32_t firstSeq)
+{
+  reset();
+  _haveSeq = true;
+  _nextSeq = firstSeq;
+  _gap = 0;
+  memset(&_stats, 0, sizeof(_stats));
+}
+
+void SonarFrameDecoder::reset()
+{
+  _bufLen = 0;
+  _emitted = false;
+}
+
+SonarFrameDecoder::frame_check_t SonarFrameDecoder::check(const uint8_t* p, std::size_t len)
+{
+  SonarFrameHeader h;
+  memcpy(&h, p, sizeof(h));
+
+  uint32_t crc = sonarCRC32(0, p, SONAR_FRAME_CRC_OFFSET);
+  crc = sonarCRC32(crc, p + SONAR_FRAME_HEADER_BYTES, len - SONAR_FRAME_HEADER_BYTES);
+  if (crc != h.crc) {
+    _stats.crc_errors++;
+    return FRAME_BAD;
+  }
+
+  // left unread, a frame with mismatched ears shows up as part of the next gap
+  if (h.seq != h.seq_adc1) {
+    _stats.ear_mismatches++;
+    return FRAME_SKIP;
+  }
+
+  if (!_haveSeq) {
+    _haveSeq = true;
+    _nextSeq = h.seq;
+  }
+
+  // a sequence number going backwards means the listener started counting again
+  int32_t gap = (int32_t)(h.seq - _nextSeq);
+  _gap = gap > 0 ? (uint32_t)gap : 0;
+  _nextSeq = h.seq + 1;
+
+  _stats.frames++;
+  _stats.missed_frames += _gap;
+  if ((h.flags & SONAR_FRAME_FLAG_SAME_COUNT) == 0)
+    _stats.unmatched_frames++;
+  _header = h;
+  _frameLen = len;
+  return FRAME_GOOD;
+}
+
+void SonarFrameDecoder::resync()
+{
+  std::size_t drop = 0;
+  while (drop < _bufLen && !magicPrefix(_buf + drop, _bufLen - drop))
+    drop += skipToCandidate(_buf + drop, _bufLen - drop);
+
+  memmove(_buf, _buf + drop, _bufLen - drop);
+  _bufLen -= drop;
+  _stats.bytes_dropped += drop;
+}
+
+std::size_t SonarFrameDecoder::feed(const uint8_t* data, std::size_t len, const uint8_t** frame)
+{
+  *frame = NULL;
+  if (_emitted) {
+    // a short frame found while resyncing can have the start of the next one behind it
+    _bufLen -= _frameLen;
+    memmove(_buf, _buf + _frameLen, _bufLen);
+    _emitted = false;
+    resync();
+  }
+
+  std::size_t used = 0;
+  while (true) {
+    if (_bufLen > 0) {
+      // finish the frame started in an earlier chunk, its length is known once the header is in
+      std::size_t want = _bufLen < SONAR_FRAME_HEADER_BYTES ? SONAR_FRAME_HEADER_BYTES : frameLength(_buf);
+      if (want == 0) {
+        memmove(_buf, _buf + 1, --_bufLen);
+        _stats.bytes_dropped++;
+        resync();
+        continue;
+      }
+
+      if (_bufLen < want) {
+        std::size_t n = want - _bufLen;
+        if (n > len - used)
+          n = len - used;
+        memcpy(_buf + _bufLen, data + used, n);
+        _bufLen += n;
+        used += n;
+
+        if (_bufLen < want) {
+          if (magicPrefix(_buf, _bufLen))
+            return used;
+          resync();
+        }
+        continue;
+      }
+
+      frame_check_t c = check(_buf, want);
+      if (c == FRAME_GOOD) {
+        _emitted = true;
+        *frame = _buf;
+        return used;
+      }
+
+      if (c == FRAME_SKIP) {
+        _bufLen -= want;
+        memmove(_buf, _buf + want, _bufLen);
+        resync();
+      } else {
+        // search again from the byte after the bad magic
+        memmove(_buf, _buf + 1, --_bufLen);
+        _stats.bytes_dropped++;
+        resync();
+      }
+      continue;
+    }
+
+    // nothing buffered, look for frames in place
+    while (used < len) {
+      const uint8_t* p = data + used;
+      std::size_t avail = len - used;
+
+      if (!magicPrefix(p, avail)) {
+        std::size_t skip = skipToCandidate(p, avail);
+        _stats.bytes_dropped += skip;
+        used += skip;
+        continue;
+      }
+      if (avail < SONAR_FRAME_HEADER_BYTES)
+        break;
+
+      std::size_t flen = frameLength(p);
+      if (flen == 0) {
+        _stats.bytes_dropped++;
+        used++;
+        continue;
+      }
+      if (avail < flen)
+        break;
+
+      frame_check_t c = check(p, flen);
+      if (c == FRAME_GOOD) {
+        *frame = p;
+        return used + flen;
+      }
+      if (c == FRAME_SKIP) {
+        used += flen;
+      } else {
+        _stats.bytes_dropped++;
+        used++;
+      }
+    }
+
+    // keep the start of a frame for the next chunk
+    memcpy(_buf, data + used, len - used);
+    _bufLen = len - used;
+    return len;
+  }
+}
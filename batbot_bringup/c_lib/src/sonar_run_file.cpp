@@ -0,0 +1,336 @@
+#include <chrono>
+#include <cstring>
+#include <string.h>
+#include <iostream>
+
+#include "sonar_run_file.hpp"
+
+uint64_t sonarRunRecordSize(std::size_t samplesPerEar)
+{
+  uint64_t size = sizeof(SonarPingHeader) + 4 * (uint64_t)samplesPerEar;
+  return (size + SONAR_RUN_ALIGN - 1) / SONAR_RUN_ALIGN * SONAR_RUN_ALIGN;
+}
+
+/*
+ * A record is only trusted if its header is self consistent and it ends inside the file
+ */
+static bool validRecord(const uint8_t* data, std::size_t size, uint64_t offset, const SonarPingHeader** ping)
+{
+  if (offset + sizeof(SonarPingHeader) > size)
+    return false;
+
+  const SonarPingHeader* h = (const SonarPingHeader*)(data + offset);
+  if (h->magic != SONAR_RUN_PING_MAGIC || h->header_size != sizeof(SonarPingHeader))
+    return false;
+  if (h->record_size != sonarRunRecordSize(h->samples_per_ear) || offset + h->record_size > size)
+    return false;
+
+  *ping = h;
+  return true;
+}
+
+int sonarRunReadIndex(const uint8_t* data, std::size_t size, std::vector<SonarRunIndexEntry>* index,
+                      uint64_t* end)
+{
+  index->clear();
+
+  const SonarRunFileHeader* fh = (const SonarRunFileHeader*)data;
+  if (size < sizeof(SonarRunFileHeader) || memcmp(fh->magic, SONAR_RUN_MAGIC, 8) != 0 ||
+      fh->version != SONAR_RUN_VERSION || fh->header_size != sizeof(SonarRunFileHeader))
+    return -1;
+
+  // the footer, if the writer got to close the run
+  if (size >= sizeof(SonarRunFileHeader) + sizeof(SonarRunTrailer)) {
+    const SonarRunTrailer* t = (const SonarRunTrailer*)(data + size - sizeof(SonarRunTrailer));
+    uint64_t index_bytes = t->num_pings * sizeof(SonarRunIndexEntry);
+
+    if (memcmp(t->magic, SONAR_RUN_INDEX_MAGIC, 8) == 0 &&
+        t->index_offset >= sizeof(SonarRunFileHeader) &&
+        t->index_offset + index_bytes + sizeof(SonarRunTrailer) == size) {
+      const SonarRunIndexEntry* e = (const SonarRunIndexEntry*)(data + t->index_offset);
+      bool ok = true;
+      for (uint64_t i = 0; i < t->num_pings && ok; ++i) {
+        const SonarPingHeader* h;
+        ok = validRecord(data, t->index_offset, e[i].offset, &h);
+      }
+      if (ok) {
+        index->assign(e, e + t->num_pings);
+        *end = t->index_offset;
+        return 1;
+      }
+    }
+  }
+
+  // no usable footer, walk the records
+  uint64_t offset = sizeof(SonarRunFileHeader);
+  const SonarPingHeader* h;
+  while (validRecord(data, size, offset, &h)) {
+    SonarRunIndexEntry e = {offset, h->timestamp_ns, h->chirp_id, h->samples_per_ear};
+    index->push_back(e);
+    offset += h->record_size;
+  }
+  *end = offset;
+  return 0;
+}
+
+static uint64_t nowNs()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+/*
+ * write() until everything is out or an error that is not an interruption
+ */
+static int writeAll(int fd, const void* data, std::size_t len)
+{
+  const uint8_t* p = (const uint8_t*)data;
+  while (len > 0) {
+    ssize_t n = write(fd, p, len);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      return -1;
+    }
+    p += n;
+    len -= n;
+  }
+  return 0;
+}
+
+SonarRunWriter::SonarRunWriter(std::string path, bool append)
+{
+  _path = path;
+  _end = 0;
+
+  _fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC | (append ? 0 : O_TRUNC), 0644);
+  if (_fd < 0) {
+    std::cout << "Error opening " << path << ": " << strerror(errno) << "\n";
+    return;
+  }
+
+  struct stat st;
+  if (fstat(_fd, &st) < 0) {
+    std::cout << "Error " << errno << " from fstat\n";
+    ::close(_fd);
+    _fd = -1;
+    return;
+  }
+
+  if (st.st_size > 0) {
+    // pick up where the run left off, dropping the old footer or a torn last record
+    void* map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, _fd, 0);
+    int ret = map == MAP_FAILED ? -1 : sonarRunReadIndex((const uint8_t*)map, st.st_size, &_index, &_end);
+    if (map != MAP_FAILED)
+      munmap(map, st.st_size);
+
+    if (ret < 0 || ftruncate(_fd, _end) < 0 || lseek(_fd, _end, SEEK_SET) < 0) {
+      std::cout << path << " is not a sonar run file\n";
+      ::close(_fd);
+      _fd = -1;
+      return;
+    }
+    return;
+  }
+
+  SonarRunFileHeader fh;
+  memset(&fh, 0, sizeof fh);
+  memcpy(fh.magic, SONAR_RUN_MAGIC, 8);
+  fh.version = SONAR_RUN_VERSION;
+  fh.header_size = sizeof(SonarRunFileHeader);
+  fh.ping_header_size = sizeof(SonarPingHeader);
+  fh.align = SONAR_RUN_ALIGN;
+  fh.created_ns = nowNs();
+
+  if (writeAll(_fd, &fh, sizeof fh) < 0) {
+    std::cout << "Error writing " << path << ": " << strerror(errno) << "\n";
+    ::close(_fd);
+    _fd = -1;
+    return;
+  }
+  _end = sizeof fh;
+}
+
+SonarRunWriter::~SonarRunWriter()
+{
+  close();
+}
+
+int SonarRunWriter::appendPing(const SonarPingInfo& info, const uint16_t* left, const uint16_t* right,
+                               std::size_t samplesPerEar)
+{
+  if (_fd < 0)
+    return -1;
+
+  SonarPingHeader h;
+  memset(&h, 0, sizeof h);
+  h.magic = SONAR_RUN_PING_MAGIC;
+  h.header_size = sizeof h;
+  h.index = _index.size();
+  h.timestamp_ns = info.timestamp_ns ? info.timestamp_ns : nowNs();
+  h.record_size = sonarRunRecordSize(samplesPerEar);
+  h.sample_rate = info.sample_rate;
+  h.chirp_id = info.chirp_id;
+  h.samples_per_ear = samplesPerEar;
+  h.num_angles = info.num_angles < SONAR_RUN_MAX_ANGLES ? info.num_angles : SONAR_RUN_MAX_ANGLES;
+  memcpy(h.angles, info.angles, h.num_angles * sizeof(int16_t));
+
+  static const uint8_t zeros[SONAR_RUN_ALIGN] = {0};
+  std::size_t pad = h.record_size - sizeof h - 4 * samplesPerEar;
+
+  // the whole record in one call, straight from the caller's arrays
+  struct iovec iov[4] = {
+    {&h, sizeof h},
+    {(void*)left, 2 * samplesPerEar},
+    {(void*)right, 2 * samplesPerEar},
+    {(void*)zeros, pad},
+  };
+  std::size_t remaining = h.record_size;
+  int first = 0;
+  while (remaining > 0) {
+    ssize_t n = writev(_fd, iov + first, 4 - first);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      std::cout << "Error writing " << _path << ": " << strerror(errno) << "\n";
+      // leave the file ending on the last whole record
+      if (ftruncate(_fd, _end) == 0)
+        lseek(_fd, _end, SEEK_SET);
+      return -1;
+    }
+    remaining -= n;
+    while (first < 4 && (std::size_t)n >= iov[first].iov_len) {
+      n -= iov[first].iov_len;
+      first++;
+    }
+    if (first < 4) {
+      iov[first].iov_base = (uint8_t*)iov[first].iov_base + n;
+      iov[first].iov_len -= n;
+    }
+  }
+
+  SonarRunIndexEntry e = {_end, h.timestamp_ns, h.chirp_id, h.samples_per_ear};
+  _index.push_back(e);
+  _end += h.record_size;
+  return 0;
+}
+
+int SonarRunWriter::sync()
+{
+  if (_fd < 0)
+    return -1;
+  return fdatasync(_fd);
+}
+
+int SonarRunWriter::close()
+{
+  if (_fd < 0)
+    return -1;
+
+  SonarRunTrailer t;
+  memset(&t, 0, sizeof t);
+  t.index_offset = _end;
+  t.num_pings = _index.size();
+  memcpy(t.magic, SONAR_RUN_INDEX_MAGIC, 8);
+
+  int ret = 0;
+  if (writeAll(_fd, _index.data(), _index.size() * sizeof(SonarRunIndexEntry)) < 0 ||
+      writeAll(_fd, &t, sizeof t) < 0) {
+    std::cout << "Error writing the index of " << _path << ": " << strerror(errno) << "\n";
+    ret = -1;
+  }
+
+  ::close(_fd);
+  _fd = -1;
+  return ret;
+}
+
+SonarRunReader::SonarRunReader(std::string path)
+{
+  _base = NULL;
+  _size = 0;
+  _indexed = false;
+
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    std::cout << "Error opening " << path << ": " << strerror(errno) << "\n";
+    return;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) < 0 || st.st_size == 0) {
+    std::cout << path << " is empty\n";
+    ::close(fd);
+    return;
+  }
+
+  void* map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (map == MAP_FAILED) {
+    std::cout << "Error " << errno << " from mmap\n";
+    return;
+  }
+
+  uint64_t end;
+  int ret = sonarRunReadIndex((const uint8_t*)map, st.st_size, &_index, &end);
+  if (ret < 0) {
+    std::cout << path << " is not a sonar run file\n";
+    munmap(map, st.st_size);
+    return;
+  }
+
+  _base = (const uint8_t*)map;
+  _size = st.st_size;
+  _indexed = ret == 1;
+}
+
+SonarRunReader::~SonarRunReader()
+{
+  if (_base != NULL)
+    munmap((void*)_base, _size);
+}
+
+const SonarPingHeader* SonarRunReader::header(std::size_t ping) const
+{
+  if (ping >= _index.size())
+    return NULL;
+  return (const SonarPingHeader*)(_base + _index[ping].offset);
+}
+
+const uint16_t* SonarRunReader::left(std::size_t ping) const
+{
+  if (ping >= _index.size())
+    return NULL;
+  return (const uint16_t*)(_base + _index[ping].offset + sizeof(SonarPingHeader));
+}
+
+const uint16_t* SonarRunReader::right(std::size_t ping) const
+{
+  const uint16_t* l = left(ping);
+  return l == NULL ? NULL : l + _index[ping].samples_per_ear;
+}
+
+std::size_t SonarRunReader::uniformStride(std::size_t first, std::size_t last) const
+{
+  if (first >= last || last > _index.size())
+    return 0;
+
+  // records are back to back, so equal sizes mean a constant stride
+  uint32_t n = _index[first].samples_per_ear;
+  for (std::size_t i = first + 1; i < last; ++i) {
+    if (_index[i].samples_per_ear != n || _index[i].offset != _index[i - 1].offset + sonarRunRecordSize(n))
+      return 0;
+  }
+  return sonarRunRecordSize(n);
+}
+
+#endif
@@ -0,0 +1,139 @@
+/**
+ * @file
+ * @brief Python bindings for the sonar run file
+ *
+ * RunWriter appends pings straight from numpy arrays. RunReader maps the file and returns
+ * read only numpy views into the mapping, which keep the reader alive as long as they
+ * are around. ears() gives a whole ping range as one (pings, samples) view per ear when
+ * the pings are the same length.
+ */
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+
+#include <cstring>
+
+#include "sonar_run_file.hpp"
+
+namespace py = pybind11;
+
+typedef py::array_t<uint16_t, py::array::c_style | py::array::forcecast> u16_array_t;
+
+static py::array read_only(py::array a)
+{
+  a.attr("setflags")(py::arg("write") = false);
+  return a;
+}
+
+static SonarRunReader& open_reader(SonarRunReader& self)
+{
+  if (!self.isOpen())
+    throw py::value_error("run file is not open");
+  return self;
+}
+
+static std::size_t check_ping(SonarRunReader& self, py::ssize_t ping)
+{
+  if (ping < 0)
+    ping += self.numPings();
+  if (ping < 0 || (std::size_t)ping >= self.numPings())
+    throw py::index_error("ping out of range");
+  return ping;
+}
+
+PYBIND11_MODULE(sonarrun, m) {
+  py::class_<SonarRunWriter>(m, "RunWriter")
+    .def(py::init<std::string, bool>(), py::arg("path"), py::arg("append") = false,
+      "Create a run file, or with append=True add to an existing one")
+    .def_property_readonly("is_open", &SonarRunWriter::isOpen)
+    .def_property_readonly("num_pings", &SonarRunWriter::numPings)
+    .def("append",
+      [](SonarRunWriter& self, u16_array_t left, u16_array_t right, uint64_t timestamp_ns,
+         uint32_t chirp_id, double sample_rate, std::vector<int16_t> angles) {
+        if (left.ndim() != 1 || right.ndim() != 1 || left.size() != right.size())
+          throw py::value_error("left and right must be 1D and the same length");
+        if (angles.size() > SONAR_RUN_MAX_ANGLES)
+          throw py::value_error("at most 16 pinna angles per ping");
+
+        SonarPingInfo info;
+        memset(&info, 0, sizeof info);
+        info.timestamp_ns = timestamp_ns;
+        info.sample_rate = sample_rate;
+        info.chirp_id = chirp_id;
+        info.num_angles = angles.size();
+        std::copy(angles.begin(), angles.end(), info.angles);
+
+        const uint16_t* l = left.data();
+        const uint16_t* r = right.data();
+        std::size_t n = left.size();
+
+        py::gil_scoped_release release;
+        return self.appendPing(info, l, r, n) == 0;
+      },
+      py::arg("left"), py::arg("right"), py::arg("timestamp_ns") = 0, py::arg("chirp_id") = 0,
+      py::arg("sample_rate") = 2e6, py::arg("angles") = std::vector<int16_t>(),
+      "Append one ping. timestamp_ns=0 stamps it now, chirp_id is the CRC32 of the chirp played, "
+      "sample_rate defaults to the listener's 2 MS/s per ear, angles are the pinna angles of both ears.")
+    .def("sync", &SonarRunWriter::sync, py::call_guard<py::gil_scoped_release>(),
+      "Flush the pings written so far to the disk")
+    .def("close", &SonarRunWriter::close, "Write the index and close the file")
+    .def("__enter__", [](SonarRunWriter& self) -> SonarRunWriter& { return self; })
+    .def("__exit__", [](SonarRunWriter& self, py::args) { self.close(); });
+
+  py::class_<SonarRunReader>(m, "RunReader")
+    .def(py::init<std::string>(), py::arg("path"), "Map a run file read only")
+    .def_property_readonly("is_open", &SonarRunReader::isOpen)
+    .def_property_readonly("indexed", &SonarRunReader::indexed,
+      "False if the run was never closed and its pings were found by walking the file")
+    .def("__len__", &SonarRunReader::numPings)
+    .def("header",
+      [](SonarRunReader& self, py::ssize_t ping) {
+        const SonarPingHeader* h = open_reader(self).header(check_ping(self, ping));
+        py::dict d;
+        d["index"] = h->index;
+        d["timestamp_ns"] = h->timestamp_ns;
+        d["sample_rate"] = h->sample_rate;
+        d["chirp_id"] = h->chirp_id;
+        d["samples_per_ear"] = h->samples_per_ear;
+        d["angles"] = std::vector<int16_t>(h->angles, h->angles + h->num_angles);
+        return d;
+      },
+      py::arg("ping"))
+    .def("ping",
+      [](py::object self_obj, py::ssize_t ping) {
+        SonarRunReader& self = open_reader(self_obj.cast<SonarRunReader&>());
+        std::size_t p = check_ping(self, ping);
+        py::ssize_t n = self.header(p)->samples_per_ear;
+        return py::make_tuple(
+          read_only(py::array_t<uint16_t>({n}, {(py::ssize_t)sizeof(uint16_t)}, self.left(p), self_obj)),
+          read_only(py::array_t<uint16_t>({n}, {(py::ssize_t)sizeof(uint16_t)}, self.right(p), self_obj)));
+      },
+      py::arg("ping"),
+      "(left, right) of one ping as read only views into the file")
+    .def("ears",
+      [](py::object self_obj, py::ssize_t start, py::object stop_obj) {
+        SonarRunReader& self = open_reader(self_obj.cast<SonarRunReader&>());
+        py::ssize_t count = self.numPings();
+        py::ssize_t stop = stop_obj.is_none() ? count : stop_obj.cast<py::ssize_t>();
+        if (start < 0)
+          start += count;
+        if (stop < 0)
+          stop += count;
+        if (start < 0 || stop > count || start >= stop)
+          throw py::index_error("empty or out of range ping range");
+
+        std::size_t stride = self.uniformStride(start, stop);
+        if (stride == 0)
+          throw py::value_error("pings in the range differ in length, use ping() for each");
+
+        py::ssize_t n = self.header(start)->samples_per_ear;
+        std::vector<py::ssize_t> shape = {stop - start, n};
+        std::vector<py::ssize_t> strides = {(py::ssize_t)stride, (py::ssize_t)sizeof(uint16_t)};
+        return py::make_tuple(
+          read_only(py::array_t<uint16_t>(shape, strides, self.left(start), self_obj)),
+          read_only(py::array_t<uint16_t>(shape, strides, self.right(start), self_obj)));
+      },
+      py::arg("start") = 0, py::arg("stop") = py::none(),
+      "(left, right) of pings [start, stop) as read only (pings, samples) views into the file");
+}
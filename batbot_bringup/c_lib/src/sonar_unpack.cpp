@@ -0,0 +1,257 @@
+#include <cstring>
+#include <string.h>
+
+#include "sonar_pack.hpp"
+#include "sonar_unpack.hpp"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define SU_HAVE_AVX2 1
+#endif
+#endif
+
+#if defined(__aarch64__) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define SU_HAVE_NEON 1
+#include <arm_neon.h>
+#endif
+
+/**
+ * @brief Gather pattern for one delta group width: the 4 bytes each value starts in
+ * and its bit offset inside them
+ */
+typedef struct {
+  uint8_t shuffle[SONAR_PACK_DELTA_GROUP][4];
+  uint32_t shift[SONAR_PACK_DELTA_GROUP];
+  uint32_t mask;
+} delta_gather_t;
+
+static const delta_gather_t* deltaGathers()
+{
+  struct Table {
+    delta_gather_t g[SONAR_PACK_DELTA_MAX_WIDTH + 1];
+    Table()
+    {
+      for (uint32_t w = 0; w <= SONAR_PACK_DELTA_MAX_WIDTH; ++w) {
+        for (uint32_t k = 0; k < SONAR_PACK_DELTA_GROUP; ++k) {
+          uint32_t bit = w * k;
+          for (uint32_t b = 0; b < 4; ++b)
+            g[w].shuffle[k][b] = (uint8_t)(bit / 8 + b);
+          g[w].shift[k] = bit % 8;
+        }
+        g[w].mask = (1u << w) - 1;
+      }
+    }
+  };
+  static const Table table;
+  return table.g;
+}
+
+/*
+ * AVX2, the PACK10 and prefix sum shuffles stay within 128 bit lanes
+ */
+
+#ifdef SU_HAVE_AVX2
+
+__attribute__((target("avx2")))
+static void unpack10AVX2(const uint8_t* in, std::size_t n, uint16_t* out)
+{
+  // sample k of 8 sits in bytes 5k/4 and 5k/4 + 1, 2 * (k % 4) bits up
+  const __m256i gather = _mm256_broadcastsi128_si256(
+    _mm_setr_epi8(0, 1, 1, 2, 2, 3, 3, 4, 5, 6, 6, 7, 7, 8, 8, 9));
+  // shift left so the sample ends at bit 15, then right by 6
+  const __m256i align = _mm256_broadcastsi128_si256(_mm_setr_epi16(64, 16, 4, 1, 64, 16, 4, 1));
+
+  // each half loads 16 bytes for the 10 it uses
+  std::size_t i = 0;
+  for (; i + 16 <= n && SONAR_PACK10_BYTES(i) + 26 <= SONAR_PACK10_BYTES(n); i += 16) {
+    const uint8_t* p = in + SONAR_PACK10_BYTES(i);
+    __m256i v = _mm256_inserti128_si256(
+      _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)p)), _mm_loadu_si128((const __m128i*)(p + 10)), 1);
+    v = _mm256_shuffle_epi8(v, gather);
+    v = _mm256_srli_epi16(_mm256_mullo_epi16(v, align), 6);
+    _mm256_storeu_si256((__m256i*)(out + i), v);
+  }
+
+  sonarPack10Decode(in + SONAR_PACK10_BYTES(i), n - i, out + i);
+}
+
+__attribute__((target("avx2")))
+static int deltaDecodeAVX2(const uint8_t* in, std::size_t len, uint16_t* out, std::size_t n)
+{
+  const delta_gather_t* gathers = deltaGathers();
+  const __m128i last_lane = _mm_set1_epi16(0x0F0E);
+  const __m256i one = _mm256_set1_epi32(1);
+
+  std::size_t groups = n / SONAR_PACK_DELTA_GROUP;
+  std::size_t pos = SONAR_PACK_DELTA_WIDTH_BYTES(n);
+  if (pos > len)
+    return -1;
+
+  __m128i prev = _mm_set1_epi16(SONAR_PACK_DELTA_START);
+  for (std::size_t g = 0; g < groups; ++g, out += SONAR_PACK_DELTA_GROUP) {
+    uint32_t w = (in[g / 2] >> (4 * (g & 1))) & 0xF;
+    if (w > SONAR_PACK_DELTA_MAX_WIDTH || pos + w > len)
+      return -1;
+    const delta_gather_t& gather = gathers[w];
+
+    // the gather reads up to 16 bytes, copy the last groups out so it stays in bounds
+    __m128i bytes;
+    if (pos + 16 <= len) {
+      bytes = _mm_loadu_si128((const __m128i*)(in + pos));
+    } else {
+      uint8_t tail[16] = {0};
+      memcpy(tail, in + pos, w);
+      bytes = _mm_loadu_si128((const __m128i*)tail);
+    }
+    pos += w;
+
+    // the shuffle works per 128 bit lane, values 0-3 come from the low copy, 4-7 from the high
+    __m256i v = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(bytes),
+                                    _mm256_loadu_si256((const __m256i*)gather.shuffle));
+    v = _mm256_srlv_epi32(v, _mm256_loadu_si256((const __m256i*)gather.shift));
+    v = _mm256_and_si256(v, _mm256_set1_epi32((int)gather.mask));
+
+    // zigzag back to signed
+    v = _mm256_xor_si256(_mm256_srli_epi32(v, 1), _mm256_sub_epi32(_mm256_setzero_si256(), _mm256_and_si256(v, one)));
+    __m128i d = _mm_packs_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+
+    d = _mm_add_epi16(d, _mm_slli_si128(d, 2));
+    d = _mm_add_epi16(d, _mm_slli_si128(d, 4));
+    d = _mm_add_epi16(d, _mm_slli_si128(d, 8));
+    d = _mm_add_epi16(d, prev);
+    _mm_storeu_si128((__m128i*)out, d);
+    prev = _mm_shuffle_epi8(d, last_lane);
+  }
+  return (int)pos;
+}
+
+#endif
+
+/*
+ * NEON, needs the AArch64 table lookups
+ */
+
+#ifdef SU_HAVE_NEON
+
+static void unpack10NEON(const uint8_t* in, std::size_t n, uint16_t* out)
+{
+  static const uint8_t gather_bytes[16] = {0, 1, 1, 2, 2, 3, 3, 4, 5, 6, 6, 7, 7, 8, 8, 9};
+  static const int16_t shifts[8] = {0, -2, -4, -6, 0, -2, -4, -6};
+  const uint8x16_t gather = vld1q_u8(gather_bytes);
+  const int16x8_t shift = vld1q_s16(shifts);
+  const uint16x8_t mask = vdupq_n_u16(0x3FF);
+
+  std::size_t i = 0;
+  for (; i + 8 <= n && SONAR_PACK10_BYTES(i) + 16 <= SONAR_PACK10_BYTES(n); i += 8) {
+    uint8x16_t v = vqtbl1q_u8(vld1q_u8(in + SONAR_PACK10_BYTES(i)), gather);
+    vst1q_u16(out + i, vandq_u16(vshlq_u16(vreinterpretq_u16_u8(v), shift), mask));
+  }
+
+  sonarPack10Decode(in + SONAR_PACK10_BYTES(i), n - i, out + i);
+}
+
+static int deltaDecodeNEON(const uint8_t* in, std::size_t len, uint16_t* out, std::size_t n)
+{
+  const delta_gather_t* gathers = deltaGathers();
+  const uint16x8_t zero = vdupq_n_u16(0);
+
+  std::size_t groups = n / SONAR_PACK_DELTA_GROUP;
+  std::size_t pos = SONAR_PACK_DELTA_WIDTH_BYTES(n);
+  if (pos > len)
+    return -1;
+
+  uint16x8_t prev = vdupq_n_u16(SONAR_PACK_DELTA_START);
+  for (std::size_t g = 0; g < groups; ++g, out += SONAR_PACK_DELTA_GROUP) {
+    uint32_t w = (in[g / 2] >> (4 * (g & 1))) & 0xF;
+    if (w > SONAR_PACK_DELTA_MAX_WIDTH || pos + w > len)
+      return -1;
+    const delta_gather_t& gather = gathers[w];
+
+    uint8x16_t bytes;
+    if (pos + 16 <= len) {
+      bytes = vld1q_u8(in + pos);
+    } else {
+      uint8_t tail[16] = {0};
+      memcpy(tail, in + pos, w);
+      bytes = vld1q_u8(tail);
+    }
+    pos += w;
+
+    uint32x4_t lo = vreinterpretq_u32_u8(vqtbl1q_u8(bytes, vld1q_u8(gather.shuffle[0])));
+    uint32x4_t hi = vreinterpretq_u32_u8(vqtbl1q_u8(bytes, vld1q_u8(gather.shuffle[4])));
+    int32x4_t shift_lo = vnegq_s32(vreinterpretq_s32_u32(vld1q_u32(gather.shift)));
+    int32x4_t shift_hi = vnegq_s32(vreinterpretq_s32_u32(vld1q_u32(gather.shift + 4)));
+    uint32x4_t mask = vdupq_n_u32(gather.mask);
+    lo = vandq_u32(vshlq_u32(lo, shift_lo), mask);
+    hi = vandq_u32(vshlq_u32(hi, shift_hi), mask);
+
+    // zigzag back to signed, 16 bits are enough from here on
+    uint16x8_t zz = vcombine_u16(vmovn_u32(lo), vmovn_u32(hi));
+    uint16x8_t d = veorq_u16(vshrq_n_u16(zz, 1), vsubq_u16(zero, vandq_u16(zz, vdupq_n_u16(1))));
+
+    d = vaddq_u16(d, vextq_u16(zero, d, 7));
+    d = vaddq_u16(d, vextq_u16(zero, d, 6));
+    d = vaddq_u16(d, vextq_u16(zero, d, 4));
+    d = vaddq_u16(d, prev);
+    vst1q_u16(out, d);
+    prev = vdupq_laneq_u16(d, 7);
+  }
+  return (int)pos;
+}
+
+#endif
+
+int sonarUnpackEar(uint16_t flags, const uint8_t* in, std::size_t len, uint16_t* out, std::size_t n, lr_isa_t isa)
+{
+  if (isa == LR_ISA_AUTO)
+    isa = lrBestIsa();
+  if (!lrIsaAvailable(isa) || n % 8 != 0)
+    return -1;
+
+  if (flags & SONAR_FRAME_FLAG_DELTA) {
+    switch (isa) {
+#ifdef SU_HAVE_AVX2
+      case LR_ISA_AVX2: return deltaDecodeAVX2(in, len, out, n);
+#endif
+#ifdef SU_HAVE_NEON
+      case LR_ISA_NEON: return deltaDecodeNEON(in, len, out, n);
+#endif
+      default: return sonarDeltaDecode(in, len, out, n);
+    }
+  }
+
+  if (flags & SONAR_FRAME_FLAG_PACK10) {
+    if (len < SONAR_PACK10_BYTES(n))
+      return -1;
+    switch (isa) {
+#ifdef SU_HAVE_AVX2
+      case LR_ISA_AVX2: unpack10AVX2(in, n, out); break;
+#endif
+#ifdef SU_HAVE_NEON
+      case LR_ISA_NEON: unpack10NEON(in, n, out); break;
+#endif
+      default: sonarPack10Decode(in, n, out); break;
+    }
+    return (int)SONAR_PACK10_BYTES(n);
+  }
+
+  // the listener and every host this runs on are little endian
+  if (len < 2 * n)
+    return -1;
+  memcpy(out, in, 2 * n);
+  return (int)(2 * n);
+}
+
+int sonarUnpackFrame(const SonarFrameHeader* header, const uint8_t* payload, uint16_t* first, uint16_t* second,
+                     lr_isa_t isa)
+{
+  std::size_t len = sonarFramePayloadBytes(header);
+  int a = sonarUnpackEar(header->flags, payload, len, first, header->count, isa);
+  if (a < 0)
+    return -1;
+  int b = sonarUnpackEar(header->flags, payload + a, len - a, second, header->count, isa);
+  if (b < 0 || (std::size_t)(a + b) != len)
+    return -1;
+  return 0;
+}
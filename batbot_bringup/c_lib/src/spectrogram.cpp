@@ -0,0 +1,151 @@
+#include <cmath>
+#include <stdexcept>
+
+#include "spectrogram.hpp"
+
+Spectrogram::Spectrogram(double fs, std::size_t nfft, std::size_t noverlap, double fmin, double fmax,
+                         std::size_t numThreads)
+  : _fft(nfft), _pool(numThreads)
+{
+  if (noverlap >= nfft)
+    throw std::invalid_argument("Spectrogram noverlap must be below nfft");
+
+  _fs = fs;
+  _nfft = nfft;
+  _noverlap = noverlap;
+
+  // same bin selection as plot_spec, the first bin at or above fmin up to the last at or below fmax
+  std::size_t bins = _fft.numBins();
+  _firstBin = 0;
+  while (_firstBin < bins && _firstBin * fs / nfft < fmin)
+    _firstBin++;
+  _lastBin = _firstBin;
+  while (_lastBin < bins && _lastBin * fs / nfft <= fmax)
+    _lastBin++;
+
+  std::vector<float> hann(nfft);
+  for (std::size_t i = 0; i < nfft; ++i)
+    hann[i] = (float)(0.5 - 0.5 * cos(2.0 * M_PI * i / (nfft - 1)));
+  setWindow(hann.data());
+
+  _frame.resize(_pool.size(), std::vector<float>(nfft));
+  _spectrum.resize(_pool.size(), std::vector<cfloat_t>(_fft.numBins()));
+  _scratch.resize(_pool.size(), std::vector<cfloat_t>(_fft.scratchLen()));
+}
+
+void Spectrogram::setWindow(const float* window)
+{
+  _window.assign(window, window + _nfft);
+
+  double power = 0;
+  for (float w : _window)
+    power += (double)w * w;
+
+  // mlab's psd scaling, |X|^2 / (fs * sum(w^2)), with everything but DC and Nyquist doubled
+  _binScale.resize(numBins());
+  for (std::size_t i = 0; i < numBins(); ++i) {
+    std::size_t k = _firstBin + i;
+    double scale = 1.0 / (_fs * power);
+    if (k != 0 && k != _nfft / 2)
+      scale *= 2;
+    _binScale[i] = (float)scale;
+  }
+}
+
+std::size_t Spectrogram::numFrames(std::size_t numSamples) const
+{
+  if (numSamples < _nfft)
+    return 0;
+  return (numSamples - _noverlap) / step();
+}
+
+template <typename T>
+void Spectrogram::computeFrame(const T* in, float mean, std::size_t frame, std::size_t numFrames,
+                               float* out, std::size_t worker)
+{
+  float* x = _frame[worker].data();
+  cfloat_t* X = _spectrum[worker].data();
+  const T* src = in + frame * step();
+
+  for (std::size_t i = 0; i < _nfft; ++i)
+    x[i] = ((float)src[i] - mean) * _window[i];
+
+  _fft.forward(x, X, _scratch[worker].data());
+
+  for (std::size_t i = 0; i < numBins(); ++i) {
+    cfloat_t v = X[_firstBin + i];
+    float p = (v.real() * v.real() + v.imag() * v.imag()) * _binScale[i];
+    if (p < SPECTROGRAM_MIN_POWER)
+      p = SPECTROGRAM_MIN_POWER;
+    out[i * numFrames + frame] = 20.0f * log10f(p);
+  }
+}
+
+template <typename T>
+int Spectrogram::computeEars(const T* left, const T* right, std::size_t numSamples,
+                             float* leftDB, float* rightDB, bool removeDC,
+                             std::size_t timeOffset, float dBRange)
+{
+  if (timeOffset > numSamples)
+    return -1;
+  std::size_t frames = numFrames(numSamples - timeOffset);
+  if (frames == 0)
+    return -1;
+
+  const int ears = right != NULL ? 2 : 1;
+  const T* in[2] = {left, right};
+  float* out[2] = {leftDB, rightDB};
+  float mean[2] = {0, 0};
+
+  if (removeDC) {
+    for (int e = 0; e < ears; ++e) {
+      double sum = 0;
+      for (std::size_t i = 0; i < numSamples; ++i)
+        sum += in[e][i];
+      mean[e] = (float)(sum / numSamples);
+    }
+  }
+
+  // one task is a run of frames of one ear
+  std::size_t tasks_per_ear = (frames + SPECTROGRAM_FRAMES_PER_TASK - 1) / SPECTROGRAM_FRAMES_PER_TASK;
+  _pool.run(ears * tasks_per_ear, [&](std::size_t task, std::size_t worker) {
+    int e = (int)(task / tasks_per_ear);
+    std::size_t first = (task % tasks_per_ear) * SPECTROGRAM_FRAMES_PER_TASK;
+    std::size_t last = first + SPECTROGRAM_FRAMES_PER_TASK;
+    if (last > frames)
+      last = frames;
+
+    for (std::size_t f = first; f < last; ++f)
+      computeFrame(in[e] + timeOffset, mean[e], f, frames, out[e], worker);
+  });
+
+  if (dBRange > 0) {
+    std::size_t n = numBins() * frames;
+    for (int e = 0; e < ears; ++e) {
+      float peak = out[e][0];
+      for (std::size_t i = 1; i < n; ++i)
+        peak = out[e][i] > peak ? out[e][i] : peak;
+
+      for (std::size_t i = 0; i < n; ++i) {
+        float v = out[e][i] - peak;
+        out[e][i] = v < -dBRange ? -dBRange : v;
+      }
+    }
+  }
+
+  return 0;
+}
+
+int Spectrogram::compute(const float* left, const float* right, std::size_t numSamples,
+                         float* leftDB, float* rightDB, bool removeDC,
+                         std::size_t timeOffset, float dBRange)
+{
+  return computeEars(left, right, numSamples, leftDB, rightDB, removeDC, timeOffset, dBRange);
+}
+
+int Spectrogram::compute(const uint16_t* left, const uint16_t* right, std::size_t numSamples,
+                         float* leftDB, float* rightDB, bool removeDC,
+                         std::size_t timeOffset, float dBRange)
+{
+  return computeEars(left, right, numSamples, leftDB, rightDB, removeDC, timeOffset, dBRange);
+}
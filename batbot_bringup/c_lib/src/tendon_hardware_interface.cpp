@@ -1,20 +1,30 @@
 #include "iostream"
-
-#include <pybind11/pybind11.h>
+#include <cstring>
 
 #include "tendon_hardware_interface.hpp"
+#include "tendon_crc16.hpp"
 #include "serial_object_uart_linux.hpp"
 #include "serial_object_uart_win.hpp"
 
 #define COMM_BAUD 115200
 
-namespace py = pybind11;
-
 TendonHardwareInterface::TendonHardwareInterface(std::string portName) {
+    rx_len = 0;
+    rx_seq = -1;
+    tx_seq = 0;
+    tendonDecoderInit(&decoder, CRC16);
+    in_flight = 0;
+    window_size = 1;
+    timeouts = 0;
+    for (std::size_t i = 0; i < 256; ++i)
+        pending[i].state = REQUEST_FREE;
+
     #ifdef __linux__
         ser = new SerialObject_UART_Linux(portName);
         ((SerialObject_UART_Linux *)ser)->set_attributes(COMM_BAUD, 1);
-        ((SerialObject_UART_Linux *)ser)->enable_blocking(true);
+        // reads return as soon as anything arrives, or after the 0.5 s timeout if nothing
+        // does, so a lost response cannot hang the pipeline
+        ((SerialObject_UART_Linux *)ser)->enable_blocking(false);
     #endif
 }
 
@@ -23,84 +33,58 @@ TendonHardwareInterface::~TendonHardwareInterface() {
     delete ser;
 }
 
-uint16_t TendonHardwareInterface::CRC16(uint16_t crc_accum, uint8_t *data, uint16_t data_blk_size)
+uint16_t TendonHardwareInterface::CRC16(uint16_t crc_accum, const uint8_t *data, uint16_t data_blk_size)
 {
-    uint16_t i, j;
-    static const uint16_t crc_table[256] = { 0x0000,
-        0x8005, 0x800F, 0x000A, 0x801B, 0x001E, 0x0014, 0x8011,
-        0x8033, 0x0036, 0x003C, 0x8039, 0x0028, 0x802D, 0x8027,
-        0x0022, 0x8063, 0x0066, 0x006C, 0x8069, 0x0078, 0x807D,
-        0x8077, 0x0072, 0x0050, 0x8055, 0x805F, 0x005A, 0x804B,
-        0x004E, 0x0044, 0x8041, 0x80C3, 0x00C6, 0x00CC, 0x80C9,
-        0x00D8, 0x80DD, 0x80D7, 0x00D2, 0x00F0, 0x80F5, 0x80FF,
-        0x00FA, 0x80EB, 0x00EE, 0x00E4, 0x80E1, 0x00A0, 0x80A5,
-        0x80AF, 0x00AA, 0x80BB, 0x00BE, 0x00B4, 0x80B1, 0x8093,
-        0x0096, 0x009C, 0x8099, 0x0088, 0x808D, 0x8087, 0x0082,
-        0x8183, 0x0186, 0x018C, 0x8189, 0x0198, 0x819D, 0x8197,
-        0x0192, 0x01B0, 0x81B5, 0x81BF, 0x01BA, 0x81AB, 0x01AE,
-        0x01A4, 0x81A1, 0x01E0, 0x81E5, 0x81EF, 0x01EA, 0x81FB,
-        0x01FE, 0x01F4, 0x81F1, 0x81D3, 0x01D6, 0x01DC, 0x81D9,
-        0x01C8, 0x81CD, 0x81C7, 0x01C2, 0x0140, 0x8145, 0x814F,
-        0x014A, 0x815B, 0x015E, 0x0154, 0x8151, 0x8173, 0x0176,
-        0x017C, 0x8179, 0x0168, 0x816D, 0x8167, 0x0162, 0x8123,
-        0x0126, 0x012C, 0x8129, 0x0138, 0x813D, 0x8137, 0x0132,
-        0x0110, 0x8115, 0x811F, 0x011A, 0x810B, 0x010E, 0x0104,
-        0x8101, 0x8303, 0x0306, 0x030C, 0x8309, 0x0318, 0x831D,
-        0x8317, 0x0312, 0x0330, 0x8335, 0x833F, 0x033A, 0x832B,
-        0x032E, 0x0324, 0x8321, 0x0360, 0x8365, 0x836F, 0x036A,
-        0x837B, 0x037E, 0x0374, 0x8371, 0x8353, 0x0356, 0x035C,
-        0x8359, 0x0348, 0x834D, 0x8347, 0x0342, 0x03C0, 0x83C5,
-        0x83CF, 0x03CA, 0x83DB, 0x03DE, 0x03D4, 0x83D1, 0x83F3,
-        0x03F6, 0x03FC, 0x83F9, 0x03E8, 0x83ED, 0x83E7, 0x03E2,
-        0x83A3, 0x03A6, 0x03AC, 0x83A9, 0x03B8, 0x83BD, 0x83B7,
-        0x03B2, 0x0390, 0x8395, 0x839F, 0x039A, 0x838B, 0x038E,
-        0x0384, 0x8381, 0x0280, 0x8285, 0x828F, 0x028A, 0x829B,
-        0x029E, 0x0294, 0x8291, 0x82B3, 0x02B6, 0x02BC, 0x82B9,
-        0x02A8, 0x82AD, 0x82A7, 0x02A2, 0x82E3, 0x02E6, 0x02EC,
-        0x82E9, 0x02F8, 0x82FD, 0x82F7, 0x02F2, 0x02D0, 0x82D5,
-        0x82DF, 0x02DA, 0x82CB, 0x02CE, 0x02C4, 0x82C1, 0x8243,
-        0x0246, 0x024C, 0x8249, 0x0258, 0x825D, 0x8257, 0x0252,
-        0x0270, 0x8275, 0x827F, 0x027A, 0x826B, 0x026E, 0x0264,
-        0x8261, 0x0220, 0x8225, 0x822F, 0x022A, 0x823B, 0x023E,
-        0x0234, 0x8231, 0x8213, 0x0216, 0x021C, 0x8219, 0x0208,
-        0x820D, 0x8207, 0x0202 
-    };
-
-    for (j = 0; j < data_blk_size; j++)
-    {
-        i = ((uint16_t)(crc_accum >> 8) ^ *data++) & 0xFF;
-        crc_accum = (crc_accum << 8) ^ crc_table[i];
-    }
-
-    return crc_accum;
+    return tendonCRC16Slice8(crc_accum, data, data_blk_size);
 }
 
-void TendonHardwareInterface::BuildPacket(uint8_t id, uint8_t opcode, uint8_t* params, std::size_t num_params)
+void TendonHardwareInterface::BuildPacket(uint8_t id, uint8_t opcode, const uint8_t* params, std::size_t num_params)
 {
     tx.data_packet_u.data_packet_s.header[0] = 0xFF;
     tx.data_packet_u.data_packet_s.header[1] = 0x00;
-    tx.data_packet_u.data_packet_s.len = num_params + TENDON_CONTROL_PKT_NUM_CRC_BYTES + TENDON_CONTROL_PKT_NUM_ID_BYTES + TENDON_CONTROL_PKT_NUM_OPCODE_BYTES;
+    tx.data_packet_u.data_packet_s.len = num_params + TENDON_CONTROL_PKT_LEN_OVERHEAD;
+    tx.data_packet_u.data_packet_s.seq = tx_seq++;
     tx.data_packet_u.data_packet_s.motorId = id; 
     tx.data_packet_u.data_packet_s.opcode = (uint8_t)opcode;
 
-    int i = 0;
-    for (; i < num_params; ++i) {
-        tx.data_packet_u.data_packet_s.pkt_params[i] = params[i];
+    // params written straight into TxParams() are already in place
+    if (params != tx.data_packet_u.data_packet_s.pkt_params) {
+        memcpy(tx.data_packet_u.data_packet_s.pkt_params, params, num_params);
     }
+    std::size_t i = num_params;
 
-    uint16_t rx_crc = CRC16(0, tx.data_packet_u.data_packet, num_params + 5);
+    uint16_t rx_crc = CRC16(0, tx.data_packet_u.data_packet, 
+        TENDON_CONTROL_PKT_NUM_HEADER_BYTES + TENDON_CONTROL_PKT_NUM_LEN_BYTES + tx.data_packet_u.data_packet_s.len - TENDON_CONTROL_PKT_NUM_CRC_BYTES);
     tx.data_packet_u.data_packet_s.pkt_params[i] = rx_crc >> 8;
     tx.data_packet_u.data_packet_s.pkt_params[i + 1] = rx_crc & 0xFF;
 
     return;
 }
 
-void TendonHardwareInterface::SendTxRx()
+int TendonHardwareInterface::SendTxRx()
 {
-    SendTx();
+    if (in_flight > 0 && Flush() < 0) {
+        std::cout << "Warning: requests in flight before SendTxRx timed out\n";
+    }
+
+    uint8_t seq = tx.data_packet_u.data_packet_s.seq;
+    rx_seq = seq;
+    SendPending();
 
-    uint8_t buff[TENDON_CONTROL_PKT_MAX_NUM_BYTES_IN_FRAME];
-    ser->readBytes(buff, TENDON_CONTROL_PKT_MAX_NUM_BYTES_IN_FRAME);
+    while (pending[seq].state == REQUEST_IN_FLIGHT) {
+        if (Poll() < 0) {
+            rx_seq = -1;
+            return -1;
+        }
+    }
+    rx_seq = -1;
+
+    if (pending[seq].state != REQUEST_DONE)
+        return -1;
+
+    // HandleFrame copied its response into the rx buffer, and nothing after it
+    pending[seq].state = REQUEST_FREE;
+    return rx_len;
 }
 
 void TendonHardwareInterface::SendTx()
@@ -111,14 +95,146 @@ void TendonHardwareInterface::SendTx()
     //     std::cout << std::hex << int(tx.data_packet_u.data_packet[i]) << " ";
     // }
     // std::cout << "\n";
-    ser->writeBytes(tx.data_packet_u.data_packet, total_packet_len - 1);
+    ser->writeBytes(tx.data_packet_u.data_packet, total_packet_len);
 }
 
+int TendonHardwareInterface::Submit(uint8_t id, uint8_t opcode, const uint8_t* params, std::size_t num_params)
+{
+    if (num_params > TENDON_CONTROL_PKT_MAX_NUM_PARAM_BYTES - TENDON_CONTROL_PKT_NUM_CRC_BYTES) {
+        std::cout << "Error: " << num_params << " params do not fit in a packet\n";
+        return -1;
+    }
+
+    // wait for room in the window, timeouts free their slots too
+    while (in_flight >= window_size) {
+        if (Poll() < 0)
+            return -1;
+    }
+
+    BuildPacket(id, opcode, params, num_params);
+    SendPending();
+    return tx.data_packet_u.data_packet_s.seq;
+}
+
+void TendonHardwareInterface::SendPending()
+{
+    PendingRequest& req = pending[tx.data_packet_u.data_packet_s.seq];
+    if (req.state != REQUEST_IN_FLIGHT)
+        in_flight++;
+    req.state = REQUEST_IN_FLIGHT;
+    req.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(TENDON_CONTROL_REQUEST_TIMEOUT_MS);
+
+    SendTx();
+}
+
+int TendonHardwareInterface::Poll()
+{
+    int n = ser->readBytes(rx_chunk, TENDON_CONTROL_RX_CHUNK_LEN);
+    if (n < 0) {
+        std::cout << "Error reading from tendon controller\n";
+        return -1;
+    }
+
+    if (n == 0) {
+        // nothing came back within the read timeout, give up on everything outstanding
+        ExpireRequests(std::chrono::steady_clock::time_point::max());
+        // a partial frame will never be completed now
+        tendonDecoderReset(&decoder);
+        return 0;
+    }
+
+    int completed = 0;
+    const uint8_t* data = rx_chunk;
+    std::size_t len = n;
+    const uint8_t* frame = NULL;
+    std::size_t frame_len = 0;
+
+    while (len > 0 || frame != NULL) {
+        std::size_t used = tendonDecoderFeed(&decoder, data, len, &frame, &frame_len);
+        data += used;
+        len -= used;
+
+        if (frame != NULL)
+            completed += HandleFrame(frame, frame_len);
+    }
 
-PYBIND11_MODULE(tendonhardware, m) {
-    py::class_<TendonHardwareInterface>(m, "TendonHardwareInterface")
-        .def(py::init<std::string>())
-        .def("BuildPacket", &TendonHardwareInterface::BuildPacket)
-        .def("SendTxRx", &TendonHardwareInterface::SendTxRx)
-        .def("SendTx", &TendonHardwareInterface::SendTx);
-}
\ No newline at end of file
+    // bytes that never make up a response must not keep the read timeout from firing forever
+    if (in_flight > 0)
+        ExpireRequests(std::chrono::steady_clock::now());
+
+    return completed;
+}
+
+void TendonHardwareInterface::ExpireRequests(std::chrono::steady_clock::time_point now)
+{
+    for (std::size_t i = 0; i < 256 && in_flight > 0; ++i) {
+        if (pending[i].state == REQUEST_IN_FLIGHT && pending[i].deadline < now) {
+            pending[i].state = REQUEST_FAILED;
+            in_flight--;
+            timeouts++;
+        }
+    }
+}
+
+int TendonHardwareInterface::Flush()
+{
+    std::size_t timeouts_before = timeouts;
+
+    while (in_flight > 0) {
+        if (Poll() < 0)
+            return -1;
+    }
+
+    return timeouts == timeouts_before ? 0 : -1;
+}
+
+int TendonHardwareInterface::HandleFrame(const uint8_t* frame, std::size_t len)
+{
+    TendonControl_data_packet_s packet;
+    memcpy(packet.data_packet_u.data_packet, frame, len);
+
+    uint8_t seq = packet.data_packet_u.data_packet_s.seq;
+    PendingRequest& req = pending[seq];
+
+    // a response to a request that already timed out, was never sent, or a duplicate
+    if (req.state != REQUEST_IN_FLIGHT)
+        return 0;
+
+    // later frames in the same chunk must not replace what SendTxRx returns
+    if (seq == rx_seq) {
+        memcpy(rx.data_packet_u.data_packet, frame, len);
+        rx_len = len;
+    }
+
+    req.response.motorId = packet.data_packet_u.data_packet_s.motorId;
+    req.response.opcode = packet.data_packet_u.data_packet_s.opcode;
+    req.response.numParams = TENDON_CONTROL_PKT_NUM_PARAMS(packet.data_packet_u.data_packet_s.len);
+    memcpy(req.response.pkt_params, packet.data_packet_u.data_packet_s.pkt_params, req.response.numParams);
+
+    req.state = REQUEST_DONE;
+    in_flight--;
+
+    if (response_callback)
+        response_callback(seq, req.response);
+
+    return 1;
+}
+
+int TendonHardwareInterface::GetResponse(uint8_t seq, TendonHardwareResponse* response)
+{
+    if (pending[seq].state != REQUEST_DONE)
+        return -1;
+
+    *response = pending[seq].response;
+    pending[seq].state = REQUEST_FREE;
+    return 0;
+}
+
+void TendonHardwareInterface::SetWindowSize(std::size_t window)
+{
+    if (window < 1)
+        window = 1;
+    if (window > TENDON_CONTROL_MAX_WINDOW)
+        window = TENDON_CONTROL_MAX_WINDOW;
+    window_size = window;
+}
@@ -0,0 +1,144 @@
+/**
+ * @file
+ * @brief Python bindings for TendonHardwareInterface
+ *
+ * Packets are exchanged through the interface's preallocated tx/rx buffers. Parameters
+ * are read in place from any contiguous byte buffer (bytes, bytearray, memoryview, numpy
+ * uint8 arrays), lists of ints are converted once, and responses are returned as numpy
+ * views onto the rx buffer, so a control loop does not allocate or copy packet data on
+ * each call.
+ */
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "tendon_hardware_interface.hpp"
+
+namespace py = pybind11;
+
+/**
+ * @brief Contiguous uint8 array, the form anything that is not already a byte buffer is converted to
+ */
+typedef py::array_t<uint8_t, py::array::c_style | py::array::forcecast> u8_array_t;
+
+/**
+ * @brief Packet parameters handed to BuildPacket/Submit. Objects supporting the buffer protocol
+ * are used in place and must hold one byte per item in one contiguous dimension. Anything else
+ * (e.g. a list of ints) is converted once to a uint8 array.
+ */
+struct PacketParams {
+    py::buffer_info info;
+    u8_array_t converted;
+    const uint8_t* data;
+    std::size_t size;
+
+    explicit PacketParams(py::handle params) {
+        const std::size_t max = TENDON_CONTROL_PKT_MAX_NUM_PARAM_BYTES - TENDON_CONTROL_PKT_NUM_CRC_BYTES;
+        if (PyObject_CheckBuffer(params.ptr())) {
+            info = py::reinterpret_borrow<py::buffer>(params).request();
+            if (info.itemsize != 1 || info.ndim != 1 || (info.size > 1 && info.strides[0] != 1))
+                throw py::value_error("params must be a contiguous 1D buffer of single bytes");
+            data = (const uint8_t*)info.ptr;
+            size = (std::size_t)info.size;
+        } else {
+            converted = u8_array_t::ensure(params);
+            if (!converted || converted.ndim() != 1)
+                throw py::value_error("params must be a buffer or a flat sequence of ints");
+            data = converted.data();
+            size = (std::size_t)converted.size();
+        }
+        if (size > max)
+            throw py::value_error("params must be at most " + std::to_string(max) + " bytes");
+    }
+};
+
+PYBIND11_MODULE(tendonhardware, m) {
+    py::class_<TendonHardwareInterface>(m, "TendonHardwareInterface")
+        .def(py::init<std::string>())
+        .def("BuildPacket",
+            [](TendonHardwareInterface& self, uint8_t id, uint8_t opcode, py::object params) {
+                PacketParams p(params);
+                self.BuildPacket(id, opcode, p.data, p.size);
+            },
+            py::arg("id"), py::arg("opcode"), py::arg("params"),
+            "Build a packet from a byte buffer (bytes, bytearray, memoryview, uint8 numpy array) "
+            "or a list of ints")
+        .def("BuildPacketInPlace",
+            [](TendonHardwareInterface& self, uint8_t id, uint8_t opcode, std::size_t num_params) {
+                if (num_params > TENDON_CONTROL_PKT_MAX_NUM_PARAM_BYTES - TENDON_CONTROL_PKT_NUM_CRC_BYTES)
+                    throw py::value_error("too many params");
+                self.BuildPacket(id, opcode, self.TxParams(), num_params);
+            },
+            py::arg("id"), py::arg("opcode"), py::arg("num_params"),
+            "Build a packet from the first num_params bytes already written to tx_params")
+        .def_property_readonly("tx_params",
+            [](TendonHardwareInterface& self) {
+                return py::array_t<uint8_t>(
+                    {TENDON_CONTROL_PKT_MAX_NUM_PARAM_BYTES - TENDON_CONTROL_PKT_NUM_CRC_BYTES}, {1},
+                    self.TxParams(), py::cast(&self));
+            },
+            "Writable view onto the parameter section of the preallocated tx buffer")
+        .def("SendTxRx",
+            [](TendonHardwareInterface& self) {
+                py::ssize_t n;
+                {
+                    py::gil_scoped_release release;
+                    n = self.SendTxRx();
+                }
+                if (n < 0)
+                    n = 0;
+                return py::array_t<uint8_t>({n}, {1}, self.RxBuffer(), py::cast(&self));
+            },
+            "Send the tx packet and return a view of the response in the rx buffer. "
+            "The view is overwritten by the next call, copy it to keep it.")
+        .def("SendTxRxInto",
+            [](TendonHardwareInterface& self, py::buffer out) {
+                py::buffer_info info = out.request(true);
+                if (info.itemsize != 1 || info.ndim != 1 || info.strides[0] != 1)
+                    throw py::value_error("out must be a writable contiguous 1D uint8 buffer");
+
+                int n;
+                {
+                    py::gil_scoped_release release;
+                    n = self.SendTxRx();
+                }
+                if (n < 0)
+                    return -1;
+
+                std::size_t len = std::min((std::size_t)n, (std::size_t)info.size);
+                memcpy(info.ptr, self.RxBuffer(), len);
+                return (int)len;
+            },
+            py::arg("out"),
+            "Send the tx packet and copy the response into a caller owned buffer, returns the number of bytes")
+        .def("SendTx", &TendonHardwareInterface::SendTx)
+        .def("Submit",
+            [](TendonHardwareInterface& self, uint8_t id, uint8_t opcode, py::object params) {
+                PacketParams p(params);
+                py::gil_scoped_release release;
+                return self.Submit(id, opcode, p.data, p.size);
+            },
+            py::arg("id"), py::arg("opcode"), py::arg("params"),
+            "Send a request without waiting for the response, returns its sequence number or -1")
+        .def("Poll", &TendonHardwareInterface::Poll, py::call_guard<py::gil_scoped_release>(),
+            "Match whatever responses have arrived to their requests, returns the number completed")
+        .def("Flush", &TendonHardwareInterface::Flush, py::call_guard<py::gil_scoped_release>(),
+            "Wait until no request is in flight, returns -1 if any timed out")
+        .def("GetResponse",
+            [](TendonHardwareInterface& self, uint8_t seq) -> py::object {
+                TendonHardwareInterface::TendonHardwareResponse resp;
+                if (self.GetResponse(seq, &resp) < 0)
+                    return py::none();
+                return py::make_tuple(resp.motorId, resp.opcode,
+                    py::bytes((const char*)resp.pkt_params, resp.numParams));
+            },
+            py::arg("seq"),
+            "Returns (motor id, opcode, params) for a completed request, or None")
+        .def_property("window_size", &TendonHardwareInterface::GetWindowSize, &TendonHardwareInterface::SetWindowSize,
+            "Maximum number of requests in flight")
+        .def_property_readonly("in_flight", &TendonHardwareInterface::InFlight)
+        .def_property_readonly("timeouts", &TendonHardwareInterface::Timeouts);
+}
@@ -0,0 +1,568 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string.h>
+#include <iostream>
+#include <random>
+
+#include "sonar_pack.hpp"
+#include "virtual_listener.hpp"
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+
+// the Teensy 4.1 core clock the frame headers count cycles of
+#define VIRTUAL_LISTENER_CPU_HZ 600e6
+
+VirtualListenerConfig virtualListenerDefaults()
+{
+  VirtualListenerConfig config;
+  config.sampleRate = 2e6;
+  config.rateScale = 1;
+  config.pingInterval = 0.03;
+  config.triggerOffset = 0;
+  config.noise = 2;
+  // a strong target at 0.86 m a little to the left, a weak one at 2 m a little to the right
+  config.echoes.push_back({0.005, 20e-6, 200, 80e3, 30e3, 0.003});
+  config.echoes.push_back({0.012, -15e-6, 60, 80e3, 30e3, 0.003});
+  config.dropRate = 0;
+  config.corruptRate = 0;
+  // roughly what the DMA double buffer and the USB transmit buffers absorb
+  config.ringFrames = 8;
+  config.captureFrames = 2000;
+  config.seed = 1;
+  return config;
+}
+
+VirtualListener::VirtualListener(const VirtualListenerConfig& config)
+  : _config(config)
+{
+  _master = -1;
+  _slave = -1;
+  _rng = config.seed;
+  _streaming = false;
+  _seq = 0;
+  _stalled = std::chrono::steady_clock::duration::zero();
+  _triggerSample = config.triggerOffset;
+  _packing = LISTENER_PACKING_NONE;
+  _baseband = false;
+  _streamBaseband = false;
+  _capturing = false;
+  _captureFailed = false;
+  _capturePre = 0;
+  _capturePost = 0;
+  _emitterSilent = false;
+  _running = false;
+  memset(&_stats, 0, sizeof(_stats));
+
+  // one ping of both ears, echoes past the end wrap into the next ping
+  std::size_t pingLen = std::max<std::size_t>(1, (std::size_t)std::lround(config.pingInterval * config.sampleRate));
+  for (int ear = 0; ear < 2; ++ear) {
+    _ping[ear].assign(pingLen, 0.0f);
+    for (const VirtualEcho& echo : config.echoes) {
+      double start = (echo.delay + (ear ? echo.earDelay : 0)) * config.sampleRate;
+      double len = echo.duration * config.sampleRate;
+      for (int64_t i = (int64_t)std::ceil(start); i < start + len; ++i) {
+        double t = (i - start) / config.sampleRate;
+        double w = 0.5 - 0.5 * std::cos(2 * M_PI * t / echo.duration);
+        double phase = 2 * M_PI * (echo.f0 * t + 0.5 * (echo.f1 - echo.f0) / echo.duration * t * t);
+        int64_t k = ((i % (int64_t)pingLen) + (int64_t)pingLen) % (int64_t)pingLen;
+        _ping[ear][k] += (float)(echo.amplitude * w * std::sin(phase));
+      }
+    }
+  }
+
+  std::mt19937 gen(config.seed);
+  std::normal_distribution<float> normal(0.0f, (float)config.noise);
+  _noise.resize(VIRTUAL_LISTENER_NOISE_LEN);
+  for (float& v : _noise)
+    v = config.noise > 0 ? normal(gen) : 0.0f;
+
+  _ddcReady = _ddc[0].init((uint32_t)config.sampleRate) == 0 && _ddc[1].init((uint32_t)config.sampleRate) == 0;
+
+  _master = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+  if (_master < 0 || grantpt(_master) != 0 || unlockpt(_master) != 0) {
+    std::cout << "Error opening a pseudo terminal: " << strerror(errno) << "\n";
+    if (_master >= 0)
+      close(_master);
+    _master = -1;
+    return;
+  }
+  _portName = ptsname(_master);
+
+  // hold the slave open so clients can come and go without the master hanging up, and
+  // make it raw so nothing is echoed or translated before a client sets it up
+  _slave = open(_portName.c_str(), O_RDWR | O_NOCTTY | O_CLOEXEC);
+  struct termios tty;
+  if (_slave < 0 || tcgetattr(_slave, &tty) != 0) {
+    std::cout << "Error opening " << _portName << ": " << strerror(errno) << "\n";
+    if (_slave >= 0)
+      close(_slave);
+    close(_master);
+    _master = -1;
+    _slave = -1;
+    return;
+  }
+  cfmakeraw(&tty);
+  tcsetattr(_slave, TCSANOW, &tty);
+
+  fcntl(_master, F_SETFL, fcntl(_master, F_GETFL) | O_NONBLOCK);
+
+  _running = true;
+  _thread = std::thread(&VirtualListener::run, this);
+}
+
+VirtualListener::~VirtualListener()
+{
+  _running = false;
+  if (_thread.joinable())
+    _thread.join();
+
+  if (_slave >= 0)
+    close(_slave);
+  if (_master >= 0)
+    close(_master);
+}
+
+VirtualListenerStats VirtualListener::stats() const
+{
+  std::lock_guard<std::mutex> lock(_statsMutex);
+  return _stats;
+}
+
+std::vector<uint32_t> VirtualListener::lostFrames() const
+{
+  std::lock_guard<std::mutex> lock(_statsMutex);
+  return _lost;
+}
+
+std::vector<uint32_t> VirtualListener::corruptedFrames() const
+{
+  std::lock_guard<std::mutex> lock(_statsMutex);
+  return _corrupted;
+}
+
+double VirtualListener::uniform()
+{
+  // 64 bit LCG, the top 53 bits
+  _rng = _rng * 6364136223846793005ULL + 1442695040888963407ULL;
+  return (double)(_rng >> 11) / 9007199254740992.0;
+}
+
+void VirtualListener::run()
+{
+  using clock = std::chrono::steady_clock;
+  bool paced = _config.rateScale > 0;
+  auto period = std::chrono::duration_cast<clock::duration>(
+    std::chrono::duration<double>(paced ? SONAR_FRAME_SAMPLES / _config.sampleRate / _config.rateScale : 0));
+
+  _frame.resize(SONAR_FRAME_BYTES);
+
+  while (_running) {
+    // wait for a command, or until the next frame or the capture is due
+    struct timespec wait = {0, 10000000};
+    if (_streaming || _capturing) {
+      auto left = clock::duration::zero();
+      if (_capturing)
+        left = _captureDue - clock::now();
+      else if (paced)
+        left = _next - clock::now();
+      if (left < clock::duration::zero())
+        left = clock::duration::zero();
+      long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(left).count();
+      wait.tv_sec = (time_t)(ns / 1000000000);
+      wait.tv_nsec = (long)(ns % 1000000000);
+    }
+
+    struct pollfd pfd = {_master, POLLIN, 0};
+    int ret = ppoll(&pfd, 1, &wait, NULL);
+    if (ret < 0 && errno != EINTR) {
+      std::cout << "Error " << errno << " from poll\n";
+      break;
+    }
+    if (ret > 0 && (pfd.revents & POLLIN)) {
+      if (!command())
+        break;
+      continue;
+    }
+
+    if (_capturing) {
+      if (clock::now() < _captureDue)
+        continue;
+      _capturing = false;
+      if (!sendCapture())
+        break;
+      continue;
+    }
+
+    if (!_streaming)
+      continue;
+
+    auto now = clock::now();
+    if (paced && now < _next)
+      continue;
+
+    // a baseband frame spans VIRTUAL_LISTENER_IQ_BLOCKS blocks
+    auto framePeriod = _streamBaseband ? VIRTUAL_LISTENER_IQ_BLOCKS * period : period;
+
+    // the firmware's ring wraps over frames it could not send in time. Only a host that
+    // stopped reading holds the firmware up, not the emulator falling behind on its own.
+    if (paced) {
+      auto limit = (int64_t)_config.ringFrames * framePeriod;
+      if (now - _next < framePeriod)
+        _stalled = clock::duration::zero();
+      bool skipped = false;
+      while (_stalled > limit && now - _next > limit) {
+        std::lock_guard<std::mutex> lock(_statsMutex);
+        _stats.frames_overrun++;
+        _lost.push_back(_seq);
+        _seq++;
+        _next += framePeriod;
+        _stalled -= framePeriod;
+        skipped = true;
+      }
+      // as SendBaseband(), the filters start over after a gap
+      if (skipped && _streamBaseband) {
+        _ddc[0].reset();
+        _ddc[1].reset();
+      }
+    }
+
+    double elapsed = std::chrono::duration<double>(now - _start).count();
+    std::size_t len = _streamBaseband ? makeBasebandFrame(_seq, elapsed) : makeFrame(_seq, elapsed, true);
+    uint32_t seq = _seq++;
+    _next += framePeriod;
+
+    double u = uniform();
+    if (u < _config.dropRate) {
+      std::lock_guard<std::mutex> lock(_statsMutex);
+      _stats.frames_dropped++;
+      _lost.push_back(seq);
+      continue;
+    }
+    if (u < _config.dropRate + _config.corruptRate) {
+      std::size_t bit = (std::size_t)(uniform() * (len - SONAR_FRAME_HEADER_BYTES) * 8);
+      _frame[SONAR_FRAME_HEADER_BYTES + bit / 8] ^= (uint8_t)(1 << (bit % 8));
+      std::lock_guard<std::mutex> lock(_statsMutex);
+      _stats.frames_corrupted++;
+      _corrupted.push_back(seq);
+    }
+
+    if (!writeAll(_frame.data(), len))
+      break;
+
+    std::lock_guard<std::mutex> lock(_statsMutex);
+    _stats.frames_sent++;
+    _stats.bytes_sent += len;
+  }
+
+  _running = false;
+}
+
+void VirtualListener::resetStats()
+{
+  std::lock_guard<std::mutex> lock(_statsMutex);
+  memset(&_stats, 0, sizeof(_stats));
+  _lost.clear();
+  _corrupted.clear();
+}
+
+bool VirtualListener::sendCapture()
+{
+  if (_captureFailed) {
+    // the firmware gives up on the trigger and drops the capture
+    uint8_t reply = LISTENER_CMD_ERROR;
+    return writeAll(&reply, 1);
+  }
+
+  // as SendCapture() in the firmware, the frames holding the window straight from its ring
+  const uint32_t n = SONAR_FRAME_SAMPLES;
+  uint32_t start = _triggerSample - _capturePre;
+  uint32_t end = _triggerSample + _capturePost;
+
+  SonarCaptureHeader header;
+  header.magic = SONAR_CAPTURE_MAGIC;
+  header.first_seq = start / n;
+  header.num_frames = (end + n - 1) / n - header.first_seq;
+  header.window_offset = start - header.first_seq * n;
+  header.pre_samples = _capturePre;
+  header.post_samples = _capturePost;
+  header.trigger_cycles = (uint32_t)(uint64_t)(_triggerSample / _config.sampleRate * VIRTUAL_LISTENER_CPU_HZ);
+  header.crc = sonarCaptureCRC(&header);
+  if (!writeAll((const uint8_t*)&header, sizeof(header)))
+    return false;
+
+  for (uint32_t i = 0; i < header.num_frames; ++i) {
+    uint32_t seq = header.first_seq + i;
+    std::size_t len = makeFrame(seq, (double)seq * n / _config.sampleRate, false);
+    if (!writeAll(_frame.data(), len))
+      return false;
+
+    std::lock_guard<std::mutex> lock(_statsMutex);
+    _stats.frames_sent++;
+    _stats.bytes_sent += len;
+  }
+  return true;
+}
+
+bool VirtualListener::command()
+{
+  uint8_t cmd;
+  ssize_t n = read(_master, &cmd, 1);
+  if (n < 0 && (errno == EAGAIN || errno == EINTR))
+    return true;
+  if (n <= 0)
+    return n == 0;
+
+  uint8_t reply = LISTENER_CMD_NONE;
+  switch (cmd) {
+    case LISTENER_CMD_ACK_REQ:
+      _capturing = false;
+      reply = LISTENER_CMD_ACK;
+      break;
+    case LISTENER_CMD_START_LISTEN:
+      _capturing = false;
+      if (_emitterSilent) {
+        // the firmware gives up on the trigger and lowers the chirp request
+        auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(VIRTUAL_LISTENER_TRIGGER_TIMEOUT_MS);
+        while (_running && std::chrono::steady_clock::now() < until)
+          std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        reply = LISTENER_CMD_ERROR;
+        break;
+      }
+      resetStats();
+      _streaming = true;
+      _seq = 0;
+      _triggerSample = _config.triggerOffset;
+      _streamBaseband = _baseband;
+      _ddc[0].reset();
+      _ddc[1].reset();
+      _start = std::chrono::steady_clock::now();
+      _next = _start;
+      _stalled = std::chrono::steady_clock::duration::zero();
+      break;
+    case LISTENER_CMD_STOP_LISTEN:
+      _streaming = false;
+      _capturing = false;
+      break;
+    case LISTENER_CMD_PACKING:
+    {
+      uint8_t mode;
+      if (!readArg(&mode, 1) || mode > LISTENER_PACKING_DELTA) {
+        reply = LISTENER_CMD_ERROR;
+        break;
+      }
+      _packing = (listener_packing_t)mode;
+      reply = LISTENER_CMD_ACK;
+    }
+    break;
+    case LISTENER_CMD_BASEBAND:
+    {
+      // refused only if SonarDDC cannot run at the emulated rate
+      uint8_t on;
+      if (!readArg(&on, 1) || (on && !_ddcReady)) {
+        reply = LISTENER_CMD_ERROR;
+        break;
+      }
+      _baseband = on != 0;
+      reply = LISTENER_CMD_ACK;
+    }
+    break;
+    case LISTENER_CMD_CAPTURE:
+    {
+      // pre and post samples per ear, the whole window plus partial frames at either end
+      // has to fit in the capture ring
+      const uint32_t n = SONAR_FRAME_SAMPLES;
+      uint32_t window[2];
+      if (!readArg((uint8_t*)window, sizeof(window)) ||
+          (uint64_t)window[0] + window[1] + 3 * n > (uint64_t)_config.captureFrames * n) {
+        reply = LISTENER_CMD_ERROR;
+        break;
+      }
+
+      resetStats();
+      _streaming = false;
+      _capturing = true;
+      _capturePre = window[0];
+      _capturePost = window[1];
+      _captureFailed = _emitterSilent;
+
+      // the chirp is requested once the pre-trigger part is recorded and lands
+      // triggerOffset into the frame after
+      uint32_t armed = (window[0] + n - 1) / n;
+      _triggerSample = armed * n + _config.triggerOffset;
+      uint64_t frames = ((uint64_t)_triggerSample + window[1] + n - 1) / n;
+      double frameTime = _config.rateScale > 0 ? n / _config.sampleRate / _config.rateScale : 0;
+      double wait = _captureFailed ? armed * frameTime + VIRTUAL_LISTENER_TRIGGER_TIMEOUT_MS / 1e3 : frames * frameTime;
+      _captureDue = std::chrono::steady_clock::now() +
+                    std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(wait));
+    }
+    break;
+    default:
+      break;
+  }
+
+  if (reply != LISTENER_CMD_NONE)
+    return writeAll(&reply, 1);
+  return true;
+}
+
+bool VirtualListener::readArg(uint8_t* data, std::size_t len)
+{
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(ECHO_RECORDER_TIMEOUT_MS);
+  std::size_t got = 0;
+  while (got < len && _running && std::chrono::steady_clock::now() < deadline) {
+    struct pollfd pfd = {_master, POLLIN, 0};
+    if (poll(&pfd, 1, 10) <= 0)
+      continue;
+    ssize_t n = read(_master, data + got, len - got);
+    if (n > 0)
+      got += n;
+  }
+  return got == len;
+}
+
+bool VirtualListener::writeAll(const uint8_t* data, std::size_t len)
+{
+  std::size_t off = 0;
+  while (off < len) {
+    if (!_running)
+      return false;
+
+    ssize_t n = write(_master, data + off, len - off);
+    if (n > 0) {
+      off += n;
+      continue;
+    }
+    if (n < 0 && errno != EAGAIN && errno != EINTR) {
+      std::cout << "Error writing " << _portName << ": " << strerror(errno) << "\n";
+      return false;
+    }
+
+    // the host is not reading, like a stalled USB endpoint
+    auto blocked = std::chrono::steady_clock::now();
+    struct pollfd pfd = {_master, POLLOUT, 0};
+    poll(&pfd, 1, 10);
+    _stalled += std::chrono::steady_clock::now() - blocked;
+  }
+  return true;
+}
+
+void VirtualListener::makeEars(uint32_t seq, uint16_t ears[2][SONAR_FRAME_SAMPLES])
+{
+  const std::size_t n = SONAR_FRAME_SAMPLES;
+  const int64_t pingLen = (int64_t)_ping[0].size();
+
+  int64_t first = ((int64_t)seq * (int64_t)n - (int64_t)_triggerSample) % pingLen;
+  if (first < 0)
+    first += pingLen;
+
+  for (int ear = 0; ear < 2; ++ear) {
+    const float* ping = _ping[ear].data();
+    std::size_t noise = (std::size_t)(uniform() * VIRTUAL_LISTENER_NOISE_LEN);
+    int64_t k = first;
+    for (std::size_t i = 0; i < n; ++i) {
+      float v = VIRTUAL_LISTENER_MID_SCALE + ping[k] + _noise[(noise + i) % VIRTUAL_LISTENER_NOISE_LEN];
+      ears[ear][i] = (uint16_t)std::min(1023.0f, std::max(0.0f, std::nearbyint(v)));
+      if (++k == pingLen)
+        k = 0;
+    }
+  }
+}
+
+std::size_t VirtualListener::makeFrame(uint32_t seq, double elapsed, bool packed)
+{
+  const std::size_t n = SONAR_FRAME_SAMPLES;
+  uint16_t ears[2][SONAR_FRAME_SAMPLES];
+  makeEars(seq, ears);
+
+  SonarFrameHeader header;
+  memset(&header, 0, sizeof(header));
+  header.magic = SONAR_FRAME_MAGIC;
+  header.seq = seq;
+  header.seq_adc1 = seq;
+  header.cycles = (uint32_t)(uint64_t)(elapsed * VIRTUAL_LISTENER_CPU_HZ);
+  header.micros = (uint32_t)(uint64_t)(elapsed * 1e6);
+  header.count = (uint16_t)n;
+  header.version = SONAR_FRAME_VERSION;
+  header.flags = SONAR_FRAME_FLAG_SAME_COUNT;
+  if (seq == _triggerSample / n)
+    header.flags |= sonarFrameTriggerFlags(_triggerSample % n);
+
+  uint8_t* payload = &_frame[SONAR_FRAME_HEADER_BYTES];
+  if (!packed || _packing == LISTENER_PACKING_NONE) {
+    // the listener and every host this runs on are little endian
+    memcpy(payload, ears[0], 2 * n);
+    memcpy(payload + 2 * n, ears[1], 2 * n);
+    header.crc = sonarFrameCRC(&header, ears[0], ears[1]);
+    memcpy(&_frame[0], &header, sizeof(header));
+    return SONAR_FRAME_BYTES;
+  }
+
+  // as SendPacked() in the firmware, DELTA only where both ears beat PACK10
+  std::size_t budget = SONAR_PACK10_BYTES(n);
+  std::size_t len = 0;
+  if (_packing == LISTENER_PACKING_DELTA) {
+    std::size_t a = sonarDeltaEncode(ears[0], n, payload, budget);
+    std::size_t b = a ? sonarDeltaEncode(ears[1], n, payload + a, budget) : 0;
+    if (a && b) {
+      len = a + b;
+      header.flags |= SONAR_FRAME_FLAG_DELTA;
+    }
+  }
+  if (len == 0) {
+    len = sonarPack10(ears[0], n, payload);
+    len += sonarPack10(ears[1], n, payload + len);
+    header.flags |= SONAR_FRAME_FLAG_PACK10;
+  }
+  header.payload = (uint16_t)len;
+  header.crc = sonarPackedFrameCRC(&header, payload);
+  memcpy(&_frame[0], &header, sizeof(header));
+  return SONAR_FRAME_HEADER_BYTES + len;
+}
+
+std::size_t VirtualListener::makeBasebandFrame(uint32_t seq, double elapsed)
+{
+  const std::size_t n = SONAR_FRAME_SAMPLES;
+  uint16_t ears[2][SONAR_FRAME_SAMPLES];
+  int16_t iq[2][SONAR_FRAME_SAMPLES];
+
+  // as SendBaseband() in the firmware, the trigger moves to the I/Q pair whose window
+  // starts at or before it
+  uint16_t flags = SONAR_FRAME_FLAG_IQ | SONAR_FRAME_FLAG_SAME_COUNT;
+  std::size_t fill = 0;
+  for (uint32_t b = 0; b < VIRTUAL_LISTENER_IQ_BLOCKS; ++b) {
+    uint32_t block = seq * VIRTUAL_LISTENER_IQ_BLOCKS + b;
+    makeEars(block, ears);
+    if (block == _triggerSample / n)
+      flags |= sonarFrameTriggerFlags((uint32_t)(fill + 2 * (_triggerSample % n / SONAR_DDC_DECIMATION)));
+    std::size_t pairs = _ddc[0].process(ears[0], n, iq[0] + fill);
+    _ddc[1].process(ears[1], n, iq[1] + fill);
+    fill += 2 * pairs;
+  }
+
+  SonarFrameHeader header;
+  memset(&header, 0, sizeof(header));
+  header.magic = SONAR_FRAME_MAGIC;
+  header.seq = seq;
+  header.seq_adc1 = seq;
+  header.cycles = (uint32_t)(uint64_t)(elapsed * VIRTUAL_LISTENER_CPU_HZ);
+  header.micros = (uint32_t)(uint64_t)(elapsed * 1e6);
+  header.count = (uint16_t)fill;
+  header.version = SONAR_FRAME_VERSION;
+  header.flags = flags;
+  header.crc = sonarFrameCRC(&header, iq[0], iq[1]);
+
+  memcpy(&_frame[0], &header, sizeof(header));
+  memcpy(&_frame[SONAR_FRAME_HEADER_BYTES], iq[0], 2 * fill);
+  memcpy(&_frame[SONAR_FRAME_HEADER_BYTES + 2 * fill], iq[1], 2 * fill);
+  return SONAR_FRAME_HEADER_BYTES + 4 * fill;
+}
+
+#endif
@@ -0,0 +1,88 @@
+#include "worker_pool.hpp"
+
+WorkerPool::WorkerPool(std::size_t numWorkers)
+{
+  if (numWorkers == 0)
+    numWorkers = std::thread::hardware_concurrency();
+  if (numWorkers == 0)
+    numWorkers = 1;
+
+  _generation = 0;
+  _busy = 0;
+  _stop = false;
+  _fn = NULL;
+  _numTasks = 0;
+  _next = 0;
+
+  for (std::size_t i = 1; i < numWorkers; ++i)
+    _threads.emplace_back(&WorkerPool::threadLoop, this, i);
+}
+
+WorkerPool::~WorkerPool()
+{
+  {
+    std::lock_guard<std::mutex> guard(_lock);
+    _stop = true;
+  }
+  _start.notify_all();
+
+  for (std::thread& t : _threads)
+    t.join();
+}
+
+void WorkerPool::work(std::size_t worker)
+{
+  std::size_t task;
+  while ((task = _next.fetch_add(1)) < _numTasks)
+    (*_fn)(task, worker);
+}
+
+void WorkerPool::threadLoop(std::size_t worker)
+{
+  uint64_t seen = 0;
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(_lock);
+      _start.wait(lock, [&] { return _stop || _generation != seen; });
+      if (_stop)
+        return;
+      seen = _generation;
+    }
+
+    work(worker);
+
+    std::lock_guard<std::mutex> guard(_lock);
+    if (--_busy == 0)
+      _done.notify_one();
+  }
+}
+
+void WorkerPool::run(std::size_t numTasks, const task_fn_t& fn)
+{
+  if (numTasks == 0)
+    return;
+
+  // not worth waking anyone for a single task
+  if (_threads.empty() || numTasks == 1) {
+    for (std::size_t t = 0; t < numTasks; ++t)
+      fn(t, 0);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(_lock);
+    _fn = &fn;
+    _numTasks = numTasks;
+    _next = 0;
+    _busy = _threads.size();
+    _generation++;
+  }
+  _start.notify_all();
+
+  work(0);
+
+  std::unique_lock<std::mutex> lock(_lock);
+  _done.wait(lock, [&] { return _busy == 0; });
+  _fn = NULL;
+}
@@ -0,0 +1,861 @@
+/**
+ * @file
+ * @brief Golden vectors for test_chirp_synth, written by gen_chirp_synth_golden.py
+ */
+#ifndef CHIRP_SYNTH_GOLDEN_HPP
+#define CHIRP_SYNTH_GOLDEN_HPP
+
+#include <stdint.h>
+
+#include "chirp_synth.hpp"
+
+#define CHIRP_SYNTH_GOLDEN_CASES 6
+
+static const ChirpParams chirp_synth_golden_params[6] = {
+  {100000, 30000, 2000, 0, 0, 0, 512, 2048},
+  {20000, 120000, 1500, 1, 1, 0, 512, 2048},
+  {100000, 20000, 3000, 2, 2, 0, 1000, 1500},
+  {80000, 25000, 2000, 3, 3, 0, 4000, 50},
+  {30000, 150000, 1000, 2, 0, 0, 512, 2048},
+  {45000, 45000, 500, 3, 1, 0, 2047, 0},
+};
+
+// the cases back to back
+static const uint16_t chirp_synth_golden_samples[10000] = {
+  2560, 2511, 2383, 2225, 2097, 2048, 2096, 2223, 2381, 2509, 2559, 2513,
+  2386, 2229, 2100, 2048, 2092, 2217, 2374, 2504, 2559, 2518, 2395, 2239,
+  2106, 2048, 2086, 2205, 2361, 2496, 2558, 2525, 2409, 2254, 2117, 2050,
+  2077, 2189, 2343, 2483, 2556, 2535, 2428, 2275, 2133, 2054, 2067, 2168,
+  2319, 2464, 2550, 2545, 2450, 2302, 2154, 2062, 2058, 2144, 2289, 2439,
+  2540, 2553, 2476, 2335, 2183, 2075, 2050, 2118, 2254, 2408, 2523, 2559,
+  2501, 2372, 2218, 2095, 2048, 2093, 2215, 2368, 2499, 2558, 2526, 2413,
+  2261, 2124, 2052, 2070, 2172, 2322, 2465, 2549, 2546, 2456, 2311, 2164,
+  2066, 2054, 2131, 2269, 2420, 2529, 2558, 2496, 2366, 2214, 2093, 2048,
+  2093, 2212, 2364, 2495, 2558, 2530, 2423, 2274, 2135, 2055, 2063, 2156,
+  2300, 2446, 2541, 2553, 2478, 2341, 2191, 2081, 2048, 2105, 2231, 2382,
+  2506, 2559, 2523, 2411, 2261, 2126, 2053, 2067, 2162, 2307, 2450, 2543,
+  2553, 2476, 2340, 2192, 2082, 2048, 2102, 2226, 2376, 2501, 2558, 2528,
+  2421, 2274, 2136, 2057, 2061, 2148, 2289, 2434, 2535, 2557, 2493, 2364,
+  2215, 2096, 2048, 2086, 2198, 2346, 2479, 2553, 2543, 2452, 2311, 2167,
+  2070, 2051, 2117, 2246, 2394, 2512, 2559, 2521, 2410, 2264, 2130, 2055,
+  2063, 2151, 2290, 2433, 2534, 2557, 2497, 2372, 2224, 2103, 2048, 2078,
+  2183, 2327, 2463, 2547, 2550, 2472, 2338, 2193, 2084, 2048, 2095, 2211,
+  2357, 2486, 2554, 2541, 2450, 2311, 2170, 2072, 2050, 2110, 2234, 2380,
+  2501, 2558, 2532, 2432, 2291, 2153, 2064, 2053, 2123, 2251, 2396, 2511,
+  2559, 2525, 2420, 2277, 2143, 2060, 2056, 2131, 2261, 2405, 2516, 2559,
+  2521, 2413, 2270, 2138, 2059, 2057, 2134, 2265, 2408, 2518, 2559, 2520,
+  2412, 2270, 2138, 2059, 2057, 2133, 2262, 2405, 2515, 2559, 2523, 2417,
+  2276, 2144, 2061, 2055, 2126, 2253, 2395, 2509, 2559, 2529, 2429, 2290,
+  2155, 2066, 2052, 2115, 2237, 2379, 2498, 2557, 2537, 2446, 2310, 2173,
+  2075, 2049, 2100, 2214, 2356, 2481, 2552, 2547, 2467, 2337, 2197, 2090,
+  2048, 2084, 2187, 2325, 2457, 2542, 2555, 2491, 2370, 2229, 2111, 2051,
+  2067, 2155, 2288, 2425, 2526, 2559, 2516, 2409, 2270, 2141, 2061, 2054,
+  2122, 2244, 2384, 2500, 2557, 2538, 2450, 2318, 2181, 2081, 2048, 2090,
+  2195, 2333, 2462, 2544, 2554, 2491, 2372, 2233, 2115, 2052, 2064, 2146,
+  2275, 2412, 2517, 2559, 2527, 2429, 2294, 2162, 2072, 2049, 2100, 2211,
+  2349, 2473, 2548, 2552, 2483, 2363, 2225, 2110, 2051, 2065, 2148, 2276,
+  2412, 2516, 2559, 2529, 2433, 2300, 2169, 2076, 2048, 2094, 2199, 2335,
+  2461, 2543, 2556, 2497, 2383, 2246, 2126, 2056, 2057, 2128, 2248, 2384,
+  2498, 2556, 2543, 2462, 2336, 2202, 2096, 2048, 2073, 2162, 2291, 2424,
+  2522, 2559, 2525, 2429, 2297, 2168, 2076, 2048, 2091, 2193, 2326, 2453,
+  2538, 2558, 2507, 2400, 2266, 2143, 2064, 2051, 2108, 2219, 2353, 2474,
+  2547, 2553, 2491, 2377, 2243, 2126, 2057, 2056, 2122, 2238, 2372, 2487,
+  2552, 2549, 2480, 2362, 2229, 2116, 2054, 2059, 2131, 2249, 2382, 2494,
+  2554, 2547, 2474, 2355, 2222, 2112, 2053, 2061, 2134, 2253, 2385, 2495,
+  2554, 2546, 2474, 2356, 2224, 2113, 2053, 2060, 2131, 2248, 2380, 2491,
+  2553, 2549, 2479, 2364, 2233, 2120, 2056, 2057, 2122, 2236, 2367, 2481,
+  2549, 2553, 2491, 2380, 2249, 2133, 2061, 2052, 2109, 2216, 2346, 2465,
+  2542, 2557, 2506, 2403, 2275, 2153, 2071, 2048, 2092, 2190, 2317, 2440,
+  2529, 2559, 2524, 2433, 2308, 2182, 2088, 2048, 2073, 2158, 2279, 2406,
+  2508, 2557, 2542, 2467, 2350, 2221, 2114, 2054, 2058, 2123, 2234, 2362,
+  2476, 2546, 2555, 2501, 2398, 2270, 2152, 2071, 2048, 2089, 2184, 2308,
+  2431, 2523, 2559, 2532, 2449, 2329, 2203, 2102, 2051, 2062, 2133, 2246,
+  2373, 2483, 2549, 2554, 2498, 2394, 2268, 2151, 2071, 2048, 2088, 2180,
+  2303, 2425, 2518, 2559, 2537, 2459, 2343, 2217, 2113, 2054, 2056, 2118,
+  2224, 2350, 2464, 2540, 2558, 2516, 2422, 2300, 2179, 2088, 2048, 2070,
+  2147, 2262, 2387, 2491, 2551, 2552, 2494, 2391, 2267, 2151, 2072, 2048,
+  2084, 2172, 2291, 2413, 2509, 2557, 2545, 2476, 2367, 2243, 2133, 2063,
+  2050, 2095, 2190, 2311, 2430, 2519, 2559, 2539, 2464, 2352, 2229, 2123,
+  2059, 2052, 2102, 2200, 2321, 2438, 2524, 2559, 2536, 2459, 2347, 2224,
+  2120, 2058, 2052, 2104, 2201, 2321, 2438, 2523, 2559, 2537, 2461, 2350,
+  2229, 2124, 2060, 2051, 2099, 2193, 2312, 2429, 2518, 2558, 2541, 2471,
+  2363, 2242, 2135, 2065, 2049, 2089, 2178, 2294, 2412, 2506, 2555, 2548,
+  2487, 2385, 2265, 2154, 2075, 2048, 2076, 2155, 2266, 2386, 2487, 2548,
+  2556, 2508, 2415, 2298, 2182, 2093, 2050, 2062, 2127, 2230, 2349, 2458,
+  2534, 2559, 2530, 2451, 2340, 2222, 2121, 2060, 2051, 2096, 2186, 2301,
+  2417, 2508, 2555, 2549, 2490, 2391, 2273, 2162, 2082, 2048, 2069, 2139,
+  2245, 2363, 2468, 2538, 2559, 2526, 2446, 2336, 2219, 2120, 2060, 2051,
+  2095, 2182, 2296, 2410, 2503, 2553, 2552, 2499, 2405, 2290, 2178, 2092,
+  2050, 2061, 2122, 2220, 2336, 2445, 2525, 2559, 2540, 2473, 2371, 2255,
+  2149, 2075, 2048, 2073, 2145, 2249, 2365, 2468, 2537, 2559, 2529, 2453,
+  2347, 2232, 2131, 2066, 2048, 2082, 2161, 2268, 2383, 2481, 2544, 2558,
+  2522, 2441, 2333, 2220, 2123, 2062, 2049, 2087, 2168, 2276, 2390, 2486,
+  2546, 2558, 2519, 2438, 2331, 2218, 2122, 2062, 2049, 2087, 2167, 2273,
+  2386, 2483, 2544, 2558, 2523, 2445, 2339, 2227, 2129, 2065, 2048, 2080,
+  2156, 2260, 2372, 2471, 2538, 2559, 2532, 2460, 2358, 2246, 2145, 2074,
+  2048, 2070, 2137, 2235, 2347, 2450, 2526, 2559, 2543, 2482, 2388, 2277,
+  2171, 2091, 2050, 2058, 2112, 2201, 2310, 2418, 2504, 2553, 2554, 2509,
+  2426, 2319, 2210, 2118, 2061, 2049, 2084, 2160, 2263, 2373, 2470, 2536,
+  2559, 2536, 2469, 2372, 2262, 2160, 2084, 2049, 2060, 2116, 2206, 2314,
+  2420, 2504, 2552, 2555, 2512, 2431, 2327, 2219, 2126, 2065, 2048, 2076,
+  2146, 2244, 2352, 2452, 2525, 2558, 2546, 2490, 2401, 2294, 2189, 2105,
+  2056, 2051, 2091, 2169, 2270, 2378, 2472, 2536, 2559, 2538, 2474, 2381,
+  2274, 2172, 2094, 2052, 2054, 2100, 2182, 2284, 2390, 2481, 2541, 2559,
+  2533, 2467, 2373, 2267, 2167, 2091, 2051, 2055, 2102, 2184, 2286, 2391,
+  2481, 2541, 2559, 2534, 2470, 2377, 2272, 2172, 2094, 2053, 2053, 2097,
+  2175, 2275, 2380, 2472, 2535, 2559, 2541, 2482, 2393, 2290, 2188, 2106,
+  2057, 2050, 2084, 2156, 2252, 2356, 2452, 2523, 2557, 2550, 2501, 2420,
+  2320, 2217, 2128, 2069, 2048, 2069, 2128, 2217, 2319, 2419, 2500, 2549,
+  2558, 2525, 2456, 2363, 2260, 2164, 2090, 2052, 2054, 2096, 2172, 2269,
+  2372, 2463, 2529, 2558, 2547, 2497, 2415, 2316, 2215, 2128, 2069, 2048,
+  2067, 2124, 2209, 2309, 2409, 2491, 2544, 2559, 2534, 2472, 2384, 2283,
+  2186, 2107, 2059, 2049, 2079, 2144, 2234, 2335, 2431, 2507, 2551, 2557,
+  2524, 2456, 2365, 2265, 2170, 2097, 2054, 2051, 2086, 2154, 2246, 2346,
+  2439, 2512, 2553, 2556, 2520, 2452, 2361, 2261, 2168, 2095, 2054, 2051,
+  2086, 2153, 2243, 2343, 2436, 2509, 2552, 2557, 2524, 2459, 2370, 2271,
+  2178, 2103, 2057, 2049, 2078, 2141, 2227, 2325, 2420, 2497, 2546, 2559,
+  2535, 2476, 2393, 2296, 2201, 2120, 2067, 2048, 2066, 2119, 2198, 2293,
+  2389, 2473, 2533, 2559, 2548, 2502, 2427, 2335, 2238, 2151, 2086, 2051,
+  2053, 2091, 2159, 2247, 2344, 2434, 2507, 2550, 2558, 2530, 2471, 2387,
+  2292, 2199, 2120, 2067, 2048, 2064, 2114, 2190, 2282, 2377, 2462, 2525,
+  2557, 2553, 2515, 2448, 2361, 2266, 2176, 2104, 2059, 2048, 2072, 2128,
+  2208, 2301, 2394, 2475, 2532, 2558, 2550, 2507, 2438, 2350, 2255, 2168,
+  2098, 2057, 2049, 2075, 2132, 2212, 2304, 2396, 2476, 2532, 2558, 2550,
+  2509, 2441, 2354, 2261, 2173, 2103, 2059, 2048, 2070, 2123, 2200, 2291,
+  2383, 2464, 2525, 2556, 2554, 2520, 2457, 2375, 2283, 2194, 2119, 2068,
+  2048, 2061, 2105, 2175, 2261, 2353, 2438, 2506, 2548, 2559, 2537, 2485,
+  2410, 2321, 2230, 2149, 2087, 2053, 2050, 2080, 2138, 2217, 2306, 2396,
+  2473, 2529, 2557, 2553, 2518, 2456, 2375, 2285, 2197, 2123, 2071, 2048,
+  2057, 2096, 2161, 2244, 2333, 2419, 2491, 2540, 2559, 2547, 2506, 2439,
+  2356, 2267, 2182, 2112, 2065, 2048, 2061, 2104, 2171, 2253, 2342, 2427,
+  2496, 2542, 2559, 2546, 2504, 2438, 2355, 2267, 2183, 2113, 2066, 2048,
+  2059, 2100, 2164, 2245, 2333, 2417, 2488, 2537, 2559, 2550, 2513, 2451,
+  2372, 2285, 2200, 2128, 2075, 2050, 2053, 2086, 2144, 2220, 2306, 2391,
+  2467, 2523, 2554, 2557, 2531, 2478, 2406, 2322, 2236, 2158, 2096, 2058,
+  2048, 2067, 2112, 2179, 2260, 2346, 2427, 2494, 2540, 2559, 2550, 2513,
+  2453, 2376, 2291, 2208, 2135, 2081, 2052, 2050, 2077, 2128, 2199, 2281,
+  2366, 2443, 2506, 2546, 2559, 2545, 2505, 2442, 2365, 2280, 2199, 2129,
+  2078, 2051, 2051, 2079, 2131, 2201, 2282, 2366, 2442, 2504, 2545, 2559,
+  2547, 2509, 2448, 2373, 2290, 2209, 2138, 2084, 2053, 2049, 2072, 2118,
+  2184, 2263, 2346, 2424, 2490, 2536, 2558, 2554, 2523, 2471, 2400, 2320,
+  2238, 2163, 2103, 2063, 2048, 2059, 2094, 2152, 2224, 2305, 2386, 2458,
+  2514, 2549, 2559, 2544, 2504, 2444, 2370, 2289, 2210, 2140, 2087, 2055,
+  2048, 2067, 2109, 2170, 2245, 2325, 2403, 2471, 2523, 2553, 2558, 2539,
+  2496, 2435, 2361, 2281, 2203, 2135, 2084, 2054, 2048, 2067, 2109, 2170,
+  2243, 2322, 2399, 2467, 2520, 2551, 2559, 2542, 2503, 2445, 2373, 2295,
+  2217, 2148, 2094, 2059, 2048, 2060, 2096, 2151, 2220, 2297, 2375, 2445,
+  2503, 2542, 2559, 2552, 2522, 2472, 2406, 2331, 2254, 2181, 2119, 2074,
+  2051, 2050, 2073, 2117, 2177, 2250, 2327, 2401, 2467, 2518, 2550, 2559,
+  2546, 2510, 2456, 2389, 2313, 2237, 2167, 2109, 2069, 2049, 2052, 2077,
+  2122, 2184, 2255, 2331, 2405, 2469, 2519, 2550, 2559, 2546, 2512, 2460,
+  2394, 2320, 2245, 2175, 2116, 2074, 2051, 2050, 2071, 2111, 2168, 2237,
+  2311, 2385, 2452, 2506, 2542, 2559, 2554, 2527, 2482, 2422, 2352, 2278,
+  2206, 2142, 2092, 2060, 2048, 2057, 2087, 2134, 2196, 2267, 2340, 2411,
+  2472, 2520, 2550, 2559, 2548, 2517, 2468, 2406, 2335, 2262, 2193, 2132,
+  2086, 2057, 2048, 2059, 2090, 2139, 2200, 2270, 2342, 2411, 2472, 2519,
+  2549, 2559, 2550, 2520, 2474, 2414, 2346, 2274, 2205, 2143, 2094, 2062,
+  2048, 2054, 2080, 2123, 2179, 2246, 2317, 2387, 2450, 2502, 2539, 2557,
+  2557, 2537, 2499, 2446, 2383, 2313, 2243, 2178, 2122, 2080, 2054, 2048,
+  2060, 2091, 2138, 2197, 2264, 2334, 2402, 2462, 2510, 2543, 2559, 2555,
+  2533, 2494, 2441, 2378, 2310, 2241, 2177, 2122, 2081, 2055, 2048, 2059,
+  2087, 2132, 2188, 2253, 2322, 2389, 2450, 2500, 2536, 2556, 2558, 2542,
+  2509, 2461, 2402, 2337, 2269, 2203, 2145, 2098, 2065, 2049, 2051, 2070,
+  2105, 2155, 2214, 2280, 2347, 2411, 2468, 2513, 2544, 2559, 2556, 2536,
+  2500, 2450, 2391, 2326, 2260, 2196, 2140, 2095, 2064, 2049, 2051, 2070,
+  2104, 2152, 2210, 2274, 2340, 2403, 2460, 2506, 2539, 2557, 2558, 2542,
+  2511, 2466, 2411, 2348, 2283, 2219, 2161, 2112, 2075, 2053, 2048, 2058,
+  2085, 2125, 2176, 2236, 2300, 2364, 2424, 2477, 2518, 2546, 2559, 2555,
+  2536, 2502, 2456, 2400, 2339, 2275, 2213, 2157, 2109, 2074, 2053, 2048,
+  2058, 2083, 2122, 2171, 2229, 2291, 2354, 2414, 2467, 2510, 2541, 2557,
+  2558, 2544, 2515, 2474, 2422, 2364, 2302, 2240, 2182, 2131, 2091, 2063,
+  2049, 2050, 2066, 2096, 2138, 2190, 2248, 2309, 2370, 2427, 2477, 2517,
+  2545, 2558, 2557, 2542, 2512, 2471, 2421, 2364, 2303, 2243, 2186, 2135,
+  2095, 2066, 2050, 2049, 2062, 2088, 2126, 2174, 2230, 2289, 2349, 2407,
+  2458, 2502, 2534, 2554, 2559, 2551, 2530, 2496, 2452, 2399, 2342, 2283,
+  2224, 2170, 2124, 2087, 2061, 2049, 2050, 2064, 2092, 2130, 2178, 2232,
+  2290, 2348, 2405, 2455, 2498, 2531, 2552, 2559, 2554, 2536, 2505, 2465,
+  2416, 2361, 2303, 2246, 2191, 2142, 2102, 2072, 2053, 2048, 2055, 2074,
+  2106, 2147, 2196, 2250, 2307, 2363, 2417, 2465, 2505, 2535, 2553, 2559,
+  2553, 2534, 2505, 2465, 2417, 2364, 2308, 2252, 2199, 2150, 2109, 2078,
+  2057, 2048, 2051, 2066, 2093, 2130, 2174, 2225, 2280, 2335, 2389, 2439,
+  2483, 2518, 2543, 2557, 2559, 2549, 2528, 2497, 2457, 2409, 2357, 2303,
+  2248, 2197, 2150, 2110, 2079, 2058, 2048, 2050, 2063, 2087, 2121, 2162,
+  2210, 2262, 2316, 2369, 2420, 2465, 2503, 2532, 2551, 2559, 2556, 2542,
+  2518, 2484, 2443, 2396, 2344, 2291, 2239, 2189, 2145, 2107, 2077, 2058,
+  2048, 2050, 2062, 2084, 2116, 2155, 2201, 2250, 2302, 2354, 2404, 2450,
+  2489, 2521, 2544, 2557, 2559, 2551, 2533, 2506, 2470, 2428, 2381, 2331,
+  2279, 2229, 2182, 2139, 2104, 2076, 2057, 2048, 2049, 2061, 2082, 2111,
+  2148, 2191, 2238, 2288, 2339, 2388, 2433, 2474, 2508, 2534, 2551, 2559,
+  2557, 2545, 2524, 2495, 2459, 2416, 2370, 2321, 2272, 2223, 2178, 2138,
+  2103, 2076, 2058, 2049, 2049, 2058, 2077, 2103, 2137, 2177, 2222, 2269,
+  2318, 2366, 2412, 2453, 2490, 2520, 2541, 2555, 2304, 2304, 2304, 2304,
+  2304, 2304, 2304, 2304, 2304, 2304, 2304, 2304, 2304, 2304, 2304, 2304,
+  2304, 2304, 2304, 2304, 2304, 2304, 2304, 2304, 2304, 2303, 2303, 2303,
+  2303, 2303, 2303, 2303, 2303, 2304, 2304, 2304, 2304, 2304, 2304, 2305,
+  2305, 2305, 2305, 2306, 2306, 2306, 2306, 2307, 2307, 2307, 2307, 2307,
+  2307, 2307, 2307, 2307, 2307, 2306, 2306, 2306, 2305, 2305, 2304, 2304,
+  2303, 2303, 2302, 2301, 2301, 2300, 2300, 2299, 2299, 2298, 2298, 2298,
+  2298, 2298, 2298, 2298, 2299, 2299, 2300, 2300, 2301, 2302, 2303, 2304,
+  2305, 2306, 2308, 2309, 2310, 2311, 2312, 2313, 2314, 2314, 2315, 2315,
+  2315, 2315, 2315, 2315, 2314, 2313, 2312, 2311, 2310, 2308, 2307, 2305,
+  2303, 2301, 2300, 2298, 2296, 2294, 2293, 2291, 2290, 2289, 2288, 2288,
+  2287, 2287, 2288, 2288, 2289, 2290, 2292, 2293, 2295, 2298, 2300, 2302,
+  2305, 2308, 2311, 2313, 2316, 2318, 2321, 2323, 2324, 2326, 2327, 2328,
+  2328, 2328, 2328, 2327, 2325, 2324, 2321, 2319, 2316, 2313, 2310, 2306,
+  2302, 2299, 2295, 2291, 2288, 2284, 2281, 2279, 2276, 2275, 2273, 2273,
+  2272, 2273, 2274, 2275, 2277, 2280, 2283, 2287, 2291, 2295, 2300, 2304,
+  2309, 2314, 2319, 2324, 2328, 2332, 2336, 2339, 2341, 2343, 2344, 2345,
+  2344, 2343, 2341, 2339, 2336, 2332, 2327, 2322, 2316, 2310, 2304, 2298,
+  2292, 2286, 2280, 2274, 2269, 2265, 2261, 2258, 2256, 2255, 2254, 2255,
+  2257, 2259, 2263, 2267, 2272, 2278, 2285, 2292, 2299, 2307, 2315, 2322,
+  2330, 2337, 2343, 2349, 2354, 2358, 2361, 2363, 2364, 2364, 2362, 2359,
+  2355, 2350, 2344, 2337, 2329, 2321, 2312, 2302, 2293, 2284, 2275, 2266,
+  2259, 2252, 2246, 2241, 2237, 2235, 2234, 2235, 2237, 2241, 2246, 2252,
+  2260, 2268, 2278, 2288, 2299, 2310, 2321, 2331, 2342, 2352, 2360, 2368,
+  2374, 2379, 2383, 2384, 2384, 2383, 2379, 2374, 2367, 2358, 2349, 2338,
+  2326, 2313, 2301, 2288, 2275, 2263, 2252, 2241, 2232, 2225, 2219, 2215,
+  2213, 2213, 2216, 2220, 2227, 2235, 2245, 2256, 2269, 2283, 2297, 2312,
+  2327, 2341, 2355, 2368, 2379, 2388, 2396, 2402, 2405, 2406, 2404, 2400,
+  2394, 2385, 2375, 2362, 2348, 2332, 2316, 2299, 2283, 2266, 2251, 2236,
+  2223, 2212, 2203, 2197, 2193, 2192, 2194, 2198, 2206, 2216, 2228, 2243,
+  2259, 2276, 2295, 2314, 2333, 2351, 2368, 2384, 2398, 2409, 2418, 2424,
+  2427, 2426, 2423, 2416, 2406, 2393, 2378, 2361, 2341, 2321, 2300, 2279,
+  2258, 2239, 2221, 2205, 2192, 2182, 2175, 2171, 2172, 2176, 2183, 2194,
+  2208, 2226, 2245, 2266, 2289, 2312, 2335, 2358, 2379, 2398, 2415, 2429,
+  2439, 2445, 2447, 2445, 2439, 2429, 2415, 2398, 2378, 2355, 2331, 2306,
+  2280, 2255, 2231, 2209, 2190, 2174, 2162, 2155, 2151, 2153, 2159, 2169,
+  2184, 2203, 2225, 2250, 2276, 2304, 2332, 2359, 2385, 2408, 2428, 2445,
+  2457, 2464, 2466, 2463, 2455, 2442, 2424, 2403, 2378, 2350, 2321, 2290,
+  2260, 2232, 2205, 2182, 2162, 2147, 2137, 2133, 2135, 2142, 2155, 2173,
+  2195, 2222, 2251, 2283, 2315, 2347, 2379, 2407, 2433, 2454, 2469, 2480,
+  2484, 2481, 2473, 2458, 2438, 2413, 2384, 2352, 2318, 2283, 2248, 2216,
+  2186, 2161, 2141, 2126, 2118, 2117, 2123, 2135, 2154, 2179, 2208, 2242,
+  2278, 2315, 2352, 2387, 2419, 2448, 2471, 2487, 2497, 2499, 2494, 2481,
+  2462, 2436, 2405, 2369, 2331, 2292, 2252, 2215, 2181, 2152, 2128, 2112,
+  2103, 2103, 2110, 2126, 2148, 2178, 2212, 2251, 2292, 2334, 2375, 2413,
+  2447, 2475, 2496, 2509, 2513, 2509, 2496, 2474, 2446, 2411, 2371, 2328,
+  2284, 2241, 2200, 2163, 2133, 2109, 2095, 2089, 2093, 2106, 2128, 2158,
+  2195, 2237, 2282, 2329, 2374, 2416, 2454, 2485, 2508, 2521, 2525, 2518,
+  2502, 2476, 2442, 2401, 2356, 2308, 2260, 2213, 2171, 2135, 2106, 2087,
+  2079, 2081, 2094, 2117, 2149, 2189, 2235, 2285, 2335, 2385, 2430, 2470,
+  2501, 2523, 2534, 2533, 2521, 2498, 2465, 2424, 2376, 2325, 2272, 2221,
+  2173, 2133, 2101, 2079, 2069, 2072, 2086, 2113, 2149, 2193, 2244, 2298,
+  2353, 2405, 2452, 2491, 2521, 2538, 2543, 2535, 2515, 2482, 2440, 2390,
+  2336, 2279, 2223, 2172, 2128, 2094, 2071, 2062, 2066, 2084, 2114, 2155,
+  2205, 2261, 2320, 2378, 2431, 2478, 2514, 2539, 2549, 2546, 2528, 2497,
+  2454, 2402, 2344, 2284, 2224, 2170, 2123, 2087, 2064, 2056, 2063, 2084,
+  2120, 2166, 2222, 2283, 2345, 2405, 2458, 2503, 2534, 2552, 2554, 2540,
+  2510, 2468, 2415, 2355, 2291, 2228, 2170, 2120, 2082, 2059, 2052, 2061,
+  2086, 2126, 2178, 2238, 2303, 2368, 2429, 2482, 2523, 2549, 2558, 2551,
+  2526, 2486, 2434, 2372, 2306, 2239, 2177, 2123, 2082, 2057, 2049, 2059,
+  2086, 2129, 2185, 2249, 2317, 2384, 2446, 2498, 2536, 2557, 2559, 2543,
+  2509, 2461, 2400, 2332, 2262, 2196, 2137, 2090, 2060, 2048, 2055, 2081,
+  2124, 2181, 2248, 2319, 2389, 2452, 2504, 2541, 2560, 2558, 2536, 2497,
+  2442, 2376, 2304, 2232, 2166, 2111, 2071, 2050, 2049, 2069, 2108, 2163,
+  2230, 2303, 2376, 2443, 2499, 2538, 2559, 2558, 2536, 2494, 2437, 2368,
+  2294, 2221, 2154, 2101, 2064, 2048, 2055, 2082, 2129, 2192, 2264, 2339,
+  2412, 2475, 2523, 2552, 2559, 2544, 2507, 2452, 2383, 2308, 2232, 2162,
+  2106, 2067, 2050, 2057, 2085, 2135, 2199, 2274, 2351, 2424, 2486, 2531,
+  2554, 2554, 2531, 2486, 2424, 2350, 2272, 2197, 2132, 2084, 2057, 2054,
+  2076, 2119, 2181, 2255, 2333, 2409, 2475, 2523, 2550, 2552, 2530, 2485,
+  2421, 2346, 2267, 2191, 2127, 2081, 2058, 2060, 2087, 2137, 2204, 2281,
+  2361, 2435, 2495, 2535, 2550, 2540, 2505, 2448, 2376, 2297, 2218, 2149,
+  2096, 2066, 2062, 2084, 2130, 2195, 2272, 2353, 2428, 2489, 2530, 2546,
+  2535, 2498, 2439, 2365, 2285, 2206, 2139, 2091, 2067, 2070, 2100, 2154,
+  2225, 2305, 2385, 2455, 2508, 2537, 2538, 2512, 2462, 2393, 2313, 2233,
+  2161, 2106, 2075, 2072, 2097, 2147, 2216, 2295, 2376, 2448, 2502, 2531,
+  2533, 2506, 2454, 2384, 2303, 2223, 2154, 2103, 2078, 2082, 2113, 2169,
+  2243, 2324, 2402, 2468, 2512, 2529, 2517, 2478, 2416, 2339, 2258, 2183,
+  2124, 2089, 2083, 2107, 2156, 2226, 2305, 2385, 2453, 2501, 2522, 2514,
+  2477, 2416, 2340, 2259, 2185, 2127, 2094, 2091, 2117, 2169, 2240, 2320,
+  2398, 2462, 2503, 2516, 2499, 2454, 2387, 2309, 2230, 2162, 2115, 2096,
+  2107, 2146, 2209, 2286, 2365, 2435, 2485, 2509, 2501, 2464, 2404, 2328,
+  2249, 2179, 2128, 2104, 2110, 2146, 2207, 2282, 2360, 2429, 2479, 2502,
+  2493, 2455, 2394, 2319, 2241, 2174, 2128, 2109, 2122, 2164, 2229, 2305,
+  2380, 2444, 2484, 2495, 2475, 2427, 2359, 2283, 2210, 2153, 2121, 2120,
+  2149, 2204, 2276, 2352, 2420, 2468, 2488, 2477, 2436, 2374, 2299, 2226,
+  2167, 2131, 2126, 2151, 2203, 2272, 2347, 2414, 2461, 2480, 2469, 2428,
+  2365, 2292, 2222, 2166, 2135, 2135, 2166, 2221, 2291, 2363, 2424, 2463,
+  2473, 2451, 2403, 2337, 2265, 2200, 2156, 2139, 2153, 2196, 2258, 2330,
+  2395, 2444, 2465, 2456, 2418, 2358, 2288, 2222, 2172, 2148, 2154, 2190,
+  2247, 2316, 2382, 2432, 2457, 2451, 2417, 2360, 2292, 2228, 2178, 2155,
+  2162, 2197, 2254, 2321, 2384, 2430, 2451, 2441, 2403, 2345, 2279, 2219,
+  2176, 2161, 2176, 2217, 2276, 2341, 2398, 2434, 2443, 2422, 2376, 2315,
+  2252, 2201, 2172, 2172, 2201, 2251, 2313, 2373, 2417, 2436, 2426, 2389,
+  2334, 2272, 2218, 2184, 2176, 2198, 2243, 2301, 2360, 2406, 2428, 2422,
+  2389, 2337, 2278, 2225, 2191, 2183, 2203, 2247, 2303, 2360, 2402, 2422,
+  2414, 2380, 2328, 2271, 2223, 2194, 2192, 2216, 2262, 2317, 2369, 2405,
+  2416, 2400, 2360, 2308, 2255, 2214, 2196, 2205, 2238, 2287, 2340, 2384,
+  2407, 2404, 2377, 2331, 2279, 2234, 2207, 2205, 2228, 2271, 2321, 2367,
+  2396, 2401, 2381, 2341, 2292, 2247, 2217, 2210, 2228, 2265, 2313, 2358,
+  2388, 2396, 2379, 2342, 2296, 2252, 2223, 2216, 2233, 2269, 2314, 2356,
+  2384, 2389, 2371, 2335, 2291, 2251, 2226, 2223, 2243, 2279, 2323, 2360,
+  2382, 2381, 2359, 2321, 2279, 2245, 2228, 2233, 2258, 2296, 2336, 2367,
+  2379, 2369, 2340, 2302, 2264, 2239, 2233, 2248, 2280, 2318, 2352, 2371,
+  2370, 2349, 2316, 2279, 2250, 2238, 2246, 2272, 2307, 2341, 2363, 2367,
+  2352, 2322, 2287, 2258, 2244, 2248, 2270, 2302, 2334, 2357, 2362, 2349,
+  2323, 2290, 2263, 2249, 2253, 2273, 2303, 2333, 2353, 2357, 2344, 2318,
+  2289, 2264, 2253, 2259, 2280, 2308, 2335, 2351, 2351, 2336, 2311, 2284,
+  2264, 2258, 2267, 2289, 2316, 2338, 2348, 2344, 2326, 2301, 2277, 2263,
+  2264, 2278, 2301, 2325, 2341, 2344, 2333, 2312, 2289, 2272, 2266, 2274,
+  2292, 2314, 2333, 2340, 2335, 2319, 2298, 2279, 2270, 2273, 2288, 2308,
+  2326, 2336, 2334, 2322, 2303, 2285, 2275, 2275, 2287, 2304, 2321, 2332,
+  2332, 2321, 2305, 2288, 2278, 2278, 2288, 2304, 2319, 2329, 2329, 2319,
+  2304, 2290, 2281, 2281, 2291, 2305, 2318, 2326, 2325, 2316, 2303, 2290,
+  2283, 2285, 2294, 2307, 2318, 2324, 2321, 2312, 2300, 2290, 2286, 2289,
+  2299, 2310, 2319, 2321, 2317, 2307, 2297, 2290, 2289, 2294, 2304, 2313,
+  2318, 2318, 2311, 2302, 2294, 2291, 2293, 2300, 2308, 2315, 2316, 2313,
+  2306, 2299, 2294, 2293, 2298, 2305, 2311, 2314, 2313, 2308, 2301, 2296,
+  2295, 2298, 2303, 2309, 2312, 2312, 2308, 2303, 2299, 2297, 2298, 2302,
+  2307, 2310, 2311, 2308, 2304, 2300, 2298, 2299, 2302, 2306, 2309, 2309,
+  2307, 2304, 2301, 2300, 2300, 2303, 2306, 2308, 2308, 2306, 2304, 2302,
+  2301, 2302, 2303, 2306, 2307, 2307, 2306, 2304, 2302, 2302, 2303, 2304,
+  2305, 2306, 2306, 2305, 2304, 2303, 2303, 2303, 2304, 2305, 2305, 2305,
+  2304, 2304, 2303, 2303, 2304, 2304, 2305, 2305, 2305, 2304, 2304, 2304,
+  2304, 2304, 2304, 2304, 2304, 2304, 2304, 2304, 2304, 2304, 2304, 2304,
+  2304, 2304, 2304, 2304, 2304, 2304, 2304, 2304, 2040, 2032, 2012, 1987,
+  1967, 1960, 1967, 1987, 2012, 2032, 2040, 2032, 2013, 1988, 1968, 1959,
+  1966, 1985, 2010, 2031, 2040, 2034, 2015, 1991, 1969, 1959, 1964, 1983,
+  2007, 2029, 2040, 2036, 2019, 1994, 1972, 1960, 1962, 1979, 2003, 2025,
+  2039, 2038, 2023, 1999, 1976, 1961, 1960, 1974, 1997, 2021, 2037, 2040,
+  2028, 2006, 1981, 1963, 1958, 1968, 1989, 2014, 2034, 2041, 2034, 2014,
+  1989, 1967, 1958, 1963, 1981, 2006, 2029, 2041, 2039, 2023, 1998, 1974,
+  1959, 1958, 1972, 1996, 2021, 2038, 2043, 2032, 2009, 1984, 1963, 1956,
+  1963, 1984, 2010, 2032, 2043, 2040, 2022, 1996, 1972, 1957, 1957, 1971,
+  1996, 2022, 2040, 2045, 2034, 2011, 1984, 1963, 1954, 1960, 1980, 2007,
+  2031, 2045, 2043, 2026, 2001, 1974, 1957, 1953, 1966, 1989, 2017, 2039,
+  2047, 2040, 2019, 1991, 1966, 1952, 1954, 1971, 1998, 2025, 2044, 2048,
+  2036, 2012, 1984, 1960, 1950, 1956, 1976, 2004, 2031, 2048, 2048, 2033,
+  2007, 1978, 1956, 1948, 1957, 1980, 2010, 2036, 2051, 2049, 2031, 2003,
+  1973, 1952, 1947, 1958, 1983, 2013, 2039, 2053, 2049, 2030, 2000, 1971,
+  1950, 1945, 1958, 1984, 2015, 2041, 2055, 2051, 2030, 2000, 1969, 1948,
+  1943, 1956, 1983, 2015, 2042, 2057, 2053, 2033, 2002, 1970, 1947, 1941,
+  1953, 1979, 2012, 2042, 2058, 2056, 2037, 2006, 1973, 1948, 1938, 1948,
+  1974, 2008, 2039, 2059, 2060, 2043, 2012, 1978, 1950, 1937, 1943, 1966,
+  2000, 2034, 2058, 2064, 2051, 2022, 1986, 1954, 1936, 1937, 1957, 1990,
+  2026, 2054, 2067, 2059, 2033, 1997, 1962, 1938, 1932, 1946, 1976, 2014,
+  2047, 2067, 2067, 2046, 2012, 1974, 1943, 1929, 1935, 1961, 1998, 2035,
+  2063, 2072, 2060, 2030, 1991, 1954, 1931, 1927, 1944, 1978, 2018, 2053,
+  2073, 2072, 2050, 2013, 1972, 1939, 1923, 1929, 1956, 1995, 2036, 2066,
+  2078, 2067, 2037, 1996, 1956, 1928, 1920, 1934, 1968, 2010, 2050, 2076,
+  2080, 2062, 2026, 1982, 1943, 1920, 1919, 1940, 1979, 2023, 2061, 2082,
+  2080, 2056, 2015, 1970, 1933, 1914, 1919, 1946, 1988, 2034, 2070, 2087,
+  2081, 2051, 2008, 1962, 1926, 1910, 1918, 1949, 1994, 2041, 2076, 2091,
+  2081, 2049, 2003, 1956, 1920, 1906, 1917, 1950, 1997, 2045, 2081, 2095,
+  2084, 2050, 2002, 1953, 1917, 1902, 1913, 1948, 1996, 2046, 2083, 2099,
+  2088, 2054, 2005, 1954, 1915, 1898, 1908, 1942, 1991, 2043, 2084, 2102,
+  2094, 2061, 2012, 1959, 1917, 1895, 1901, 1933, 1982, 2036, 2081, 2105,
+  2102, 2073, 2024, 1969, 1921, 1894, 1893, 1920, 1967, 2023, 2073, 2105,
+  2110, 2086, 2041, 1984, 1932, 1896, 1886, 1905, 1948, 2005, 2060, 2101,
+  2116, 2102, 2062, 2006, 1948, 1903, 1882, 1890, 1926, 1980, 2040, 2089,
+  2117, 2116, 2085, 2034, 1973, 1919, 1884, 1878, 1902, 1950, 2011, 2069,
+  2110, 2125, 2109, 2066, 2006, 1945, 1896, 1873, 1880, 1917, 1974, 2037,
+  2092, 2124, 2127, 2098, 2046, 1982, 1922, 1880, 1867, 1886, 1932, 1995,
+  2059, 2109, 2133, 2126, 2088, 2029, 1962, 1904, 1869, 1864, 1892, 1945,
+  2011, 2075, 2122, 2140, 2124, 2080, 2016, 1948, 1892, 1861, 1862, 1895,
+  1954, 2023, 2087, 2131, 2145, 2125, 2075, 2008, 1939, 1883, 1854, 1859,
+  1896, 1957, 2028, 2093, 2137, 2150, 2128, 2076, 2007, 1936, 1878, 1849,
+  1853, 1891, 1954, 2028, 2095, 2141, 2155, 2134, 2083, 2012, 1938, 1878,
+  1845, 1846, 1882, 1945, 2020, 2091, 2142, 2161, 2144, 2095, 2025, 1948,
+  1883, 1843, 1838, 1868, 1928, 2004, 2080, 2138, 2165, 2157, 2114, 2045,
+  1966, 1894, 1845, 1830, 1851, 1905, 1980, 2060, 2126, 2166, 2169, 2136,
+  2073, 1994, 1915, 1855, 1825, 1833, 1877, 1948, 2030, 2105, 2159, 2178,
+  2160, 2107, 2030, 1947, 1875, 1829, 1819, 1847, 1908, 1989, 2072, 2140,
+  2179, 2180, 2143, 2076, 1992, 1910, 1846, 1814, 1821, 1865, 1938, 2024,
+  2105, 2165, 2190, 2176, 2125, 2048, 1960, 1881, 1825, 1806, 1826, 1882,
+  1963, 2052, 2130, 2182, 2196, 2171, 2110, 2026, 1937, 1860, 1811, 1800,
+  1830, 1895, 1981, 2071, 2147, 2194, 2201, 2168, 2100, 2012, 1921, 1846,
+  1801, 1796, 1831, 1901, 1990, 2082, 2158, 2202, 2206, 2169, 2098, 2008,
+  1915, 1839, 1794, 1790, 1827, 1899, 1990, 2084, 2162, 2208, 2213, 2177,
+  2105, 2013, 1918, 1838, 1790, 1782, 1817, 1887, 1980, 2077, 2159, 2210,
+  2221, 2190, 2121, 2029, 1931, 1845, 1789, 1773, 1801, 1867, 1958, 2058,
+  2147, 2208, 2230, 2207, 2146, 2056, 1955, 1863, 1796, 1767, 1782, 1838,
+  1925, 2027, 2123, 2197, 2234, 2227, 2177, 2094, 1993, 1893, 1813, 1766,
+  1764, 1805, 1882, 1982, 2085, 2173, 2229, 2242, 2211, 2141, 2045, 1940,
+  1845, 1779, 1753, 1772, 1833, 1924, 2030, 2131, 2208, 2247, 2241, 2192,
+  2107, 2003, 1898, 1810, 1757, 1747, 1783, 1858, 1959, 2067, 2164, 2231,
+  2257, 2237, 2175, 2081, 1972, 1868, 1787, 1743, 1745, 1792, 1877, 1983,
+  2092, 2186, 2247, 2264, 2235, 2164, 2064, 1953, 1849, 1772, 1734, 1742,
+  1796, 1885, 1994, 2105, 2198, 2257, 2271, 2238, 2163, 2061, 1947, 1842,
+  1764, 1726, 1735, 1790, 1881, 1993, 2106, 2201, 2262, 2278, 2247, 2174,
+  2070, 1955, 1846, 1764, 1721, 1725, 1776, 1865, 1977, 2093, 2193, 2262,
+  2286, 2263, 2195, 2094, 1977, 1864, 1773, 1719, 1713, 1754, 1836, 1945,
+  2064, 2173, 2253, 2291, 2282, 2225, 2131, 2016, 1897, 1795, 1726, 1702,
+  1727, 1796, 1899, 2019, 2136, 2231, 2288, 2299, 2261, 2180, 2070, 1949,
+  1835, 1747, 1700, 1701, 1751, 1840, 1956, 2079, 2189, 2269, 2307, 2295,
+  2236, 2139, 2020, 1897, 1790, 1716, 1687, 1708, 1775, 1877, 2000, 2122,
+  2226, 2294, 2316, 2288, 2215, 2108, 1983, 1861, 1761, 1697, 1680, 1714,
+  1792, 1902, 2028, 2150, 2249, 2309, 2322, 2284, 2203, 2090, 1963, 1841,
+  1743, 1685, 1674, 1714, 1797, 1912, 2040, 2162, 2260, 2318, 2328, 2288,
+  2204, 2089, 1960, 1837, 1738, 1678, 1667, 1706, 1789, 1904, 2034, 2159,
+  2260, 2323, 2337, 2301, 2219, 2105, 1975, 1848, 1743, 1677, 1658, 1690,
+  1767, 1879, 2010, 2139, 2248, 2320, 2345, 2320, 2248, 2139, 2009, 1878,
+  1764, 1684, 1651, 1668, 1733, 1837, 1966, 2099, 2218, 2306, 2349, 2343,
+  2286, 2188, 2063, 1928, 1804, 1707, 1652, 1647, 1692, 1781, 1902, 2037,
+  2167, 2273, 2341, 2360, 2328, 2250, 2136, 2002, 1868, 1752, 1671, 1636,
+  1652, 1717, 1822, 1952, 2089, 2213, 2308, 2360, 2362, 2313, 2221, 2097,
+  1960, 1828, 1720, 1650, 1628, 1658, 1735, 1849, 1983, 2120, 2241, 2329,
+  2372, 2364, 2306, 2206, 2077, 1938, 1807, 1702, 1637, 1622, 1657, 1739,
+  1857, 1994, 2132, 2252, 2339, 2380, 2369, 2310, 2208, 2078, 1938, 1805,
+  1698, 1632, 1614, 1648, 1729, 1845, 1983, 2123, 2247, 2338, 2385, 2380,
+  2326, 2228, 2100, 1959, 1823, 1709, 1634, 1607, 1630, 1702, 1814, 1949,
+  2091, 2222, 2324, 2384, 2394, 2353, 2266, 2144, 2004, 1863, 1739, 1649,
+  1603, 1609, 1665, 1764, 1893, 2036, 2174, 2291, 2370, 2403, 2384, 2316,
+  2208, 2073, 1929, 1793, 1684, 1614, 1593, 1623, 1701, 1816, 1955, 2099,
+  2231, 2335, 2396, 2408, 2369, 2284, 2163, 2022, 1878, 1748, 1650, 1595,
+  1590, 1636, 1727, 1851, 1994, 2138, 2265, 2360, 2410, 2410, 2360, 2266,
+  2139, 1994, 1851, 1725, 1632, 1584, 1587, 1640, 1736, 1864, 2009, 2153,
+  2279, 2371, 2418, 2415, 2362, 2266, 2137, 1992, 1847, 1721, 1628, 1579,
+  1580, 1631, 1726, 1854, 1999, 2144, 2273, 2369, 2422, 2425, 2377, 2286,
+  2160, 2015, 1869, 1737, 1637, 1578, 1569, 1610, 1697, 1819, 1962, 2110,
+  2245, 2352, 2418, 2435, 2403, 2323, 2206, 2066, 1917, 1778, 1664, 1589,
+  1560, 1582, 1652, 1762, 1899, 2047, 2190, 2312, 2398, 2439, 2430, 2373,
+  2272, 2141, 1994, 1847, 1718, 1620, 1564, 1558, 1601, 1689, 1812, 1956,
+  2105, 2242, 2352, 2424, 2448, 2422, 2349, 2237, 2099, 1950, 1806, 1683,
+  1596, 1552, 1558, 1613, 1710, 1839, 1986, 2134, 2268, 2372, 2436, 2453,
+  2419, 2341, 2225, 2084, 1934, 1791, 1671, 1586, 1546, 1554, 1611, 1710,
+  1840, 1987, 2135, 2270, 2375, 2440, 2458, 2427, 2351, 2237, 2097, 1947,
+  1803, 1679, 1590, 1543, 1545, 1595, 1688, 1813, 1959, 2108, 2247, 2359,
+  2434, 2464, 2444, 2379, 2273, 2139, 1990, 1843, 1711, 1610, 1548, 1534,
+  1568, 1646, 1761, 1901, 2051, 2196, 2321, 2412, 2462, 2464, 2418, 2330,
+  2207, 2064, 1914, 1772, 1654, 1571, 1531, 1539, 1593, 1689, 1816, 1962,
+  2112, 2250, 2363, 2440, 2472, 2457, 2396, 2295, 2165, 2018, 1869, 1733,
+  1623, 1551, 1524, 1544, 1609, 1713, 1845, 1993, 2141, 2276, 2383, 2452,
+  2478, 2456, 2389, 2284, 2151, 2003, 1855, 1721, 1614, 1545, 1520, 1541,
+  1607, 1711, 1844, 1991, 2139, 2274, 2382, 2454, 2481, 2463, 2399, 2298,
+  2168, 2021, 1873, 1736, 1625, 1550, 1517, 1530, 1588, 1685, 1812, 1957,
+  2106, 2245, 2360, 2442, 2482, 2476, 2426, 2336, 2214, 2071, 1923, 1781,
+  1660, 1570, 1521, 1516, 1556, 1638, 1753, 1891, 2039, 2184, 2311, 2410,
+  2471, 2488, 2461, 2391, 2285, 2152, 2006, 1860, 1726, 1617, 1543, 1510,
+  1523, 1579, 1673, 1796, 1939, 2086, 2226, 2346, 2434, 2483, 2488, 2449,
+  2370, 2258, 2122, 1976, 1831, 1702, 1599, 1532, 1507, 1525, 1586, 1684,
+  1810, 1952, 2099, 2237, 2354, 2439, 2486, 2490, 2451, 2372, 2260, 2125,
+  1980, 1836, 1706, 1602, 1533, 1505, 1520, 1576, 1669, 1791, 1931, 2077,
+  2217, 2337, 2428, 2482, 2495, 2465, 2395, 2291, 2162, 2019, 1874, 1740,
+  1629, 1549, 1507, 1508, 1550, 1631, 1743, 1877, 2021, 2163, 2291, 2395,
+  2465, 2496, 2485, 2434, 2346, 2228, 2092, 1948, 1808, 1685, 1587, 1524,
+  1501, 1519, 1577, 1671, 1791, 1929, 2072, 2210, 2330, 2423, 2480, 2499,
+  2476, 2414, 2318, 2196, 2058, 1915, 1779, 1661, 1571, 1516, 1500, 1525,
+  1588, 1685, 1807, 1945, 2087, 2222, 2339, 2428, 2483, 2499, 2475, 2413,
+  2317, 2196, 2060, 1919, 1784, 1666, 1575, 1518, 1500, 1520, 1579, 1672,
+  1790, 1924, 2065, 2200, 2320, 2414, 2475, 2500, 2484, 2431, 2344, 2230,
+  2098, 1959, 1823, 1700, 1601, 1533, 1501, 1508, 1553, 1633, 1741, 1868,
+  2006, 2143, 2270, 2375, 2451, 2493, 2496, 2462, 2392, 2293, 2171, 2036,
+  1898, 1768, 1656, 1570, 1517, 1500, 1521, 1578, 1667, 1781, 1912, 2049,
+  2182, 2301, 2398, 2465, 2496, 2491, 2449, 2373, 2270, 2146, 2012, 1877,
+  1751, 1644, 1563, 1514, 1501, 1526, 1585, 1674, 1788, 1917, 2052, 2183,
+  2300, 2396, 2462, 2495, 2491, 2451, 2379, 2279, 2159, 2027, 1894, 1768,
+  1659, 1575, 1521, 1503, 1520, 1571, 1653, 1761, 1885, 2017, 2148, 2268,
+  2369, 2444, 2486, 2494, 2467, 2407, 2317, 2206, 2079, 1948, 1820, 1705,
+  1610, 1544, 1509, 1509, 1544, 1610, 1704, 1818, 1945, 2075, 2201, 2312,
+  2401, 2462, 2491, 2486, 2447, 2377, 2281, 2166, 2039, 1910, 1787, 1679,
+  1593, 1535, 1509, 1516, 1557, 1628, 1724, 1839, 1965, 2093, 2214, 2321,
+  2406, 2463, 2489, 2481, 2441, 2372, 2277, 2164, 2039, 1913, 1792, 1685,
+  1599, 1541, 1513, 1518, 1554, 1621, 1712, 1823, 1945, 2071, 2192, 2300,
+  2388, 2450, 2482, 2483, 2451, 2390, 2304, 2197, 2078, 1954, 1832, 1722,
+  1631, 1563, 1524, 1516, 1539, 1592, 1672, 1773, 1888, 2011, 2132, 2245,
+  2342, 2417, 2464, 2482, 2469, 2426, 2355, 2262, 2152, 2033, 1911, 1796,
+  1693, 1610, 1552, 1523, 1524, 1554, 1613, 1697, 1799, 1914, 2034, 2152,
+  2260, 2351, 2421, 2464, 2477, 2461, 2416, 2345, 2253, 2145, 2028, 1910,
+  1797, 1697, 1616, 1559, 1529, 1528, 1556, 1612, 1691, 1789, 1900, 2017,
+  2133, 2240, 2332, 2404, 2452, 2471, 2462, 2425, 2362, 2277, 2175, 2063,
+  1948, 1835, 1733, 1647, 1582, 1542, 1530, 1547, 1590, 1658, 1746, 1849,
+  1961, 2075, 2185, 2283, 2364, 2424, 2458, 2465, 2444, 2397, 2327, 2238,
+  2134, 2023, 1911, 1804, 1709, 1631, 1574, 1543, 1538, 1561, 1609, 1679,
+  1768, 1871, 1981, 2091, 2196, 2290, 2367, 2422, 2453, 2457, 2436, 2389,
+  2320, 2233, 2132, 2024, 1915, 1811, 1718, 1641, 1584, 1552, 1545, 1563,
+  1607, 1672, 1756, 1854, 1960, 2067, 2171, 2265, 2344, 2403, 2440, 2451,
+  2438, 2400, 2339, 2260, 2167, 2064, 1958, 1854, 1759, 1677, 1613, 1571,
+  1553, 1559, 1589, 1642, 1715, 1803, 1902, 2006, 2109, 2206, 2292, 2362,
+  2411, 2438, 2441, 2421, 2377, 2313, 2232, 2138, 2038, 1935, 1836, 1746,
+  1670, 1612, 1575, 1561, 1570, 1602, 1656, 1727, 1813, 1909, 2010, 2110,
+  2203, 2286, 2354, 2402, 2429, 2433, 2414, 2374, 2314, 2237, 2148, 2051,
+  1952, 1856, 1767, 1691, 1631, 1590, 1571, 1574, 1600, 1646, 1710, 1789,
+  1879, 1975, 2072, 2166, 2250, 2321, 2376, 2411, 2425, 2417, 2387, 2338,
+  2272, 2192, 2102, 2007, 1912, 1822, 1741, 1673, 1622, 1590, 1579, 1590,
+  1621, 1671, 1737, 1817, 1906, 1999, 2092, 2180, 2259, 2324, 2374, 2404,
+  2415, 2404, 2374, 2325, 2259, 2182, 2095, 2004, 1912, 1826, 1748, 1683,
+  1633, 1602, 1590, 1598, 1626, 1673, 1735, 1810, 1894, 1983, 2072, 2158,
+  2236, 2302, 2354, 2388, 2403, 2399, 2375, 2333, 2276, 2205, 2124, 2038,
+  1950, 1865, 1786, 1718, 1663, 1625, 1604, 1603, 1620, 1655, 1707, 1772,
+  1848, 1931, 2017, 2102, 2182, 2253, 2312, 2356, 2383, 2392, 2383, 2356,
+  2312, 2254, 2184, 2105, 2022, 1938, 1858, 1783, 1720, 1669, 1634, 1615,
+  1615, 1632, 1666, 1716, 1778, 1850, 1929, 2011, 2093, 2169, 2238, 2296,
+  2340, 2368, 2380, 2374, 2351, 2313, 2260, 2196, 2123, 2044, 1964, 1886,
+  1813, 1748, 1695, 1656, 1632, 1625, 1635, 1661, 1702, 1756, 1821, 1893,
+  1970, 2049, 2124, 2194, 2256, 2305, 2341, 2362, 2367, 2356, 2329, 2287,
+  2234, 2170, 2099, 2023, 1947, 1873, 1806, 1746, 1698, 1663, 1643, 1639,
+  1650, 1676, 1716, 1768, 1830, 1899, 1972, 2047, 2119, 2185, 2244, 2291,
+  2327, 2348, 2354, 2345, 2322, 2284, 2235, 2176, 2110, 2039, 1967, 1896,
+  1830, 1771, 1722, 1685, 1662, 1652, 1657, 1677, 1710, 1754, 1809, 1872,
+  1940, 2010, 2080, 2146, 2205, 2256, 2296, 2324, 2338, 2339, 2325, 2298,
+  2258, 2209, 2150, 2086, 2019, 1951, 1885, 1824, 1770, 1726, 1693, 1673,
+  1666, 1673, 1693, 1725, 1768, 1821, 1880, 1944, 2010, 2076, 2138, 2194,
+  2243, 2281, 2309, 2323, 2325, 2314, 2290, 2255, 2209, 2156, 2097, 2034,
+  1969, 1907, 1848, 1795, 1751, 1716, 1693, 1682, 1683, 1697, 1723, 1759,
+  1805, 1858, 1916, 1978, 2040, 2100, 2156, 2206, 2248, 2280, 2301, 2310,
+  2308, 2293, 2267, 2231, 2187, 2135, 2078, 2018, 1958, 1900, 1846, 1797,
+  1757, 1726, 1706, 1696, 1699, 1712, 1737, 1771, 1814, 1864, 1918, 1976,
+  2034, 2091, 2144, 2191, 2231, 2262, 2284, 2294, 2294, 2283, 2261, 2229,
+  2189, 2143, 2091, 2036, 1980, 1924, 1872, 1825, 1784, 1751, 1728, 1715,
+  1712, 1719, 1737, 1765, 1801, 1844, 1892, 1944, 1998, 2052, 2104, 2152,
+  2194, 2229, 2255, 2272, 2280, 2277, 2264, 2242, 2211, 2173, 2128, 2080,
+  2028, 1976, 1925, 1877, 1833, 1795, 1765, 1743, 1731, 1728, 1734, 1750,
+  1775, 1807, 1846, 1891, 1939, 1988, 2039, 2087, 2132, 2173, 2207, 2234,
+  2253, 2262, 2263, 2254, 2237, 2211, 2179, 2140, 2096, 2050, 2002, 1954,
+  1908, 1865, 1827, 1795, 1770, 1753, 1745, 1745, 1754, 1771, 1796, 1828,
+  1866, 1908, 1952, 1999, 2045, 2089, 2130, 2167, 2197, 2221, 2238, 2246,
+  2246, 2238, 2222, 2199, 2169, 2133, 2093, 2051, 2006, 1962, 1919, 1879,
+  1844, 1813, 1789, 1772, 1762, 1760, 1766, 1780, 1801, 1828, 1861, 1898,
+  1939, 1981, 2023, 2065, 2104, 2140, 2171, 2196, 2215, 2226, 2231, 2228,
+  2217, 2200, 2176, 2147, 2113, 2076, 2036, 1995, 1955, 1916, 1881, 1849,
+  1822, 1801, 1786, 1778, 1777, 1783, 1796, 1816, 1841, 1871, 1905, 1941,
+  1980, 2018, 2056, 2092, 2125, 2154, 2178, 2196, 2208, 2214, 2213, 2205,
+  2191, 2171, 2146, 2116, 2083, 2048, 2011, 1974, 1938, 1904, 1873, 1847,
+  1825, 1808, 1798, 1793, 1795, 1803, 1818, 1837, 1862, 1890, 1922, 1955,
+  1990, 2026, 2060, 2092, 2121, 2146, 2167, 2183, 2193, 2197, 2196, 2188,
+  2175, 2157, 2134, 2108, 2078, 2046, 2013, 1979, 1947, 1916, 1888, 1863,
+  1842, 1826, 1816, 1810, 1811, 1817, 1828, 1844, 1864, 1889, 1916, 1946,
+  1977, 2009, 2040, 2070, 2098, 2122, 2143, 2160, 2172, 2179, 2181, 2178,
+  2169, 2156, 2138, 2116, 2092, 2064, 2035, 2005, 1976, 1947, 1919, 1894,
+  1872, 1854, 1841, 1831, 1827, 1827, 1832, 1842, 1857, 1875, 1896, 1921,
+  1947, 1975, 2003, 2031, 2058, 2083, 2106, 2126, 2142, 2154, 2162, 2165,
+  2163, 2157, 2147, 2133, 2115, 2094, 2071, 2046, 2019, 1993, 1966, 1941,
+  1917, 1896, 1878, 1863, 1852, 1845, 1842, 1844, 1850, 1859, 1873, 1890,
+  1909, 1931, 1955, 1980, 2005, 2029, 2053, 2076, 2096, 2113, 2128, 2138,
+  2145, 2149, 2148, 2143, 2135, 2123, 2107, 2089, 2069, 2047, 2024, 2001,
+  1977, 1955, 1933, 1914, 1897, 1882, 1871, 1863, 1859, 1858, 1862, 1868,
+  1878, 1891, 1907, 1925, 1945, 1966, 1988, 2010, 2032, 2053, 2072, 2089,
+  2104, 2116, 2125, 2131, 2133, 2132, 2128, 2120, 2110, 2096, 2081, 2063,
+  2044, 2024, 2003, 1983, 1963, 1944, 1926, 1911, 1898, 1887, 1880, 1875,
+  1873, 1875, 1880, 1888, 1898, 1911, 1926, 1943, 1961, 1979, 1999, 2018,
+  2036, 2054, 2070, 2084, 2096, 2106, 2113, 2117, 2118, 2117, 2112, 2105,
+  2095, 2083, 2070, 2054, 2037, 2020, 2002, 1984, 1967, 1950, 1935, 1922,
+  1910, 1901, 1894, 1890, 1888, 1889, 1893, 1899, 1907, 1918, 1930, 1944,
+  1960, 1976, 1992, 2009, 2025, 2041, 2055, 2068, 2080, 2089, 2096, 2101,
+  2104, 2104, 2102, 2097, 2090, 2081, 2070, 2058, 2044, 2030, 2014, 1999,
+  1984, 1969, 1955, 1942, 1931, 1921, 1913, 1907, 1903, 1902, 1903, 1905,
+  1911, 1918, 1926, 1937, 1949, 1962, 1975, 1989, 2004, 2018, 2031, 2044,
+  2055, 2066, 2074, 2081, 2087, 2090, 2091, 2090, 2087, 2082, 2075, 2067,
+  2057, 2046, 2035, 2022, 2009, 1996, 1983, 1970, 1959, 1948, 1938, 1930,
+  1924, 1919, 1916, 1915, 1915, 1918, 1922, 1928, 1935, 1944, 1954, 1965,
+  1976, 1988, 2000, 2012, 2024, 2035, 2045, 2054, 2062, 2069, 2073, 2077,
+  2079, 2078, 2077, 2073, 2069, 2062, 2055, 2046, 2036, 2026, 2015, 2004,
+  1993, 1982, 1972, 1962, 1953, 1945, 1939, 1933, 1929, 1927, 1926, 1927,
+  1929, 1932, 1937, 1944, 1951, 1959, 1968, 1978, 1988, 1998, 2008, 2018,
+  2028, 2036, 2044, 2051, 2057, 2062, 2065, 2067, 2068, 2067, 2065, 2061,
+  2057, 2051, 2044, 2036, 2028, 2019, 2010, 2001, 1991, 1982, 1974, 1966,
+  1958, 1952, 1946, 1942, 1939, 1937, 1936, 1937, 1939, 1942, 1946, 1951,
+  1957, 1964, 1971, 1979, 1988, 1996, 2005, 2013, 2021, 2029, 2036, 2042,
+  2047, 2052, 2055, 2057, 2058, 2058, 2057, 2055, 2051, 2047, 2042, 2036,
+  2029, 2022, 2014, 2007, 1999, 1991, 1983, 1976, 1969, 1963, 1958, 1953,
+  1950, 1947, 1945, 1945, 1945, 1947, 1949, 1953, 1957, 1962, 1968, 1974,
+  1981, 1988, 1995, 2002, 2009, 2016, 2023, 2029, 2034, 2039, 2043, 2046,
+  2049, 2050, 2051, 2050, 2049, 2047, 2043, 2039, 2035, 2030, 2024, 2018,
+  2011, 2005, 1998, 1991, 1985, 1979, 1973, 1968, 1963, 1959, 1956, 1954,
+  1952, 1952, 1952, 1953, 1955, 1958, 1961, 1965, 1970, 1975, 1981, 1987,
+  1993, 1999, 2005, 2011, 2017, 2023, 2028, 2032, 2036, 2039, 2042, 2044,
+  2045, 2045, 2044, 2043, 2041, 2038, 2034, 2030, 2026, 2021, 2015, 2010,
+  2004, 1998, 1992, 1987, 1981, 1976, 1972, 1968, 1964, 1961, 1959, 1957,
+  1957, 1957, 1957, 1959, 1961, 1963, 1967, 1971, 1975, 1980, 1985, 1990,
+  1996, 2001, 2007, 2012, 2017, 2022, 2026, 2030, 2034, 2036, 2039, 2040,
+  2041, 2041, 2041, 2039, 2037, 2035, 2032, 2028, 2024, 2020, 2015, 2010,
+  2005, 1999, 1994, 1989, 1984, 1979, 1975, 1971, 1968, 1965, 1962, 1961,
+  1960, 1959, 1959, 1960, 1962, 1964, 1966, 1970, 1973, 1977, 1982, 1987,
+  1992, 1997, 2002, 2007, 2012, 2016, 2021, 2025, 2029, 2032, 2035, 2037,
+  2038, 2039, 2040, 2039, 2038, 2037, 2035, 2032, 2049, 2049, 2049, 2049,
+  2049, 2049, 2049, 2049, 2049, 2049, 2049, 2049, 2049, 2049, 2049, 2049,
+  2049, 2049, 2049, 2048, 2049, 2049, 2049, 2050, 2050, 2050, 2050, 2050,
+  2050, 2049, 2048, 2048, 2047, 2048, 2048, 2049, 2050, 2051, 2052, 2052,
+  2051, 2050, 2048, 2047, 2046, 2046, 2046, 2047, 2049, 2051, 2053, 2054,
+  2054, 2053, 2051, 2048, 2046, 2044, 2043, 2044, 2045, 2048, 2051, 2054,
+  2056, 2057, 2056, 2053, 2049, 2045, 2042, 2040, 2040, 2042, 2046, 2050,
+  2055, 2058, 2060, 2060, 2057, 2052, 2047, 2041, 2038, 2036, 2037, 2041,
+  2046, 2053, 2059, 2063, 2065, 2063, 2058, 2051, 2044, 2037, 2032, 2031,
+  2034, 2039, 2047, 2056, 2063, 2068, 2070, 2067, 2060, 2051, 2041, 2033,
+  2027, 2026, 2029, 2036, 2047, 2058, 2068, 2074, 2076, 2072, 2064, 2053,
+  2040, 2029, 2021, 2019, 2022, 2031, 2043, 2057, 2070, 2079, 2083, 2080,
+  2072, 2058, 2043, 2028, 2017, 2011, 2013, 2022, 2035, 2052, 2069, 2083,
+  2090, 2090, 2083, 2069, 2051, 2032, 2016, 2005, 2003, 2008, 2022, 2041,
+  2062, 2081, 2095, 2101, 2097, 2085, 2066, 2044, 2022, 2004, 1994, 1993,
+  2003, 2021, 2044, 2069, 2091, 2106, 2111, 2106, 2090, 2067, 2040, 2014,
+  1994, 1982, 1982, 1994, 2016, 2043, 2073, 2099, 2117, 2124, 2118, 2100,
+  2073, 2042, 2011, 1986, 1971, 1969, 1980, 2004, 2035, 2070, 2102, 2125,
+  2137, 2134, 2117, 2088, 2052, 2015, 1983, 1961, 1954, 1961, 1984, 2017,
+  2056, 2095, 2128, 2148, 2152, 2140, 2113, 2075, 2032, 1991, 1959, 1940,
+  1939, 1955, 1987, 2029, 2075, 2118, 2150, 2168, 2167, 2147, 2112, 2066,
+  2017, 1972, 1938, 1921, 1923, 1945, 1984, 2034, 2086, 2134, 2170, 2187,
+  2184, 2160, 2119, 2066, 2010, 1959, 1920, 1901, 1904, 1928, 1972, 2028,
+  2088, 2143, 2185, 2207, 2207, 2182, 2138, 2079, 2016, 1956, 1909, 1882,
+  1879, 1901, 1945, 2006, 2073, 2138, 2191, 2225, 2233, 2215, 2172, 2111,
+  2040, 1969, 1909, 1868, 1852, 1865, 1903, 1963, 2037, 2113, 2181, 2232,
+  2257, 2253, 2221, 2164, 2090, 2009, 1932, 1871, 1834, 1826, 1849, 1901,
+  1973, 2057, 2142, 2214, 2265, 2287, 2276, 2235, 2167, 2082, 1991, 1907,
+  1842, 1803, 1797, 1826, 1885, 1967, 2061, 2155, 2236, 2293, 2318, 2307,
+  2262, 2188, 2095, 1994, 1899, 1823, 1775, 1764, 1789, 1850, 1937, 2040,
+  2146, 2240, 2311, 2348, 2347, 2307, 2234, 2135, 2024, 1915, 1822, 1757,
+  1729, 1741, 1793, 1878, 1987, 2104, 2216, 2308, 2369, 2389, 2367, 2305,
+  2209, 2092, 1968, 1853, 1762, 1705, 1690, 1720, 1791, 1896, 2020, 2150,
+  2268, 2361, 2417, 2428, 2392, 2314, 2202, 2071, 1935, 1812, 1716, 1660,
+  1650, 1689, 1772, 1889, 2027, 2169, 2298, 2399, 2459, 2471, 2432, 2347,
+  2225, 2081, 1932, 1795, 1687, 1620, 1604, 1640, 1724, 1848, 1996, 2153,
+  2299, 2417, 2493, 2519, 2490, 2409, 2286, 2134, 1971, 1815, 1684, 1594,
+  1556, 1574, 1646, 1766, 1919, 2088, 2255, 2400, 2507, 2562, 2560, 2500,
+  2389, 2238, 2064, 1887, 1726, 1600, 1523, 1505, 1546, 1645, 1789, 1964,
+  2150, 2326, 2474, 2576, 2620, 2602, 2524, 2392, 2221, 2030, 1839, 1669,
+  1540, 1464, 1452, 1504, 1616, 1776, 1967, 2169, 2359, 2518, 2628, 2676,
+  2658, 2575, 2434, 2251, 2045, 1837, 1650, 1504, 1415, 1392, 1438, 1549,
+  1714, 1915, 2133, 2343, 2525, 2658, 2729, 2729, 2659, 2524, 2339, 2122,
+  1896, 1684, 1507, 1386, 1331, 1350, 1442, 1596, 1798, 2027, 2261, 2474,
+  2647, 2759, 2801, 2766, 2659, 2489, 2273, 2032, 1792, 1576, 1405, 1298,
+  1265, 1310, 1430, 1613, 1840, 2090, 2338, 2559, 2731, 2837, 2866, 2815,
+  2687, 2496, 2259, 2000, 1744, 1516, 1338, 1228, 1198, 1250, 1381, 1577,
+  1820, 2088, 2353, 2592, 2779, 2898, 2936, 2888, 2760, 2563, 2316, 2041,
+  1765, 1514, 1312, 1179, 1128, 1163, 1283, 1476, 1724, 2005, 2292, 2558,
+  2778, 2931, 3003, 2986, 2881, 2698, 2454, 2170, 1873, 1590, 1348, 1170,
+  1071, 1062, 1144, 1310, 1545, 1827, 2132, 2431, 2697, 2906, 3038, 3081,
+  3030, 2890, 2672, 2397, 2089, 1775, 1484, 1242, 1071, 987, 998, 1103,
+  1294, 1553, 1858, 2182, 2496, 2772, 2986, 3117, 3156, 3096, 2943, 2711,
+  2419, 2093, 1761, 1452, 1194, 1010, 915, 918, 1021, 1213, 1479, 1796,
+  2137, 2473, 2773, 3013, 3170, 3232, 3193, 3055, 2829, 2536, 2199, 1848,
+  1512, 1220, 997, 862, 828, 897, 1064, 1315, 1630, 1982, 2341, 2677,
+  2963, 3173, 3290, 3303, 3212, 3023, 2751, 2420, 2056, 1690, 1352, 1070,
+  868, 762, 762, 869, 1073, 1359, 1703, 2077, 2450, 2793, 3076, 3276,
+  3378, 3371, 3257, 3044, 2750, 2397, 2014, 1633, 1283, 994, 788, 683,
+  687, 801, 1015, 1313, 1672, 2062, 2452, 2813, 3114, 3332, 3448, 3455,
+  3350, 3142, 2846, 2486, 2091, 1690, 1316, 998, 761, 624, 598, 685,
+  879, 1165, 1521, 1920, 2330, 2720, 3059, 3322, 3487, 3542, 3482, 3312,
+  3043, 2698, 2301, 1883, 1477, 1113, 819, 617, 524, 547, 684, 925,
+  1252, 1641, 2062, 2483, 2873, 3203, 3447, 3587, 3611, 3519, 3316, 3018,
+  2647, 2229, 1797, 1382, 1015, 724, 530, 448, 484, 636, 893, 1236,
+  1640, 2075, 2510, 2912, 3253, 3506, 3653, 3684, 3596, 3394, 3094, 2718,
+  2291, 1846, 1414, 1027, 712, 493, 386, 398, 529, 769, 1102, 1504,
+  1946, 2396, 2823, 3196, 3488, 3679, 3754, 3709, 3545, 3275, 2918, 2498,
+  2046, 1592, 1170, 808, 533, 363, 311, 381, 567, 858, 1232, 1664,
+  2124, 2580, 3000, 3355, 3620, 3778, 3816, 3732, 3532, 3230, 2845, 2405,
+  1939, 1480, 1059, 705, 442, 288, 254, 342, 546, 853, 1241, 1686,
+  2155, 2619, 3045, 3404, 3673, 3833, 3874, 3792, 3592, 3290, 2903, 2459,
+  1986, 1517, 1083, 712, 429, 253, 197, 263, 447, 738, 1115, 1555,
+  2028, 2503, 2950, 3337, 3641, 3841, 3924, 3885, 3725, 3456, 3095, 2666,
+  2195, 1715, 1255, 847, 515, 283, 164, 166, 290, 527, 863, 1275,
+  1737, 2219, 2692, 3124, 3487, 3760, 3924, 3968, 3891, 3696, 3397, 3012,
+  2566, 2087, 1605, 1150, 752, 434, 219, 117, 137, 277, 528, 874,
+  1294, 1761, 2247, 2721, 3153, 3517, 3790, 3956, 4003, 3930, 3740, 3446,
+  3066, 2623, 2144, 1659, 1198, 789, 456, 221, 98, 93, 208, 435,
+  761, 1164, 1622, 2106, 2586, 3035, 3423, 3729, 3934, 4025, 3997, 3853,
+  3599, 3253, 2834, 2369, 1884, 1409, 972, 599, 313, 129, 60, 109,
+  273, 542, 901, 1327, 1796, 2279, 2750, 3179, 3541, 3816, 3987, 4045,
+  3986, 3813, 3538, 3175, 2748, 2279, 1797, 1330, 905, 546, 275, 106,
+  50, 109, 279, 552, 911, 1335, 1800, 2279, 2745, 3171, 3532, 3808,
+  3984, 4050, 4001, 3841, 3580, 3232, 2817, 2359, 1883, 1418, 988, 618,
+  329, 138, 54, 82, 220, 461, 791, 1191, 1638, 2108, 2575, 3011,
+  3394, 3701, 3917, 4029, 4031, 3923, 3711, 3408, 3030, 2599, 2138, 1672,
+  1228, 829, 497, 251, 104, 63, 131, 303, 571, 918, 1327, 1774,
+  2236, 2687, 3103, 3461, 3743, 3932, 4020, 4001, 3877, 3655, 3347, 2970,
+  2544, 2092, 1638, 1207, 822, 503, 266, 125, 87, 153, 319, 577,
+  913, 1308, 1741, 2191, 2632, 3041, 3397, 3682, 3881, 3983, 3983, 3882,
+  3686, 3404, 3052, 2648, 2213, 1771, 1345, 956, 624, 367, 197, 124,
+  151, 275, 491, 787, 1147, 1553, 1983, 2416, 2829, 3202, 3514, 3751,
+  3900, 3954, 3912, 3774, 3549, 3248, 2887, 2484, 2060, 1637, 1235, 876,
+  577, 352, 214, 169, 218, 359, 585, 883, 1239, 1635, 2051, 2465,
+  2857, 3208, 3501, 3720, 3856, 3902, 3855, 3720, 3501, 3212, 2866, 2481,
+  2075, 1669, 1284, 936, 645, 423, 282, 228, 263, 385, 588, 862,
+  1193, 1564, 1958, 2356, 2737, 3083, 3379, 3609, 3763, 3833, 3817, 3717,
+  3536, 3284, 2973, 2619, 2239, 1851, 1474, 1126, 823, 579, 407, 313,
+  303, 375, 527, 751, 1035, 1367, 1729, 2106, 2479, 2829, 3142, 3403,
+  3598, 3720, 3763, 3725, 3609, 3420, 3168, 2864, 2524, 2162, 1797, 1445,
+  1122, 843, 622, 468, 387, 384, 458, 606, 819, 1089, 1401, 1742,
+  2096, 2446, 2777, 3073, 3321, 3509, 3630, 3678, 3652, 3552, 3384, 3157,
+  2880, 2566, 2230, 1887, 1553, 1243, 971, 749, 587, 491, 466, 512,
+  627, 806, 1039, 1317, 1627, 1954, 2284, 2601, 2893, 3146, 3348, 3492,
+  3571, 3582, 3525, 3402, 3221, 2988, 2714, 2413, 2097, 1780, 1477, 1201,
+  963, 774, 642, 572, 568, 628, 750, 929, 1155, 1420, 1710, 2014,
+  2318, 2608, 2873, 3101, 3282, 3408, 3475, 3481, 3424, 3308, 3138, 2923,
+  2671, 2394, 2103, 1811, 1532, 1276, 1054, 876, 750, 679, 667, 715,
+  818, 974, 1174, 1411, 1673, 1950, 2229, 2499, 2749, 2967, 3146, 3277,
+  3356, 3380, 3347, 3260, 3123, 2942, 2724, 2479, 2218, 1951, 1690, 1445,
+  1227, 1045, 905, 814, 774, 788, 854, 969, 1128, 1324, 1548, 1792,
+  2046, 2297, 2537, 2755, 2943, 3093, 3200, 3258, 3267, 3226, 3137, 3004,
+  2833, 2632, 2407, 2170, 1930, 1695, 1477, 1283, 1122, 999, 919, 886,
+  899, 959, 1063, 1205, 1380, 1581, 1800, 2027, 2253, 2470, 2668, 2840,
+  2980, 3081, 3141, 3156, 3128, 3057, 2946, 2801, 2627, 2431, 2221, 2006,
+  1795, 1594, 1414, 1259, 1137, 1051, 1006, 1001, 1038, 1114, 1226, 1370,
+  1539, 1727, 1925, 2128, 2325, 2511, 2677, 2817, 2927, 3002, 3039, 3038,
+  2998, 2922, 2813, 2676, 2515, 2337, 2150, 1960, 1776, 1603, 1448, 1318,
+  1217, 1149, 1115, 1117, 1155, 1227, 1329, 1458, 1608, 1774, 1949, 2127,
+  2300, 2462, 2607, 2730, 2826, 2892, 2926, 2927, 2894, 2830, 2737, 2619,
+  2481, 2328, 2165, 2000, 1838, 1685, 1547, 1429, 1335, 1268, 1231, 1225,
+  1249, 1303, 1384, 1489, 1613, 1753, 1903, 2056, 2208, 2353, 2485, 2600,
+  2694, 2764, 2806, 2820, 2806, 2765, 2697, 2607, 2497, 2372, 2236, 2094,
+  1953, 1816, 1688, 1575, 1480, 1407, 1358, 1334, 1336, 1364, 1416, 1491,
+  1585, 1694, 1816, 1945, 2076, 2205, 2327, 2439, 2535, 2612, 2669, 2704,
+  2714, 2701, 2665, 2607, 2530, 2437, 2331, 2216, 2096, 1975, 1859, 1750,
+  1653, 1571, 1507, 1462, 1438, 1437, 1456, 1496, 1556, 1632, 1721, 1822,
+  1929, 2039, 2149, 2254, 2350, 2435, 2506, 2561, 2597, 2613, 2610, 2587,
+  2547, 2489, 2417, 2332, 2239, 2141, 2040, 1941, 1846, 1760, 1684, 1622,
+  1575, 1545, 1532, 1537, 1560, 1599, 1653, 1720, 1797, 1882, 1972, 2063,
+  2153, 2238, 2316, 2384, 2440, 2483, 2509, 2521, 2516, 2495, 2460, 2411,
+  2351, 2281, 2204, 2123, 2041, 1960, 1882, 1811, 1749, 1698, 1659, 1633,
+  1622, 1625, 1642, 1672, 1714, 1767, 1829, 1897, 1970, 2044, 2117, 2188,
+  2253, 2310, 2358, 2395, 2421, 2434, 2434, 2422, 2397, 2362, 2316, 2263,
+  2203, 2139, 2073, 2007, 1943, 1883, 1830, 1784, 1748, 1722, 1706, 1702,
+  1709, 1728, 1756, 1793, 1838, 1890, 1945, 2004, 2063, 2121, 2175, 2225,
+  2269, 2305, 2332, 2350, 2358, 2357, 2345, 2324, 2295, 2258, 2215, 2167,
+  2117, 2065, 2013, 1963, 1916, 1874, 1839, 1810, 1790, 1778, 1774, 1780,
+  1793, 1815, 1843, 1878, 1918, 1961, 2006, 2052, 2097, 2140, 2179, 2214,
+  2243, 2266, 2282, 2290, 2291, 2284, 2270, 2249, 2223, 2191, 2156, 2118,
+  2078, 2038, 1999, 1962, 1928, 1899, 1875, 1856, 1844, 1838, 1838, 1845,
+  1859, 1877, 1901, 1929, 1960, 1993, 2028, 2062, 2096, 2128, 2156, 2181,
+  2202, 2218, 2228, 2233, 2232, 2225, 2214, 2197, 2177, 2153, 2126, 2097,
+  2068, 2038, 2009, 1982, 1958, 1936, 1918, 1905, 1896, 1891, 1892, 1897,
+  1907, 1920, 1937, 1958, 1980, 2005, 2030, 2055, 2080, 2103, 2124, 2143,
+  2158, 2170, 2179, 2183, 2183, 2180, 2172, 2162, 2148, 2131, 2112, 2092,
+  2071, 2050, 2029, 2009, 1991, 1974, 1961, 1950, 1942, 1937, 1936, 1938,
+  1943, 1951, 1962, 1975, 1990, 2007, 2024, 2042, 2059, 2076, 2092, 2106,
+  2118, 2128, 2136, 2141, 2143, 2143, 2139, 2134, 2126, 2116, 2104, 2091,
+  2077, 2063, 2048, 2034, 2021, 2009, 1998, 1988, 1981, 1976, 1973, 1972,
+  1974, 1977, 1982, 1990, 1998, 2008, 2019, 2031, 2042, 2054, 2065, 2075,
+  2085, 2093, 2100, 2105, 2109, 2111, 2111, 2109, 2106, 2101, 2095, 2088,
+  2080, 2071, 2062, 2053, 2043, 2035, 2027, 2019, 2013, 2008, 2004, 2002,
+  2001, 2001, 2003, 2005, 2009, 2014, 2020, 2026, 2033, 2040, 2047, 2054,
+  2061, 2067, 2072, 2077, 2081, 2084, 2085, 2086, 2086, 2084, 2082, 2079,
+  2076, 2071, 2066, 2061, 2056, 2051, 2046, 2041, 2036, 2032, 2029, 2026,
+  2024, 2023, 2022, 2022, 2023, 2025, 2027, 2030, 2033, 2036, 2040, 2044,
+  2047, 2051, 2055, 2058, 2061, 2063, 2065, 2067, 2068, 2068, 2068, 2067,
+  2066, 2065, 2063, 2061, 2059, 2056, 2054, 2051, 2049, 2046, 2044, 2042,
+  2040, 2039, 2038, 2037, 2037, 2037, 2037, 2038, 2039, 2040, 2041, 2043,
+  2044, 2046, 2047, 2049, 2050, 2052, 2053, 2054, 2055, 2055, 2056, 2056,
+  2056, 2056, 2056, 2055, 2055, 2054, 2053, 2052, 2051, 2051, 2050, 2049,
+  2048, 2048, 2047, 2047, 2046, 2046, 2046, 2046, 2046, 2046, 2046, 2046,
+  2047, 2047, 2048, 2048, 2048, 2049, 2049, 2049, 2050, 2050, 2050, 2050,
+  2050, 2050, 2050, 2050, 2050, 2050, 2050, 2050, 2050, 2050, 2049, 2049,
+  2049, 2049, 2049, 2049, 2049, 2049, 2049, 2049, 2049, 2049, 2049, 2049,
+  2049, 2049, 2049, 2049, 2560, 2555, 2541, 2519, 2490, 2453, 2411, 2365,
+  2317, 2268, 2221, 2176, 2136, 2102, 2076, 2057, 2048, 2049, 2059, 2078,
+  2106, 2141, 2183, 2229, 2278, 2328, 2377, 2424, 2466, 2501, 2529, 2549,
+  2558, 2558, 2548, 2528, 2499, 2462, 2419, 2371, 2320, 2269, 2219, 2172,
+  2131, 2096, 2070, 2054, 2048, 2052, 2067, 2091, 2125, 2166, 2213, 2264,
+  2316, 2369, 2418, 2463, 2501, 2530, 2550, 2559, 2557, 2544, 2521, 2487,
+  2446, 2399, 2347, 2293, 2240, 2189, 2143, 2105, 2075, 2056, 2048, 2051,
+  2066, 2092, 2128, 2172, 2222, 2276, 2331, 2385, 2435, 2480, 2516, 2542,
+  2556, 2559, 2550, 2528, 2496, 2455, 2406, 2352, 2296, 2240, 2187, 2139,
+  2100, 2071, 2053, 2048, 2055, 2075, 2106, 2148, 2197, 2252, 2310, 2367,
+  2421, 2469, 2509, 2538, 2555, 2559, 2550, 2527, 2493, 2449, 2397, 2340,
+  2281, 2223, 2169, 2122, 2086, 2060, 2048, 2050, 2066, 2095, 2135, 2185,
+  2241, 2301, 2361, 2418, 2469, 2510, 2540, 2556, 2559, 2546, 2520, 2481,
+  2432, 2376, 2315, 2253, 2195, 2142, 2099, 2068, 2051, 2048, 2061, 2089,
+  2129, 2179, 2238, 2300, 2363, 2422, 2474, 2516, 2544, 2558, 2557, 2539,
+  2507, 2462, 2407, 2346, 2282, 2219, 2161, 2112, 2076, 2054, 2048, 2058,
+  2084, 2125, 2177, 2237, 2302, 2367, 2428, 2481, 2522, 2549, 2559, 2553,
+  2529, 2491, 2439, 2379, 2313, 2246, 2183, 2129, 2086, 2058, 2048, 2055,
+  2079, 2119, 2172, 2235, 2302, 2370, 2433, 2487, 2527, 2552, 2559, 2548,
+  2519, 2474, 2417, 2351, 2282, 2214, 2153, 2102, 2067, 2049, 2051, 2071,
+  2109, 2161, 2225, 2294, 2365, 2430, 2486, 2529, 2553, 2559, 2545, 2511,
+  2462, 2400, 2330, 2258, 2190, 2130, 2085, 2056, 2048, 2060, 2091, 2140,
+  2203, 2273, 2347, 2416, 2477, 2523, 2552, 2559, 2546, 2512, 2460, 2395,
+  2323, 2249, 2179, 2119, 2076, 2052, 2049, 2069, 2108, 2165, 2234, 2310,
+  2384, 2452, 2507, 2544, 2559, 2552, 2522, 2473, 2409, 2335, 2257, 2184,
+  2122, 2076, 2051, 2050, 2071, 2114, 2175, 2248, 2326, 2402, 2469, 2521,
+  2552, 2559, 2542, 2502, 2443, 2371, 2291, 2213, 2144, 2090, 2057, 2048,
+  2064, 2104, 2163, 2237, 2318, 2397, 2467, 2520, 2552, 2559, 2539, 2496,
+  2433, 2356, 2274, 2195, 2127, 2077, 2051, 2051, 2077, 2128, 2197, 2277,
+  2361, 2438, 2501, 2543, 2559, 2548, 2510, 2450, 2373, 2289, 2206, 2134,
+  2081, 2052, 2051, 2078, 2130, 2202, 2286, 2371, 2450, 2511, 2549, 2559,
+  2540, 2493, 2425, 2342, 2255, 2173, 2106, 2063, 2048, 2062, 2106, 2173,
+  2256, 2344, 2428, 2497, 2543, 2559, 2545, 2501, 2433, 2349, 2259, 2175,
+  2106, 2062, 2048, 2065, 2113, 2185, 2272, 2363, 2446, 2512, 2551, 2558,
+  2533, 2478, 2400, 2310, 2218, 2138, 2079, 2050, 2054, 2091, 2157, 2242,
+  2335, 2425, 2498, 2545, 2559, 2539, 2487, 2409, 2317, 2223, 2140, 2079,
+  2050, 2055, 2096, 2166, 2255, 2351, 2441, 2511, 2552, 2557, 2526, 2463,
+  2377, 2280, 2186, 2110, 2061, 2048, 2072, 2131, 2215, 2313, 2409, 2490,
+  2542, 2559, 2538, 2481, 2396, 2298, 2200, 2118, 2065, 2048, 2070, 2129,
+  2215, 2315, 2414, 2495, 2546, 2559, 2531, 2467, 2377, 2275, 2177, 2100,
+  2055, 2051, 2088, 2160, 2256, 2359, 2454, 2524, 2558, 2549, 2499, 2416,
+  2315, 2211, 2123, 2065, 2048, 2074, 2140, 2234, 2340, 2440, 2517, 2556,
+  2551, 2503, 2420, 2316, 2210, 2120, 2063, 2048, 2080, 2151, 2250, 2359,
+  2458, 2529, 2559, 2542, 2482, 2388, 2279, 2174, 2093, 2051, 2057, 2108,
+  2197, 2306, 2415, 2502, 2552, 2554, 2509, 2423, 2314, 2203, 2112, 2057,
+  2051, 2094, 2179, 2288, 2401, 2494, 2549, 2556, 2512, 2425, 2314, 2201,
+  2108, 2055, 2053, 2102, 2193, 2306, 2420, 2509, 2555, 2549, 2492, 2394,
+  2278, 2166, 2084, 2048, 2067, 2137, 2242, 2361, 2468, 2539, 2559, 2523,
+  2439, 2325, 2206, 2109, 2054, 2055, 2112, 2211, 2332, 2446, 2528, 2559,
+  2532, 2453, 2339, 2217, 2115, 2056, 2054, 2111, 2213, 2336, 2451, 2532,
+  2559, 2526, 2439, 2320, 2197, 2099, 2050, 2063, 2134, 2246, 2373, 2483,
+  2548, 2554, 2498, 2393, 2266, 2148, 2069, 2049, 2092, 2190, 2316, 2439,
+  2528, 2559, 2525, 2434, 2309, 2182, 2087, 2048, 2076, 2163, 2288, 2417,
+  2516, 2559, 2534, 2447, 2321, 2191, 2091, 2048, 2075, 2164, 2291, 2422,
+  2521, 2559, 2527, 2433, 2302, 2172, 2078, 2048, 2089, 2192, 2326, 2454,
+  2539, 2557, 2502, 2390, 2252, 2129, 2057, 2057, 2129, 2252, 2391, 2504,
+  2558, 2536, 2445, 2311, 2175, 2077, 2048, 2096, 2207, 2348, 2475, 2550,
+  2549, 2472, 2343, 2201, 2091, 2048, 2084, 2190, 2332, 2465, 2547, 2551,
+  2476, 2346, 2202, 2090, 2048, 2088, 2199, 2344, 2476, 2552, 2545, 2459,
+  2321, 2177, 2075, 2049, 2109, 2235, 2384, 2506, 2559, 2525, 2415, 2267,
+  2131, 2054, 2064, 2157, 2302, 2447, 2542, 2553, 2476, 2338, 2187, 2078,
+  2049, 2112, 2244, 2397, 2517, 2559, 2508, 2383, 2227, 2100, 2048, 2090,
+  2212, 2368, 2500, 2559, 2522, 2402, 2245, 2110, 2048, 2084, 2204, 2363,
+  2498, 2559, 2520, 2397, 2238, 2103, 2048, 2093, 2221, 2383, 2513, 2559,
+  2504, 2368, 2205, 2083, 2049, 2119, 2264, 2426, 2537, 2553, 2465, 2311,
+  2153, 2058, 2065, 2173, 2335, 2485, 2558, 2523, 2394, 2227, 2092, 2048,
+  2114, 2262, 2428, 2540, 2549, 2450, 2287, 2130, 2050, 2083, 2213, 2384,
+  2519, 2558, 2482, 2325, 2158, 2057, 2069, 2187, 2359, 2506, 2559, 2494,
+  2341, 2169, 2061, 2066, 2183, 2357, 2506, 2559, 2491, 2333, 2161, 2057,
+  2072, 2199, 2377, 2519, 2557, 2470, 2302, 2134, 2050, 2091, 2238, 2418,
+  2541, 2545, 2427, 2247, 2095, 2049, 2132, 2303, 2475, 2558, 2510, 2355,
+  2173, 2059, 2072, 2206, 2392, 2531, 2550, 2438, 2255, 2097, 2049, 2138,
+  2316, 2488, 2559, 2492, 2322, 2141, 2050, 2097, 2259, 2445, 2553, 2522,
+  2369, 2179, 2058, 2076, 2222, 2415, 2544, 2536, 2395, 2201, 2066, 2068,
+  2206, 2401, 2540, 2540, 2402, 2205, 2067, 2068, 2209, 2407, 2543, 2536,
+  2389, 2190, 2060, 2077, 2232, 2431, 2552, 2520, 2355, 2158, 2051, 2100,
+  2277, 2470, 2559, 2488, 2300, 2114, 2048, 2145, 2343, 2516, 2553, 2428,
+  2223, 2070, 2068, 2220, 2427, 2552, 2515, 2337, 2137, 2048, 2128, 2326,
+  2509, 2554, 2430, 2220, 2067, 2074, 2238, 2447, 2558, 2493, 2297, 2106,
+  2051, 2173, 2386, 2541, 2530, 2358, 2148, 2048, 2130, 2336, 2519, 2548,
+  2400, 2183, 2053, 2105, 2302, 2501, 2555, 2424, 2204, 2058, 2094, 2286,
+  2492, 2557, 2431, 2209, 2058, 2094, 2288, 2495, 2555, 2422, 2198, 2054,
+  2104, 2309, 2510, 2549, 2396, 2170, 2049, 2129, 2347, 2531, 2534, 2352,
+  2131, 2049, 2173, 2403, 2552, 2499, 2286, 2087, 1023, 1023, 1023, 1023,
+  1023, 1023, 1023, 1022, 1021, 1020, 1019, 1018, 1017, 1017, 1017, 1019,
+  1021, 1024, 1028, 1032, 1036, 1040, 1042, 1044, 1043, 1041, 1036, 1029,
+  1021, 1011, 1001, 992, 984, 979, 977, 979, 985, 995, 1008, 1025,
+  1043, 1061, 1077, 1091, 1099, 1102, 1099, 1089, 1072, 1049, 1023, 994,
+  966, 940, 919, 905, 901, 906, 921, 946, 979, 1018, 1060, 1101,
+  1139, 1168, 1188, 1195, 1188, 1167, 1133, 1088, 1035, 978, 922, 872,
+  831, 804, 793, 801, 828, 872, 930, 999, 1072, 1145, 1211, 1264,
+  1300, 1314, 1306, 1274, 1220, 1148, 1063, 972, 881, 798, 731, 685,
+  665, 673, 710, 774, 860, 962, 1072, 1182, 1283, 1366, 1423, 1450,
+  1443, 1402, 1329, 1229, 1109, 979, 849, 729, 630, 560, 525, 530,
+  574, 656, 770, 907, 1057, 1207, 1346, 1463, 1547, 1590, 1589, 1542,
+  1452, 1326, 1173, 1004, 833, 673, 539, 441, 387, 384, 432, 528,
+  666, 835, 1023, 1214, 1393, 1545, 1658, 1723, 1732, 1684, 1583, 1434,
+  1251, 1046, 836, 638, 468, 339, 263, 248, 294, 399, 555, 752,
+  972, 1200, 1416, 1604, 1748, 1835, 1859, 1816, 1709, 1545, 1338, 1104,
+  860, 627, 423, 264, 165, 133, 172, 279, 447, 662, 908, 1166,
+  1415, 1634, 1807, 1918, 1959, 1925, 1819, 1649, 1428, 1172, 903, 641,
+  408, 223, 100, 50, 77, 180, 350, 576, 838, 1116, 1388, 1633,
+  1830, 1964, 2023, 2003, 1905, 1736, 1510, 1244, 959, 679, 425, 217,
+  74, 5, 18, 110, 275, 500, 767, 1055, 1341, 1602, 1817, 1969,
+  2047, 2042, 1957, 1798, 1576, 1311, 1023, 735, 469, 248, 89, 4,
+  0, 77, 229, 444, 705, 990, 1278, 1545, 1770, 1935, 2027, 2039,
+  1970, 1827, 1620, 1366, 1086, 802, 537, 311, 142, 44, 25, 84,
+  217, 414, 658, 930, 1207, 1469, 1693, 1863, 1966, 1993, 1943, 1820,
+  1635, 1403, 1142, 874, 620, 399, 229, 124, 91, 131, 242, 414,
+  633, 880, 1137, 1382, 1596, 1763, 1870, 1908, 1876, 1777, 1620, 1416,
+  1184, 942, 709, 503, 341, 235, 192, 215, 302, 445, 632, 847,
+  1073, 1292, 1487, 1642, 1747, 1792, 1776, 1701, 1574, 1405, 1208, 1000,
+  796, 614, 468, 367, 320, 329, 393, 505, 656, 834, 1023, 1208,
+  1376, 1513, 1608, 1655, 1652, 1599, 1502, 1369, 1211, 1042, 875, 723,
+  598, 509, 463, 462, 505, 588, 703, 841, 989, 1137, 1272, 1385,
+  1465, 1509, 1514, 1480, 1410, 1312, 1194, 1066, 938, 820, 721, 649,
+  609, 602, 628, 685, 766, 866, 974, 1083, 1183, 1268, 1330, 1367,
+  1375, 1355, 1310, 1243, 1162, 1073, 983, 900, 829, 777, 745, 737,
+  751, 787, 839, 903, 975, 1046, 1113, 1170, 1213, 1239, 1247, 1236,
+  1210, 1170, 1121, 1066, 1011, 959, 915, 882, 862, 855, 862, 881,
+  910, 947, 987, 1027, 1065, 1097, 1121, 1136, 1141, 1136, 1123, 1103,
+  1078, 1050, 1023, 997, 976, 960, 950, 946, 949, 958, 971, 987,
+  1004, 1021, 1036, 1049, 1059, 1064, 1066, 1064, 1059, 1052, 1043, 1034,
+  1025, 1017, 1011, 1006, 1004, 1004, 1005, 1007, 1011, 1015, 1018, 1022,
+  1024, 1026, 1027, 1028, 1028, 1027, 1026, 1025, 1024, 1023, 1023, 1023,
+  1023, 1023, 1023, 1023,
+};
+
+#endif
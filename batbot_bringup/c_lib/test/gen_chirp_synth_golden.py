@@ -0,0 +1,79 @@
+"""
+Writes chirp_synth_golden.hpp, the golden vectors for test_chirp_synth
+
+Each chirp is made the way EchoEmitter.gen_chirp makes it: scipy.signal.chirp sampled at
+1 MHz, optionally windowed, stretched over offset to offset + gain and truncated to
+uint16, all in float64. chirpSynth must land within 1 LSB of every sample.
+
+    python3 gen_chirp_synth_golden.py > chirp_synth_golden.hpp
+"""
+
+import numpy as np
+from scipy import signal
+
+FS = 1000000
+
+METHODS = ["linear", "quadratic", "logarithmic", "hyperbolic"]
+WINDOWS = [None, "hann", "hamming", "blackman"]
+
+# f0, f1, duration in us, method, window, gain, offset
+CASES = [
+    (100000, 30000, 2000, "linear", None, 512, 2048),
+    (20000, 120000, 1500, "quadratic", "hann", 512, 2048),
+    (100000, 20000, 3000, "logarithmic", "hamming", 1000, 1500),
+    (80000, 25000, 2000, "hyperbolic", "blackman", 4000, 50),
+    (30000, 150000, 1000, "logarithmic", None, 512, 2048),
+    (45000, 45000, 500, "hyperbolic", "hann", 2047, 0),
+]
+
+
+def gen_chirp(f0, f1, duration_us, method, window, gain, offset):
+    t_end = duration_us / 1e3
+    Ts = 1 / FS
+    t = np.arange(0, t_end * 1e-3 - Ts / 2, Ts)
+    chirp = signal.chirp(t, f0, t_end * 1e-3, f1, method)
+    if window is not None:
+        chirp = chirp * {"hann": np.hanning, "hamming": np.hamming, "blackman": np.blackman}[window](chirp.size)
+    chirp = chirp - np.min(chirp)
+    chirp = chirp / np.max(chirp)
+    return (chirp * gain + offset).astype(np.uint16)
+
+
+def array(ctype, name, values):
+    lines = ["static const %s %s[%d] = {" % (ctype, name, len(values))]
+    for i in range(0, len(values), 12):
+        lines.append("  " + ", ".join(str(int(v)) for v in values[i:i + 12]) + ",")
+    lines.append("};")
+    return "\n".join(lines)
+
+
+def main():
+    samples = []
+    print("/**")
+    print(" * @file")
+    print(" * @brief Golden vectors for test_chirp_synth, written by gen_chirp_synth_golden.py")
+    print(" */")
+    print("#ifndef CHIRP_SYNTH_GOLDEN_HPP")
+    print("#define CHIRP_SYNTH_GOLDEN_HPP")
+    print()
+    print("#include <stdint.h>")
+    print()
+    print("#include \"chirp_synth.hpp\"")
+    print()
+    print("#define CHIRP_SYNTH_GOLDEN_CASES %d" % len(CASES))
+    print()
+    print("static const ChirpParams chirp_synth_golden_params[%d] = {" % len(CASES))
+    for f0, f1, duration, method, window, gain, offset in CASES:
+        print("  {%d, %d, %d, %d, %d, 0, %d, %d}," % (f0, f1, duration, METHODS.index(method),
+                                                     WINDOWS.index(window), gain, offset))
+        samples.append(gen_chirp(f0, f1, duration, method, window, gain, offset))
+    print("};")
+    print()
+    print("// the cases back to back")
+    print(array("uint16_t", "chirp_synth_golden_samples", np.concatenate(samples)))
+    print()
+    print("#endif")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,92 @@
+"""
+Writes sonar_ddc_golden.hpp, the golden vectors for test_sonar_ddc
+
+The expected output is computed the textbook way, independently of SonarDDC: every
+input sample is mixed down by e^{-jwn}, the product goes through the Hamming windowed
+sinc low pass and every 8th output is kept, the one on the last of each 8 samples, all
+in float64. SonarDDC filters first and mixes after decimating, in float32, so the two
+only agree to within rounding.
+
+    python3 gen_sonar_ddc_golden.py > sonar_ddc_golden.hpp
+"""
+
+import numpy as np
+
+FS = 2000000
+DECIMATION = 8
+TAPS = 128
+CENTER = 65000
+CUTOFF = 40000
+MIDSCALE = 512
+GAIN = 32.0
+BLOCK = 1016
+BLOCKS = 2
+
+
+def make_input():
+    rng = np.random.default_rng(20240917)
+    n = np.arange(BLOCK * BLOCKS)
+    x = (MIDSCALE
+         + 200 * np.sin(2 * np.pi * 70000 / FS * n + 0.3)
+         + 150 * np.sin(2 * np.pi * 45000 / FS * n + 1.1)
+         + 100 * np.sin(2 * np.pi * 300000 / FS * n)
+         + rng.normal(0, 20, n.size))
+    return np.clip(np.round(x), 0, 1023).astype(np.uint16)
+
+
+def lowpass():
+    fc = CUTOFF / FS
+    t = np.arange(TAPS) - (TAPS - 1) / 2
+    h = 2 * fc * np.sinc(2 * fc * t) * np.hamming(TAPS)
+    return h / h.sum()
+
+
+def reference(x):
+    n = np.arange(x.size)
+    mixed = (x.astype(np.float64) - MIDSCALE) * np.exp(-2j * np.pi * CENTER / FS * n)
+    # zero history before the first sample, as after SonarDDC::reset()
+    y = np.convolve(mixed, lowpass())[:x.size]
+    # outputs at the last sample of every DECIMATION, as arm_fir_decimate_f32 takes them
+    y = y[DECIMATION - 1::DECIMATION] * GAIN
+    iq = np.empty(2 * y.size)
+    iq[0::2] = y.real
+    iq[1::2] = y.imag
+    return np.clip(np.round(iq), -32768, 32767).astype(np.int16)
+
+
+def array(ctype, name, values):
+    lines = ["static const %s %s[%d] = {" % (ctype, name, len(values))]
+    for i in range(0, len(values), 12):
+        lines.append("  " + ", ".join(str(int(v)) for v in values[i:i + 12]) + ",")
+    lines.append("};")
+    return "\n".join(lines)
+
+
+def main():
+    x = make_input()
+    iq = reference(x)
+    print("/**")
+    print(" * @file")
+    print(" * @brief Golden vectors for test_sonar_ddc, written by gen_sonar_ddc_golden.py")
+    print(" */")
+    print("#ifndef SONAR_DDC_GOLDEN_HPP")
+    print("#define SONAR_DDC_GOLDEN_HPP")
+    print()
+    print("#include <stdint.h>")
+    print()
+    print("#define SONAR_DDC_GOLDEN_RATE %d" % FS)
+    print("#define SONAR_DDC_GOLDEN_BLOCK %d" % BLOCK)
+    print("#define SONAR_DDC_GOLDEN_SAMPLES %d" % x.size)
+    print("#define SONAR_DDC_GOLDEN_OUTPUTS %d" % (iq.size // 2))
+    print()
+    print("// 70 and 45 kHz in band, 300 kHz out of band, plus noise")
+    print(array("uint16_t", "sonar_ddc_golden_input", x))
+    print()
+    print("// I, Q interleaved")
+    print(array("int16_t", "sonar_ddc_golden_iq", iq))
+    print()
+    print("#endif")
+
+
+if __name__ == "__main__":
+    main()
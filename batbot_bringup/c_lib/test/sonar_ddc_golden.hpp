@@ -0,0 +1,236 @@
+/**
+ * @file
+ * @brief Golden vectors for test_sonar_ddc, written by gen_sonar_ddc_golden.py
+ */
+#ifndef SONAR_DDC_GOLDEN_HPP
+#define SONAR_DDC_GOLDEN_HPP
+
+#include <stdint.h>
+
+#define SONAR_DDC_GOLDEN_RATE 2000000
+#define SONAR_DDC_GOLDEN_BLOCK 1016
+#define SONAR_DDC_GOLDEN_SAMPLES 2032
+#define SONAR_DDC_GOLDEN_OUTPUTS 254
+
+// 70 and 45 kHz in band, 300 kHz out of band, plus noise
+static const uint16_t sonar_ddc_golden_input[2032] = {
+  708, 827, 875, 875, 763, 770, 809, 858, 855, 903, 711, 574,
+  538, 525, 492, 524, 429, 272, 119, 106, 219, 277, 274, 274,
+  190, 172, 245, 413, 508, 554, 497, 452, 530, 605, 676, 750,
+  729, 634, 577, 575, 677, 720, 705, 632, 494, 390, 420, 549,
+  565, 554, 457, 394, 396, 500, 561, 658, 648, 546, 537, 556,
+  600, 715, 737, 657, 546, 488, 486, 532, 558, 506, 369, 226,
+  183, 236, 292, 306, 268, 178, 147, 211, 327, 435, 540, 525,
+  513, 513, 586, 748, 865, 923, 826, 785, 753, 828, 886, 873,
+  842, 680, 548, 502, 516, 539, 513, 356, 253, 163, 194, 286,
+  340, 337, 280, 195, 218, 350, 455, 547, 528, 478, 485, 523,
+  649, 640, 716, 659, 521, 485, 521, 603, 663, 588, 495, 379,
+  334, 419, 505, 563, 544, 456, 424, 496, 568, 716, 763, 678,
+  605, 622, 648, 740, 793, 765, 669, 554, 489, 493, 549, 514,
+  428, 265, 192, 133, 211, 295, 279, 217, 192, 111, 199, 322,
+  481, 525, 503, 493, 515, 693, 775, 888, 862, 803, 760, 772,
+  862, 890, 837, 735, 614, 537, 516, 543, 538, 479, 339, 251,
+  206, 270, 376, 417, 387, 299, 272, 341, 463, 543, 605, 564,
+  519, 473, 525, 614, 663, 633, 549, 416, 412, 455, 500, 535,
+  496, 369, 302, 351, 383, 517, 561, 516, 460, 455, 554, 668,
+  780, 784, 716, 698, 694, 750, 834, 842, 790, 666, 539, 521,
+  518, 519, 482, 361, 225, 132, 135, 198, 253, 272, 149, 125,
+  126, 241, 414, 502, 500, 485, 483, 523, 670, 843, 843, 808,
+  730, 687, 743, 805, 850, 776, 656, 553, 441, 505, 569, 570,
+  463, 387, 284, 272, 366, 455, 507, 408, 378, 359, 447, 538,
+  597, 639, 551, 508, 458, 482, 593, 615, 552, 427, 394, 296,
+  413, 464, 436, 368, 292, 241, 297, 408, 494, 552, 512, 482,
+  534, 649, 768, 868, 848, 794, 742, 743, 817, 865, 865, 775,
+  635, 533, 466, 470, 482, 423, 300, 155, 126, 160, 235, 268,
+  232, 170, 129, 197, 311, 427, 514, 486, 442, 468, 589, 695,
+  774, 836, 747, 660, 688, 703, 792, 761, 742, 603, 457, 440,
+  483, 549, 549, 535, 343, 335, 390, 496, 590, 560, 530, 417,
+  456, 512, 663, 668, 644, 572, 454, 440, 528, 580, 567, 492,
+  343, 291, 246, 333, 379, 357, 256, 212, 243, 291, 451, 514,
+  491, 517, 506, 570, 742, 843, 849, 887, 808, 783, 744, 883,
+  897, 879, 731, 591, 515, 506, 538, 510, 405, 259, 162, 158,
+  212, 257, 286, 280, 142, 189, 254, 379, 538, 524, 539, 474,
+  496, 595, 737, 763, 777, 656, 585, 559, 665, 664, 705, 588,
+  472, 425, 418, 516, 578, 566, 459, 398, 375, 492, 559, 637,
+  637, 565, 516, 561, 664, 705, 733, 615, 541, 481, 485, 524,
+  524, 515, 361, 237, 209, 255, 275, 312, 266, 168, 150, 219,
+  317, 474, 541, 553, 499, 515, 603, 743, 860, 910, 850, 769,
+  773, 841, 885, 909, 803, 662, 576, 491, 488, 573, 497, 417,
+  254, 145, 188, 284, 319, 356, 294, 209, 253, 326, 477, 591,
+  551, 496, 436, 520, 605, 682, 701, 673, 570, 524, 521, 574,
+  620, 551, 496, 387, 355, 422, 563, 554, 506, 496, 447, 430,
+  565, 686, 753, 673, 635, 608, 656, 722, 798, 746, 681, 548,
+  460, 477, 562, 547, 458, 290, 155, 161, 188, 251, 237, 220,
+  142, 153, 228, 368, 463, 546, 493, 486, 557, 690, 783, 853,
+  892, 787, 753, 726, 825, 906, 857, 732, 631, 504, 518, 533,
+  551, 482, 392, 246, 240, 235, 391, 405, 390, 319, 273, 325,
+  436, 555, 597, 556, 485, 482, 506, 583, 723, 639, 546, 416,
+  395, 470, 501, 528, 455, 370, 319, 320, 420, 511, 585, 470,
+  473, 470, 531, 681, 764, 793, 743, 702, 624, 744, 832, 824,
+  776, 651, 534, 485, 512, 505, 480, 330, 277, 150, 132, 201,
+  234, 204, 204, 135, 133, 265, 409, 513, 532, 507, 515, 577,
+  710, 843, 884, 822, 735, 707, 747, 767, 881, 802, 668, 530,
+  472, 525, 581, 554, 475, 371, 269, 269, 371, 443, 492, 431,
+  378, 357, 452, 545, 609, 634, 559, 509, 472, 526, 613, 650,
+  561, 430, 337, 366, 381, 430, 464, 380, 258, 232, 347, 426,
+  541, 551, 525, 484, 499, 620, 779, 860, 831, 785, 761, 722,
+  844, 878, 848, 744, 597, 494, 485, 486, 536, 447, 276, 210,
+  111, 169, 226, 275, 239, 182, 164, 167, 310, 422, 529, 543,
+  479, 506, 552, 708, 786, 822, 715, 639, 675, 706, 777, 766,
+  705, 576, 450, 445, 532, 573, 559, 458, 391, 312, 377, 488,
+  567, 574, 546, 465, 441, 511, 643, 688, 624, 543, 509, 511,
+  526, 615, 570, 435, 354, 247, 250, 337, 375, 346, 269, 205,
+  212, 250, 449, 509, 552, 514, 496, 556, 708, 845, 859, 862,
+  782, 786, 800, 889, 902, 855, 735, 552, 518, 541, 524, 505,
+  404, 279, 176, 146, 208, 262, 287, 262, 187, 179, 244, 382,
+  521, 554, 488, 464, 485, 634, 734, 780, 747, 700, 579, 607,
+  603, 718, 682, 628, 454, 445, 434, 542, 563, 572, 447, 386,
+  387, 517, 584, 697, 657, 653, 485, 563, 653, 749, 714, 659,
+  530, 501, 526, 563, 528, 487, 355, 248, 190, 232, 317, 331,
+  305, 174, 133, 175, 385, 438, 523, 529, 499, 535, 627, 782,
+  883, 850, 825, 761, 777, 813, 906, 909, 813, 689, 550, 537,
+  525, 531, 484, 429, 239, 176, 223, 274, 324, 327, 286, 241,
+  209, 355, 428, 553, 563, 509, 455, 490, 590, 733, 669, 626,
+  489, 534, 509, 593, 612, 560, 507, 419, 364, 435, 506, 587,
+  542, 472, 445, 441, 592, 678, 733, 708, 627, 600, 661, 756,
+  812, 759, 666, 535, 477, 472, 531, 545, 377, 293, 184, 167,
+  172, 253, 266, 219, 152, 164, 204, 384, 452, 533, 499, 501,
+  554, 655, 826, 916, 876, 790, 734, 765, 869, 852, 871, 755,
+  596, 535, 507, 539, 553, 493, 413, 253, 197, 276, 369, 404,
+  375, 303, 283, 330, 412, 535, 614, 585, 502, 494, 551, 613,
+  690, 657, 556, 437, 401, 451, 509, 541, 459, 393, 297, 305,
+  422, 519, 550, 500, 494, 488, 552, 675, 786, 772, 749, 695,
+  659, 740, 814, 831, 817, 637, 526, 496, 551, 527, 488, 377,
+  216, 161, 148, 216, 266, 293, 168, 123, 129, 273, 389, 491,
+  535, 494, 474, 575, 662, 818, 858, 831, 743, 723, 725, 798,
+  821, 805, 675, 560, 466, 518, 567, 555, 484, 352, 266, 287,
+  365, 503, 492, 463, 348, 386, 439, 524, 603, 655, 564, 512,
+  453, 507, 621, 632, 508, 437, 350, 330, 396, 438, 452, 350,
+  246, 223, 291, 392, 511, 574, 494, 508, 512, 633, 719, 852,
+  827, 802, 686, 712, 811, 891, 843, 767, 599, 490, 479, 539,
+  533, 462, 290, 162, 93, 131, 254, 283, 195, 176, 160, 206,
+  326, 420, 540, 525, 477, 481, 580, 712, 791, 797, 783, 669,
+  621, 675, 752, 774, 681, 562, 462, 465, 484, 583, 539, 495,
+  378, 365, 355, 492, 551, 599, 523, 466, 432, 537, 636, 696,
+  651, 581, 485, 482, 517, 582, 582, 470, 325, 272, 255, 342,
+  382, 371, 288, 188, 192, 291, 451, 531, 532, 486, 500, 564,
+  704, 849, 896, 847, 792, 769, 799, 870, 900, 856, 734, 600,
+  508, 524, 523, 528, 420, 255, 175, 185, 184, 262, 279, 269,
+  171, 159, 234, 362, 491, 575, 539, 473, 508, 617, 719, 783,
+  686, 657, 593, 571, 642, 679, 684, 607, 451, 395, 401, 502,
+  542, 534, 477, 359, 403, 485, 612, 632, 626, 562, 525, 539,
+  636, 727, 758, 649, 511, 447, 470, 546, 553, 502, 343, 284,
+  184, 249, 294, 331, 283, 191, 161, 188, 292, 486, 499, 519,
+  531, 518, 616, 734, 838, 903, 858, 774, 757, 824, 869, 883,
+  776, 682, 584, 481, 505, 539, 494, 371, 237, 188, 191, 284,
+  372, 337, 285, 181, 250, 365, 438, 575, 545, 482, 449, 448,
+  605, 724, 701, 606, 531, 533, 503, 586, 613, 624, 490, 390,
+  392, 410, 525, 631, 540, 483, 431, 463, 582, 712, 744, 720,
+  593, 590, 655, 749, 820, 799, 638, 539, 506, 457, 532, 514,
+  443, 289, 172, 204, 220, 236, 240, 203, 146, 152, 230, 368,
+  472, 519, 493, 533, 532, 643, 786, 888, 848, 791, 781, 741,
+  810, 881, 865, 705, 588, 495, 496, 529, 570, 485, 372, 243,
+  222, 279, 358, 401, 409, 276, 301, 330, 438, 544, 572, 529,
+  498, 482, 512, 605, 645, 666, 575, 460, 394, 477, 506, 528,
+  484, 402, 332, 342, 428, 534, 551, 526, 439, 474, 508, 661,
+  784, 805, 801, 720, 673, 760, 817, 798, 780, 630, 515, 507,
+  515, 500, 498, 397, 198, 115, 146, 181, 282, 271, 179, 110,
+  153, 266, 419, 497, 477, 525, 463, 563, 732, 823, 846, 883,
+  745, 704, 739, 807, 847, 802, 683, 512, 492, 520, 494, 556,
+  458, 323, 253, 302, 378, 444, 522, 466, 360, 366, 429, 522,
+  619, 621, 595, 475, 470, 487, 574, 599, 556, 445, 336, 319,
+  382, 396, 418, 356, 278, 264, 300, 395, 551, 562, 502, 516,
+  538, 630, 790, 849, 847, 750, 760, 775, 800, 887, 860, 780,
+  575, 541, 526, 524, 510, 462, 332, 184, 118, 142, 227, 243,
+  227, 191, 147, 193, 308, 433, 530, 481, 480, 478, 597, 745,
+  807, 844, 756, 680, 646, 690, 769, 748, 727, 544, 471, 501,
+  481, 565, 544, 451, 382, 340, 372, 482, 542, 584, 520, 434,
+  450, 552, 633, 674, 652, 535, 519, 457, 532, 543, 559, 442,
+  318, 306, 268, 338, 382, 371, 263, 234, 224, 297, 457, 521,
+  533, 513, 478, 578, 678, 847, 865, 866, 799, 752, 799, 856,
+  908, 849, 704, 592, 529, 500, 543, 504, 392, 279, 204, 153,
+  209, 294, 290, 236, 207, 195, 238, 396, 513, 544, 473, 456,
+  472, 596, 709, 809, 732, 669, 593, 576, 642, 671, 663, 586,
+  470, 400, 416, 501, 565, 511, 452, 383, 384, 477, 562, 680,
+  614, 546, 538, 532, 635, 716, 743, 636, 533, 434, 466, 523,
+  543, 471, 391, 199, 218, 216, 302, 323, 294, 209, 101, 201,
+  324, 458, 554, 511, 524, 519, 610, 735, 900, 892, 845, 774,
+  767, 849, 867, 856, 825, 677, 583, 505, 499, 529, 523, 373,
+  225, 173, 203, 282, 360, 329, 287, 225, 234, 340, 457, 551,
+  559, 535, 502, 526, 589, 702, 720, 616, 540, 509, 483, 556,
+  655, 616, 481, 378, 401, 410, 542, 549, 540, 421, 443, 500,
+  563, 677, 710, 693, 604, 610, 649, 764, 804, 767, 654, 512,
+  466, 471, 531, 522, 411, 278, 132, 173, 198, 222, 257, 218,
+  132, 131, 227, 383, 501, 497, 529, 493, 557, 678, 801, 879,
+  865, 823, 751, 771, 827, 891, 883, 737, 590, 502, 516, 550,
+  543, 477, 341, 268, 240, 278, 359, 425, 412, 344, 262, 323,
+  431, 523, 614, 545, 510, 449, 479, 592, 667, 647, 561, 443,
+  417, 433, 510, 498, 491, 384, 275, 361, 424, 488, 576, 527,
+  467, 501, 559, 674, 790, 782, 764, 704, 702, 734, 827, 863,
+  769, 654, 526, 470, 477, 526, 466, 382, 215, 119, 98, 214,
+  261, 248, 173, 128, 146, 269, 404, 479, 559, 498, 486, 559,
+  706, 801, 859, 820, 746, 726, 780, 812, 826, 789, 652, 544,
+  426, 448, 497, 520, 495, 342, 267, 306, 383, 446, 455, 471,
+  368, 351, 429, 543, 610, 605, 618, 474, 451, 533, 582, 621,
+  534, 425, 295, 334, 367, 431, 444, 356, 276, 243, 338, 373,
+  508, 558, 534, 490, 516, 620, 768, 828, 849, 775, 731, 723,
+  800, 869, 892, 763, 634, 515, 465, 541, 532, 467, 350, 193,
+  135, 164, 261, 272, 204, 152, 184, 178, 316, 454, 521, 492,
+  487, 529, 560, 702, 836, 837, 711, 667, 688, 692, 784, 774,
+  697, 574, 486, 451, 478, 581, 541, 480, 390, 296, 380, 447,
+  542, 568, 491, 446, 447, 547, 620, 666, 648, 568, 527, 493,
+  560, 558, 539, 476, 321, 254, 274, 337, 364, 389, 260, 262,
+  162, 273, 404, 549, 545, 545, 509, 565, 695, 847, 914, 843,
+  766, 787, 767, 860, 878, 865, 717, 574, 508, 498, 512, 559,
+  426, 268, 205, 173, 207, 254, 273, 233, 157, 143, 248, 363,
+  489, 552, 523, 484,
+};
+
+// I, Q interleaved
+static const int16_t sonar_ddc_golden_iq[508] = {
+  22, -19, 1, -27, -68, 31, -183, 203, -113, 317, 347, -15,
+  1193, -1087, 2059, -2728, 2438, -4285, 2131, -5064, 1313, -4814, 507, -3765,
+  101, -2353, 344, -891, 1178, 390, 2426, 1306, 3742, 1713, 4839, 1563,
+  5443, 1007, 5445, 252, 4838, -398, 3731, -721, 2369, -518, 1014, 219,
+  -6, 1403, -541, 2777, -479, 4067, 32, 5011, 810, 5431, 1517, 5262,
+  1899, 4527, 1762, 3420, 1085, 2173, -27, 1133, -1420, 519, -2844, 482,
+  -4072, 932, -4807, 1694, -4934, 2478, -4429, 3032, -3526, 3160, -2459, 2745,
+  -1538, 1818, -957, 462, -867, -1092, -1259, -2614, -2003, -3769, -2908, -4337,
+  -3715, -4184, -4221, -3451, -4173, -2418, -3509, -1443, -2264, -804, -735, -655,
+  800, -1058, 2031, -1915, 2800, -3054, 3009, -4141, 2694, -4906, 2028, -5101,
+  1232, -4684, 597, -3705, 291, -2369, 506, -908, 1221, 413, 2374, 1356,
+  3655, 1771, 4776, 1616, 5414, 1046, 5425, 289, 4802, -337, 3682, -635,
+  2335, -445, 1021, 233, 44, 1356, -478, 2721, -454, 4057, -16, 5041,
+  704, 5438, 1416, 5194, 1867, 4393, 1806, 3281, 1159, 2088, 28, 1109,
+  -1377, 513, -2780, 434, -3993, 801, -4781, 1488, -5027, 2254, -4633, 2867,
+  -3763, 3097, -2664, 2771, -1698, 1872, -1083, 496, -944, -1075, -1263, -2571,
+  -1937, -3670, -2804, -4205, -3588, -4074, -4063, -3404, -3985, -2428, -3333, -1480,
+  -2145, -859, -684, -748, 817, -1203, 2045, -2082, 2812, -3184, 3004, -4196,
+  2666, -4902, 1978, -5096, 1162, -4717, 520, -3755, 248, -2370, 542, -824,
+  1339, 539, 2514, 1449, 3744, 1785, 4786, 1566, 5383, 965, 5392, 190,
+  4766, -457, 3611, -770, 2215, -565, 873, 160, -102, 1344, -611, 2756,
+  -577, 4112, -119, 5101, 644, 5497, 1415, 5259, 1910, 4483, 1860, 3406,
+  1187, 2237, 10, 1242, -1437, 590, -2843, 459, -3992, 828, -4663, 1567,
+  -4804, 2386, -4374, 3001, -3541, 3172, -2504, 2752, -1590, 1761, -1027, 331,
+  -953, -1220, -1339, -2626, -2050, -3618, -2910, -4104, -3658, -4014, -4080, -3430,
+  -3939, -2516, -3231, -1570, -2023, -912, -590, -755, 851, -1166, 2029, -2016,
+  2769, -3116, 2950, -4167, 2601, -4922, 1923, -5125, 1165, -4702, 619, -3692,
+  406, -2318, 657, -847, 1331, 436, 2401, 1315, 3611, 1681, 4698, 1536,
+  5333, 1024, 5345, 318, 4713, -326, 3564, -711, 2176, -608, 829, 59,
+  -143, 1249, -611, 2696, -511, 4067, -23, 5031, 683, 5397, 1339, 5147,
+  1761, 4368, 1761, 3281, 1240, 2101, 203, 1113, -1225, 493, -2736, 389,
+  -4033, 752, -4811, 1471, -5003, 2294, -4603, 2942, -3793, 3154, -2736, 2756,
+  -1720, 1758, -997, 290, -789, -1331, -1154, -2803, -1957, -3802, -2954, -4217,
+  -3808, -4031, -4279, -3407, -4153, -2532, -3438, -1648, -2194, -997, -692, -767,
+  822, -1078, 2040, -1859, 2784, -2945, 2949, -4004, 2578, -4758, 1873, -4959,
+  1087, -4569, 529, -3637, 331, -2353, 606, -917, 1299, 415, 2377, 1387,
+  3607, 1816, 4728, 1655, 5396, 1075, 5425, 326, 4800, -277, 3669, -568,
+  2320, -402, 1004, 235, 2, 1331, -575, 2710, -607, 4096, -187, 5142,
+  562, 5582, 1324, 5332, 1817, 4471, 1797, 3268, 1186, 1994, 55, 971,
+  -1418, 364, -2923, 297, -4187, 699, -4923, 1439, -5076, 2251, -4647, 2861,
+  -3830, 3035, -2784, 2632, -1784, 1669, -1066, 260, -856, -1292, -1208, -2696,
+  -1986, -3635, -2938, -4019, -3740, -3841, -4187, -3263, -4093, -2440, -3464, -1608,
+  -2316, -1016, -861, -861,
+};
+
+#endif
@@ -0,0 +1,19 @@
+/**
+ * @file
+ * @brief The CHECK macro the tests share: prints the failed condition with its file and
+ * line and returns 1 from the enclosing function
+ */
+#ifndef TEST_CHECK_HPP
+#define TEST_CHECK_HPP
+
+#include <iostream>
+
+#define CHECK(cond)                                                          \
+  do {                                                                       \
+    if (!(cond)) {                                                           \
+      std::cout << __FILE__ << ":" << __LINE__ << " CHECK failed: " #cond "\n"; \
+      return 1;                                                              \
+    }                                                                        \
+  } while (0)
+
+#endif
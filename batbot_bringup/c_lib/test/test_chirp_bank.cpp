@@ -0,0 +1,118 @@
+/**
+ * @file
+ * @brief Checks the emitter's chirp bank: lookup by CRC, wrapping round the buffer,
+ * dropping what gets overwritten or was used least recently, a failed upload, and new
+ * chirps going around the pinned ones the DAC plays
+ */
+
+#include <cstdlib>
+#include <iostream>
+
+#include "chirp_bank.hpp"
+#include "test_check.hpp"
+
+#define EMIT_BUF_LEN 65000
+
+/**
+ * @brief Allocates and commits a chirp, the slot it went to
+ */
+static int add(ChirpBank* bank, uint32_t len, uint32_t crc)
+{
+  int slot = chirpBankAlloc(bank, len);
+  if (slot >= 0)
+    chirpBankCommit(bank, slot, len, crc);
+  return slot;
+}
+
+int main()
+{
+  ChirpBank bank;
+  chirpBankInit(&bank, EMIT_BUF_LEN + 1);
+  CHECK(bank.active == -1);
+  CHECK(chirpBankFind(&bank, 0) < 0);
+
+  // the longest chirp still fits with its silent sample, nothing longer or empty does
+  CHECK(chirpBankAlloc(&bank, EMIT_BUF_LEN + 1) < 0);
+  CHECK(chirpBankAlloc(&bank, 0) < 0);
+  int full = add(&bank, EMIT_BUF_LEN, 0xF011);
+  CHECK(full >= 0 && bank.slots[full].offset == 0);
+
+  // two 30 ms chirps side by side push the full one out
+  int a = add(&bank, 30000, 0xA);
+  int b = add(&bank, 30000, 0xB);
+  CHECK(a >= 0 && b >= 0 && a != b);
+  CHECK(chirpBankFind(&bank, 0xF011) < 0);
+  CHECK(bank.slots[a].offset == 0 && bank.slots[b].offset == 30001);
+  CHECK(bank.active == b);
+
+  // alternating between them is only a select
+  CHECK(chirpBankSelect(&bank, 0xA) == a && bank.active == a);
+  CHECK(chirpBankSelect(&bank, 0xB) == b && bank.active == b);
+  CHECK(chirpBankSelect(&bank, 0xC) < 0 && bank.active == b);
+
+  // a third wraps to the start and overwrites the first, the second survives
+  int c = add(&bank, 20000, 0xC);
+  CHECK(bank.slots[c].offset == 0);
+  CHECK(chirpBankFind(&bank, 0xA) < 0);
+  CHECK(chirpBankFind(&bank, 0xB) == b);
+
+  // the same chirp again keeps a single key
+  int c2 = add(&bank, 20000, 0xC);
+  CHECK(chirpBankFind(&bank, 0xC) == c2 && bank.slots[c2].offset == 20001);
+  CHECK(chirpBankFind(&bank, 0xB) < 0);
+
+  // short chirps fill every slot, the next drops the least recently used
+  chirpBankInit(&bank, EMIT_BUF_LEN + 1);
+  for (uint32_t i = 0; i < CHIRP_BANK_SLOTS; ++i)
+    CHECK(add(&bank, 1000, 0x100 + i) >= 0);
+  CHECK(chirpBankSelect(&bank, 0x100) >= 0);
+  CHECK(add(&bank, 1000, 0x200) >= 0);
+  CHECK(chirpBankFind(&bank, 0x100) >= 0);
+  CHECK(chirpBankFind(&bank, 0x101) < 0);
+  for (uint32_t i = 2; i < CHIRP_BANK_SLOTS; ++i)
+    CHECK(chirpBankFind(&bank, 0x100 + i) >= 0);
+
+  // a failed upload leaves the slot empty and the active chirp alone unless overwritten
+  chirpBankInit(&bank, EMIT_BUF_LEN + 1);
+  a = add(&bank, 10000, 0xA);
+  CHECK(chirpBankAlloc(&bank, 10000) >= 0);
+  CHECK(bank.active == a && chirpBankFind(&bank, 0xA) == a);
+  CHECK(chirpBankAlloc(&bank, 60000) >= 0);
+  CHECK(bank.active == -1 && chirpBankFind(&bank, 0xA) < 0);
+  for (int i = 0; i < CHIRP_BANK_SLOTS; ++i)
+    CHECK(bank.slots[i].len == 0);
+
+  // the playing chirp is pinned, the next goes around it instead of over it
+  chirpBankInit(&bank, EMIT_BUF_LEN + 1);
+  a = add(&bank, 30000, 0xA);
+  b = add(&bank, 30000, 0xB);
+  bank.slots[b].pinned = true;
+  c = add(&bank, 20000, 0xC);
+  CHECK(c >= 0 && bank.slots[c].offset == 0);
+  CHECK(chirpBankFind(&bank, 0xB) == b);
+  bank.slots[c].pinned = true;
+  // no room beside both
+  CHECK(chirpBankAlloc(&bank, 20000) < 0);
+  CHECK(chirpBankFind(&bank, 0xB) == b && chirpBankFind(&bank, 0xC) == c);
+  // but in the gap between them, silent sample included
+  CHECK(chirpBankAlloc(&bank, 10000) < 0);
+  int d = add(&bank, 9999, 0xD);
+  CHECK(d >= 0 && bank.slots[d].offset == 20001);
+  // the same chirp as a pinned one does not drop it
+  bank.slots[b].pinned = false;
+  int c3 = add(&bank, 20000, 0xC);
+  CHECK(c3 >= 0 && c3 != c && bank.slots[c3].offset == 30001);
+  CHECK(chirpBankFind(&bank, 0xB) < 0);
+  CHECK(bank.slots[c].len == 20000 && bank.slots[c].crc == 0xC);
+  // all but one slot pinned leaves that one for the LRU
+  chirpBankInit(&bank, EMIT_BUF_LEN + 1);
+  for (uint32_t i = 0; i < CHIRP_BANK_SLOTS; ++i) {
+    int slot = add(&bank, 1000, 0x100 + i);
+    CHECK(slot >= 0);
+    bank.slots[slot].pinned = i != 3;
+  }
+  CHECK(add(&bank, 1000, 0x200) >= 0 && chirpBankFind(&bank, 0x103) < 0);
+
+  std::cout << "chirp bank tests passed\n";
+  return 0;
+}
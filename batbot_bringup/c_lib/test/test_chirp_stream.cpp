@@ -0,0 +1,113 @@
+/**
+ * @file
+ * @brief Checks the emitter's streaming ring: when playback starts, the host's blocks
+ * going round behind the DMA, underruns when the host is late, the samples due then
+ * following the silence, and the stop after the last block
+ */
+
+#include <cstdlib>
+#include <iostream>
+
+#include "chirp_stream.hpp"
+#include "test_check.hpp"
+
+/**
+ * @brief Fills the host's next block, the block it went to
+ */
+static int send(ChirpStream* stream)
+{
+  int block = chirpStreamWriteBlock(stream);
+  if (block >= 0)
+    chirpStreamCommit(stream, block, chirpStreamBlockLen(stream));
+  return block;
+}
+
+int main()
+{
+  // the last block is short, the rest are whole
+  ChirpStream s;
+  chirpStreamInit(&s, 20 * CHIRP_STREAM_BLOCK_LEN + 100);
+  CHECK(chirpStreamBlockLen(&s) == CHIRP_STREAM_BLOCK_LEN);
+  CHECK(!chirpStreamReady(&s));
+
+  // it starts with all but two blocks full, and takes no more before
+  for (int i = 0; i < CHIRP_STREAM_BLOCKS - 2; ++i) {
+    CHECK(!chirpStreamReady(&s));
+    CHECK(send(&s) == i);
+  }
+  CHECK(chirpStreamReady(&s));
+  CHECK(chirpStreamWriteBlock(&s) < 0);
+  chirpStreamStart(&s);
+  CHECK(!chirpStreamReady(&s));
+
+  // keeping up, the host fills the ring up to the block the DMA plays
+  CHECK(send(&s) == CHIRP_STREAM_BLOCKS - 2);
+  CHECK(send(&s) == CHIRP_STREAM_BLOCKS - 1);
+  CHECK(chirpStreamWriteBlock(&s) < 0);
+  CHECK(chirpStreamBlockDone(&s) == 0);
+  CHECK(s.play == 1 && s.underruns == 0);
+  CHECK(send(&s) == 0);
+  CHECK(chirpStreamWriteBlock(&s) < 0);
+
+  // the DMA drains the ring while the host is away, and plays silence past the end
+  for (int i = 0; i < CHIRP_STREAM_BLOCKS; ++i)
+    chirpStreamBlockDone(&s);
+  CHECK(s.play == 1 && s.queued == 0);
+  CHECK(s.underruns == 1);
+  chirpStreamBlockDone(&s);
+  CHECK(s.play == 2 && s.underruns == 2);
+
+  // the samples due then go two blocks ahead of the DMA, not behind it
+  CHECK(send(&s) == 4);
+  chirpStreamBlockDone(&s);
+  CHECK(s.underruns == 3);
+  chirpStreamBlockDone(&s);
+  CHECK(s.play == 4 && s.underruns == 3);
+
+  // only the block playing is full, the next one is too close to write
+  CHECK(send(&s) == 6);
+  CHECK(send(&s) == 7);
+  chirpStreamBlockDone(&s);
+  CHECK(s.play == 5 && s.underruns == 4);
+
+  // round to the silent block the DMA plays, which is not written either
+  for (int i = 0; i < 5; ++i)
+    CHECK(send(&s) == i);
+  CHECK(chirpStreamWriteBlock(&s) < 0 && s.write == 5);
+  chirpStreamBlockDone(&s);
+  CHECK(s.play == 6 && s.underruns == 4);
+  CHECK(send(&s) == 5);
+
+  // the rest, the short last block stops the DMA after it
+  uint32_t sent = 0;
+  while (s.received < s.total) {
+    while (chirpStreamWriteBlock(&s) < 0)
+      chirpStreamBlockDone(&s);
+    sent = chirpStreamBlockLen(&s);
+    send(&s);
+  }
+  CHECK(sent == 100);
+  CHECK(chirpStreamBlockLen(&s) == 0);
+  CHECK(chirpStreamWriteBlock(&s) < 0);
+  CHECK(s.last >= 0);
+
+  uint32_t underruns = s.underruns;
+  while (!s.done)
+    chirpStreamBlockDone(&s);
+  CHECK(s.play == s.last && s.queued == 0);
+  CHECK(s.underruns == underruns);
+
+  // a waveform shorter than the ring starts as soon as it is all in
+  chirpStreamInit(&s, CHIRP_STREAM_BLOCK_LEN + 1);
+  CHECK(send(&s) == 0);
+  CHECK(!chirpStreamReady(&s));
+  CHECK(send(&s) == 1);
+  CHECK(chirpStreamReady(&s) && s.last == 1);
+  chirpStreamStart(&s);
+  CHECK(chirpStreamBlockDone(&s) == 0 && !s.done);
+  CHECK(chirpStreamBlockDone(&s) == 1 && s.done);
+  CHECK(s.underruns == 0);
+
+  std::cout << "chirp stream tests passed\n";
+  return 0;
+}
@@ -0,0 +1,137 @@
+/**
+ * @file
+ * @brief Checks the emitter's chirp synthesis against gen_chirp's output, golden vectors
+ * for every method and window, and a float64 reference over a whole 65 ms buffer
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "chirp_synth.hpp"
+#include "chirp_synth_golden.hpp"
+#include "test_check.hpp"
+
+#define EMIT_BUF_LEN 65000
+
+/**
+ * @brief gen_chirp in float64, scipy.signal.chirp's phase, numpy's windows
+ */
+static std::vector<uint16_t> reference(const ChirpParams& p)
+{
+  const double pi = 3.14159265358979323846;
+  const std::size_t n = p.duration_us;
+  const double t1 = n * 1e-6;
+  std::vector<double> x(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    double t = i * 1e-6;
+    double phase = p.f0 * t;
+    if (p.method == CHIRP_METHOD_LINEAR)
+      phase = p.f0 * t + 0.5 * (p.f1 - p.f0) / t1 * t * t;
+    else if (p.method == CHIRP_METHOD_QUADRATIC)
+      phase = p.f0 * t + (p.f1 - p.f0) / (t1 * t1) * t * t * t / 3;
+    else if (p.method == CHIRP_METHOD_LOGARITHMIC && p.f0 != p.f1)
+      phase = t1 / std::log(p.f1 / p.f0) * p.f0 * (std::pow(p.f1 / p.f0, t / t1) - 1.0);
+    else if (p.method == CHIRP_METHOD_HYPERBOLIC && p.f0 != p.f1) {
+      double sing = -p.f1 * t1 / (p.f0 - p.f1);
+      phase = -sing * p.f0 * std::log(std::fabs(1 - t / sing));
+    }
+    double c = 2 * pi * i / (n - 1);
+    double w = 1;
+    if (p.window == CHIRP_WINDOW_HANN)
+      w = 0.5 - 0.5 * std::cos(c);
+    else if (p.window == CHIRP_WINDOW_HAMMING)
+      w = 0.54 - 0.46 * std::cos(c);
+    else if (p.window == CHIRP_WINDOW_BLACKMAN)
+      w = 0.42 - 0.5 * std::cos(c) + 0.08 * std::cos(2 * c);
+    x[i] = std::cos(2 * pi * phase) * w;
+  }
+  double lo = *std::min_element(x.begin(), x.end());
+  double hi = *std::max_element(x.begin(), x.end());
+  std::vector<uint16_t> out(n);
+  for (std::size_t i = 0; i < n; ++i)
+    out[i] = (uint16_t)((x[i] - lo) / (hi - lo) * p.gain + p.offset);
+  return out;
+}
+
+static int worst_error(const uint16_t* a, const uint16_t* b, std::size_t n)
+{
+  int worst = 0;
+  for (std::size_t i = 0; i < n; ++i)
+    worst = std::max(worst, std::abs((int)a[i] - (int)b[i]));
+  return worst;
+}
+
+int main()
+{
+  std::vector<uint16_t> out(EMIT_BUF_LEN);
+
+  // gen_chirp's own output
+  const uint16_t* expected = chirp_synth_golden_samples;
+  for (int c = 0; c < CHIRP_SYNTH_GOLDEN_CASES; ++c) {
+    const ChirpParams& p = chirp_synth_golden_params[c];
+    CHECK(chirpSynthLength(&p, EMIT_BUF_LEN) == (int)p.duration_us);
+    CHECK(chirpSynth(&p, out.data(), EMIT_BUF_LEN) == (int)p.duration_us);
+    int worst = worst_error(out.data(), expected, p.duration_us);
+    if (worst > 1) {
+      std::cout << "golden case " << c << " is " << worst << " LSB off\n";
+      return 1;
+    }
+    expected += p.duration_us;
+  }
+
+  // a whole buffer, where phase drift would show
+  for (uint8_t method = CHIRP_METHOD_LINEAR; method <= CHIRP_METHOD_HYPERBOLIC; ++method) {
+    for (uint8_t window = CHIRP_WINDOW_NONE; window <= CHIRP_WINDOW_BLACKMAN; ++window) {
+      ChirpParams p = {120000, 20000, EMIT_BUF_LEN, method, window, 0, 4095, 0};
+      CHECK(chirpSynth(&p, out.data(), EMIT_BUF_LEN) == EMIT_BUF_LEN);
+      int worst = worst_error(out.data(), reference(p).data(), EMIT_BUF_LEN);
+      if (worst > 1) {
+        std::cout << "method " << (int)method << " window " << (int)window << " is " << worst << " LSB off\n";
+        return 1;
+      }
+    }
+  }
+
+  // the range is what was asked for
+  ChirpParams p = {50000, 50000, 1000, CHIRP_METHOD_LINEAR, CHIRP_WINDOW_NONE, 0, 512, 2048};
+  CHECK(chirpSynth(&p, out.data(), EMIT_BUF_LEN) == 1000);
+  CHECK(*std::min_element(out.begin(), out.begin() + 1000) == 2048);
+  CHECK(*std::max_element(out.begin(), out.begin() + 1000) == 2560);
+
+  // and what is not a chirp is refused
+  ChirpParams bad = p;
+  bad.duration_us = 0;
+  CHECK(chirpSynth(&bad, out.data(), EMIT_BUF_LEN) < 0);
+  bad.duration_us = EMIT_BUF_LEN + 1;
+  CHECK(chirpSynth(&bad, out.data(), EMIT_BUF_LEN) < 0);
+  bad = p;
+  bad.f1 = CHIRP_SYNTH_RATE / 2;
+  CHECK(chirpSynthLength(&bad, EMIT_BUF_LEN) < 0);
+  bad.f1 = NAN;
+  CHECK(chirpSynthLength(&bad, EMIT_BUF_LEN) < 0);
+  bad = p;
+  bad.method = CHIRP_METHOD_LOGARITHMIC;
+  bad.f0 = -1000;
+  CHECK(chirpSynthLength(&bad, EMIT_BUF_LEN) < 0);
+  bad.method = CHIRP_METHOD_HYPERBOLIC;
+  bad.f0 = 0;
+  CHECK(chirpSynthLength(&bad, EMIT_BUF_LEN) < 0);
+  bad = p;
+  bad.method = 4;
+  CHECK(chirpSynthLength(&bad, EMIT_BUF_LEN) < 0);
+  bad = p;
+  bad.window = 4;
+  CHECK(chirpSynthLength(&bad, EMIT_BUF_LEN) < 0);
+  bad = p;
+  bad.gain = 65535 - 2048 + 1;
+  CHECK(chirpSynthLength(&bad, EMIT_BUF_LEN) < 0);
+  bad = p;
+  bad.offset = -1;
+  CHECK(chirpSynthLength(&bad, EMIT_BUF_LEN) < 0);
+
+  std::cout << "chirp synth tests passed\n";
+  return 0;
+}
@@ -0,0 +1,384 @@
+/**
+ * @file
+ * @brief Runs EchoRecorder against a fake listener on a pty
+ *
+ * The fake answers ACK_REQ and, between START_LISTEN and STOP_LISTEN, streams frames of
+ * left then right samples at the listener's 2 MS/s per ear. The left ear counts up and the
+ * right ear counts down, so any lost, repeated or swapped byte shows up. In the first
+ * capture it leaves one frame out and corrupts another, which must come back as gap
+ * fill without shifting anything after them. CAPTURE is answered with a window around a
+ * made up trigger, sent all at once. After BASEBAND the frames are flagged as I/Q and
+ * one of them is left out, which must come back as zeros. After PACKING the samples are
+ * cut to 10 bits and packed with the firmware's own encoders.
+ *
+ * Frames are flagged SONAR_FRAME_FLAG_SAME_COUNT except one of the first capture, and
+ * the trigger is reported in frame 0 of every stream and in its frame of a capture.
+ * While the emitter is silent START_LISTEN is answered with ERROR after the firmware's
+ * timeout.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "echo_recorder.hpp"
+#include "sonar_pack.hpp"
+#include "test_check.hpp"
+
+#define BLOCK_SAMPLES SONAR_FRAME_SAMPLES
+
+// frames of the first capture that never arrive and that arrive corrupted
+#define SKIPPED_FRAME 50
+#define CORRUPTED_FRAME 100
+// frame left out of every baseband stream
+#define SKIPPED_IQ_FRAME 3
+// frame of the first capture without SONAR_FRAME_FLAG_SAME_COUNT
+#define UNMATCHED_FRAME 70
+// where frame 0 of every stream reports the trigger
+#define STREAM_TRIGGER 321
+
+// the fake's ring for triggered captures, and where in it the trigger lands
+#define CAPTURE_RING_SAMPLES 1000000
+#define CAPTURE_TRIGGER 123456
+
+static std::atomic<bool> device_running(true);
+static std::atomic<bool> emitter_silent(false);
+
+/**
+ * @brief Fills a frame whose first sample is number count, packed the way the listener
+ * does it
+ */
+static void make_frame(std::vector<uint8_t>& block, uint32_t seq, uint16_t count, uint16_t flags = 0,
+                       listener_packing_t packing = LISTENER_PACKING_NONE)
+{
+  uint16_t mask = packing == LISTENER_PACKING_NONE ? 0xFFFF : 0x3FF;
+  block.resize(SONAR_FRAME_BYTES);
+  uint8_t* samples = &block[SONAR_FRAME_HEADER_BYTES];
+  for (std::size_t i = 0; i < BLOCK_SAMPLES; ++i, ++count) {
+    uint16_t l = count & mask;
+    uint16_t r = (uint16_t)~count & mask;
+    samples[2 * i + 0] = l & 0xFF;
+    samples[2 * i + 1] = l >> 8;
+    samples[2 * BLOCK_SAMPLES + 2 * i + 0] = r & 0xFF;
+    samples[2 * BLOCK_SAMPLES + 2 * i + 1] = r >> 8;
+  }
+
+  SonarFrameHeader header;
+  memset(&header, 0, sizeof(header));
+  header.magic = SONAR_FRAME_MAGIC;
+  header.seq = seq;
+  header.seq_adc1 = seq;
+  header.count = BLOCK_SAMPLES;
+  header.version = SONAR_FRAME_VERSION;
+  header.flags = flags;
+
+  if (packing == LISTENER_PACKING_NONE) {
+    header.crc = sonarFrameCRC(&header, samples, samples + 2 * BLOCK_SAMPLES);
+    memcpy(&block[0], &header, sizeof(header));
+    return;
+  }
+
+  uint16_t ears[2][BLOCK_SAMPLES];
+  memcpy(ears, samples, sizeof(ears));
+  std::size_t budget = SONAR_PACK10_BYTES(BLOCK_SAMPLES);
+  std::size_t len = 0;
+  if (packing == LISTENER_PACKING_DELTA) {
+    std::size_t a = sonarDeltaEncode(ears[0], BLOCK_SAMPLES, samples, budget);
+    std::size_t b = a ? sonarDeltaEncode(ears[1], BLOCK_SAMPLES, samples + a, budget) : 0;
+    if (a && b) {
+      len = a + b;
+      header.flags |= SONAR_FRAME_FLAG_DELTA;
+    }
+  }
+  if (len == 0) {
+    len = sonarPack10(ears[0], BLOCK_SAMPLES, samples);
+    len += sonarPack10(ears[1], BLOCK_SAMPLES, samples + len);
+    header.flags |= SONAR_FRAME_FLAG_PACK10;
+  }
+  header.payload = (uint16_t)len;
+  header.crc = sonarPackedFrameCRC(&header, samples);
+  memcpy(&block[0], &header, sizeof(header));
+  block.resize(SONAR_FRAME_HEADER_BYTES + len);
+}
+
+static void write_all(int fd, const uint8_t* data, std::size_t len)
+{
+  // odd sized writes so frames straddle reads and the ring wrap
+  std::size_t off = 0;
+  while (off < len) {
+    std::size_t n = std::min<std::size_t>(len - off, 1237);
+    ssize_t w = write(fd, data + off, n);
+    if (w > 0)
+      off += w;
+  }
+}
+
+/**
+ * @brief Answers CAPTURE as if the trigger had come at sample CAPTURE_TRIGGER
+ */
+static void fake_capture(int fd, std::vector<uint8_t>& block)
+{
+  uint32_t window[2];
+  std::size_t got = 0;
+  while (got < sizeof(window)) {
+    ssize_t n = read(fd, (uint8_t*)window + got, sizeof(window) - got);
+    if (n > 0)
+      got += n;
+  }
+
+  if ((uint64_t)window[0] + window[1] > CAPTURE_RING_SAMPLES) {
+    uint8_t err = LISTENER_CMD_ERROR;
+    write_all(fd, &err, 1);
+    return;
+  }
+
+  // the window is only sent once it has been recorded
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+  uint32_t start = CAPTURE_TRIGGER - window[0];
+  uint32_t end = CAPTURE_TRIGGER + window[1];
+  SonarCaptureHeader header;
+  header.magic = SONAR_CAPTURE_MAGIC;
+  header.first_seq = start / BLOCK_SAMPLES;
+  header.num_frames = (end + BLOCK_SAMPLES - 1) / BLOCK_SAMPLES - header.first_seq;
+  header.window_offset = start - header.first_seq * BLOCK_SAMPLES;
+  header.pre_samples = window[0];
+  header.post_samples = window[1];
+  header.trigger_cycles = 0;
+  header.crc = sonarCaptureCRC(&header);
+  write_all(fd, (const uint8_t*)&header, sizeof(header));
+
+  for (uint32_t i = 0; i < header.num_frames; ++i) {
+    uint32_t seq = header.first_seq + i;
+    uint16_t flags = SONAR_FRAME_FLAG_SAME_COUNT;
+    if (seq == CAPTURE_TRIGGER / BLOCK_SAMPLES)
+      flags |= sonarFrameTriggerFlags(CAPTURE_TRIGGER % BLOCK_SAMPLES);
+    make_frame(block, seq, (uint16_t)(seq * BLOCK_SAMPLES), flags);
+    write_all(fd, block.data(), block.size());
+  }
+}
+
+static void fake_listener(int fd)
+{
+  bool streaming = false;
+  bool baseband = false;
+  listener_packing_t packing = LISTENER_PACKING_NONE;
+  int captures = 0;
+  uint16_t count = 0;
+  uint32_t seq = 0;
+  std::chrono::steady_clock::time_point next_block;
+  std::vector<uint8_t> block(SONAR_FRAME_BYTES);
+
+  while (device_running) {
+    struct pollfd pfd = {fd, POLLIN, 0};
+    if (poll(&pfd, 1, streaming ? 0 : 10) > 0 && (pfd.revents & POLLIN)) {
+      uint8_t cmd;
+      if (read(fd, &cmd, 1) == 1) {
+        if (cmd == LISTENER_CMD_ACK_REQ) {
+          uint8_t ack = LISTENER_CMD_ACK;
+          if (write(fd, &ack, 1) != 1)
+            return;
+        } else if (cmd == LISTENER_CMD_START_LISTEN && emitter_silent) {
+          // CHIRP_TRIGGER_TIMEOUT_MS in the firmware
+          std::this_thread::sleep_for(std::chrono::milliseconds(200));
+          uint8_t err = LISTENER_CMD_ERROR;
+          if (write(fd, &err, 1) != 1)
+            return;
+        } else if (cmd == LISTENER_CMD_START_LISTEN) {
+          streaming = true;
+          captures++;
+          count = 0;
+          seq = 0;
+          next_block = std::chrono::steady_clock::now();
+        } else if (cmd == LISTENER_CMD_STOP_LISTEN) {
+          streaming = false;
+        } else if (cmd == LISTENER_CMD_CAPTURE) {
+          fake_capture(fd, block);
+        } else if (cmd == LISTENER_CMD_BASEBAND) {
+          uint8_t on;
+          while (read(fd, &on, 1) != 1) {
+          }
+          baseband = on != 0;
+          uint8_t ack = LISTENER_CMD_ACK;
+          if (write(fd, &ack, 1) != 1)
+            return;
+        } else if (cmd == LISTENER_CMD_PACKING) {
+          uint8_t mode;
+          while (read(fd, &mode, 1) != 1) {
+          }
+          packing = (listener_packing_t)mode;
+          uint8_t ack = LISTENER_CMD_ACK;
+          if (write(fd, &ack, 1) != 1)
+            return;
+        }
+      }
+    }
+
+    if (!streaming)
+      continue;
+
+    // one block per 508 us is 2 MS/s per ear
+    std::this_thread::sleep_until(next_block);
+    next_block += std::chrono::nanoseconds(BLOCK_SAMPLES * 500);
+
+    uint16_t flags = SONAR_FRAME_FLAG_SAME_COUNT;
+    if (seq == 0)
+      flags |= sonarFrameTriggerFlags(STREAM_TRIGGER);
+    if (captures == 1 && seq == UNMATCHED_FRAME)
+      flags &= ~SONAR_FRAME_FLAG_SAME_COUNT;
+    if (baseband)
+      make_frame(block, seq, count, flags | SONAR_FRAME_FLAG_IQ);
+    else
+      make_frame(block, seq, count, flags, packing);
+    count += BLOCK_SAMPLES;
+    seq++;
+
+    if (baseband && seq - 1 == SKIPPED_IQ_FRAME)
+      continue;
+
+    if (captures == 1 && seq - 1 == SKIPPED_FRAME)
+      continue;
+    if (captures == 1 && seq - 1 == CORRUPTED_FRAME)
+      block[SONAR_FRAME_HEADER_BYTES + 1234] ^= 0x10;
+
+    write_all(fd, block.data(), block.size());
+  }
+}
+
+static int check_samples(const std::vector<uint16_t>& left, const std::vector<uint16_t>& right, uint16_t start,
+                         bool withGaps = false)
+{
+  for (std::size_t i = 0; i < left.size(); ++i) {
+    std::size_t frame = i / BLOCK_SAMPLES;
+    if (withGaps && (frame == SKIPPED_FRAME || frame == CORRUPTED_FRAME)) {
+      if (left[i] != ECHO_RECORDER_GAP_FILL || right[i] != ECHO_RECORDER_GAP_FILL) {
+        std::cout << "sample " << i << ": got " << left[i] << "/" << right[i] << ", expected gap fill\n";
+        return 1;
+      }
+      continue;
+    }
+
+    uint16_t expected = (uint16_t)(start + i);
+    if (left[i] != expected || right[i] != (uint16_t)~expected) {
+      std::cout << "sample " << i << ": got " << left[i] << "/" << right[i] << ", expected " << expected << "\n";
+      return 1;
+    }
+  }
+  return 0;
+}
+
+int main()
+{
+  int master = posix_openpt(O_RDWR | O_NOCTTY);
+  CHECK(master >= 0 && grantpt(master) == 0 && unlockpt(master) == 0);
+
+  std::thread dev;
+  {
+    EchoRecorder rec(ptsname(master));
+    CHECK(rec.isOpen());
+    dev = std::thread(fake_listener, master);
+
+    CHECK(rec.ackRequest() == 0);
+
+    // one second of both ears
+    std::size_t n = 1000000;
+    std::vector<uint16_t> left(n), right(n);
+    auto start = std::chrono::steady_clock::now();
+    CHECK(rec.listen(left.data(), right.data(), n) == 0);
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    CHECK(check_samples(left, right, 0, true) == 0);
+    std::cout << "listen: " << n * 4 / 1e6 << " MB in " << secs << " s (" << n * 4 / 1e6 / secs << " MB/s)\n";
+
+    const SonarStreamStats& stats = rec.streamStats();
+    CHECK(stats.missed_frames == 2);
+    CHECK(stats.crc_errors == 1);
+    CHECK(stats.ear_mismatches == 0);
+    CHECK(stats.unmatched_frames == 1);
+    CHECK(rec.triggerSample() == STREAM_TRIGGER);
+
+    // the stream was drained, so the listener can be pinged again right away
+    CHECK(rec.ackRequest() == 0);
+
+    // continuous capture in odd sized pieces picks up exactly where the last piece ended
+    CHECK(rec.startStream() == 0);
+    std::size_t piece = 123457;
+    std::vector<uint16_t> l(piece), r(piece);
+    for (int i = 0; i < 10; ++i) {
+      CHECK(rec.readSamples(l.data(), r.data(), piece) == 0);
+      CHECK(check_samples(l, r, (uint16_t)(i * piece)) == 0);
+    }
+    CHECK(rec.stopStream() == 0);
+    CHECK(rec.ackRequest() == 0);
+    CHECK(rec.streamStats().missed_frames == 0);
+    CHECK(rec.streamStats().bytes_dropped == 0);
+
+    // a triggered capture comes back as exactly the window, trigger at sample pre
+    std::size_t pre = 20000, post = 30000;
+    std::vector<uint16_t> cl(pre + post), cr(pre + post);
+    CHECK(rec.capture(cl.data(), cr.data(), pre, post) == 0);
+    CHECK(check_samples(cl, cr, (uint16_t)(CAPTURE_TRIGGER - pre)) == 0);
+    CHECK(rec.streamStats().missed_frames == 0);
+    CHECK(rec.triggerSample() == (int64_t)pre);
+
+    // a window bigger than the listener's ring is refused and leaves it usable
+    CHECK(rec.capture(cl.data(), cr.data(), CAPTURE_RING_SAMPLES, 1) < 0);
+    CHECK(rec.ackRequest() == 0);
+
+    // missing baseband frames read as zero I and Q, not mid scale
+    CHECK(rec.setBaseband(true) == 0);
+    std::vector<uint16_t> il(8 * BLOCK_SAMPLES), ir(8 * BLOCK_SAMPLES);
+    CHECK(rec.listen(il.data(), ir.data(), il.size()) == 0);
+    CHECK(rec.streamStats().missed_frames == 1);
+    CHECK(rec.triggerSample() == STREAM_TRIGGER);
+    for (std::size_t i = 0; i < il.size(); ++i) {
+      uint16_t expected = i / BLOCK_SAMPLES == SKIPPED_IQ_FRAME ? 0 : (uint16_t)i;
+      uint16_t expected_r = i / BLOCK_SAMPLES == SKIPPED_IQ_FRAME ? 0 : (uint16_t)~i;
+      CHECK(il[i] == expected && ir[i] == expected_r);
+    }
+    CHECK(rec.setBaseband(false) == 0);
+
+    // packed streams come back as the same samples cut to 10 bits, in fewer bytes
+    const listener_packing_t packings[] = {LISTENER_PACKING_10BIT, LISTENER_PACKING_DELTA};
+    for (listener_packing_t packing : packings) {
+      CHECK(rec.setPacking(packing) == 0);
+      std::vector<uint16_t> pl(20 * BLOCK_SAMPLES), pr(20 * BLOCK_SAMPLES);
+      std::size_t before = rec.receivedBytes();
+      CHECK(rec.listen(pl.data(), pr.data(), pl.size()) == 0);
+      for (std::size_t i = 0; i < pl.size(); ++i)
+        CHECK(pl[i] == (i & 0x3FF) && pr[i] == (~i & 0x3FF));
+      CHECK(rec.streamStats().missed_frames == 0 && rec.streamStats().crc_errors == 0);
+      CHECK(rec.streamStats().unmatched_frames == 0 && rec.triggerSample() == STREAM_TRIGGER);
+      CHECK(rec.receivedBytes() - before < pl.size() * 4);
+      std::cout << "packing " << packing << ": " << (double)(rec.receivedBytes() - before) / (pl.size() * 4)
+                << " of the plain stream\n";
+    }
+    CHECK(rec.setPacking(LISTENER_PACKING_NONE) == 0);
+
+    // no trigger from the emitter fails the listen on the ERROR reply, not on a stall
+    emitter_silent = true;
+    auto silent_start = std::chrono::steady_clock::now();
+    CHECK(rec.listen(il.data(), ir.data(), il.size()) < 0);
+    CHECK(std::chrono::steady_clock::now() - silent_start < std::chrono::milliseconds(ECHO_RECORDER_TIMEOUT_MS));
+    emitter_silent = false;
+    CHECK(rec.ackRequest() == 0);
+    CHECK(rec.listen(il.data(), ir.data(), il.size()) == 0);
+
+    CHECK(rec.droppedBytes() == 0);
+  }
+
+  device_running = false;
+  dev.join();
+  close(master);
+
+  std::cout << "echo recorder tests passed\n";
+  return 0;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file
+ * @brief Checks every available deinterleave kernel against the scalar one, including
+ * lengths that leave a tail after the vector loop
+ */
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "lr_deinterleave.hpp"
+#include "test_check.hpp"
+
+static bool close_enough(float a, float b)
+{
+  return std::fabs(a - b) <= 1e-5f * (1.0f + std::fabs(b));
+}
+
+static int check_isa(lr_isa_t isa, const std::vector<uint16_t>& in)
+{
+  const LRCalibration cal = {512.0f, 1.0f / 512.0f, 498.5f, 1.1f / 512.0f};
+
+  const std::size_t lengths[] = {0, 1, 3, 7, 8, 15, 16, 17, 31, 33, 1000, 30000, 150001};
+  for (std::size_t n : lengths) {
+    for (int dc = 0; dc < 2; ++dc) {
+      std::vector<float> l(n), r(n), el(n), er(n);
+      CHECK(lrDeinterleave(in.data(), n, el.data(), er.data(), &cal, dc, LR_ISA_SCALAR) == 0);
+      CHECK(lrDeinterleave(in.data(), n, l.data(), r.data(), &cal, dc, isa) == 0);
+
+      for (std::size_t i = 0; i < n; ++i) {
+        if (!close_enough(l[i], el[i]) || !close_enough(r[i], er[i])) {
+          std::cout << lrIsaName(isa) << " n=" << n << " dc=" << dc << " differs at " << i << "\n";
+          return 1;
+        }
+      }
+    }
+
+    uint64_t sl, sr, esl, esr;
+    CHECK(lrChannelSums(in.data(), n, &esl, &esr, LR_ISA_SCALAR) == 0);
+    CHECK(lrChannelSums(in.data(), n, &sl, &sr, isa) == 0);
+    CHECK(sl == esl && sr == esr);
+  }
+  return 0;
+}
+
+int main()
+{
+  // full 16-bit range so the sums exercise the 32-bit lane flushing
+  std::vector<uint16_t> in(2 * 150001);
+  uint32_t rng = 7;
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    rng = rng * 1664525 + 1013904223;
+    in[i] = (i & 1) ? (uint16_t)(rng >> 16) : (uint16_t)(0xFF00 | (rng >> 24));
+  }
+
+  // scalar against a plain reference, with and without DC removal
+  {
+    std::size_t n = 1000;
+    std::vector<float> l(n), r(n);
+    CHECK(lrDeinterleave(in.data(), n, l.data(), r.data(), NULL, false, LR_ISA_SCALAR) == 0);
+    for (std::size_t i = 0; i < n; ++i)
+      CHECK(l[i] == in[2 * i] && r[i] == in[2 * i + 1]);
+
+    CHECK(lrDeinterleave(in.data(), n, l.data(), r.data(), NULL, true, LR_ISA_SCALAR) == 0);
+    double ml = 0, mr = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+      ml += l[i];
+      mr += r[i];
+    }
+    CHECK(std::fabs(ml / n) < 0.01 && std::fabs(mr / n) < 0.01);
+  }
+
+  const lr_isa_t isas[] = {LR_ISA_SSE2, LR_ISA_AVX2, LR_ISA_NEON};
+  for (lr_isa_t isa : isas) {
+    if (!lrIsaAvailable(isa)) {
+      std::cout << lrIsaName(isa) << " not available, skipped\n";
+      continue;
+    }
+    if (check_isa(isa, in))
+      return 1;
+    std::cout << lrIsaName(isa) << " matches scalar\n";
+  }
+
+  std::cout << "lr deinterleave tests passed\n";
+  return 0;
+}
@@ -0,0 +1,142 @@
+/**
+ * @file
+ * @brief Checks MatchedFilter against a direct correlation, across block boundaries,
+ * thread counts and input types
+ */
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "matched_filter.hpp"
+#include "test_check.hpp"
+
+/*
+ * linear chirp around a DAC mid scale, like the uploaded ones
+ */
+static std::vector<float> make_chirp(std::size_t n)
+{
+  std::vector<float> c(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    double t = i / 1e6;
+    double T = n / 1e6;
+    double phase = 2 * M_PI * (100e3 * t - 0.5 * 50e3 / T * t * t);
+    c[i] = (float)(2048 + 512 * sin(phase));
+  }
+  return c;
+}
+
+static std::vector<double> reference(const std::vector<float>& x, const std::vector<float>& chirp)
+{
+  double xm = 0, cm = 0;
+  for (float v : x)
+    xm += v;
+  for (float v : chirp)
+    cm += v;
+  xm /= x.size();
+  cm /= chirp.size();
+
+  std::vector<double> out(x.size(), 0.0);
+  for (std::size_t k = 0; k < x.size(); ++k) {
+    for (std::size_t n = 0; n < chirp.size() && k + n < x.size(); ++n)
+      out[k] += (x[k + n] - xm) * (chirp[n] - cm);
+  }
+  return out;
+}
+
+int main()
+{
+  std::vector<float> chirp = make_chirp(300);
+  // long captures want big blocks, a 30 ms ping is cheaper in six 8k blocks than two 32k ones
+  CHECK(MatchedFilter::bestFFTSize(3000) == 32768);
+  CHECK(MatchedFilter::bestFFTSize(3000, 30000) == 8192);
+  CHECK(MatchedFilter::bestFFTSize(3000, 1000) == 8192);
+
+  // echoes of the chirp at known delays in noise, on a mid scale offset
+  const std::size_t n = 5000, channels = 4;
+  const std::size_t delays[channels] = {0, 700, 1023, 4800};
+  std::vector<std::vector<uint16_t>> raw(channels, std::vector<uint16_t>(n));
+  std::vector<std::vector<float>> x(channels, std::vector<float>(n));
+  uint32_t rng = 3;
+  for (std::size_t c = 0; c < channels; ++c) {
+    for (std::size_t i = 0; i < n; ++i) {
+      rng = rng * 1664525 + 1013904223;
+      float v = 2000.0f + (rng >> 27);
+      if (i >= delays[c] && i - delays[c] < chirp.size())
+        v += 0.25f * (chirp[i - delays[c]] - 2048.0f);
+      raw[c][i] = (uint16_t)v;
+      x[c][i] = raw[c][i];
+    }
+  }
+
+  const float* in[channels];
+  const uint16_t* raw_in[channels];
+  for (std::size_t c = 0; c < channels; ++c) {
+    in[c] = x[c].data();
+    raw_in[c] = raw[c].data();
+  }
+
+  // a small block forces several blocks per channel and a short last one
+  MatchedFilter mf(chirp.data(), chirp.size(), true, 1, 512);
+  CHECK(mf.fftSize(n) == 512);
+
+  std::vector<std::vector<float>> y(channels, std::vector<float>(n));
+  float* out[channels];
+  for (std::size_t c = 0; c < channels; ++c)
+    out[c] = y[c].data();
+  CHECK(mf.process(in, channels, n, out) == 0);
+
+  for (std::size_t c = 0; c < channels; ++c) {
+    std::vector<double> ref = reference(x[c], chirp);
+    double peak = 0;
+    std::size_t best = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+      if (std::fabs(ref[i]) > peak)
+        peak = std::fabs(ref[i]);
+      if (y[c][i] > y[c][best])
+        best = i;
+    }
+    for (std::size_t i = 0; i < n; ++i)
+      CHECK(std::fabs(y[c][i] - ref[i]) < 1e-4 * peak);
+    // the last echo is cut off by the end of the capture, the rest compress to their delay
+    if (delays[c] + chirp.size() <= n)
+      CHECK(best == delays[c]);
+  }
+
+  // threads and the automatic FFT size only change how the work is split
+  MatchedFilter mf4(chirp.data(), chirp.size(), true, 4);
+  std::vector<std::vector<float>> y4(channels, std::vector<float>(n));
+  float* out4[channels];
+  for (std::size_t c = 0; c < channels; ++c)
+    out4[c] = y4[c].data();
+  CHECK(mf4.process(in, channels, n, out4) == 0);
+  for (std::size_t c = 0; c < channels; ++c) {
+    float peak = 0;
+    for (float v : y[c])
+      peak = std::fabs(v) > peak ? std::fabs(v) : peak;
+    for (std::size_t i = 0; i < n; ++i)
+      CHECK(std::fabs(y4[c][i] - y[c][i]) < 1e-4f * peak);
+  }
+
+  // raw samples match their float copies exactly, normalized profiles peak at 1
+  std::vector<std::vector<float>> yr(channels, std::vector<float>(n));
+  float* outr[channels];
+  for (std::size_t c = 0; c < channels; ++c)
+    outr[c] = yr[c].data();
+  CHECK(mf4.process(raw_in, channels, n, outr, true, true) == 0);
+  CHECK(mf4.process(in, channels, n, out4, true, true) == 0);
+  for (std::size_t c = 0; c < channels; ++c) {
+    CHECK(yr[c] == y4[c]);
+    float peak = 0;
+    for (float v : yr[c]) {
+      CHECK(v >= 0);
+      peak = v > peak ? v : peak;
+    }
+    CHECK(peak == 1.0f);
+  }
+
+  CHECK(mf4.process(in, 0, n, out4) == -1);
+
+  std::cout << "matched filter tests passed\n";
+  return 0;
+}
@@ -0,0 +1,222 @@
+/**
+ * @file
+ * @brief Exercises SerialReactor against openpty() pairs, no hardware needed
+ *
+ * Each pty master is registered with the reactor (the host side), and a writer
+ * thread per pty plays the device by pushing fixed size frames into the slave in
+ * randomly sized chunks. An unplugged device is played by closing the master under a
+ * registered slave, which then reads 0 like a hung up USB tty.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <pty.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "serial_reactor.hpp"
+#include "test_check.hpp"
+
+#define NUM_PTYS 5
+#define FRAME_LEN 2000
+#define FRAMES_PER_PTY 2000
+
+static int open_raw_pty(int* master, int* slave)
+{
+  struct termios tty;
+  memset(&tty, 0, sizeof tty);
+  cfmakeraw(&tty);
+  return openpty(master, slave, NULL, &tty, NULL);
+}
+
+static void device_writer(int fd, uint8_t id)
+{
+  std::vector<uint8_t> stream(FRAME_LEN * FRAMES_PER_PTY);
+  for (std::size_t i = 0; i < stream.size(); ++i) {
+    std::size_t frame = i / FRAME_LEN;
+    stream[i] = (i % FRAME_LEN == 0) ? id : (uint8_t)(frame + i);
+  }
+
+  // odd sized writes so frames straddle read() boundaries
+  std::size_t off = 0;
+  std::size_t chunk = 1;
+  while (off < stream.size()) {
+    std::size_t n = std::min(chunk, stream.size() - off);
+    ssize_t w = write(fd, &stream[off], n);
+    if (w > 0)
+      off += w;
+    chunk = (chunk * 7 + 13) % 4093 + 1;
+  }
+}
+
+static int test_frames_and_throughput()
+{
+  SerialReactor reactor;
+
+  int masters[NUM_PTYS];
+  int slaves[NUM_PTYS];
+  std::size_t frames[NUM_PTYS] = {0};
+  bool ok = true;
+
+  for (int i = 0; i < NUM_PTYS; ++i) {
+    CHECK(open_raw_pty(&masters[i], &slaves[i]) == 0);
+
+    int port = reactor.addFd(
+      masters[i],
+      SerialReactor::fixedLengthSplitter(FRAME_LEN),
+      [&frames, &ok, i](int port, const uint8_t* frame, std::size_t len) {
+        (void)port;
+        std::size_t n = frames[i];
+        if (len != FRAME_LEN || frame[0] != (uint8_t)i || frame[1] != (uint8_t)(n + n * FRAME_LEN + 1))
+          ok = false;
+        frames[i]++;
+      });
+    CHECK(port == i);
+  }
+
+  std::vector<std::thread> writers;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < NUM_PTYS; ++i)
+    writers.push_back(std::thread(device_writer, slaves[i], (uint8_t)i));
+
+  std::size_t total = 0;
+  while (total < (std::size_t)NUM_PTYS * FRAMES_PER_PTY) {
+    CHECK(reactor.poll(2000) > 0);
+    total = 0;
+    for (int i = 0; i < NUM_PTYS; ++i)
+      total += frames[i];
+  }
+  double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  for (std::size_t i = 0; i < writers.size(); ++i)
+    writers[i].join();
+
+  CHECK(ok);
+  for (int i = 0; i < NUM_PTYS; ++i)
+    CHECK(frames[i] == FRAMES_PER_PTY);
+
+  double mbytes = (double)NUM_PTYS * FRAMES_PER_PTY * FRAME_LEN / 1e6;
+  std::cout << NUM_PTYS << " ptys, " << mbytes << " MB in " << secs << " s (" << mbytes / secs << " MB/s) from one thread\n";
+
+  for (int i = 0; i < NUM_PTYS; ++i) {
+    reactor.closePort(i);
+    close(masters[i]);
+    close(slaves[i]);
+  }
+  return 0;
+}
+
+static int test_write_and_stop()
+{
+  SerialReactor reactor;
+
+  int master, slave;
+  CHECK(open_raw_pty(&master, &slave) == 0);
+
+  std::vector<uint8_t> echoed;
+  int port = reactor.addFd(master, SerialReactor::passthroughSplitter(),
+    [&echoed](int port, const uint8_t* frame, std::size_t len) {
+      (void)port;
+      echoed.insert(echoed.end(), frame, frame + len);
+    });
+  CHECK(port >= 0);
+
+  // larger than the pty buffer, so part of it has to wait for EPOLLOUT
+  std::vector<uint8_t> tx(256 * 1024);
+  for (std::size_t i = 0; i < tx.size(); ++i)
+    tx[i] = (uint8_t)(i * 31);
+  CHECK(reactor.writeBytes(port, tx.data(), tx.size()) == 0);
+
+  // the "device" echoes everything back
+  std::thread device([slave, &tx]() {
+    std::vector<uint8_t> buf(4096);
+    std::size_t got = 0;
+    while (got < tx.size()) {
+      ssize_t n = read(slave, buf.data(), buf.size());
+      if (n <= 0)
+        break;
+      std::size_t off = 0;
+      while (off < (std::size_t)n) {
+        ssize_t w = write(slave, buf.data() + off, n - off);
+        if (w > 0)
+          off += w;
+      }
+      got += n;
+    }
+  });
+
+  while (echoed.size() < tx.size()) {
+    if (reactor.poll(5000) <= 0)
+      break;
+  }
+
+  device.join();
+  CHECK(echoed == tx);
+
+  // run() must return once stop() is called from another thread
+  std::thread stopper([&reactor]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    reactor.stop();
+  });
+  reactor.run();
+  stopper.join();
+
+  reactor.closePort(port);
+  close(master);
+  close(slave);
+  return 0;
+}
+
+static int test_hang_up()
+{
+  SerialReactor reactor;
+
+  int master, slave;
+  CHECK(open_raw_pty(&master, &slave) == 0);
+
+  std::vector<uint8_t> got;
+  int port = reactor.addFd(slave, SerialReactor::passthroughSplitter(),
+    [&got](int port, const uint8_t* frame, std::size_t len) {
+      (void)port;
+      got.insert(got.end(), frame, frame + len);
+    });
+  CHECK(port >= 0);
+
+  std::vector<int> gone;
+  reactor.setDisconnectCallback([&gone](int port) { gone.push_back(port); });
+
+  // the last bytes before the unplug still arrive, then the port is closed once
+  const uint8_t last[] = {1, 2, 3};
+  CHECK(write(master, last, sizeof last) == (ssize_t)sizeof last);
+  CHECK(reactor.poll(1000) > 0);
+  close(master);
+  for (int i = 0; i < 10 && gone.empty(); ++i)
+    CHECK(reactor.poll(100) >= 0);
+  CHECK(got.size() == sizeof last);
+  CHECK(gone.size() == 1 && gone[0] == port);
+
+  // nothing is left registered to wake the loop
+  CHECK(reactor.poll(100) == 0);
+  CHECK(reactor.writeBytes(port, last, sizeof last) < 0);
+
+  close(slave);
+  return 0;
+}
+
+int main()
+{
+  if (test_frames_and_throughput())
+    return 1;
+  if (test_write_and_stop())
+    return 1;
+  if (test_hang_up())
+    return 1;
+
+  std::cout << "serial reactor tests passed\n";
+  return 0;
+}
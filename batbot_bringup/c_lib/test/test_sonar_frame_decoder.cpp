@@ -0,0 +1,228 @@
+/**
+ * @file
+ * @brief Feeds the sonar frame decoder streams of plain and packed frames mixed with
+ * noise, corrupted frames, missing frames and frames with mismatched ears, cut into
+ * chunks of many sizes
+ */
+
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "sonar_frame_decoder.hpp"
+#include "test_check.hpp"
+
+#define NUM_FRAMES 60
+
+/**
+ * @brief A plain frame, or a packed one if payload is not 0. The decoder does not look
+ * inside the payload, so a packed frame is just a shorter one.
+ */
+static std::vector<uint8_t> make_frame(uint32_t seq, uint32_t seq_adc1, uint16_t payload = 0)
+{
+  std::vector<uint8_t> f(SONAR_FRAME_HEADER_BYTES + (payload ? payload : SONAR_FRAME_PAYLOAD_BYTES));
+  uint8_t* samples = &f[SONAR_FRAME_HEADER_BYTES];
+  for (std::size_t i = 0; i < f.size() - SONAR_FRAME_HEADER_BYTES; ++i)
+    samples[i] = (uint8_t)(seq * 7 + i);
+
+  // magic bytes inside the samples must not confuse the search
+  memcpy(samples + 100, "BBSF", 4);
+
+  SonarFrameHeader h;
+  memset(&h, 0, sizeof(h));
+  h.magic = SONAR_FRAME_MAGIC;
+  h.seq = seq;
+  h.seq_adc1 = seq_adc1;
+  h.cycles = seq * 600000;
+  h.micros = seq * 1016;
+  h.count = SONAR_FRAME_SAMPLES;
+  h.version = SONAR_FRAME_VERSION;
+  if (payload) {
+    h.flags = SONAR_FRAME_FLAG_DELTA;
+    h.payload = payload;
+    h.crc = sonarPackedFrameCRC(&h, samples);
+  } else {
+    h.crc = sonarFrameCRC(&h, samples, samples + SONAR_FRAME_PAYLOAD_BYTES / 2);
+  }
+  memcpy(&f[0], &h, sizeof(h));
+  return f;
+}
+
+/**
+ * @brief Builds the test stream and the sequence numbers of the frames that must come out of it
+ */
+static void make_stream(std::vector<uint8_t>& stream, std::vector<uint32_t>& expected, std::vector<std::size_t>& lengths)
+{
+  uint32_t rng = 12345;
+  for (uint32_t seq = 0; seq < NUM_FRAMES; ++seq) {
+    rng = rng * 1103515245 + 12345;
+    // every third frame packed, so short frames turn up behind corrupted long ones
+    uint16_t payload = seq % 3 == 0 ? (uint16_t)(200 + (rng >> 12) % 2500) : 0;
+    std::vector<uint8_t> f = make_frame(seq, seq, payload);
+
+    switch (seq % 10) {
+    case 3:
+      // lost on the way
+      continue;
+    case 5:
+      // one flipped bit
+      f[SONAR_FRAME_HEADER_BYTES + (rng >> 8) % (f.size() - SONAR_FRAME_HEADER_BYTES)] ^= 0x04;
+      break;
+    case 7:
+      // cut short, the next frame starts inside it
+      f.resize((rng >> 8) % f.size());
+      break;
+    case 8:
+      // ears from different DMA blocks
+      f = make_frame(seq, seq + 1, payload);
+      break;
+    default:
+      expected.push_back(seq);
+      lengths.push_back(f.size());
+    }
+    stream.insert(stream.end(), f.begin(), f.end());
+
+    // noise, sometimes the start of a magic
+    std::size_t noise = (rng >> 16) % 9;
+    for (std::size_t i = 0; i < noise; ++i)
+      stream.push_back(i % 3 == 0 ? 'B' : (uint8_t)(rng >> i));
+  }
+}
+
+static int run_chunked(const std::vector<uint8_t>& stream, const std::vector<uint32_t>& expected,
+                       const std::vector<std::size_t>& lengths, std::size_t chunk)
+{
+  SonarFrameDecoder dec;
+  dec.restart();
+
+  std::vector<uint32_t> got;
+  uint32_t last = 0;
+  uint64_t gaps = 0;
+  for (std::size_t off = 0; off < stream.size(); off += chunk) {
+    // copy each chunk so in-place frames can only point at the current chunk
+    std::vector<uint8_t> buf(stream.begin() + off, stream.begin() + std::min(off + chunk, stream.size()));
+    const uint8_t* data = buf.data();
+    std::size_t len = buf.size();
+    const uint8_t* frame = NULL;
+
+    while (len > 0 || frame != NULL) {
+      std::size_t n = dec.feed(data, len, &frame);
+      CHECK(n <= len);
+      data += n;
+      len -= n;
+
+      if (frame != NULL) {
+        uint32_t seq = dec.header().seq;
+        CHECK(memcmp(frame, &dec.header(), sizeof(SonarFrameHeader)) == 0);
+        CHECK(got.size() < lengths.size() && dec.frameBytes() == lengths[got.size()]);
+        CHECK(frame[SONAR_FRAME_HEADER_BYTES] == (uint8_t)(seq * 7));
+        CHECK(got.empty() ? dec.gap() == seq : dec.gap() == seq - last - 1);
+        gaps += dec.gap();
+        last = seq;
+        got.push_back(seq);
+      }
+    }
+  }
+
+  if (got != expected) {
+    std::cout << "chunk " << chunk << ": decoded " << got.size() << " frames, expected " << expected.size() << "\n";
+    return 1;
+  }
+
+  const SonarStreamStats& s = dec.stats();
+  CHECK(s.frames == expected.size());
+  CHECK(s.missed_frames == gaps);
+  CHECK(s.missed_frames == last + 1 - expected.size());
+  CHECK(s.crc_errors >= NUM_FRAMES / 10);
+  CHECK(s.ear_mismatches == NUM_FRAMES / 10);
+  CHECK(s.bytes_dropped > 0);
+  return 0;
+}
+
+static int test_in_place()
+{
+  SonarFrameDecoder dec;
+  dec.restart();
+
+  std::vector<uint8_t> buf = make_frame(0, 0);
+  std::vector<uint8_t> b = make_frame(1, 1);
+  buf.insert(buf.end(), b.begin(), b.end());
+
+  // whole frames inside one chunk come back as pointers into that chunk
+  const uint8_t* frame;
+  std::size_t n = dec.feed(buf.data(), buf.size(), &frame);
+  CHECK(n == SONAR_FRAME_BYTES && frame == buf.data() && !dec.frameBuffered());
+  n = dec.feed(buf.data() + n, buf.size() - n, &frame);
+  CHECK(n == SONAR_FRAME_BYTES && frame == buf.data() + SONAR_FRAME_BYTES && dec.gap() == 0);
+  CHECK(dec.header().micros == 1016);
+  n = dec.feed(buf.data(), 0, &frame);
+  CHECK(n == 0 && frame == NULL);
+
+  // the listener started counting again
+  b = make_frame(0, 0);
+  n = dec.feed(b.data(), b.size(), &frame);
+  CHECK(frame != NULL && dec.gap() == 0);
+  CHECK(dec.stats().missed_frames == 0 && dec.stats().bytes_dropped == 0);
+  return 0;
+}
+
+static int test_short_behind_cut()
+{
+  // a plain frame cut short with two packed frames and a plain one behind it: the packed
+  // frames are only found once the cut frame has been buffered to full length and failed
+  std::vector<uint8_t> stream = make_frame(0, 0);
+  stream.resize(100);
+  for (uint32_t seq = 1; seq <= 3; ++seq) {
+    std::vector<uint8_t> f = make_frame(seq, seq, seq < 3 ? 500 : 0);
+    stream.insert(stream.end(), f.begin(), f.end());
+  }
+
+  const std::size_t chunks[] = {1, 7, 4096, 5000};
+  for (std::size_t chunk : chunks) {
+    SonarFrameDecoder dec;
+    dec.restart(1);
+    std::vector<uint32_t> got;
+    for (std::size_t off = 0; off < stream.size(); off += chunk) {
+      const uint8_t* data = stream.data() + off;
+      std::size_t len = std::min(chunk, stream.size() - off);
+      const uint8_t* frame = NULL;
+      while (len > 0 || frame != NULL) {
+        std::size_t n = dec.feed(data, len, &frame);
+        data += n;
+        len -= n;
+        if (frame != NULL) {
+          CHECK(dec.frameBytes() == (dec.header().seq < 3 ? SONAR_FRAME_HEADER_BYTES + 500 : SONAR_FRAME_BYTES));
+          got.push_back(dec.header().seq);
+        }
+      }
+    }
+    CHECK(got == std::vector<uint32_t>({1, 2, 3}));
+    CHECK(dec.stats().missed_frames == 0);
+  }
+  return 0;
+}
+
+int main()
+{
+  // zlib's check value, so zlib.crc32() verifies frames on the Python side
+  CHECK(sonarCRC32(0, (const uint8_t*)"123456789", 9) == 0xCBF43926u);
+
+  if (test_in_place() || test_short_behind_cut())
+    return 1;
+
+  std::vector<uint8_t> stream;
+  std::vector<uint32_t> expected;
+  std::vector<std::size_t> lengths;
+  make_stream(stream, expected, lengths);
+
+  const std::size_t chunks[] = {1, 3, 511, 512, 4095, 4096, 4097, 65536};
+  for (std::size_t chunk : chunks) {
+    if (run_chunked(stream, expected, lengths, chunk))
+      return 1;
+  }
+  if (run_chunked(stream, expected, lengths, stream.size()))
+    return 1;
+
+  std::cout << "sonar frame decoder tests passed\n";
+  return 0;
+}
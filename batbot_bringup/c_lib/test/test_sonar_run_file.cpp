@@ -0,0 +1,140 @@
+/**
+ * @file
+ * @brief Writes, appends to, tears and reads back sonar run files
+ */
+
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "sonar_run_file.hpp"
+#include "test_check.hpp"
+
+static uint16_t sample(std::size_t ping, std::size_t ear, std::size_t i)
+{
+  return (uint16_t)(ping * 7919 + ear * 104729 + i * 31);
+}
+
+static int write_pings(SonarRunWriter& w, std::size_t first, std::size_t count, std::size_t n)
+{
+  std::vector<uint16_t> l(n), r(n);
+  for (std::size_t p = first; p < first + count; ++p) {
+    for (std::size_t i = 0; i < n; ++i) {
+      l[i] = sample(p, 0, i);
+      r[i] = sample(p, 1, i);
+    }
+
+    SonarPingInfo info;
+    memset(&info, 0, sizeof info);
+    info.timestamp_ns = 1000 + p;
+    info.sample_rate = 1e6;
+    info.chirp_id = 0xC0FFEE00 + (uint32_t)p;
+    info.num_angles = 14;
+    for (int a = 0; a < 14; ++a)
+      info.angles[a] = (int16_t)(a - 7 + p);
+
+    CHECK(w.appendPing(info, l.data(), r.data(), n) == 0);
+  }
+  return 0;
+}
+
+static int check_pings(const SonarRunReader& rd, std::size_t first, std::size_t count, std::size_t n)
+{
+  for (std::size_t p = first; p < first + count; ++p) {
+    const SonarPingHeader* h = rd.header(p);
+    CHECK(h != NULL);
+    CHECK(h->index == p && h->timestamp_ns == 1000 + p && h->chirp_id == 0xC0FFEE00 + p);
+    CHECK(h->sample_rate == 1e6 && h->samples_per_ear == n && h->num_angles == 14);
+    CHECK(h->angles[0] == (int16_t)(p - 7) && h->angles[13] == (int16_t)(p + 6));
+
+    const uint16_t* l = rd.left(p);
+    const uint16_t* r = rd.right(p);
+    CHECK((uintptr_t)l % SONAR_RUN_ALIGN == 0);
+    for (std::size_t i = 0; i < n; ++i)
+      CHECK(l[i] == sample(p, 0, i) && r[i] == sample(p, 1, i));
+  }
+  return 0;
+}
+
+int main()
+{
+  char path[] = "/tmp/test_sonar_run_XXXXXX";
+  int fd = mkstemp(path);
+  CHECK(fd >= 0);
+  close(fd);
+
+  // a run of 30 ms pings, then a longer one
+  {
+    SonarRunWriter w(path);
+    CHECK(w.isOpen());
+    CHECK(write_pings(w, 0, 5, 30000) == 0);
+    CHECK(write_pings(w, 5, 1, 30001) == 0);
+    CHECK(w.numPings() == 6);
+  }
+  {
+    SonarRunReader rd(path);
+    CHECK(rd.isOpen() && rd.indexed() && rd.numPings() == 6);
+    CHECK(check_pings(rd, 0, 5, 30000) == 0);
+    CHECK(check_pings(rd, 5, 1, 30001) == 0);
+    CHECK(rd.uniformStride(0, 5) == sonarRunRecordSize(30000));
+    CHECK(rd.uniformStride(0, 6) == 0);
+    CHECK(rd.header(6) == NULL && rd.left(6) == NULL);
+  }
+
+  // appending keeps the old pings and replaces the footer
+  {
+    SonarRunWriter w(path, true);
+    CHECK(w.isOpen() && w.numPings() == 6);
+    CHECK(write_pings(w, 6, 2, 1000) == 0);
+  }
+  {
+    SonarRunReader rd(path);
+    CHECK(rd.isOpen() && rd.indexed() && rd.numPings() == 8);
+    CHECK(check_pings(rd, 0, 5, 30000) == 0);
+    CHECK(check_pings(rd, 6, 2, 1000) == 0);
+  }
+
+  // cut off the footer and half the last ping, like a run that never got closed
+  uint64_t torn = 64 + 5 * sonarRunRecordSize(30000) + sonarRunRecordSize(30001) +
+                  sonarRunRecordSize(1000) + 1000;
+  CHECK(truncate(path, torn) == 0);
+  {
+    SonarRunReader rd(path);
+    CHECK(rd.isOpen() && !rd.indexed() && rd.numPings() == 7);
+    CHECK(check_pings(rd, 0, 5, 30000) == 0);
+    CHECK(check_pings(rd, 6, 1, 1000) == 0);
+  }
+
+  // appending to the torn run drops the partial ping and carries on
+  {
+    SonarRunWriter w(path, true);
+    CHECK(w.isOpen() && w.numPings() == 7);
+    CHECK(write_pings(w, 7, 3, 1000) == 0);
+  }
+  {
+    SonarRunReader rd(path);
+    CHECK(rd.isOpen() && rd.indexed() && rd.numPings() == 10);
+    CHECK(check_pings(rd, 6, 4, 1000) == 0);
+    CHECK(rd.uniformStride(6, 10) == sonarRunRecordSize(1000));
+  }
+
+  // anything else is refused rather than appended to
+  CHECK(truncate(path, 0) == 0);
+  {
+    FILE* f = fopen(path, "w");
+    fputs("not a run file, just some text that is long enough to look like a header......", f);
+    fclose(f);
+    SonarRunReader rd(path);
+    CHECK(!rd.isOpen());
+    SonarRunWriter w(path, true);
+    CHECK(!w.isOpen());
+  }
+
+  unlink(path);
+  std::cout << "sonar run file tests passed\n";
+  return 0;
+}
@@ -0,0 +1,155 @@
+/**
+ * @file
+ * @brief Round trips ears through the firmware's packers and every available unpacking
+ * kernel, on quiet, noisy, full swing and constant signals of several lengths, and feeds
+ * the unpackers broken input
+ */
+
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "sonar_pack.hpp"
+#include "sonar_unpack.hpp"
+#include "test_check.hpp"
+
+static const lr_isa_t isas[] = {LR_ISA_SCALAR, LR_ISA_SSE2, LR_ISA_AVX2, LR_ISA_NEON};
+
+typedef enum { SIG_ECHO, SIG_NOISE, SIG_SWING, SIG_FLAT } signal_t;
+
+static std::vector<uint16_t> make_signal(signal_t sig, std::size_t n, uint32_t seed)
+{
+  std::vector<uint16_t> x(n);
+  uint32_t rng = seed;
+  for (std::size_t i = 0; i < n; ++i) {
+    rng = rng * 1103515245 + 12345;
+    double v;
+    switch (sig) {
+    case SIG_ECHO:
+      // an 80 kHz echo at 2 MS/s over a little noise
+      v = 512 + 300 * std::sin(2 * M_PI * 80000 / 2e6 * i) * std::exp(-(double)i / 400) + (int)(rng >> 28) - 8;
+      break;
+    case SIG_NOISE:
+      v = (rng >> 16) & 0x3FF;
+      break;
+    case SIG_SWING:
+      v = (i & 1) ? 1023 : 0;
+      break;
+    default:
+      v = 517;
+    }
+    x[i] = (uint16_t)v;
+  }
+  return x;
+}
+
+static int round_trip(signal_t sig, std::size_t n)
+{
+  std::vector<uint16_t> x = make_signal(sig, n, (uint32_t)(sig * 7919 + n));
+
+  std::vector<uint8_t> packed(SONAR_PACK10_BYTES(n));
+  CHECK(sonarPack10(x.data(), n, packed.data()) == packed.size());
+
+  std::size_t max_delta = SONAR_PACK_DELTA_WIDTH_BYTES(n) + n / SONAR_PACK_DELTA_GROUP * SONAR_PACK_DELTA_MAX_WIDTH;
+  std::vector<uint8_t> delta(max_delta);
+  std::size_t delta_len = sonarDeltaEncode(x.data(), n, delta.data(), delta.size());
+  CHECK(delta_len > 0);
+  delta.resize(delta_len);
+
+  // the firmware's budget: fall back to PACK10 unless DELTA is smaller
+  std::vector<uint8_t> scratch(packed.size());
+  std::size_t budgeted = sonarDeltaEncode(x.data(), n, scratch.data(), packed.size());
+  CHECK(budgeted == (delta_len <= packed.size() ? delta_len : 0));
+  if (sig == SIG_FLAT)
+    CHECK(delta_len == SONAR_PACK_DELTA_WIDTH_BYTES(n) + 4);  // only the step from mid scale
+  if (sig == SIG_ECHO)
+    CHECK(delta_len < packed.size());
+  if (sig == SIG_SWING)
+    CHECK(delta_len == max_delta);
+
+  for (lr_isa_t isa : isas) {
+    if (!lrIsaAvailable(isa))
+      continue;
+
+    // a guard sample after the output catches overruns
+    std::vector<uint16_t> out(n + 1, 0xBEEF);
+    CHECK(sonarUnpackEar(SONAR_FRAME_FLAG_PACK10, packed.data(), packed.size(), out.data(), n, isa) == (int)packed.size());
+    CHECK(memcmp(out.data(), x.data(), 2 * n) == 0 && out[n] == 0xBEEF);
+
+    std::fill(out.begin(), out.end(), 0xBEEF);
+    CHECK(sonarUnpackEar(SONAR_FRAME_FLAG_DELTA, delta.data(), delta.size(), out.data(), n, isa) == (int)delta.size());
+    if (memcmp(out.data(), x.data(), 2 * n) != 0 || out[n] != 0xBEEF) {
+      std::cout << lrIsaName(isa) << ": delta round trip of signal " << sig << ", " << n << " samples failed\n";
+      return 1;
+    }
+
+    // truncated input is refused, never read past
+    std::vector<uint8_t> cut(delta.begin(), delta.end() - 1);
+    CHECK(sonarUnpackEar(SONAR_FRAME_FLAG_DELTA, cut.data(), cut.size(), out.data(), n, isa) == -1);
+    CHECK(sonarUnpackEar(SONAR_FRAME_FLAG_PACK10, packed.data(), packed.size() - 1, out.data(), n, isa) == -1);
+  }
+  return 0;
+}
+
+/**
+ * @brief Builds a packed frame the way the firmware does and unpacks it again
+ */
+static int frame_round_trip(uint16_t flags)
+{
+  std::vector<uint16_t> a = make_signal(SIG_ECHO, SONAR_FRAME_SAMPLES, 1);
+  std::vector<uint16_t> b = make_signal(SIG_ECHO, SONAR_FRAME_SAMPLES, 2);
+
+  uint8_t payload[SONAR_FRAME_PAYLOAD_BYTES];
+  std::size_t len;
+  if (flags == SONAR_FRAME_FLAG_PACK10) {
+    len = sonarPack10(a.data(), SONAR_FRAME_SAMPLES, payload);
+    len += sonarPack10(b.data(), SONAR_FRAME_SAMPLES, payload + len);
+  } else {
+    len = sonarDeltaEncode(a.data(), SONAR_FRAME_SAMPLES, payload, sizeof(payload));
+    len += sonarDeltaEncode(b.data(), SONAR_FRAME_SAMPLES, payload + len, sizeof(payload) - len);
+  }
+
+  SonarFrameHeader h;
+  memset(&h, 0, sizeof(h));
+  h.count = SONAR_FRAME_SAMPLES;
+  h.flags = flags;
+  h.payload = (uint16_t)len;
+  CHECK(sonarFramePayloadBytes(&h) == len);
+
+  std::vector<uint16_t> first(SONAR_FRAME_SAMPLES), second(SONAR_FRAME_SAMPLES);
+  CHECK(sonarUnpackFrame(&h, payload, first.data(), second.data()) == 0);
+  CHECK(first == a && second == b);
+
+  // the ears must use up exactly the payload
+  h.payload = (uint16_t)(len + 1);
+  CHECK(sonarUnpackFrame(&h, payload, first.data(), second.data()) == -1);
+  h.payload = (uint16_t)(len - 1);
+  CHECK(sonarUnpackFrame(&h, payload, first.data(), second.data()) == -1);
+  return 0;
+}
+
+int main()
+{
+  const std::size_t lengths[] = {8, 16, 24, 40, 128, SONAR_FRAME_SAMPLES};
+  for (std::size_t n : lengths) {
+    for (signal_t sig : {SIG_ECHO, SIG_NOISE, SIG_SWING, SIG_FLAT}) {
+      if (round_trip(sig, n))
+        return 1;
+    }
+  }
+
+  if (frame_round_trip(SONAR_FRAME_FLAG_PACK10) || frame_round_trip(SONAR_FRAME_FLAG_DELTA))
+    return 1;
+
+  // a group width beyond 11 bits is not a valid coding
+  uint8_t bad[64] = {0x0C};
+  uint16_t out[16];
+  for (lr_isa_t isa : isas) {
+    if (lrIsaAvailable(isa))
+      CHECK(sonarUnpackEar(SONAR_FRAME_FLAG_DELTA, bad, sizeof(bad), out, 16, isa) == -1);
+  }
+
+  std::cout << "sonar unpack tests passed (best isa " << lrIsaName(lrBestIsa()) << ")\n";
+  return 0;
+}
@@ -0,0 +1,169 @@
+/**
+ * @file
+ * @brief Checks RealFFT against a direct DFT and Spectrogram against a double precision
+ * reference of what mlab.specgram and plot_spec compute
+ */
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "real_fft.hpp"
+#include "spectrogram.hpp"
+#include "test_check.hpp"
+
+static std::vector<float> noise(std::size_t n, uint32_t seed)
+{
+  std::vector<float> x(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    seed = seed * 1664525 + 1013904223;
+    x[i] = (float)(seed >> 20) - 2048.0f;
+  }
+  return x;
+}
+
+static int test_fft()
+{
+  for (std::size_t n = 4; n <= 2048; n *= 2) {
+    RealFFT fft(n);
+    std::vector<float> x = noise(n, (uint32_t)n);
+    std::vector<cfloat_t> X(fft.numBins()), scratch(fft.scratchLen());
+    fft.forward(x.data(), X.data(), scratch.data());
+
+    double tol = 1e-5 * 2048 * n;
+    for (std::size_t k = 0; k < fft.numBins(); ++k) {
+      double re = 0, im = 0;
+      for (std::size_t j = 0; j < n; ++j) {
+        double a = -2.0 * M_PI * (double)((j * k) % n) / n;
+        re += x[j] * cos(a);
+        im += x[j] * sin(a);
+      }
+      CHECK(std::fabs(X[k].real() - re) < tol && std::fabs(X[k].imag() - im) < tol);
+    }
+
+    std::vector<float> y(n);
+    fft.inverse(X.data(), y.data(), scratch.data());
+    for (std::size_t j = 0; j < n; ++j)
+      CHECK(std::fabs(y[j] - x[j]) < 1e-3);
+  }
+  return 0;
+}
+
+/*
+ * mlab.specgram(x - mean(x), NFFT, noverlap, window=hann) then 20 log10, in double
+ */
+static std::vector<double> reference(const std::vector<float>& x, std::size_t offset, double fs,
+                                     std::size_t nfft, std::size_t noverlap,
+                                     std::size_t k0, std::size_t k1, std::size_t* frames)
+{
+  double mean = 0;
+  for (float v : x)
+    mean += v;
+  mean /= x.size();
+
+  std::vector<double> w(nfft);
+  double wpow = 0;
+  for (std::size_t i = 0; i < nfft; ++i) {
+    w[i] = 0.5 - 0.5 * cos(2.0 * M_PI * i / (nfft - 1));
+    wpow += w[i] * w[i];
+  }
+
+  std::size_t step = nfft - noverlap;
+  *frames = (x.size() - offset - noverlap) / step;
+  std::vector<double> out((k1 - k0) * *frames);
+
+  for (std::size_t f = 0; f < *frames; ++f) {
+    for (std::size_t k = k0; k < k1; ++k) {
+      double re = 0, im = 0;
+      for (std::size_t j = 0; j < nfft; ++j) {
+        double v = (x[offset + f * step + j] - mean) * w[j];
+        double a = -2.0 * M_PI * (double)((j * k) % nfft) / nfft;
+        re += v * cos(a);
+        im += v * sin(a);
+      }
+      double p = (re * re + im * im) / (fs * wpow);
+      if (k != 0 && k != nfft / 2)
+        p *= 2;
+      out[(k - k0) * *frames + f] = 20 * log10(p);
+    }
+  }
+  return out;
+}
+
+static int test_spectrogram()
+{
+  const double fs = 1e6;
+  Spectrogram spec(fs, 512, 400, 30e3, 100e3, 1);
+
+  // 30 kHz is bin 15.36 and 100 kHz is bin 51.2, so rows are bins 16 .. 51
+  CHECK(spec.numBins() == 36);
+  CHECK(std::fabs(spec.binFrequency(0) - 16 * fs / 512) < 1e-9);
+  CHECK(std::fabs(spec.frameTime(1) - (256 + 112) / fs) < 1e-12);
+  CHECK(spec.numFrames(511) == 0);
+  CHECK(spec.numFrames(512) == 1);
+  CHECK(spec.numFrames(30000) == (30000 - 400) / 112);
+
+  std::vector<float> left = noise(6000, 1), right = noise(6000, 2);
+  for (std::size_t i = 0; i < right.size(); ++i)
+    right[i] += 300.0f;
+
+  std::size_t offset = 333;
+  std::size_t frames = spec.numFrames(left.size() - offset);
+  std::vector<float> ldb(spec.numBins() * frames), rdb(spec.numBins() * frames);
+  CHECK(spec.compute(left.data(), right.data(), left.size(), ldb.data(), rdb.data(), true, offset) == 0);
+
+  std::size_t ref_frames;
+  std::vector<double> lref = reference(left, offset, fs, 512, 400, 16, 52, &ref_frames);
+  std::vector<double> rref = reference(right, offset, fs, 512, 400, 16, 52, &ref_frames);
+  CHECK(ref_frames == frames);
+  for (std::size_t i = 0; i < lref.size(); ++i)
+    CHECK(std::fabs(ldb[i] - lref[i]) < 0.01 && std::fabs(rdb[i] - rref[i]) < 0.01);
+
+  // threads only change who computes a frame, never the result
+  Spectrogram spec4(fs, 512, 400, 30e3, 100e3, 4);
+  std::vector<float> ldb4(ldb.size()), rdb4(rdb.size());
+  CHECK(spec4.compute(left.data(), right.data(), left.size(), ldb4.data(), rdb4.data(), true, offset) == 0);
+  CHECK(ldb4 == ldb && rdb4 == rdb);
+
+  // raw samples give the same as their float copies
+  std::vector<uint16_t> raw(left.size());
+  std::vector<float> rawf(left.size());
+  for (std::size_t i = 0; i < raw.size(); ++i) {
+    raw[i] = (uint16_t)(left[i] + 2048.0f);
+    rawf[i] = raw[i];
+  }
+  std::vector<float> a(ldb.size()), b(ldb.size());
+  CHECK(spec4.compute(raw.data(), NULL, raw.size(), a.data(), NULL, true, offset) == 0);
+  CHECK(spec4.compute(rawf.data(), NULL, rawf.size(), b.data(), NULL, true, offset) == 0);
+  CHECK(a == b);
+
+  // a 50 kHz tone peaks at bin 25.6, rounded to 26, row 10
+  std::vector<float> tone(30000);
+  for (std::size_t i = 0; i < tone.size(); ++i)
+    tone[i] = (float)(1000 * sin(2 * M_PI * 50e3 * i / fs));
+  frames = spec4.numFrames(tone.size());
+  std::vector<float> tdb(spec4.numBins() * frames);
+  CHECK(spec4.compute(tone.data(), NULL, tone.size(), tdb.data(), NULL, false, 0, 40) == 0);
+  for (std::size_t f = 0; f < frames; ++f) {
+    std::size_t best = 0;
+    for (std::size_t r = 0; r < spec4.numBins(); ++r) {
+      CHECK(tdb[r * frames + f] <= 0 && tdb[r * frames + f] >= -40);
+      if (tdb[r * frames + f] > tdb[best * frames + f])
+        best = r;
+    }
+    CHECK(best == 10);
+  }
+
+  // nothing to do before the first full frame
+  CHECK(spec4.compute(tone.data(), NULL, 600, tdb.data(), NULL, true, 100) == -1);
+  return 0;
+}
+
+int main()
+{
+  if (test_fft() || test_spectrogram())
+    return 1;
+
+  std::cout << "spectrogram tests passed\n";
+  return 0;
+}
@@ -0,0 +1,164 @@
+/**
+ * @file
+ * @brief Feeds the shared tendon frame decoder streams of valid frames mixed with noise
+ * and corrupted frames, cut into chunks of every size from 1 byte upwards
+ */
+
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "tendon_frame_decoder.hpp"
+#include "tendon_hardware_interface.hpp"
+#include "test_check.hpp"
+
+// same table driven CRC as the firmware and TendonHardwareInterface, computed bitwise
+static uint16_t crc16(uint16_t crc, const uint8_t* data, uint16_t len)
+{
+  for (uint16_t i = 0; i < len; ++i) {
+    crc ^= (uint16_t)data[i] << 8;
+    for (int b = 0; b < 8; ++b)
+      crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x8005) : (uint16_t)(crc << 1);
+  }
+  return crc;
+}
+
+static std::vector<uint8_t> make_frame(uint8_t seq, uint8_t num_params)
+{
+  std::vector<uint8_t> f;
+  f.push_back(0xFF);
+  f.push_back(0x00);
+  f.push_back(num_params + TENDON_CONTROL_PKT_LEN_OVERHEAD);
+  f.push_back(seq);
+  f.push_back(1);
+  f.push_back(ECHO);
+  for (uint8_t i = 0; i < num_params; ++i)
+    f.push_back((uint8_t)(i == 0 ? 0xFF : seq + i)); // header-like bytes inside the payload
+  uint16_t crc = crc16(0, f.data(), f.size());
+  f.push_back(crc >> 8);
+  f.push_back(crc & 0xFF);
+  return f;
+}
+
+/**
+ * @brief Builds the test stream and the sequence numbers of the frames that must come out of it
+ */
+static void make_stream(std::vector<uint8_t>& stream, std::vector<uint8_t>& expected)
+{
+  uint32_t rng = 12345;
+  for (int i = 0; i < 400; ++i) {
+    rng = rng * 1103515245 + 12345;
+    uint8_t seq = (uint8_t)i;
+    std::vector<uint8_t> f = make_frame(seq, (rng >> 8) % 25);
+
+    switch ((rng >> 16) % 6) {
+      case 0:
+        // line noise, including a lone header and an impossible length
+        stream.push_back(0x13);
+        stream.push_back(0xFF);
+        stream.push_back(0xFF);
+        stream.push_back(0x00);
+        stream.push_back(0xF0);
+        break;
+      case 1: {
+        // a corrupted frame followed directly by a good one
+        std::vector<uint8_t> bad = make_frame(0xEE, 4);
+        bad[7] ^= 0x10;
+        stream.insert(stream.end(), bad.begin(), bad.end());
+        break;
+      }
+      case 2: {
+        // a frame cut short by a new header
+        std::vector<uint8_t> cut = make_frame(0xEE, 10);
+        stream.insert(stream.end(), cut.begin(), cut.begin() + 8);
+        break;
+      }
+      default:
+        break;
+    }
+
+    stream.insert(stream.end(), f.begin(), f.end());
+    expected.push_back(seq);
+  }
+}
+
+static int run_chunked(const std::vector<uint8_t>& stream, const std::vector<uint8_t>& expected, std::size_t chunk)
+{
+  TendonControl_frame_decoder_t dec;
+  tendonDecoderInit(&dec, crc16);
+
+  std::vector<uint8_t> got;
+  for (std::size_t off = 0; off < stream.size(); off += chunk) {
+    // copy each chunk so in-place frames can only point at the current chunk
+    std::vector<uint8_t> buf(stream.begin() + off, stream.begin() + std::min(off + chunk, stream.size()));
+    const uint8_t* data = buf.data();
+    std::size_t len = buf.size();
+    const uint8_t* frame = NULL;
+    std::size_t frame_len = 0;
+
+    while (len > 0 || frame != NULL) {
+      std::size_t n = tendonDecoderFeed(&dec, data, len, &frame, &frame_len);
+      CHECK(n <= len);
+      data += n;
+      len -= n;
+
+      if (frame != NULL) {
+        CHECK(frame[0] == 0xFF && frame[1] == 0x00);
+        CHECK(frame_len == (std::size_t)frame[2] + 3);
+        CHECK(crc16(0, frame, frame_len - 2) == ((frame[frame_len - 2] << 8) | frame[frame_len - 1]));
+        got.push_back(frame[3]);
+      }
+    }
+  }
+
+  if (got != expected) {
+    std::cout << "chunk " << chunk << ": decoded " << got.size() << " frames, expected " << expected.size() << "\n";
+    return 1;
+  }
+  CHECK(dec.frames == expected.size());
+  CHECK(dec.crc_errors > 0);
+  CHECK(dec.bytes_dropped > 0);
+  return 0;
+}
+
+static int test_in_place()
+{
+  TendonControl_frame_decoder_t dec;
+  tendonDecoderInit(&dec, crc16);
+
+  std::vector<uint8_t> a = make_frame(1, 3);
+  std::vector<uint8_t> b = make_frame(2, 0);
+  std::vector<uint8_t> buf(a);
+  buf.insert(buf.end(), b.begin(), b.end());
+
+  // whole frames inside one chunk come back as pointers into that chunk
+  const uint8_t* frame;
+  std::size_t frame_len;
+  std::size_t n = tendonDecoderFeed(&dec, buf.data(), buf.size(), &frame, &frame_len);
+  CHECK(n == a.size() && frame == buf.data() && frame_len == a.size());
+  n = tendonDecoderFeed(&dec, buf.data() + n, buf.size() - n, &frame, &frame_len);
+  CHECK(n == b.size() && frame == buf.data() + a.size() && frame_len == b.size());
+  n = tendonDecoderFeed(&dec, buf.data(), 0, &frame, &frame_len);
+  CHECK(n == 0 && frame == NULL);
+  return 0;
+}
+
+int main()
+{
+  if (test_in_place())
+    return 1;
+
+  std::vector<uint8_t> stream;
+  std::vector<uint8_t> expected;
+  make_stream(stream, expected);
+
+  for (std::size_t chunk = 1; chunk <= 70; ++chunk) {
+    if (run_chunked(stream, expected, chunk))
+      return 1;
+  }
+  if (run_chunked(stream, expected, stream.size()))
+    return 1;
+
+  std::cout << "tendon frame decoder tests passed\n";
+  return 0;
+}
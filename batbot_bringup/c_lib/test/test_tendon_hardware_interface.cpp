@@ -0,0 +1,155 @@
+/**
+ * @file
+ * @brief Checks that SendTxRx() returns its own response when late and duplicate frames
+ * arrive right behind it in the same read, and that a request times out while the
+ * controller keeps sending bytes that never make up its response
+ */
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "tendon_crc16.hpp"
+#include "tendon_hardware_interface.hpp"
+#include "test_check.hpp"
+
+/**
+ * @brief Writes a response frame: header, len, seq, id, opcode, params, big endian CRC
+ *
+ * @return std::size_t the frame's length
+ */
+static std::size_t frame(uint8_t* out, uint8_t seq, uint8_t id, uint8_t opcode, const uint8_t* params, std::size_t num_params)
+{
+  std::size_t len = 6 + num_params;
+  out[0] = 0xFF;
+  out[1] = 0x00;
+  out[2] = (uint8_t)(num_params + TENDON_CONTROL_PKT_LEN_OVERHEAD);
+  out[3] = seq;
+  out[4] = id;
+  out[5] = opcode;
+  memcpy(out + 6, params, num_params);
+  uint16_t crc = tendonCRC16Slice8(0, out, (uint16_t)len);
+  out[len] = TENDON_CONTROL_GET_UPPER_16B(crc);
+  out[len + 1] = TENDON_CONTROL_GET_LOWER_16B(crc);
+  return len + 2;
+}
+
+/**
+ * @brief Plays the controller: reads one request and writes its echo, then a response to
+ * a request never sent and a second response to the same one, all in one write
+ */
+static void device(int fd)
+{
+  uint8_t out[3 * TENDON_CONTROL_PKT_MAX_NUM_BYTES_IN_FRAME];
+  std::size_t got = 0;
+  while (got < 3 || got < (std::size_t)out[2] + 3) {
+    ssize_t n = read(fd, out + got, TENDON_CONTROL_PKT_MAX_NUM_BYTES_IN_FRAME - got);
+    if (n <= 0)
+      return;
+    got += n;
+  }
+
+  const uint8_t stale[] = {0xAA, 0xBB, 0xCC};
+  const uint8_t dup[] = {0xDD, 0xEE};
+  std::size_t len = got;
+  len += frame(out + len, (uint8_t)(out[3] + 1), out[4], ECHO, stale, sizeof stale);
+  len += frame(out + len, out[3], out[4], ECHO, dup, sizeof dup);
+  if (write(fd, out, len) < 0)
+    return;
+}
+
+/**
+ * @brief Reads one request and then streams bytes with no frame header among them for
+ * seconds seconds, so every read in Poll() returns data
+ */
+static void noisy_device(int fd, double seconds)
+{
+  uint8_t in[TENDON_CONTROL_PKT_MAX_NUM_BYTES_IN_FRAME];
+  std::size_t got = 0;
+  while (got < 3 || got < (std::size_t)in[2] + 3) {
+    ssize_t n = read(fd, in + got, sizeof in - got);
+    if (n <= 0)
+      return;
+    got += n;
+  }
+
+  const uint8_t noise[8] = {0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55};
+  auto end = std::chrono::steady_clock::now() + std::chrono::duration<double>(seconds);
+  while (std::chrono::steady_clock::now() < end) {
+    if (write(fd, noise, sizeof noise) < 0)
+      return;
+    usleep(10000);
+  }
+}
+
+static int test_late_frames()
+{
+  int master = posix_openpt(O_RDWR | O_NOCTTY);
+  CHECK(master >= 0 && grantpt(master) == 0 && unlockpt(master) == 0);
+
+  // no termios here, it defines ECHO. The interface puts the pty into raw mode when it opens the slave.
+  std::thread dev(device, master);
+
+  const uint8_t params[] = {0x12, 0x34};
+  int len;
+  std::size_t rx_len;
+  uint8_t rx[TENDON_CONTROL_PKT_MAX_NUM_BYTES_IN_FRAME];
+  {
+    TendonHardwareInterface th(ptsname(master));
+    th.BuildPacket(1, ECHO, params, sizeof params);
+    len = th.SendTxRx();
+    rx_len = th.RxLength();
+    memcpy(rx, th.RxBuffer(), sizeof rx);
+  }
+  dev.join();
+  close(master);
+
+  // the echo, not either of the frames read along with it
+  std::size_t want = 3 + TENDON_CONTROL_PKT_LEN_OVERHEAD + sizeof params;
+  CHECK(len == (int)want && rx_len == want);
+  CHECK(memcmp(rx + 6, params, sizeof params) == 0);
+  return 0;
+}
+
+static int test_deadline_under_noise()
+{
+  int master = posix_openpt(O_RDWR | O_NOCTTY);
+  CHECK(master >= 0 && grantpt(master) == 0 && unlockpt(master) == 0);
+  const double noise_s = 2.0;
+  std::thread dev(noisy_device, master, noise_s);
+
+  const uint8_t params[] = {0x12, 0x34};
+  double waited;
+  std::size_t timeouts, in_flight;
+  {
+    TendonHardwareInterface th(ptsname(master));
+    auto start = std::chrono::steady_clock::now();
+    CHECK(th.Submit(1, ECHO, params, sizeof params) >= 0);
+    while (th.InFlight() > 0 && std::chrono::steady_clock::now() - start < std::chrono::duration<double>(noise_s))
+      CHECK(th.Poll() >= 0);
+    waited = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    timeouts = th.Timeouts();
+    in_flight = th.InFlight();
+  }
+  dev.join();
+  close(master);
+
+  // failed on its deadline, long before the noise stopped
+  CHECK(in_flight == 0 && timeouts == 1);
+  CHECK(waited >= TENDON_CONTROL_REQUEST_TIMEOUT_MS / 1e3 && waited < TENDON_CONTROL_REQUEST_TIMEOUT_MS / 1e3 + 1.0);
+  return 0;
+}
+
+int main()
+{
+  if (test_late_frames() || test_deadline_under_noise())
+    return 1;
+
+  std::cout << "tendon hardware interface tests passed\n";
+  return 0;
+}
@@ -0,0 +1,216 @@
+/**
+ * @file
+ * @brief Runs EchoRecorder against the listener emulator
+ *
+ * The echoes must land where the emulator put them relative to the reported trigger,
+ * in every packing and in a capture window. Baseband must match SonarDDC run on the
+ * clean signal. Frames it leaves out or corrupts must be counted exactly, and if nobody
+ * reads it must overrun like the firmware's ring. A silent emitter fails the listen and
+ * the capture on the ERROR reply.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "echo_recorder.hpp"
+#include "sonar_ddc.hpp"
+#include "sonar_frame_decoder.hpp"
+#include "virtual_listener.hpp"
+#include "test_check.hpp"
+
+#define TRIGGER_OFFSET 321
+
+/**
+ * @brief Checks both ears against the emulator's clean ping, allowing for the noise
+ */
+static int check_echoes(const VirtualListener& dev, const std::vector<uint16_t>& left,
+                        const std::vector<uint16_t>& right, int64_t trigger)
+{
+  const std::vector<float>* ping[2] = {&dev.ping(0), &dev.ping(1)};
+  const std::vector<uint16_t>* ears[2] = {&left, &right};
+  for (int ear = 0; ear < 2; ++ear) {
+    const int64_t len = (int64_t)ping[ear]->size();
+    double worst = 0;
+    for (std::size_t i = 0; i < left.size(); ++i) {
+      std::size_t k = (std::size_t)((((int64_t)i - trigger) % len + len) % len);
+      worst = std::max(worst, (double)std::fabs((*ears[ear])[i] - VIRTUAL_LISTENER_MID_SCALE - (*ping[ear])[k]));
+    }
+    // 6 sigma of 2 counts of noise plus rounding
+    if (worst > 13) {
+      std::cout << "ear " << ear << " is " << worst << " counts off the echoes\n";
+      return 1;
+    }
+  }
+  return 0;
+}
+
+int main()
+{
+  VirtualListenerConfig config = virtualListenerDefaults();
+  config.triggerOffset = TRIGGER_OFFSET;
+
+  {
+    VirtualListener dev(config);
+    CHECK(dev.isOpen());
+    EchoRecorder rec(dev.portName());
+    CHECK(rec.isOpen());
+    CHECK(rec.ackRequest() == 0);
+
+    // two pings, in every packing
+    std::size_t n = 60000 + TRIGGER_OFFSET;
+    std::vector<uint16_t> left(n), right(n);
+    const listener_packing_t packings[] = {LISTENER_PACKING_NONE, LISTENER_PACKING_10BIT, LISTENER_PACKING_DELTA};
+    for (listener_packing_t packing : packings) {
+      CHECK(rec.setPacking(packing) == 0);
+      CHECK(rec.listen(left.data(), right.data(), n) == 0);
+      CHECK(rec.streamStats().missed_frames == 0 && rec.streamStats().unmatched_frames == 0);
+      CHECK(rec.triggerSample() == TRIGGER_OFFSET);
+      CHECK(check_echoes(dev, left, right, rec.triggerSample()) == 0);
+    }
+
+    // a window around the trigger, sent raw whatever the packing
+    const std::size_t pre = 3000, post = 57000;
+    std::vector<uint16_t> capLeft(pre + post), capRight(pre + post);
+    CHECK(rec.capture(capLeft.data(), capRight.data(), pre, post) == 0);
+    CHECK(rec.triggerSample() == (int64_t)pre);
+    CHECK(check_echoes(dev, capLeft, capRight, rec.triggerSample()) == 0);
+    CHECK(rec.setPacking(LISTENER_PACKING_NONE) == 0);
+
+    // a window the capture ring cannot hold is refused
+    const std::size_t ring = (std::size_t)config.captureFrames * SONAR_FRAME_SAMPLES;
+    std::vector<uint16_t> bigLeft(ring), bigRight(ring);
+    CHECK(rec.capture(bigLeft.data(), bigRight.data(), ring - 2 * SONAR_FRAME_SAMPLES, 0) < 0);
+    CHECK(rec.ackRequest() == 0);
+
+    dev.setEmitterSilent(true);
+    auto start = std::chrono::steady_clock::now();
+    CHECK(rec.listen(left.data(), right.data(), n) < 0);
+    CHECK(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(ECHO_RECORDER_TIMEOUT_MS));
+    start = std::chrono::steady_clock::now();
+    CHECK(rec.capture(capLeft.data(), capRight.data(), pre, post) < 0);
+    CHECK(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(ECHO_RECORDER_TIMEOUT_MS));
+    dev.setEmitterSilent(false);
+    CHECK(rec.ackRequest() == 0);
+    CHECK(rec.droppedBytes() == 0);
+  }
+
+  // baseband, against SonarDDC run here on the clean signal
+  config.noise = 0;
+  {
+    VirtualListener dev(config);
+    EchoRecorder rec(dev.portName());
+    CHECK(rec.ackRequest() == 0);
+    CHECK(rec.setBaseband(true) == 0);
+
+    // 16 frames of 4 blocks, two int16 per complex sample
+    const std::size_t blocks = 16 * VIRTUAL_LISTENER_IQ_BLOCKS;
+    const std::size_t perBlock = 2 * (SONAR_FRAME_SAMPLES / SONAR_DDC_DECIMATION);
+    std::vector<uint16_t> left(blocks * perBlock), right(blocks * perBlock);
+    CHECK(rec.listen(left.data(), right.data(), left.size()) == 0);
+    CHECK(rec.streamStats().missed_frames == 0 && rec.streamStats().unmatched_frames == 0);
+    CHECK(rec.triggerSample() == 2 * (TRIGGER_OFFSET / SONAR_DDC_DECIMATION));
+
+    const std::vector<uint16_t>* ears[2] = {&left, &right};
+    for (int ear = 0; ear < 2; ++ear) {
+      SonarDDC ddc;
+      CHECK(ddc.init((uint32_t)config.sampleRate) == 0);
+      const std::vector<float>& ping = dev.ping(ear);
+      std::vector<int16_t> want(left.size());
+      uint16_t block[SONAR_FRAME_SAMPLES];
+      for (std::size_t b = 0; b < blocks; ++b) {
+        for (std::size_t i = 0; i < SONAR_FRAME_SAMPLES; ++i) {
+          std::size_t k = (b * SONAR_FRAME_SAMPLES + i + ping.size() - TRIGGER_OFFSET) % ping.size();
+          float v = VIRTUAL_LISTENER_MID_SCALE + ping[k];
+          block[i] = (uint16_t)std::min(1023.0f, std::max(0.0f, std::nearbyint(v)));
+        }
+        ddc.process(block, SONAR_FRAME_SAMPLES, want.data() + b * perBlock);
+      }
+      CHECK(memcmp(ears[ear]->data(), want.data(), 2 * want.size()) == 0);
+    }
+    CHECK(rec.setBaseband(false) == 0);
+  }
+
+  // lost and corrupted frames, as fast as the host reads
+  config.noise = 2;
+  config.rateScale = 0;
+  config.dropRate = 0.02;
+  config.corruptRate = 0.01;
+  {
+    VirtualListener dev(config);
+    EchoRecorder rec(dev.portName());
+    CHECK(rec.ackRequest() == 0);
+
+    const uint32_t frames = 1000;
+    std::vector<uint16_t> left(frames * SONAR_FRAME_SAMPLES), right(frames * SONAR_FRAME_SAMPLES);
+    CHECK(rec.listen(left.data(), right.data(), left.size()) == 0);
+
+    // a lost tail is only counted once the frame after it arrives
+    std::vector<uint32_t> lost = dev.lostFrames();
+    std::vector<uint32_t> corrupted = dev.corruptedFrames();
+    CHECK(!lost.empty() && !corrupted.empty());
+    uint32_t last = frames - 1;
+    while (std::count(lost.begin(), lost.end(), last) || std::count(corrupted.begin(), corrupted.end(), last))
+      last++;
+    uint64_t bad = std::count_if(corrupted.begin(), corrupted.end(), [&](uint32_t s) { return s < last; });
+    uint64_t gone = std::count_if(lost.begin(), lost.end(), [&](uint32_t s) { return s < last; });
+    CHECK(rec.streamStats().crc_errors == bad);
+    CHECK(rec.streamStats().missed_frames == bad + gone);
+
+    // the good frames still hold the echoes, the lost ones gap fill
+    for (std::size_t i = 0; i < left.size(); ++i) {
+      uint32_t seq = (uint32_t)(i / SONAR_FRAME_SAMPLES);
+      if (std::count(lost.begin(), lost.end(), seq) || std::count(corrupted.begin(), corrupted.end(), seq))
+        CHECK(left[i] == ECHO_RECORDER_GAP_FILL && right[i] == ECHO_RECORDER_GAP_FILL);
+      else
+        CHECK(std::fabs(left[i] - VIRTUAL_LISTENER_MID_SCALE -
+                        dev.ping(0)[(i - TRIGGER_OFFSET + dev.ping(0).size()) % dev.ping(0).size()]) <= 13);
+    }
+  }
+
+  // nobody reads for a while: the emulator blocks on the full pty and its ring overruns
+  config = virtualListenerDefaults();
+  {
+    VirtualListener dev(config);
+    int fd = open(dev.portName().c_str(), O_RDWR | O_NOCTTY);
+    CHECK(fd >= 0);
+    uint8_t cmd = LISTENER_CMD_START_LISTEN;
+    CHECK(write(fd, &cmd, 1) == 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    // drain what was buffered and a little more, then stop
+    SonarFrameDecoder decoder;
+    decoder.restart();
+    std::vector<uint8_t> buf(65536);
+    auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+    while (std::chrono::steady_clock::now() < until) {
+      ssize_t got = read(fd, buf.data(), buf.size());
+      std::size_t off = 0;
+      while (got > 0 && off < (std::size_t)got) {
+        const uint8_t* frame;
+        off += decoder.feed(buf.data() + off, got - off, &frame);
+      }
+    }
+    cmd = LISTENER_CMD_STOP_LISTEN;
+    CHECK(write(fd, &cmd, 1) == 1);
+    close(fd);
+
+    VirtualListenerStats s = dev.stats();
+    CHECK(s.frames_overrun > 100);
+    CHECK(s.frames_dropped == 0 && s.frames_corrupted == 0);
+    CHECK(decoder.stats().missed_frames > 0 && decoder.stats().missed_frames <= s.frames_overrun);
+    CHECK(decoder.stats().crc_errors == 0);
+  }
+
+  std::cout << "virtual listener tests passed\n";
+  return 0;
+}
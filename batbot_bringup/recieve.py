@@ -235,7 +235,7 @@ def split_raw_to_LR(
 # teensy.write(b'0')
 # teensy.close()
 
-CHAN_BURST = 1000
+CHAN_BURST = 1016
 bb_ears = EchoRecorder(
     Serial("/dev/ttyACM0"), channel_burst_len=CHAN_BURST
 )
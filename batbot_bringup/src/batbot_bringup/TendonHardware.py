@@ -75,12 +75,16 @@ class TendonHardwareInterface:
             self.test_mode = False
 
         self.packet = []
+        self.seq = 0
 
     def BuildPacket(self, id, opcode, params):
         data = [0xFF, 0x00]
 
-        length = len(params) + 4
+        # seq, id, opcode and the two crc bytes are counted in the length
+        length = len(params) + 5
         data.append(length)
+        data.append(self.seq)
+        self.seq = (self.seq + 1) & 0xFF
         data.append(id)
         data.append(opcode)
         data = data + params
@@ -135,10 +139,11 @@ class TendonHardwareInterface:
 
         if data != -1:
             return {
-                "id": data[3],
-                "opcode": data[4],
-                "status": data[5],
-                "params": data[6:]
+                "seq": data[3],
+                "id": data[4],
+                "opcode": data[5],
+                "status": data[6],
+                "params": data[7:]
             }
         else:
             return -1
@@ -44,6 +44,18 @@ import multiprocessing as mp
 from serial_helper import get_port_from_serial_num
 from datetime import datetime
 
+# native spectrogram from c_lib, falls back to mlab.specgram when the extension is not built
+try:
+    import sonardsp
+except ImportError:
+    sonardsp = None
+
+# native run file writer from c_lib, falls back to a pair of .npy files per ping
+try:
+    import sonarrun
+except ImportError:
+    sonarrun = None
+
 
 logging.basicConfig(level=logging.WARNING)
 plt.set_loglevel("error")
@@ -126,6 +138,19 @@ def plot_spec(ax, fig, spec_tup, fbounds = (30E3, 100E3), dB_range = 40, plot_ti
     ax.title.set_text(plot_title)
 
 
+def plot_spec_db(ax, fig, s_db, f, t, fbounds = (30E3, 100E3), plot_title = 'spec', plot_db=False):
+    """plot_spec() for a spectrogram sonardsp.Spectrogram already cropped, normalized and clipped"""
+    fmin, fmax = fbounds
+    cf = ax.pcolormesh(t, f, s_db, cmap='jet', shading='auto')
+    if plot_db:
+        cbar = fig.colorbar(cf, ax=ax)
+        cbar.ax.set_ylabel('dB')
+
+    ax.set_ylim(fmin, fmax)
+    ax.set_ylabel('Frequency (Hz)')
+    ax.set_xlabel('Time (sec)')
+    ax.title.set_text(plot_title)
+
  
             
 def plot_time(ax, fig,Fs,plot_data,use_ms=False)->None:
@@ -555,7 +580,7 @@ class bb_repl(Cmd):
     run_parser = Cmd2ArgumentParser()
     run_parser.add_argument('-lt','--listen_time_ms',type=int,help="Time to listen for in ms",default=30)
     run_parser.add_argument('-p','--plot',action='store_true',help="Plot the results")
-    run_parser.add_argument('-pf','--plot_freq',help="how often to plot the spec", default=5)
+    run_parser.add_argument('-pf','--plot_freq',type=int,help="how often to plot the spec", default=1 if sonardsp is not None else 5)
     run_parser.add_argument('-nc','--num_chirps',type=int,help='times to chirp',default=30)
     run_parser.add_argument('-to','--time_off',type=int,default=3000)
 
@@ -576,7 +601,7 @@ class bb_repl(Cmd):
 		            wspace=0.4,
 		            hspace=0.4)
 
-        Fs = 1e6
+        Fs = bb_listener.SONAR_ADC_RATE
         count = 0
         NFFT = 512
         noverlap = 400
@@ -585,18 +610,41 @@ class bb_repl(Cmd):
         f_plot_bounds = (30E3, 100E3)
         
         show_db = True
+
+        # plan once for the whole run, both ears are done together on every core
+        spec = None
+        if sonardsp is not None:
+            spec = sonardsp.Spectrogram(Fs, NFFT, noverlap, f_plot_bounds[0], f_plot_bounds[1])
+            spec_f = spec.freqs()
         
         cur_time = self.get_current_time_str()
         cur_dir = self.runs_path+f"/RUN_{cur_time}"
         os.makedirs(cur_dir)
         self.emitter.save_chirp_info(cur_dir+"/chirp_info.txt")
+
+        # every ping of the run in one append-only file, read back with sonarrun.RunReader
+        run_file = None
+        if sonarrun is not None:
+            run_file = sonarrun.RunWriter(cur_dir+"/run.bbrun")
         while True:
             _,L,R = self.record_MCU.listen(args.listen_time_ms)
             
-            np.save(cur_dir+f"/left_ear_{count}.npy",L)
-            np.save(cur_dir+f"/right_ear_{count}.npy",R)
-
-            if args.plot and count % args.plot_freq == 0:
+            if run_file is not None:
+                angles = np.concatenate((self.L_pinna_MCU.current_angles, self.R_pinna_MCU.current_angles))
+                run_file.append(L, R, chirp_id=getattr(self.emit_MCU, 'chirp_crc', 0), sample_rate=bb_listener.SONAR_ADC_RATE, angles=angles)
+            else:
+                np.save(cur_dir+f"/left_ear_{count}.npy",L)
+                np.save(cur_dir+f"/right_ear_{count}.npy",R)
+
+            if args.plot and count % args.plot_freq == 0 and spec is not None:
+                s1, s2 = spec.compute(L, R, time_offset=args.time_off, db_range=DB_range)
+                spec_t = spec.times(len(L), args.time_off)
+                plot_spec_db(axes[0], fig, s1, spec_f, spec_t, fbounds = f_plot_bounds, plot_title='Left Ear',plot_db=show_db)
+                plot_spec_db(axes[1], fig, s2, spec_f, spec_t, fbounds = f_plot_bounds, plot_title='Right Ear',plot_db=show_db)
+                show_db = False
+                plt.draw()
+                plt.pause(0.0001)
+            elif args.plot and count % args.plot_freq == 0:
                 spec_tup1, pt_cut1, pt1 = process(L, spec_settings, time_offs=args.time_off)
                 spec_tup2, pt_cut2, pt2 = process(R, spec_settings, time_offs=args.time_off)
                 plot_spec(axes[0], fig, spec_tup1, fbounds = f_plot_bounds, dB_range = DB_range, plot_title='Left Ear',plot_db=show_db)
@@ -611,6 +659,9 @@ class bb_repl(Cmd):
                 break
             
             count+=1
+
+        if run_file is not None:
+            run_file.close()
         
         
     
@@ -694,6 +745,8 @@ class bb_repl(Cmd):
     upload_chirp_parser.add_argument('-fft','--fft',help='Preview',action='store_true')
     upload_chirp_parser.add_argument('-spec','--spec',help='Preview',action='store_true')
     upload_chirp_parser.add_argument('-cf','--file',help='file to use')
+    upload_chirp_parser.add_argument('-w','--window',help='hann, hamming or blackman',type=str,default=None)
+    upload_chirp_parser.add_argument('-sy','--synth',help='send only the parameters, the emitter makes the chirp',action='store_true')
     @with_argparser(upload_chirp_parser)
     def do_upload_chirp(self,args):
         
@@ -705,7 +758,7 @@ class bb_repl(Cmd):
             if freq1 is None:
                 self.perror("-f1 should be xk")
                 
-            [s,t] = self.emit_MCU.gen_chirp(freq0,freq1,args.time,args.method,args.gain)
+            [s,t] = self.emit_MCU.gen_chirp(freq0,freq1,args.time,args.method,args.gain,window=args.window)
         else:
             s = self.emit_MCU.get_and_convert_numpy(args.file)
          
@@ -761,7 +814,10 @@ class bb_repl(Cmd):
                 return
             val = input(f"y/n: ")
 
-        self.emit_MCU.upload_chirp(data=s)
+        if args.synth and not args.file:
+            self.emit_MCU.synth_chirp(freq0,freq1,args.time,args.method,args.gain,window=args.window)
+        else:
+            self.emit_MCU.upload_chirp(data=s)
     
     upload_parser = Cmd2ArgumentParser()
     upload_parser.add_argument('file',help='file to upload')
@@ -830,6 +886,61 @@ class bb_repl(Cmd):
         # self.emit_MCU.chirp()
         self.emit_MCU.write_cmd(bb_emitter.ECHO_SERIAL_CMD.EMIT_CHIRP)
         
+    bank_parser = Cmd2ArgumentParser()
+    bank_parser.add_argument('-s','--select',help='CRC32 in hex of the chirp to play',type=str)
+    bank_parser.add_argument('-e','--emit',help='and play it now',action='store_true')
+    @with_argparser(bank_parser)
+    def do_bank(self,args):
+        if args.select:
+            self.emit_MCU.query_bank()
+            self.emit_MCU.select_chirp(int(args.select,16),emit=args.emit)
+            return
+        
+        bank = self.emit_MCU.query_bank()
+        if bank is None:
+            self.perror("emitter did not answer")
+            return
+        for crc,length in bank.items():
+            mark = '*' if crc == self.emit_MCU.chirp_crc else ' '
+            self.poutput(f"{mark} {crc:08x} {length/1e3:6.3f} ms")
+        
+    train_parser = Cmd2ArgumentParser()
+    train_parser.add_argument('-i','--interval',help='ms between pings',type=float,default=50)
+    train_parser.add_argument('-n','--num_pings',help='pings, 0 until stopped',type=int,default=0)
+    train_parser.add_argument('-s','--stop',help='stop the train',action='store_true')
+    @with_argparser(train_parser)
+    def do_train(self,args):
+        if args.stop:
+            self.emit_MCU.stop_ping_train()
+            running, pings, first, times = self.emit_MCU.ping_train_status()
+            if pings is not None:
+                self.poutput(f"stopped after {pings} pings")
+            return
+        
+        if self.emit_MCU.start_ping_train(args.interval,args.num_pings):
+            self.poutput(f"pinging every {args.interval} ms, stop with train -s")
+        
+    stream_parser = Cmd2ArgumentParser()
+    stream_parser.add_argument('-f0','--freq0',help='start freq',type=str)
+    stream_parser.add_argument('-f1','--freq1',help='end freq',type=str)
+    stream_parser.add_argument('-t','--time',help='Time in ms to sweep, any length',type=float,default=1000)
+    stream_parser.add_argument('-g','--gain',help='gain to boost signal for DAC',type=int,default=512)
+    stream_parser.add_argument('-m','--method',help='linear, quadratic..',type=str,default='linear')
+    stream_parser.add_argument('-w','--window',help='hann, hamming or blackman',type=str,default=None)
+    stream_parser.add_argument('-d','--divider',help='DAC rate is 1 MHz / divider, 2 or more keeps up over USB',type=int,default=2)
+    @with_argparser(stream_parser)
+    def do_stream(self,args):
+        freq0 = convert_khz(args.freq0)
+        freq1 = convert_khz(args.freq1)
+        if freq0 is None or freq1 is None:
+            self.perror("-f0 and -f1 should be xk")
+            return
+        
+        # made at 1 MHz for a sweep divider times faster, it plays divider times slower
+        [s,t] = self.emit_MCU.gen_chirp(freq0*args.divider,freq1*args.divider,args.time/args.divider,args.method,args.gain,window=args.window)
+        underruns = self.emit_MCU.stream_chirp(s,args.divider)
+        if underruns is not None:
+            self.poutput(f"streamed {args.time} ms at {1e3/args.divider:.0f} kHz, {underruns} underruns")
         
     def do_quit(self,args):
         try:
@@ -25,7 +25,32 @@ class ECHO_SERIAL_CMD(Enum):
     START_AMP = 8
     STOP_AMP = 9
     CLEAR_SERIAL = 10
+    CHIRP_SYNTH = 11
+    CHIRP_BANK_QUERY = 12
+    CHIRP_SELECT = 13
+    EMIT_SLOT = 14
+    CHIRP_CRC_START = 15
+    CHIRP_CRC_POLL = 16
+    PING_TRAIN_START = 17
+    PING_TRAIN_STOP = 18
+    PING_TRAIN_STATUS = 19
+    STREAM_START = 20
     
+# chirp upload, bytes per ACK as CHIRP_UPLOAD_BLOCK in echo_main.cpp, and how many
+# blocks may be on the wire before waiting for the oldest ACK
+CHIRP_UPLOAD_BLOCK = 4096
+CHIRP_UPLOAD_WINDOW = 4
+
+# streaming playback, blocks in the emitter's ring as CHIRP_STREAM_BLOCKS in chirp_stream.hpp,
+# each one CHIRP_UPLOAD_BLOCK bytes
+CHIRP_STREAM_BLOCKS = 8
+
+# CHIRP_SYNTH parameters, ChirpParams in chirp_synth.hpp: f0, f1, duration in us, method,
+# window, reserved, gain, offset, little endian
+CHIRP_SYNTH_FORMAT = '<ddIBBHff'
+CHIRP_SYNTH_METHODS = ['linear', 'quadratic', 'logarithmic', 'hyperbolic']
+CHIRP_SYNTH_WINDOWS = [None, 'hann', 'hamming', 'blackman']
+
 class LAST_CHIRP_DATA(Enum):
     FILE = 0
     CUSTOM = 1
@@ -69,6 +94,12 @@ class EchoEmitter:
         self.output_t = 1/output_freq
         
         self.chirp_uploaded = False
+        # zlib CRC32 of the uploaded chirp, recorded with each ping as its chirp id
+        self.chirp_crc = 0
+        # the emitter's chirp bank as last queried, CRC32 -> length, and the CRCs synth_chirp
+        # got back for each set of parameters
+        self.bank = {}
+        self.synth_crcs = {}
         self.last_upload_type = LAST_CHIRP_DATA.NONE
         self.last_f0 = 0
         self.last_f1 = 0
@@ -163,6 +194,21 @@ class EchoEmitter:
         elif cmd == ECHO_SERIAL_CMD.STOP_AMP.value:
             return ECHO_SERIAL_CMD.STOP_AMP
         
+        elif cmd == ECHO_SERIAL_CMD.CHIRP_SYNTH.value:
+            return ECHO_SERIAL_CMD.CHIRP_SYNTH
+        
+        elif cmd == ECHO_SERIAL_CMD.CHIRP_BANK_QUERY.value:
+            return ECHO_SERIAL_CMD.CHIRP_BANK_QUERY
+        
+        elif cmd == ECHO_SERIAL_CMD.CHIRP_CRC_POLL.value:
+            return ECHO_SERIAL_CMD.CHIRP_CRC_POLL
+        
+        elif cmd == ECHO_SERIAL_CMD.PING_TRAIN_STATUS.value:
+            return ECHO_SERIAL_CMD.PING_TRAIN_STATUS
+        
+        elif cmd == ECHO_SERIAL_CMD.STREAM_START.value:
+            return ECHO_SERIAL_CMD.STREAM_START
+        
         print(f"{t_colors.FAIL}UNKNOWN CMD {cmd}{t_colors.ENDC}")
         return ECHO_SERIAL_CMD.ERROR
 
@@ -186,21 +232,20 @@ class EchoEmitter:
         if not self.max_chirp_length:
             self.get_max_chirp_uint16_length()
         
-        write_data = []
-        copy_write = bytearray()
         data_len = len(data)
         
         if data_len > self.max_chirp_length:
             print(f"{t_colors.FAIL}DATA TOO LONG! given: {data_len} but max is {self.max_chirp_length} or {self.max_chirp_length*1e-3}ms!{t_colors.ENDC}")
             return False
 
+        # little endian uint16, as the DAC buffer holds it
+        payload = np.ascontiguousarray(data, dtype='<u2').tobytes()
+        OG_CRC = zlib.crc32(payload)
         
-        OG_CRC = zlib.crc32(data)
-
-        write_data = data.tolist()
-        for data in write_data:
-            copy_write.append(data &0xff)
-            copy_write.append((data>>8)&0xff)
+        # already on the emitter, it only needs to play
+        if self.resident(OG_CRC, data_len):
+            print(f"{t_colors.OKGREEN}CHIRP ALREADY ON THE EMITTER, SELECTED IT{t_colors.ENDC}")
+            return self.select_chirp(OG_CRC)
         
         self.itsy.write([ECHO_SERIAL_CMD.CHIRP_DATA.value,data_len&0xff,data_len>>8&0xff])
         
@@ -220,38 +265,44 @@ class EchoEmitter:
             self.chirp_uploaded = False
             return False
             
-        # upload the chirp
+        # stream the chirp in blocks, keeping up to CHIRP_UPLOAD_WINDOW of them unacknowledged
         hide_cursor()
-        for i in range(0,len(copy_write),20):
-            self.itsy.write([copy_write[i],copy_write[i+1],
-                             copy_write[i+2],copy_write[i+3],
-                             copy_write[i+4],copy_write[i+5],
-                             copy_write[i+6],copy_write[i+7],
-                             copy_write[i+8],copy_write[i+9],
-                             copy_write[i+10],copy_write[i+11],
-                             copy_write[i+12],copy_write[i+13],
-                             copy_write[i+14],copy_write[i+15],
-                             copy_write[i+16],copy_write[i+17],
-                             copy_write[i+18],copy_write[i+19]])
-            
-            if i % 20 == 0:
-                print(f"{t_colors.OKBLUE}Uploading{t_colors.ENDC}: {i/len(copy_write)*100:.1f}%",end='\r',flush=True)
+        start = time.perf_counter()
+        blocks = range(0, len(payload), CHIRP_UPLOAD_BLOCK)
+        acked = 0
+        for sent, i in enumerate(blocks):
+            if sent - acked >= CHIRP_UPLOAD_WINDOW:
+                msg_recv = self.get_cmd()
+                if msg_recv != ECHO_SERIAL_CMD.ACK:
+                    show_cursor()
+                    print(f"{t_colors.FAIL}EXPECTED ACK FOR BLOCK {acked} GOT {msg_recv}{t_colors.ENDC}")
+                    self.chirp_uploaded = False
+                    return False
+                acked += 1
+            self.itsy.write(payload[i:i + CHIRP_UPLOAD_BLOCK])
+            print(f"{t_colors.OKBLUE}Uploading{t_colors.ENDC}: {i/len(payload)*100:.1f}%",end='\r',flush=True)
+
+        while acked < len(blocks):
+            msg_recv = self.get_cmd()
+            if msg_recv != ECHO_SERIAL_CMD.ACK:
+                show_cursor()
+                print(f"{t_colors.FAIL}EXPECTED ACK FOR BLOCK {acked} GOT {msg_recv}{t_colors.ENDC}")
+                self.chirp_uploaded = False
+                return False
+            acked += 1
+        elapsed = time.perf_counter() - start
         print(f"{t_colors.OKBLUE}Uploading{t_colors.ENDC}: {100:.1f}%",end='\r',flush=True)
         print()            
         show_cursor()
-                
-
-        # wait for an ack from itsy to say they got it
-        self.write_cmd(ECHO_SERIAL_CMD.ACK_REQ)
-        msg_recv = self.get_cmd()
-        if msg_recv != ECHO_SERIAL_CMD.ACK:
-            print(f"{t_colors.FAIL}EXPECTED ACK {msg_recv}{t_colors.ENDC}")
-            self.chirp_uploaded = False
-            return
+        print(f"{len(payload)/1e3:.1f} kB in {elapsed*1e3:.0f} ms ({len(payload)/1e3/max(elapsed,1e-9):.0f} kB/s)")
         
-        # verify the chirp by reading it back
+        # the emitter follows the last ACK with the CRC it kept while receiving
         print("Validating hash...")
         crc_back = self.itsy.read(4)
+        if len(crc_back) != 4:
+            print(f"{t_colors.FAIL}NO HASH FROM EMITTER{t_colors.ENDC}")
+            self.chirp_uploaded = False
+            return False
         crc_back = (crc_back[0] | (crc_back[1]<<8) | (crc_back[2] << 16) | (crc_back[3] << 24))
 
 
@@ -263,7 +314,215 @@ class EchoEmitter:
             return False
         
         self.chirp_uploaded = True
+        self.chirp_crc = OG_CRC
+        self.EMIT_TIME = data_len
+        return True
+
+    def synth_chirp(self,f_start:int,f_end:int, t_end:float,method:str ='linear',gain:float = None,offset = None,window:str = None)->bool:
+        """Has the emitter make the chirp gen_chirp would, to within 1 LSB, from 32 bytes of
+        parameters instead of uploading its samples."""
+        if not self.connection_status():
+            return False
+        
+        if method not in CHIRP_SYNTH_METHODS or window not in CHIRP_SYNTH_WINDOWS:
+            print(f"{t_colors.FAIL}EMITTER CAN'T MAKE A {method} CHIRP WITH WINDOW {window}{t_colors.ENDC}")
+            return False
+        
+        g = self.SIG_GAIN if gain is None else gain
+        of = self.SIG_OFFSET if offset is None else offset
+        data_len = int(round(t_end*1e3))
+        
+        params = struct.pack(CHIRP_SYNTH_FORMAT, f_start, f_end, data_len, CHIRP_SYNTH_METHODS.index(method),
+                             CHIRP_SYNTH_WINDOWS.index(window), 0, g, of)
+        
+        crc = self.synth_crcs.get(params)
+        if crc is not None and self.resident(crc, data_len):
+            print(f"{t_colors.OKGREEN}CHIRP ALREADY ON THE EMITTER, SELECTED IT{t_colors.ENDC}")
+            return self.select_chirp(crc)
+        
+        self.itsy.write(bytes([ECHO_SERIAL_CMD.CHIRP_SYNTH.value]) + params)
+        
+        msg_recv = self.get_cmd()
+        if msg_recv != ECHO_SERIAL_CMD.ACK:
+            print(f"{t_colors.FAIL}EMITTER REFUSED THE CHIRP, GOT {msg_recv}{t_colors.ENDC}")
+            self.chirp_uploaded = False
+            return False
+        
+        crc_back = self.itsy.read(4)
+        if len(crc_back) != 4:
+            print(f"{t_colors.FAIL}NO HASH FROM EMITTER{t_colors.ENDC}")
+            self.chirp_uploaded = False
+            return False
+        
+        print(f"{t_colors.OKGREEN}SUCCESS, SYNTHESIZED CHIRP!{t_colors.ENDC}")
+        self.chirp_uploaded = True
+        self.chirp_crc = int.from_bytes(crc_back, 'little')
+        self.synth_crcs[params] = self.chirp_crc
         self.EMIT_TIME = data_len
+        self.last_upload_type = LAST_CHIRP_DATA.CUSTOM
+        self.last_f0 = f_start
+        self.last_f1 = f_end
+        self.last_tend = t_end
+        self.last_method = method
+        return True
+
+    def query_bank(self)->dict:
+        """CRC32 -> length of every chirp held on the emitter, None if it does not answer."""
+        self.write_cmd(ECHO_SERIAL_CMD.CHIRP_BANK_QUERY)
+        if self.get_cmd() != ECHO_SERIAL_CMD.CHIRP_BANK_QUERY:
+            return None
+        
+        head = self.itsy.read(2)
+        if len(head) != 2:
+            return None
+        raw = self.itsy.read(6*head[0])
+        if len(raw) != 6*head[0]:
+            return None
+        
+        self.bank = {}
+        for i in range(head[0]):
+            crc, length = struct.unpack_from('<IH', raw, 6*i)
+            if length:
+                self.bank[crc] = length
+        return self.bank
+    
+    def resident(self,crc:int,data_len:int)->bool:
+        bank = self.query_bank()
+        return bank is not None and bank.get(crc) == data_len
+    
+    def verify_chirp(self,software:bool = False,timeout:float = 1.0)->tuple[bool,int]:
+        """Has the emitter CRC the chirp that plays again, on the DSU in the background or
+        with its CRC32 library, and polls for the result. Whether it still matches what was
+        uploaded and the microseconds the emitter took, None for those if it did not answer."""
+        self.itsy.write(bytes([ECHO_SERIAL_CMD.CHIRP_CRC_START.value, 1 if software else 0]))
+        msg = self.get_cmd()
+        if msg != ECHO_SERIAL_CMD.ACK:
+            print(f"{t_colors.FAIL}EMITTER CAN'T CHECK THE CHIRP, GOT {msg}{t_colors.ENDC}")
+            return [None,None]
+        
+        deadline = time.perf_counter() + timeout
+        while time.perf_counter() < deadline:
+            self.write_cmd(ECHO_SERIAL_CMD.CHIRP_CRC_POLL)
+            if self.get_cmd() != ECHO_SERIAL_CMD.CHIRP_CRC_POLL:
+                break
+            raw = self.itsy.read(9)
+            if len(raw) != 9:
+                break
+            done, crc, elapsed = struct.unpack('<BII', raw)
+            if done:
+                return [crc == self.chirp_crc, elapsed]
+        
+        print(f"{t_colors.FAIL}NO CRC FROM EMITTER{t_colors.ENDC}")
+        return [None,None]
+    
+    def start_ping_train(self,interval_ms:float,count:int = 0)->bool:
+        """Has the emitter ping on its own timer every interval_ms, count times or until
+        stop_ping_train. The interval has to be longer than the chirp."""
+        if not self.chirp_uploaded:
+            print(f"{t_colors.WARNING}WARNING NO CHRIP UPLOADED{t_colors.ENDC}")
+        
+        self.itsy.write(bytes([ECHO_SERIAL_CMD.PING_TRAIN_START.value]) + struct.pack('<II', int(round(interval_ms*1e3)), count))
+        msg = self.get_cmd()
+        if msg != ECHO_SERIAL_CMD.ACK:
+            print(f"{t_colors.FAIL}EMITTER REFUSED A PING EVERY {interval_ms} ms, GOT {msg}{t_colors.ENDC}")
+            return False
+        return True
+    
+    def stop_ping_train(self)->bool:
+        self.write_cmd(ECHO_SERIAL_CMD.PING_TRAIN_STOP)
+        return self.get_cmd() == ECHO_SERIAL_CMD.ACK
+    
+    def ping_train_status(self,first:int = 0)->tuple[bool,int,int,np.ndarray]:
+        """Whether the train still runs, the pings so far, and the emitter's micros() of the
+        pings from first on that it still has, with the number of the first of them."""
+        self.itsy.write(bytes([ECHO_SERIAL_CMD.PING_TRAIN_STATUS.value]) + struct.pack('<I', first))
+        if self.get_cmd() != ECHO_SERIAL_CMD.PING_TRAIN_STATUS:
+            return [None,None,None,None]
+        
+        raw = self.itsy.read(10)
+        if len(raw) != 10:
+            return [None,None,None,None]
+        running, pings, first, n = struct.unpack('<BIIB', raw)
+        times = self.itsy.read(4*n)
+        if len(times) != 4*n:
+            return [None,None,None,None]
+        return [bool(running), pings, first, np.frombuffer(times, dtype='<u4')]
+    
+    def stream_chirp(self,data:np.uint16,divider:int = 1)->int:
+        """Plays a waveform of any length while it is sent, at 1 MHz / divider. USB full
+        speed carries about 600k samples a second, so playing without gaps takes a divider
+        of 2 or more. Returns how many blocks of silence the emitter played because the
+        samples came late, None if the stream failed. The chirp uploaded before stays."""
+        if not self.connection_status():
+            return None
+        if not 1 <= divider <= 255 or len(data) == 0:
+            print(f"{t_colors.FAIL}CAN'T STREAM {len(data)} SAMPLES AT 1 MHz / {divider}{t_colors.ENDC}")
+            return None
+        
+        payload = np.ascontiguousarray(data, dtype='<u2').tobytes()
+        self.itsy.write(bytes([ECHO_SERIAL_CMD.STREAM_START.value]) + struct.pack('<IB', len(data), divider))
+        
+        # an ACK waits for room in the ring, the reply for the whole ring to play out
+        block_s = CHIRP_UPLOAD_BLOCK/2*divider/1e6
+        old_timeout = self.itsy.timeout
+        self.itsy.timeout = max(old_timeout, CHIRP_STREAM_BLOCKS*block_s + 0.5)
+        try:
+            msg_recv = self.get_cmd()
+            if msg_recv != ECHO_SERIAL_CMD.ACK:
+                print(f"{t_colors.FAIL}EMITTER REFUSED THE STREAM, GOT {msg_recv}{t_colors.ENDC}")
+                return None
+            
+            hide_cursor()
+            blocks = range(0, len(payload), CHIRP_UPLOAD_BLOCK)
+            acked = 0
+            for sent, i in enumerate(blocks):
+                if sent - acked >= CHIRP_UPLOAD_WINDOW:
+                    msg_recv = self.get_cmd()
+                    if msg_recv != ECHO_SERIAL_CMD.ACK:
+                        show_cursor()
+                        print(f"{t_colors.FAIL}EXPECTED ACK FOR BLOCK {acked} GOT {msg_recv}{t_colors.ENDC}")
+                        return None
+                    acked += 1
+                self.itsy.write(payload[i:i + CHIRP_UPLOAD_BLOCK])
+                print(f"{t_colors.OKBLUE}Streaming{t_colors.ENDC}: {i/len(payload)*100:.1f}%",end='\r',flush=True)
+            
+            while acked < len(blocks):
+                msg_recv = self.get_cmd()
+                if msg_recv != ECHO_SERIAL_CMD.ACK:
+                    show_cursor()
+                    print(f"{t_colors.FAIL}EXPECTED ACK FOR BLOCK {acked} GOT {msg_recv}{t_colors.ENDC}")
+                    return None
+                acked += 1
+            print(f"{t_colors.OKBLUE}Streaming{t_colors.ENDC}: {100:.1f}%",end='\r',flush=True)
+            print()
+            show_cursor()
+            
+            msg_recv = self.get_cmd()
+            raw = self.itsy.read(4)
+            if msg_recv != ECHO_SERIAL_CMD.STREAM_START or len(raw) != 4:
+                print(f"{t_colors.FAIL}STREAM DID NOT FINISH, GOT {msg_recv}{t_colors.ENDC}")
+                return None
+        finally:
+            self.itsy.timeout = old_timeout
+        
+        underruns = int.from_bytes(raw,'little')
+        if underruns:
+            print(f"{t_colors.WARNING}{underruns} BLOCKS OF SILENCE, {underruns*block_s*1e3:.1f} ms, THE HOST WAS LATE{t_colors.ENDC}")
+        return underruns
+    
+    def select_chirp(self,crc:int,emit:bool = False)->bool:
+        """Makes a chirp already on the emitter the one EMIT_CHIRP plays, emit plays it right away."""
+        cmd = ECHO_SERIAL_CMD.EMIT_SLOT if emit else ECHO_SERIAL_CMD.CHIRP_SELECT
+        self.itsy.write(bytes([cmd.value]) + crc.to_bytes(4,'little'))
+        msg = self.get_cmd()
+        if msg != ECHO_SERIAL_CMD.ACK:
+            print(f"{t_colors.FAIL}CHIRP {crc:08x} NOT ON THE EMITTER, GOT {msg}{t_colors.ENDC}")
+            return False
+        
+        self.chirp_uploaded = True
+        self.chirp_crc = crc
+        self.EMIT_TIME = self.bank.get(crc, self.EMIT_TIME)
+        return True
 
  
     def get_max_chirp_uint16_length(self) -> np.uint16:
@@ -288,11 +547,13 @@ class EchoEmitter:
 
     
     
-    def gen_chirp(self,f_start:int,f_end:int, t_end:int,method:str ='linear',gain:float = None,offset = None)->tuple[np.uint16,np.ndarray]:
+    def gen_chirp(self,f_start:int,f_end:int, t_end:int,method:str ='linear',gain:float = None,offset = None,window:str = None)->tuple[np.uint16,np.ndarray]:
         Fs = 1e6
         Ts = 1/Fs
         t = np.arange(0,t_end*1e-3 - Ts/2,Ts)
         chirp = signal.chirp(t,f_start,t_end*1e-3,f_end,method)
+        if window is not None:
+            chirp = chirp*{'hann':np.hanning,'hamming':np.hamming,'blackman':np.blackman}[window](len(chirp))
         chirp = self.convert_and_range_data(chirp,gain,offset)
 
         self.last_upload_type = LAST_CHIRP_DATA.CUSTOM
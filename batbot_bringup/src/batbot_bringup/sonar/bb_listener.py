@@ -6,14 +6,126 @@ from serial import Serial
 import time
 import numpy as np
 import os
+import struct
+import zlib
 from enum import Enum
 
+# native recorder from c_lib, falls back to pyserial when the extension is not built
+try:
+    import echorecorder
+except ImportError:
+    echorecorder = None
+
+# listener stream framing, must match batbot_sonar/lib/stream/sonar_frame.hpp
+SONAR_FRAME_MAGIC = b'BBSF'
+SONAR_FRAME_SAMPLES = 1016
+SONAR_FRAME_HEADER = struct.Struct('<IIIIIHHHHI')
+SONAR_FRAME_CRC_OFFSET = 28
+SONAR_FRAME_BYTES = SONAR_FRAME_HEADER.size + SONAR_FRAME_SAMPLES*4
+# written in place of missing samples, mid scale of the 10 bit ADCs
+SONAR_GAP_FILL = 512
+SONAR_FRAME_FLAG_IQ = 0x1
+# packed frames, only the native recorder unpacks them, see sonar_pack.hpp
+SONAR_FRAME_FLAG_PACK10 = 0x2
+SONAR_FRAME_FLAG_DELTA = 0x4
+# both ADCs started off one timer and both DMA streams at the same sample count, a count
+# check that does not measure the skew between the ears
+SONAR_FRAME_FLAG_SAME_COUNT = 0x8
+# the frame holding the chirp trigger, with its sample offset in the top bits of the flags
+SONAR_FRAME_FLAG_TRIGGER = 0x10
+SONAR_FRAME_TRIGGER_SHIFT = 6
+
+# listener baseband, must match batbot_sonar/lib/ddc/sonar_ddc.hpp
+SONAR_ADC_RATE = 2e6
+SONAR_DDC_DECIMATION = 8
+SONAR_DDC_GAIN = 32.0
+
+# sent ahead of the frames of a triggered capture, see SonarCaptureHeader
+SONAR_CAPTURE_MAGIC = 0x43534242
+SONAR_CAPTURE_HEADER = struct.Struct('<IIIIIIII')
+
+def split_frames(raw_bytes:bytes, samples_per_ear:int, samples_per_frame:int = SONAR_FRAME_SAMPLES, first_seq:int = 0, gap_fill:int = SONAR_GAP_FILL):
+    """Cuts CRC checked frames out of the listener stream and places each ear by the
+    frame sequence numbers, so lost or corrupted frames leave SONAR_GAP_FILL behind
+    instead of shifting everything after them. Packed frames are stepped over and
+    read as missing, only the native recorder unpacks them.
+
+    Args:
+        raw_bytes (bytes): the stream as received
+        samples_per_ear (int): length of the output
+        samples_per_frame (int): samples per ear in each frame
+        first_seq (int): sequence number of the frame holding the first output sample
+        gap_fill (int): value of missing samples, 0 for baseband streams
+
+    Returns:
+        tuple[np.uint16,np.uint16,dict]: ADC 0 samples, ADC 1 samples, frame counters and
+        'trigger_sample', the index of the chirp trigger or None if no frame reported it
+    """
+    first = np.full(samples_per_ear, gap_fill, dtype=np.uint16)
+    second = np.full(samples_per_ear, gap_fill, dtype=np.uint16)
+    stats = {'frames':0, 'missed_frames':0, 'bytes_dropped':0, 'crc_errors':0, 'ear_mismatches':0,
+             'unmatched_frames':0, 'trigger_sample':None}
+    frame_len = SONAR_FRAME_HEADER.size + samples_per_frame*4
+
+    pos = 0
+    last_seq = first_seq - 1
+    while True:
+        start = raw_bytes.find(SONAR_FRAME_MAGIC, pos)
+        if start < 0 or start + frame_len > len(raw_bytes):
+            stats['bytes_dropped'] += len(raw_bytes) - pos if start < 0 else start - pos
+            break
+        stats['bytes_dropped'] += start - pos
+
+        magic, seq, seq_adc1, cycles, micros, count, version, flags, packed, crc = SONAR_FRAME_HEADER.unpack_from(raw_bytes, start)
+        if packed != 0:
+            # a packed frame, this path never asks for them, step over it and leave a gap
+            if count == samples_per_frame and packed <= samples_per_frame*4 and start + SONAR_FRAME_HEADER.size + packed <= len(raw_bytes):
+                stats['bytes_dropped'] += SONAR_FRAME_HEADER.size + packed
+                pos = start + SONAR_FRAME_HEADER.size + packed
+            else:
+                stats['bytes_dropped'] += 1
+                pos = start + 1
+            continue
+        payload = raw_bytes[start + SONAR_FRAME_HEADER.size:start + frame_len]
+        if count != samples_per_frame or zlib.crc32(payload, zlib.crc32(raw_bytes[start:start + SONAR_FRAME_CRC_OFFSET])) != crc:
+            if count == samples_per_frame:
+                stats['crc_errors'] += 1
+            stats['bytes_dropped'] += 1
+            pos = start + 1
+            continue
+        pos = start + frame_len
+
+        if seq != seq_adc1:
+            stats['ear_mismatches'] += 1
+            continue
+
+        stats['frames'] += 1
+        stats['missed_frames'] += max(seq - last_seq - 1, 0)
+        last_seq = seq
+
+        offset = (seq - first_seq)*samples_per_frame
+        if not flags & SONAR_FRAME_FLAG_SAME_COUNT:
+            stats['unmatched_frames'] += 1
+        if flags & SONAR_FRAME_FLAG_TRIGGER:
+            stats['trigger_sample'] = offset + (flags >> SONAR_FRAME_TRIGGER_SHIFT)
+        n = min(samples_per_frame, samples_per_ear - offset)
+        if n <= 0 or offset < 0:
+            continue
+        ears = np.frombuffer(payload, dtype=np.uint16).reshape(2, samples_per_frame)
+        first[offset:offset + n] = ears[0, :n]
+        second[offset:offset + n] = ears[1, :n]
+
+    return first, second, stats
+
 class LISTENER_SERIAL_CMD(Enum):
     NONE = 0
     START_LISTEN = 1
     STOP_LISTEN = 2
     ACK_REQ = 3
     ACK = 4
+    CAPTURE = 5
+    BASEBAND = 6
+    PACKING = 7
     ERROR = 100
     
 class t_colors:
@@ -29,12 +141,12 @@ class t_colors:
     
 class EchoRecorder:
     
-    def __init__(self, serial_obj:Serial = Serial(), channel_burst_len:np.uint16 = 1000, left_channel_first = True,sample_freq:int = 1e6) -> None:
+    def __init__(self, serial_obj:Serial = Serial(), channel_burst_len:np.uint16 = SONAR_FRAME_SAMPLES, left_channel_first = True,sample_freq:int = 1e6) -> None:
         """Create echo listener using the serial device 
 
         Args:
             serial_obj (Serial): object of teensy
-            channel_burst_len (np.uint16): length of left and right channel bursts. Defaults to 1000 uint16's.
+            channel_burst_len (np.uint16): samples per ear in each frame, must match the listener's buffer_size. Defaults to SONAR_FRAME_SAMPLES uint16's.
         """
         
         self.teensy = serial_obj
@@ -51,6 +163,12 @@ class EchoRecorder:
         # for sending data over UART and reconstructing to left and right channels
         self.channel_burst_len = channel_burst_len
         self.left_channel_first = left_channel_first
+
+        # persistent native connection, opened on the first listen()
+        self.native = None
+
+        # frame counters of the last listen()
+        self.stream_stats = None
     
     def check_status(self)->bool:
         if not self.teensy:
@@ -70,11 +188,13 @@ class EchoRecorder:
         return False
     
     def connect_Serial(self,serial:Serial):
+        self.native = None
         self.teensy = serial
         self.teensy.baudrate = 480e6
         self.teensy.timeout = 0.3
         
     def disconnect_serial(self):
+        self.native = None
         try:
             self.teensy.close()
         except:
@@ -110,6 +230,9 @@ class EchoRecorder:
         return LISTENER_SERIAL_CMD.ERROR
     
     def connection_status(self,print_:bool = False)->bool:
+        if self.native is not None:
+            return self.native.connection_status()
+
         if not self.teensy.is_open:
             if print_: print(f"{t_colors.FAIL}LISTENER NO SERIAL!{t_colors.ENDC}") 
             try:
@@ -141,8 +264,9 @@ class EchoRecorder:
         
     def listen(self, listen_time_ms:np.uint16)->tuple[np.uint16,np.uint16,np.uint16]:
         """Reads bytes from Teensy for given amount of listen time. This listen time
-         is calculated into number of bytes so deviation of time is not an issue. The raw_data
-         is interleaved between left and right ear for ease of demodulating at the end.
+         is calculated into number of frames so deviation of time is not an issue. The raw_data
+         is the framed stream as received. Lost or corrupted frames read as SONAR_GAP_FILL and
+         are counted in self.stream_stats.
 
         Args:
             listen_time_ms (np.uint16): time to listen for in ms
@@ -151,6 +275,9 @@ class EchoRecorder:
             tuple[np.uint16,np.uint16,np.uint16]: raw_data, left_ear, right_ear
         """
         
+        if echorecorder is not None and self.open_native():
+            return self.listen_native(listen_time_ms)
+        
         if not self.connection_status():
             print(f"EROR")
             return None
@@ -158,36 +285,213 @@ class EchoRecorder:
         
         listen_time_ms = listen_time_ms * 1e-3
         
-        # ms * 1MS * 2 ears
-        samples_to_read = int(listen_time_ms*self.sample_freq * 2)
-        read_times = int(samples_to_read/self.channel_burst_len)
+        # the listener sends whole frames of [ header ][ burst x first ear ][ burst x second ear ]
+        samples_per_ear = int(listen_time_ms*self.sample_freq)
+        read_times = -(-samples_per_ear//self.channel_burst_len)
 
             
         raw_bytes = bytearray()
         self.teensy.write([LISTENER_SERIAL_CMD.START_LISTEN.value])
+        no_trigger = bytes([LISTENER_SERIAL_CMD.ERROR.value])
         for i in range(read_times):
-            raw_bytes.extend(self.teensy.read(self.channel_burst_len*2))
+            raw_bytes.extend(self.teensy.read(SONAR_FRAME_HEADER.size + self.channel_burst_len*4))
+            if raw_bytes[:1] == no_trigger:
+                break
 
         self.teensy.write([LISTENER_SERIAL_CMD.STOP_LISTEN.value])
         self.teensy.flush()
         self.teensy.close()
         self.teensy.open()
         self.teensy.flush()
+
+        # the listener answers with ERROR instead of frames when the emitter never triggered
+        if raw_bytes[:1] == no_trigger:
+            print(f"EROR no chirp trigger from the emitter")
+            return None
         
-        raw_data = np.frombuffer(raw_bytes,dtype=np.uint16)
+        first, second, self.stream_stats = split_frames(bytes(raw_bytes), samples_per_ear, self.channel_burst_len)
+        self.report_stream_stats()
 
         if self.left_channel_first:
-            left_ear = raw_data[::2]
-            right_ear = raw_data[1::2]
+            left_ear = first
+            right_ear = second
         else:
-            left_ear = raw_data[1::2]
-            right_ear = raw_data[::2]
+            left_ear = second
+            right_ear = first
 
             
         return [raw_bytes,left_ear,right_ear]
 
-        
-        
-        
-        
-        
\ No newline at end of file
+    def capture(self, pre_ms:float, post_ms:float)->tuple[np.uint16,np.uint16]:
+        """Triggered capture. The Teensy records into its own ring buffer, starts the chirp
+        once the pre-trigger part is full and sends the window around the chirp trigger
+        afterwards, so a USB stall during the ping cannot drop echo data.
+
+        Args:
+            pre_ms (float): time to keep before the trigger in ms
+            post_ms (float): time to record from the trigger on in ms
+
+        Returns:
+            tuple[np.uint16,np.uint16]: left_ear, right_ear with the trigger at pre_ms, or None
+        """
+        pre = int(pre_ms*1e-3*SONAR_ADC_RATE)
+        post = int(post_ms*1e-3*SONAR_ADC_RATE)
+
+        if echorecorder is not None and self.open_native():
+            ears = self.native.capture(pre, post)
+            if ears is None:
+                print(f"EROR")
+                return None
+            self.stream_stats = self.native.stream_stats
+            self.report_stream_stats()
+            return ears
+
+        if not self.connection_status():
+            print(f"EROR")
+            return None
+
+        # nothing arrives until the window is recorded
+        self.teensy.timeout = 0.5 + (pre + post)/SONAR_ADC_RATE
+        self.teensy.write(bytes([LISTENER_SERIAL_CMD.CAPTURE.value]) + struct.pack('<II', pre, post))
+        head = self.teensy.read(SONAR_CAPTURE_HEADER.size)
+        self.teensy.timeout = 0.3
+
+        if len(head) < SONAR_CAPTURE_HEADER.size:
+            print(f"EROR {head}")
+            return None
+        magic, first_seq, num_frames, window_offset, pre_samples, post_samples, trigger_cycles, crc = SONAR_CAPTURE_HEADER.unpack(head)
+        if magic != SONAR_CAPTURE_MAGIC or zlib.crc32(head[:-4]) != crc:
+            print(f"EROR bad capture header")
+            return None
+
+        raw_bytes = self.teensy.read(num_frames*(SONAR_FRAME_HEADER.size + self.channel_burst_len*4))
+        first, second, self.stream_stats = split_frames(raw_bytes, window_offset + pre + post, self.channel_burst_len, first_seq)
+        if self.stream_stats['trigger_sample'] is not None:
+            self.stream_stats['trigger_sample'] -= window_offset
+        self.report_stream_stats()
+        first = first[window_offset:]
+        second = second[window_offset:]
+
+        if self.left_channel_first:
+            return first, second
+        return second, first
+
+    def listen_iq(self, listen_time_ms:float)->tuple[np.complex64,np.complex64]:
+        """Like listen(), but the Teensy filters each ear down to the echo band and sends
+        it as complex baseband decimated by SONAR_DDC_DECIMATION, a quarter of the raw
+        stream. The band centre sits at 0 Hz.
+
+        Args:
+            listen_time_ms (float): time to listen for in ms
+
+        Returns:
+            tuple[np.complex64,np.complex64]: left_ear, right_ear at SONAR_ADC_RATE/SONAR_DDC_DECIMATION
+            in ADC counts, or None
+        """
+        # each complex sample is an int16 I, Q pair
+        values_per_ear = 2*int(listen_time_ms*1e-3*SONAR_ADC_RATE/SONAR_DDC_DECIMATION)
+
+        if echorecorder is not None and self.open_native():
+            first = np.empty(values_per_ear, dtype=np.uint16)
+            second = np.empty(values_per_ear, dtype=np.uint16)
+            ok = self.native.set_baseband(True)
+            if ok:
+                ok = self.native.listen_into(first, second)
+                self.stream_stats = self.native.stream_stats
+            self.native.set_baseband(False)
+            if not ok:
+                print(f"EROR")
+                return None
+            if not self.left_channel_first:
+                first, second = second, first
+        else:
+            if not self.connection_status():
+                print(f"EROR")
+                return None
+
+            self.teensy.write([LISTENER_SERIAL_CMD.BASEBAND.value, 1])
+            if self.get_cmd() != LISTENER_SERIAL_CMD.ACK:
+                print(f"EROR no baseband")
+                return None
+
+            read_times = -(-values_per_ear//self.channel_burst_len)
+            self.teensy.write([LISTENER_SERIAL_CMD.START_LISTEN.value])
+            raw_bytes = self.teensy.read(read_times*(SONAR_FRAME_HEADER.size + self.channel_burst_len*4))
+            self.teensy.write([LISTENER_SERIAL_CMD.STOP_LISTEN.value])
+            self.teensy.flush()
+            self.teensy.close()
+            self.teensy.open()
+            self.teensy.write([LISTENER_SERIAL_CMD.BASEBAND.value, 0])
+            self.get_cmd()
+
+            first, second, self.stream_stats = split_frames(raw_bytes, values_per_ear, self.channel_burst_len, gap_fill=0)
+            if not self.left_channel_first:
+                first, second = second, first
+
+        self.report_stream_stats()
+        left_ear, right_ear = (ear.view(np.int16).astype(np.float32).view(np.complex64)/SONAR_DDC_GAIN for ear in (first, second))
+        return left_ear, right_ear
+
+    def open_native(self)->bool:
+        """Hands the port over to the native recorder, which keeps it open from then on.
+
+        Returns:
+            bool: True if the native recorder is connected
+        """
+        if self.native is not None:
+            return True
+
+        port = getattr(self.teensy, 'port', None)
+        if not port:
+            return False
+
+        if self.teensy.is_open:
+            self.teensy.close()
+
+        native = echorecorder.EchoRecorder(port, self.left_channel_first)
+        if not native.is_open:
+            return False
+
+        self.native = native
+        return True
+
+    def listen_native(self, listen_time_ms:np.uint16)->tuple[np.uint16,np.uint16,np.uint16]:
+        """listen() through the native recorder. The ears are split straight out of the
+        recorder's ring buffer; raw_data is rebuilt from them, without frame headers, for
+        callers that still use it.
+        """
+        samples_per_ear = int(listen_time_ms * 1e-3 * self.sample_freq)
+
+        # fresh arrays each ping since callers keep them around, the recorder writes straight into them
+        left_ear = np.empty(samples_per_ear, dtype=np.uint16)
+        right_ear = np.empty(samples_per_ear, dtype=np.uint16)
+
+        if not self.native.listen_into(left_ear, right_ear):
+            print(f"EROR")
+            return None
+
+        self.stream_stats = self.native.stream_stats
+        self.report_stream_stats()
+
+        # same block layout the listener sends, zero padded to a whole block
+        burst = self.channel_burst_len
+        num_blocks = -(-samples_per_ear//burst)
+        raw_data = np.zeros((num_blocks, 2, burst), dtype=np.uint16)
+        first, second = (left_ear, right_ear) if self.left_channel_first else (right_ear, left_ear)
+        for ear, data in ((0, first), (1, second)):
+            padded = np.zeros(num_blocks*burst, dtype=np.uint16)
+            padded[:samples_per_ear] = data
+            raw_data[:,ear,:] = padded.reshape(num_blocks, burst)
+
+        return [raw_data.tobytes(), left_ear, right_ear]
+
+    def report_stream_stats(self)->None:
+        """Warns if frames of the last listen() were lost, corrupted or misaligned"""
+        s = self.stream_stats
+        if s and (s['missed_frames'] or s['crc_errors'] or s['ear_mismatches']):
+            print(f"{t_colors.WARNING}LISTENER lost {s['missed_frames']} frames "
+                  f"({s['crc_errors']} CRC errors, {s['ear_mismatches']} ear mismatches, "
+                  f"{s['bytes_dropped']} bytes dropped){t_colors.ENDC}")
+        if s and s.get('unmatched_frames'):
+            print(f"{t_colors.WARNING}LISTENER {s['unmatched_frames']} frames without matching ear sample counts, "
+                  f"interaural timing is unreliable in those{t_colors.ENDC}")
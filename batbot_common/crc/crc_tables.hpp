@@ -0,0 +1,106 @@
+/**
+ * @file
+ * @brief Compile time lookup tables for table driven CRCs, shared by the firmware and the host
+ *
+ * A CRC is described by its register type, which sets the width, its generator polynomial
+ * and whether it is reflected (LSB first, polynomial given bit reversed, as zlib's
+ * 0xEDB88320) or not (MSB first). Slice table k holds, for every byte value, the CRC of
+ * that byte followed by k zero bytes, which is what slicing-by-N needs. Table 0 is the
+ * classic 256 entry table. The nibble table is the 16 entry table for two lookups per byte.
+ *
+ * The CRC loops themselves stay with their protocols, see tendon_crc16.hpp and
+ * sonar_frame.hpp. Written against C++11 so it also builds with the Arduino toolchains.
+ */
+#ifndef CRC_TABLES_HPP
+#define CRC_TABLES_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace crc_tables {
+
+template<typename T> constexpr int width()
+{
+  return (int)(sizeof(T) * 8);
+}
+
+/**
+ * @brief Shifts one bit out of the register, xoring in the polynomial if it was set
+ */
+template<typename T, T Poly, bool Reflected> constexpr T shiftBit(T crc)
+{
+  return Reflected ?
+    ((crc & 1) ? (T)((crc >> 1) ^ Poly) : (T)(crc >> 1)) :
+    (((crc >> (width<T>() - 1)) & 1) ? (T)((T)(crc << 1) ^ Poly) : (T)(crc << 1));
+}
+
+template<typename T, T Poly, bool Reflected> constexpr T shiftBits(T crc, int bits)
+{
+  return bits == 0 ? crc : shiftBits<T, Poly, Reflected>(shiftBit<T, Poly, Reflected>(crc), bits - 1);
+}
+
+/**
+ * @brief Entry i of slice table k: the CRC of byte i followed by k zero bytes
+ */
+template<typename T, T Poly, bool Reflected> constexpr T sliceEntry(size_t i, int k)
+{
+  return Reflected ?
+    (k == 0 ? shiftBits<T, Poly, Reflected>((T)i, 8) :
+      (T)((sliceEntry<T, Poly, Reflected>(i, k - 1) >> 8) ^
+          shiftBits<T, Poly, Reflected>((T)(sliceEntry<T, Poly, Reflected>(i, k - 1) & 0xFF), 8))) :
+    (k == 0 ? shiftBits<T, Poly, Reflected>((T)((T)i << (width<T>() - 8)), 8) :
+      (T)((T)(sliceEntry<T, Poly, Reflected>(i, k - 1) << 8) ^
+          shiftBits<T, Poly, Reflected>((T)(sliceEntry<T, Poly, Reflected>(i, k - 1) >> (width<T>() - 8) << (width<T>() - 8)), 8)));
+}
+
+/**
+ * @brief Entry i of the nibble table: the CRC of the 4 bits i
+ */
+template<typename T, T Poly, bool Reflected> constexpr T nibbleEntry(size_t i)
+{
+  return Reflected ? shiftBits<T, Poly, Reflected>((T)i, 4) :
+    shiftBits<T, Poly, Reflected>((T)((T)i << (width<T>() - 4)), 4);
+}
+
+template<size_t... I> struct IndexList {};
+template<size_t N, size_t... I> struct MakeIndexList : MakeIndexList<N - 1, N - 1, I...> {};
+template<size_t... I> struct MakeIndexList<0, I...> { typedef IndexList<I...> type; };
+
+template<typename T, T Poly, bool Reflected, int K, typename L> struct SliceTable;
+template<typename T, T Poly, bool Reflected, int K, size_t... I>
+struct SliceTable<T, Poly, Reflected, K, IndexList<I...> > {
+  static constexpr T table[sizeof...(I)] = { sliceEntry<T, Poly, Reflected>(I, K)... };
+};
+template<typename T, T Poly, bool Reflected, int K, size_t... I>
+constexpr T SliceTable<T, Poly, Reflected, K, IndexList<I...> >::table[sizeof...(I)];
+
+template<typename T, T Poly, bool Reflected, typename L> struct NibbleTable;
+template<typename T, T Poly, bool Reflected, size_t... I>
+struct NibbleTable<T, Poly, Reflected, IndexList<I...> > {
+  static constexpr T table[sizeof...(I)] = { nibbleEntry<T, Poly, Reflected>(I)... };
+};
+template<typename T, T Poly, bool Reflected, size_t... I>
+constexpr T NibbleTable<T, Poly, Reflected, IndexList<I...> >::table[sizeof...(I)];
+
+/**
+ * @brief The tables of one CRC, each generated only if it is used
+ *
+ * @tparam T the register type, uint16_t for a CRC-16, uint32_t for a CRC-32
+ * @tparam Poly the generator polynomial, bit reversed if Reflected
+ * @tparam Reflected true if the CRC runs LSB first
+ */
+template<typename T, T Poly, bool Reflected> struct CrcTables {
+  template<int K> static const T* slice()
+  {
+    return SliceTable<T, Poly, Reflected, K, MakeIndexList<256>::type>::table;
+  }
+
+  static const T* nibble()
+  {
+    return NibbleTable<T, Poly, Reflected, MakeIndexList<16>::type>::table;
+  }
+};
+
+} // namespace crc_tables
+
+#endif
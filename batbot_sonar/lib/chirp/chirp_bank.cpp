@@ -0,0 +1,108 @@
+#include "chirp_bank.hpp"
+
+static void dropSlot(ChirpBank* bank, int i)
+{
+  bank->slots[i].len = 0;
+  bank->slots[i].crc = 0;
+  if (bank->active == i)
+    bank->active = -1;
+}
+
+void chirpBankInit(ChirpBank* bank, uint32_t capacity)
+{
+  for (int i = 0; i < CHIRP_BANK_SLOTS; ++i) {
+    bank->slots[i].crc = 0;
+    bank->slots[i].offset = 0;
+    bank->slots[i].len = 0;
+    bank->slots[i].used = 0;
+    bank->slots[i].pinned = false;
+  }
+  bank->capacity = capacity;
+  bank->next = 0;
+  bank->active = -1;
+  bank->uses = 0;
+}
+
+int chirpBankAlloc(ChirpBank* bank, uint32_t len)
+{
+  // the chirp and its silent sample
+  uint32_t need = len + 1;
+  if (len == 0 || need > bank->capacity)
+    return -1;
+
+  // past any pinned slot in the way, each hop moves on or wraps once
+  uint32_t start = bank->next;
+  for (int hops = 0;; ++hops) {
+    if (need > bank->capacity - start)
+      start = 0;
+    int hit = -1;
+    for (int i = 0; i < CHIRP_BANK_SLOTS; ++i) {
+      const ChirpSlot& s = bank->slots[i];
+      if (s.pinned && s.offset < start + need && start < s.offset + s.len + 1)
+        hit = i;
+    }
+    if (hit < 0)
+      break;
+    if (hops > 2 * CHIRP_BANK_SLOTS)
+      return -1;
+    start = bank->slots[hit].offset + bank->slots[hit].len + 1;
+  }
+
+  // whatever it overwrites is gone
+  for (int i = 0; i < CHIRP_BANK_SLOTS; ++i) {
+    const ChirpSlot& s = bank->slots[i];
+    if (s.len && s.offset < start + need && start < s.offset + s.len + 1)
+      dropSlot(bank, i);
+  }
+
+  // a free slot, or the least recently used one
+  int pick = -1;
+  for (int i = 0; i < CHIRP_BANK_SLOTS; ++i) {
+    if (bank->slots[i].pinned)
+      continue;
+    if (!bank->slots[i].len) {
+      pick = i;
+      break;
+    }
+    if (pick < 0 || bank->slots[i].used < bank->slots[pick].used)
+      pick = i;
+  }
+  if (pick < 0)
+    return -1;
+  dropSlot(bank, pick);
+
+  bank->slots[pick].offset = start;
+  bank->next = start + need;
+  return pick;
+}
+
+void chirpBankCommit(ChirpBank* bank, int slot, uint32_t len, uint32_t crc)
+{
+  int old = chirpBankFind(bank, crc);
+  if (old >= 0 && old != slot && !bank->slots[old].pinned)
+    dropSlot(bank, old);
+
+  bank->slots[slot].crc = crc;
+  bank->slots[slot].len = len;
+  bank->slots[slot].used = ++bank->uses;
+  bank->active = slot;
+}
+
+int chirpBankFind(const ChirpBank* bank, uint32_t crc)
+{
+  for (int i = 0; i < CHIRP_BANK_SLOTS; ++i) {
+    if (bank->slots[i].len && bank->slots[i].crc == crc)
+      return i;
+  }
+  return -1;
+}
+
+int chirpBankSelect(ChirpBank* bank, uint32_t crc)
+{
+  int i = chirpBankFind(bank, crc);
+  if (i < 0)
+    return -1;
+  bank->slots[i].used = ++bank->uses;
+  bank->active = i;
+  return i;
+}
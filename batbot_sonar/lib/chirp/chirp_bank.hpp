@@ -0,0 +1,109 @@
+/**
+ * @file
+ * @brief Keeps several chirps in the emitter's DAC buffer at once, keyed by their CRC32
+ *
+ * Only the bookkeeping lives here: where each chirp sits in the buffer, which one plays,
+ * and which ones a new chirp pushes out. The firmware writes the samples and points the
+ * DMA at the active slot. It is shared with the host so it can be tested there.
+ *
+ * Chirps go into the buffer one after the other and wrap to its start when the next one
+ * does not fit, overwriting the oldest. Every chirp is followed by one silent sample, so
+ * the DAC rests at 0 once it has played, as it did after the zeroed tail of the single
+ * buffer. A slot is keyed by zlib.crc32 of its samples' little endian bytes, the same
+ * CRC the uploads are verified with, and no two slots share a key.
+ *
+ * The firmware pins the slot the DMA is playing and the one staged to replace it at the
+ * end of the emission. New chirps go around pinned slots, so an upload can go on while
+ * the DAC plays, and only fails when it can't fit beside them.
+ *
+ * Written against C++11 so it also builds with the Arduino toolchains.
+ */
+#ifndef CHIRP_BANK_HPP
+#define CHIRP_BANK_HPP
+
+#include <stdint.h>
+
+/**
+ * @brief Most chirps held at once
+ */
+#define CHIRP_BANK_SLOTS 8
+
+/**
+ * @brief Where a chirp sits in the buffer
+ */
+typedef struct {
+  uint32_t crc;
+  // first sample
+  uint32_t offset;
+  // samples of chirp, not counting the silent one after them. 0 when empty
+  uint32_t len;
+  // chirpBankCommit() or chirpBankSelect() count when it was last used
+  uint32_t used;
+  // not to be overwritten or dropped
+  bool pinned;
+} ChirpSlot;
+
+typedef struct {
+  ChirpSlot slots[CHIRP_BANK_SLOTS];
+  // samples in the buffer
+  uint32_t capacity;
+  // where the next chirp goes
+  uint32_t next;
+  // the slot that plays, -1 if none
+  int active;
+  uint32_t uses;
+} ChirpBank;
+
+/**
+ * @brief Empties the bank
+ *
+ * @param bank the bank
+ * @param capacity samples in the buffer, the longest chirp is one less
+ */
+void chirpBankInit(ChirpBank* bank, uint32_t capacity);
+
+/**
+ * @brief Makes room for a chirp
+ *
+ * The slots it overlaps are dropped, and so is the least recently used one if no slot
+ * is free. The new slot stays empty, so a failed upload leaves nothing behind, until
+ * chirpBankCommit(). Pinned slots are neither overlapped nor dropped.
+ *
+ * @param bank the bank
+ * @param len samples of the chirp
+ * @return int the slot, its offset is where the samples go, -1 if the chirp is too long
+ * or does not fit beside the pinned slots
+ */
+int chirpBankAlloc(ChirpBank* bank, uint32_t len);
+
+/**
+ * @brief Fills a slot from chirpBankAlloc() and makes it the active one
+ *
+ * An older slot with the same CRC is dropped, unless it is pinned.
+ *
+ * @param bank the bank
+ * @param slot the slot
+ * @param len samples of the chirp written at its offset, with a 0 after them
+ * @param crc CRC32 of the samples
+ */
+void chirpBankCommit(ChirpBank* bank, int slot, uint32_t len, uint32_t crc);
+
+/**
+ * @brief Looks a chirp up by its CRC
+ *
+ * @param bank the bank
+ * @param crc CRC32 of the samples
+ * @return int the slot, -1 if the chirp is not in the bank
+ */
+int chirpBankFind(const ChirpBank* bank, uint32_t crc);
+
+/**
+ * @brief Makes a chirp the active one
+ *
+ * @param bank the bank
+ * @param crc CRC32 of the samples
+ * @return int the slot, -1 if the chirp is not in the bank
+ */
+int chirpBankSelect(ChirpBank* bank, uint32_t crc);
+
+#endif
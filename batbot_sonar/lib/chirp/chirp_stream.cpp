@@ -0,0 +1,88 @@
+#include "chirp_stream.hpp"
+
+static int nextBlock(int block)
+{
+  return (block + 1) % CHIRP_STREAM_BLOCKS;
+}
+
+void chirpStreamInit(ChirpStream* stream, uint32_t total)
+{
+  for (int i = 0; i < CHIRP_STREAM_BLOCKS; ++i)
+    stream->full[i] = false;
+  stream->total = total;
+  stream->received = 0;
+  stream->queued = 0;
+  stream->write = 0;
+  stream->play = -1;
+  stream->last = -1;
+  stream->underruns = 0;
+  stream->done = false;
+}
+
+uint32_t chirpStreamBlockLen(const ChirpStream* stream)
+{
+  uint32_t left = stream->total - stream->received;
+  return left < CHIRP_STREAM_BLOCK_LEN ? left : CHIRP_STREAM_BLOCK_LEN;
+}
+
+int chirpStreamWriteBlock(ChirpStream* stream)
+{
+  if (stream->received >= stream->total)
+    return -1;
+
+  // the full blocks run from the one playing or after it up to before write. the DMA
+  // caught up if there are none, or only the one it plays, so the next one is too close.
+  // the samples go two blocks ahead of it
+  if (stream->play >= 0) {
+    if (stream->queued == 0 || stream->write == nextBlock(stream->play))
+      stream->write = nextBlock(nextBlock(stream->play));
+    else if (stream->write == stream->play)
+      return -1;
+  }
+  else if (stream->queued >= CHIRP_STREAM_BLOCKS - 2) {
+    return -1;
+  }
+
+  if (stream->full[stream->write])
+    return -1;
+  return stream->write;
+}
+
+void chirpStreamCommit(ChirpStream* stream, int block, uint32_t len)
+{
+  stream->full[block] = true;
+  ++stream->queued;
+  stream->received += len;
+  stream->write = nextBlock(block);
+  if (stream->received >= stream->total)
+    stream->last = block;
+}
+
+bool chirpStreamReady(const ChirpStream* stream)
+{
+  return stream->play < 0 && stream->queued > 0 &&
+         (stream->queued >= CHIRP_STREAM_BLOCKS - 2 || stream->last >= 0);
+}
+
+void chirpStreamStart(ChirpStream* stream)
+{
+  stream->play = 0;
+}
+
+int chirpStreamBlockDone(ChirpStream* stream)
+{
+  int block = stream->play;
+  if (stream->full[block]) {
+    stream->full[block] = false;
+    --stream->queued;
+  }
+  if (block == stream->last) {
+    stream->done = true;
+    return block;
+  }
+
+  stream->play = nextBlock(block);
+  if (!stream->full[stream->play])
+    ++stream->underruns;
+  return block;
+}
@@ -0,0 +1,116 @@
+/**
+ * @file
+ * @brief Plays a waveform longer than the emitter's DAC buffer as it streams in from the host
+ *
+ * The firmware keeps a ring of CHIRP_STREAM_BLOCKS linked DMA descriptors, each one over a
+ * block of samples, and the DMA goes round it without stopping. Only the bookkeeping lives
+ * here: which block the host's next samples go into, which one the DMA plays, and when it
+ * ran out. It is shared with the host so it can be tested there.
+ *
+ * A block the host has not filled yet plays silence. When the DMA reaches one, that is an
+ * underrun: it is counted, and the samples that were due there follow the silence instead
+ * of being dropped. The block the DMA plays and the one after it are never written, the
+ * DMA may already have fetched the next one's descriptor by the time the block interrupt
+ * runs. Playback starts once all but those two blocks are full, or the whole waveform is
+ * in, and stops after the block holding its last sample.
+ *
+ * Written against C++11 so it also builds with the Arduino toolchains.
+ */
+#ifndef CHIRP_STREAM_HPP
+#define CHIRP_STREAM_HPP
+
+#include <stdint.h>
+
+/**
+ * @brief Blocks in the ring
+ */
+#define CHIRP_STREAM_BLOCKS 8
+
+/**
+ * @brief Samples per block, one upload block of the host's
+ */
+#define CHIRP_STREAM_BLOCK_LEN 2048
+
+typedef struct {
+  // samples in the waveform
+  uint32_t total;
+  // samples the host has sent so far
+  uint32_t received;
+  // full blocks, the host's samples are in them and they have not played yet
+  bool full[CHIRP_STREAM_BLOCKS];
+  int queued;
+  // where the host's next samples go
+  int write;
+  // the block the DMA plays, -1 until it starts
+  int play;
+  // the block with the last sample, -1 until the host has sent it
+  int last;
+  // silent blocks the DMA played because the host was late
+  uint32_t underruns;
+  // the last block has played
+  bool done;
+} ChirpStream;
+
+/**
+ * @brief Empties the ring for a new waveform
+ *
+ * @param stream the stream
+ * @param total samples in the waveform
+ */
+void chirpStreamInit(ChirpStream* stream, uint32_t total);
+
+/**
+ * @brief How many samples the host sends next
+ *
+ * @param stream the stream
+ * @return uint32_t a block's worth, less for the last one, 0 once all are in
+ */
+uint32_t chirpStreamBlockLen(const ChirpStream* stream);
+
+/**
+ * @brief The block the host's next samples go into
+ *
+ * Skips ahead of the DMA if it has caught up with the host. Call it again once the
+ * samples are in, the DMA may have caught up meanwhile, and move them if the block changed.
+ *
+ * @param stream the stream
+ * @return int the block, -1 if the ring is full or all samples are in
+ */
+int chirpStreamWriteBlock(ChirpStream* stream);
+
+/**
+ * @brief Marks a block from chirpStreamWriteBlock() as full
+ *
+ * @param stream the stream
+ * @param block the block
+ * @param len samples in it, from chirpStreamBlockLen()
+ */
+void chirpStreamCommit(ChirpStream* stream, int block, uint32_t len);
+
+/**
+ * @brief Whether enough is buffered to start the DMA
+ *
+ * @param stream the stream
+ * @return bool true once all but two blocks are full or the last one is, until it starts
+ */
+bool chirpStreamReady(const ChirpStream* stream);
+
+/**
+ * @brief The DMA starts on block 0
+ *
+ * @param stream the stream
+ */
+void chirpStreamStart(ChirpStream* stream);
+
+/**
+ * @brief The DMA has played a block, from the block interrupt
+ *
+ * Moves on to the next block and counts an underrun if it is not full. The DMA no longer
+ * needs the block that played, it can be pointed at silence again.
+ *
+ * @param stream the stream
+ * @return int the block that played
+ */
+int chirpStreamBlockDone(ChirpStream* stream);
+
+#endif
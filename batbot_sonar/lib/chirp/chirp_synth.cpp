@@ -0,0 +1,211 @@
+#include <math.h>
+#include <string.h>
+
+#include "chirp_synth.hpp"
+
+#define TABLE_LEN (1 << CHIRP_SYNTH_TABLE_BITS)
+
+// cos(2 pi i / TABLE_LEN) in Q30, one extra entry so the interpolation never wraps
+static int32_t cos_table[TABLE_LEN + 1];
+static bool cos_table_ready = false;
+
+static void makeCosTable()
+{
+  const double pi = 3.14159265358979323846;
+  for (int i = 0; i <= TABLE_LEN; ++i)
+    cos_table[i] = (int32_t)lround(cos(2 * pi * i / TABLE_LEN) * (1 << 30));
+  cos_table_ready = true;
+}
+
+/**
+ * @brief cos(2 pi phase) in Q30, phase a 64 bit fraction of a turn
+ */
+static inline int32_t cosQ30(uint64_t phase)
+{
+  uint32_t i = (uint32_t)(phase >> (64 - CHIRP_SYNTH_TABLE_BITS));
+  int32_t frac = (int32_t)((phase >> (64 - CHIRP_SYNTH_TABLE_BITS - 16)) & 0xFFFF);
+  int32_t a = cos_table[i];
+  return a + (int32_t)(((int64_t)(cos_table[i + 1] - a) * frac) >> 16);
+}
+
+/**
+ * @brief Turns as a 64 bit fraction, wrapped. Negative values wrap the other way, so
+ * adding the result steps the phase back.
+ */
+static uint64_t turnsQ64(double x)
+{
+  bool negative = x < 0;
+  if (negative)
+    x = -x;
+  x -= floor(x);
+  double hi = floor(ldexp(x, 32));
+  double lo = ldexp(ldexp(x, 32) - hi, 32);
+  uint64_t q = ((uint64_t)hi << 32) + (uint64_t)lo;
+  return negative ? (uint64_t)0 - q : q;
+}
+
+/**
+ * @brief Phase in turns, frequency and its first two derivatives of a sweep at time t,
+ * following scipy.signal.chirp with vertex_zero
+ */
+typedef struct {
+  double phase;
+  double f;
+  double df;
+  double ddf;
+} sweep_point_t;
+
+static void sweepAt(const ChirpParams* params, double t1, double t, sweep_point_t* s)
+{
+  double f0 = params->f0;
+  double f1 = params->f1;
+  s->phase = f0 * t;
+  s->f = f0;
+  s->df = 0;
+  s->ddf = 0;
+
+  switch (params->method) {
+    case CHIRP_METHOD_LINEAR:
+    {
+      double beta = (f1 - f0) / t1;
+      s->phase = f0 * t + 0.5 * beta * t * t;
+      s->f = f0 + beta * t;
+      s->df = beta;
+    }
+    break;
+    case CHIRP_METHOD_QUADRATIC:
+    {
+      double beta = (f1 - f0) / (t1 * t1);
+      s->phase = f0 * t + beta * t * t * t / 3;
+      s->f = f0 + beta * t * t;
+      s->df = 2 * beta * t;
+      s->ddf = 2 * beta;
+    }
+    break;
+    case CHIRP_METHOD_LOGARITHMIC:
+      if (f0 != f1) {
+        double k = log(f1 / f0) / t1;
+        double r = pow(f1 / f0, t / t1);
+        s->phase = f0 / k * (r - 1.0);
+        s->f = f0 * r;
+        s->df = s->f * k;
+        s->ddf = s->df * k;
+      }
+      break;
+    case CHIRP_METHOD_HYPERBOLIC:
+      if (f0 != f1) {
+        double sing = -f1 * t1 / (f0 - f1);
+        double u = 1 - t / sing;
+        s->phase = -sing * f0 * log(fabs(u));
+        s->f = f0 / u;
+        s->df = s->f / (sing * u);
+        s->ddf = 2 * s->df / (sing * u);
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+/**
+ * @brief Window in Q30 at phase n / (N - 1) of a turn
+ */
+static inline int32_t windowQ30(uint8_t window, uint64_t phase)
+{
+  switch (window) {
+    case CHIRP_WINDOW_HANN:
+      return (1 << 29) - (cosQ30(phase) >> 1);
+    case CHIRP_WINDOW_HAMMING:
+      return 579820585 - (int32_t)(((int64_t)cosQ30(phase) * 493921239) >> 30);
+    case CHIRP_WINDOW_BLACKMAN:
+      return 450971566 - (cosQ30(phase) >> 1) + (int32_t)(((int64_t)cosQ30(phase << 1) * 85899346) >> 30);
+    default:
+      return 1 << 30;
+  }
+}
+
+int chirpSynthLength(const ChirpParams* params, uint32_t maxLen)
+{
+  // one sample per microsecond
+  uint32_t n = params->duration_us;
+  double f0 = params->f0;
+  double f1 = params->f1;
+  double nyquist = CHIRP_SYNTH_RATE / 2.0;
+
+  if (n == 0 || n > maxLen)
+    return -1;
+  if (!(fabs(f0) < nyquist) || !(fabs(f1) < nyquist))
+    return -1;
+  if (params->method > CHIRP_METHOD_HYPERBOLIC || params->window > CHIRP_WINDOW_BLACKMAN)
+    return -1;
+  if (params->method == CHIRP_METHOD_LOGARITHMIC && !(f0 * f1 > 0))
+    return -1;
+  if (params->method == CHIRP_METHOD_HYPERBOLIC && (f0 == 0 || f1 == 0))
+    return -1;
+  if (!(params->gain >= 0) || !(params->offset >= 0) || !(params->offset + params->gain < 65536))
+    return -1;
+  return (int)n;
+}
+
+int chirpSynth(const ChirpParams* params, uint16_t* out, uint32_t maxLen)
+{
+  int len = chirpSynthLength(params, maxLen);
+  if (len < 0)
+    return -1;
+  if (!cos_table_ready)
+    makeCosTable();
+
+  const uint32_t n = (uint32_t)len;
+  const double h = 1.0 / CHIRP_SYNTH_RATE;
+  const double t1 = n * h;
+  int16_t* q15 = (int16_t*)out;
+
+  // polynomial sweeps are exact cubics, the others drift from theirs
+  bool exact = params->method == CHIRP_METHOD_LINEAR || params->method == CHIRP_METHOD_QUADRATIC;
+  uint32_t segment = exact ? n : CHIRP_SYNTH_SEGMENT;
+
+  uint64_t window_phase = 0;
+  uint64_t window_step = n > 1 ? turnsQ64(1.0 / (n - 1)) : 0;
+
+  // pass 1: the windowed sweep in Q15, and its range
+  int32_t lo = INT16_MAX;
+  int32_t hi = INT16_MIN;
+  for (uint32_t start = 0; start < n; start += segment) {
+    sweep_point_t s;
+    sweepAt(params, t1, start * h, &s);
+
+    // forward differences of the cubic through the phase and its derivatives here
+    uint64_t phase = turnsQ64(s.phase);
+    uint64_t d1 = turnsQ64(s.f * h + s.df * h * h / 2 + s.ddf * h * h * h / 6);
+    uint64_t d2 = turnsQ64(s.df * h * h + s.ddf * h * h * h);
+    uint64_t d3 = turnsQ64(s.ddf * h * h * h);
+
+    uint32_t end = n - start > segment ? start + segment : n;
+    for (uint32_t k = start; k < end; ++k) {
+      int32_t v = cosQ30(phase);
+      if (params->window != CHIRP_WINDOW_NONE && n > 1)
+        v = (int32_t)(((int64_t)v * windowQ30(params->window, window_phase)) >> 30);
+
+      int32_t q = (v + (1 << 14)) >> 15;
+      if (q > INT16_MAX)
+        q = INT16_MAX;
+      q15[k] = (int16_t)q;
+      if (q < lo)
+        lo = q;
+      if (q > hi)
+        hi = q;
+
+      phase += d1;
+      d1 += d2;
+      d2 += d3;
+      window_phase += window_step;
+    }
+  }
+
+  // pass 2: stretched over offset to offset + gain and truncated, as gen_chirp does
+  float scale = hi > lo ? params->gain / (float)(hi - lo) : 0.0f;
+  for (uint32_t k = 0; k < n; ++k)
+    out[k] = (uint16_t)(params->offset + (float)(q15[k] - lo) * scale);
+
+  return len;
+}
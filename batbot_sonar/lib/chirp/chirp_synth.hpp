@@ -0,0 +1,98 @@
+/**
+ * @file
+ * @brief Synthesizes the emitter's chirps from their parameters, shared by the firmware and the host
+ *
+ * Produces the same DAC samples as EchoEmitter.gen_chirp on the host, scipy.signal.chirp
+ * optionally windowed and stretched over offset to offset + gain, to within 1 LSB. The
+ * host then only sends a few bytes of parameters instead of the whole waveform.
+ *
+ * The phase is a 64 bit fraction of a turn stepped with third order forward differences,
+ * so the linear and quadratic sweeps are exact cubics. The logarithmic and hyperbolic
+ * sweeps are re-anchored to the exact phase every CHIRP_SYNTH_SEGMENT samples with
+ * differences taken from the sweep's derivatives there. The cosine and the window both
+ * come from one linearly interpolated Q30 cosine table.
+ *
+ * Like gen_chirp, the windowed sweep is first normalised by its own minimum and maximum,
+ * so it is made in two passes over the output: int16 samples first, then the scaling to
+ * DAC counts in place.
+ *
+ * Written against C++11 so it also builds with the Arduino toolchains.
+ */
+#ifndef CHIRP_SYNTH_HPP
+#define CHIRP_SYNTH_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief DAC sample rate the chirps are made for
+ */
+#define CHIRP_SYNTH_RATE 1000000
+
+/**
+ * @brief Samples between re-anchoring the phase of logarithmic and hyperbolic sweeps
+ */
+#define CHIRP_SYNTH_SEGMENT 32
+
+/**
+ * @brief log2 of the cosine table length
+ */
+#define CHIRP_SYNTH_TABLE_BITS 10
+
+typedef enum {
+  CHIRP_METHOD_LINEAR = 0,
+  CHIRP_METHOD_QUADRATIC = 1,
+  CHIRP_METHOD_LOGARITHMIC = 2,
+  CHIRP_METHOD_HYPERBOLIC = 3
+} chirp_method_t;
+
+/**
+ * @brief Symmetric windows, as numpy.hanning, hamming and blackman
+ */
+typedef enum {
+  CHIRP_WINDOW_NONE = 0,
+  CHIRP_WINDOW_HANN = 1,
+  CHIRP_WINDOW_HAMMING = 2,
+  CHIRP_WINDOW_BLACKMAN = 3
+} chirp_window_t;
+
+/**
+ * @brief Parameters of a chirp as they go over the wire, little endian
+ */
+typedef struct {
+  double f0;
+  double f1;
+  // length in samples at CHIRP_SYNTH_RATE, t1 of scipy.signal.chirp
+  uint32_t duration_us;
+  uint8_t method;
+  uint8_t window;
+  uint16_t reserved;
+  // EchoEmitter.SIG_GAIN and SIG_OFFSET
+  float gain;
+  float offset;
+} ChirpParams;
+
+static_assert(sizeof(ChirpParams) == 32, "chirp parameter layout");
+
+/**
+ * @brief Checks a set of parameters
+ *
+ * @param params the chirp
+ * @param maxLen the longest chirp the caller can hold
+ * @return int the length in samples, -1 if the parameters are not a valid chirp: a
+ * frequency at or above Nyquist, a logarithmic sweep through 0 Hz, a hyperbolic one
+ * from or to 0 Hz, an unknown method or window, or a range outside 16 bits
+ */
+int chirpSynthLength(const ChirpParams* params, uint32_t maxLen);
+
+/**
+ * @brief Synthesizes a chirp
+ *
+ * @param params the chirp
+ * @param out filled with chirpSynthLength() DAC samples
+ * @param maxLen the length of out
+ * @return int the number of samples written, -1 if the parameters are not valid
+ */
+int chirpSynth(const ChirpParams* params, uint16_t* out, uint32_t maxLen);
+
+#endif
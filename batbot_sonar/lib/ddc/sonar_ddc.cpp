@@ -0,0 +1,117 @@
+#include <math.h>
+#include <string.h>
+
+#include "sonar_ddc.hpp"
+
+static uint32_t gcd(uint32_t a, uint32_t b)
+{
+  while (b != 0) {
+    uint32_t t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+int SonarDDC::init(uint32_t fs_hz)
+{
+  // the rotation advances by CENTER * DECIMATION / fs turns per output
+  uint32_t step = SONAR_DDC_CENTER_HZ * SONAR_DDC_DECIMATION;
+  _period = fs_hz / gcd(step, fs_hz);
+  if (_period > SONAR_DDC_MAX_PERIOD)
+    return -1;
+
+  // Hamming windowed sinc low pass with unity gain at DC, modulated up to the centre
+  const double pi = 3.14159265358979323846;
+  const double fc = (double)SONAR_DDC_CUTOFF_HZ / fs_hz;
+  const double w = 2 * pi * SONAR_DDC_CENTER_HZ / fs_hz;
+  double h[SONAR_DDC_TAPS];
+  double sum = 0;
+  for (int k = 0; k < SONAR_DDC_TAPS; ++k) {
+    double t = k - (SONAR_DDC_TAPS - 1) / 2.0;
+    double sinc = t == 0 ? 2 * fc : sin(2 * pi * fc * t) / (pi * t);
+    h[k] = sinc * (0.54 - 0.46 * cos(2 * pi * k / (SONAR_DDC_TAPS - 1)));
+    sum += h[k];
+  }
+  for (int k = 0; k < SONAR_DDC_TAPS; ++k) {
+    _tapsI[k] = (float)(h[k] / sum * cos(w * k));
+    _tapsQ[k] = (float)(h[k] / sum * sin(w * k));
+  }
+
+  // like arm_fir_decimate_f32, output m is taken at input index m * DECIMATION + DECIMATION - 1,
+  // the newest of the samples it decimates
+  for (uint32_t m = 0; m < _period; ++m) {
+    double phase = w * (m * SONAR_DDC_DECIMATION + SONAR_DDC_DECIMATION - 1);
+    _rotI[m] = (float)cos(phase);
+    _rotQ[m] = (float)-sin(phase);
+  }
+
+#ifdef SONAR_DDC_CMSIS
+  for (int k = 0; k < SONAR_DDC_TAPS; ++k) {
+    _revI[k] = _tapsI[SONAR_DDC_TAPS - 1 - k];
+    _revQ[k] = _tapsQ[SONAR_DDC_TAPS - 1 - k];
+  }
+  if (arm_fir_decimate_init_f32(&_firI, SONAR_DDC_TAPS, SONAR_DDC_DECIMATION, _revI, _stateI, SONAR_DDC_MAX_BLOCK) != ARM_MATH_SUCCESS ||
+      arm_fir_decimate_init_f32(&_firQ, SONAR_DDC_TAPS, SONAR_DDC_DECIMATION, _revQ, _stateQ, SONAR_DDC_MAX_BLOCK) != ARM_MATH_SUCCESS)
+    return -1;
+#endif
+
+  reset();
+  return 0;
+}
+
+void SonarDDC::reset()
+{
+  _phase = 0;
+#ifdef SONAR_DDC_CMSIS
+  memset(_stateI, 0, sizeof(_stateI));
+  memset(_stateQ, 0, sizeof(_stateQ));
+#else
+  memset(_history, 0, sizeof(_history));
+#endif
+}
+
+size_t SonarDDC::process(const uint16_t* in, size_t n, int16_t* iq)
+{
+  size_t outputs = n / SONAR_DDC_DECIMATION;
+
+#ifdef SONAR_DDC_CMSIS
+  for (size_t i = 0; i < n; ++i)
+    _block[i] = (float)in[i] - SONAR_DDC_MIDSCALE;
+  arm_fir_decimate_f32(&_firI, _block, _outI, n);
+  arm_fir_decimate_f32(&_firQ, _block, _outQ, n);
+#else
+  float* x = _history + SONAR_DDC_TAPS - 1;
+  for (size_t i = 0; i < n; ++i)
+    x[i] = (float)in[i] - SONAR_DDC_MIDSCALE;
+
+  // only the outputs that survive decimation are computed, newest sample times taps[0]
+  for (size_t m = 0; m < outputs; ++m) {
+    const float* newest = x + m * SONAR_DDC_DECIMATION + SONAR_DDC_DECIMATION - 1;
+    float accI = 0, accQ = 0;
+    for (int k = 0; k < SONAR_DDC_TAPS; ++k) {
+      accI += _tapsI[k] * newest[-k];
+      accQ += _tapsQ[k] * newest[-k];
+    }
+    _outI[m] = accI;
+    _outQ[m] = accQ;
+  }
+
+  memmove(_history, _history + n, (SONAR_DDC_TAPS - 1) * sizeof(float));
+#endif
+
+  // shift the band down to 0 Hz and scale to int16
+  for (size_t m = 0; m < outputs; ++m) {
+    float re = _outI[m] * _rotI[_phase] - _outQ[m] * _rotQ[_phase];
+    float im = _outI[m] * _rotQ[_phase] + _outQ[m] * _rotI[_phase];
+    if (++_phase == _period)
+      _phase = 0;
+
+    float v[2] = {re * SONAR_DDC_GAIN, im * SONAR_DDC_GAIN};
+    for (int c = 0; c < 2; ++c) {
+      float r = v[c] < 0 ? v[c] - 0.5f : v[c] + 0.5f;
+      iq[2 * m + c] = r > 32767 ? 32767 : r < -32768 ? -32768 : (int16_t)r;
+    }
+  }
+  return outputs;
+}
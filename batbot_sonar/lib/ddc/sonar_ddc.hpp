@@ -0,0 +1,136 @@
+/**
+ * @file
+ * @brief Bandpass decimation of one ear to complex baseband, shared by the firmware and the host
+ *
+ * The useful echo band is 30 to 100 kHz, a sliver of what the 2 MS/s ADCs capture. This
+ * stage shifts that band to 0 Hz and decimates by SONAR_DDC_DECIMATION, turning each ear
+ * into complex I/Q at 250 kS/s: a quarter of the values, so the stream shrinks 4x.
+ *
+ * Instead of mixing every input sample down and then low pass filtering, the low pass
+ * taps are modulated up to the band centre, b[k] = h[k] e^{jwk}, and only every
+ * SONAR_DDC_DECIMATION-th output of that complex bandpass is computed (the polyphase
+ * form of the decimating filter). The mix then only happens at the output rate, where
+ * the phase of e^{-jwn} repeats every few outputs and comes from a table.
+ *
+ * On the Teensy the two real halves of the bandpass run through CMSIS-DSP's
+ * arm_fir_decimate_f32. Everywhere else a plain C++ loop computes the same sums, which is
+ * what the host tests check against golden vectors. The two agree to within rounding of
+ * the int16 output.
+ *
+ * Written against C++11 so it also builds with the Arduino toolchains.
+ */
+#ifndef SONAR_DDC_HPP
+#define SONAR_DDC_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__IMXRT1062__)
+#include <arm_math.h>
+#define SONAR_DDC_CMSIS
+#endif
+
+/**
+ * @brief Input samples per output
+ */
+#define SONAR_DDC_DECIMATION 8
+
+/**
+ * @brief Length of the bandpass
+ */
+#define SONAR_DDC_TAPS 128
+
+/**
+ * @brief Centre of the echo band, shifted to 0 Hz
+ */
+#define SONAR_DDC_CENTER_HZ 65000
+
+/**
+ * @brief Cutoff of the low pass the bandpass is made from, the band is +-35 kHz around the centre
+ */
+#define SONAR_DDC_CUTOFF_HZ 40000
+
+/**
+ * @brief Subtracted from the 10 bit ADC samples before filtering
+ */
+#define SONAR_DDC_MIDSCALE 512
+
+/**
+ * @brief Output scale, a full scale tone in the band comes out at about half of int16
+ */
+#define SONAR_DDC_GAIN 32.0f
+
+/**
+ * @brief Largest block process() takes in one call, one DMA buffer
+ */
+#define SONAR_DDC_MAX_BLOCK 1016
+
+/**
+ * @brief Longest period of the output rotation, in outputs
+ */
+#define SONAR_DDC_MAX_PERIOD 256
+
+class SonarDDC {
+
+public:
+  /**
+   * @brief Designs the filter for a sampling rate and clears the history
+   *
+   * @param fs_hz the ADC sampling rate
+   * @return int 0 on success, -1 if the output rotation does not repeat within
+   * SONAR_DDC_MAX_PERIOD outputs at this rate
+   */
+  int init(uint32_t fs_hz);
+
+  /**
+   * @brief Clears the filter history and restarts the output rotation
+   */
+  void reset();
+
+  /**
+   * @brief Filters and decimates a block of one ear
+   *
+   * @param in n raw ADC samples
+   * @param n a multiple of SONAR_DDC_DECIMATION, at most SONAR_DDC_MAX_BLOCK
+   * @param iq filled with n / SONAR_DDC_DECIMATION I, Q pairs
+   * @return size_t the number of I, Q pairs written
+   *
+   * Blocks are continuous: the history carries over from one call to the next.
+   */
+  size_t process(const uint16_t* in, size_t n, int16_t* iq);
+
+  /**
+   * @brief The real and imaginary halves of the bandpass, b[k] = tapsI[k] + j tapsQ[k]
+   */
+  const float* tapsI() const { return _tapsI; }
+  const float* tapsQ() const { return _tapsQ; }
+
+private:
+  float _tapsI[SONAR_DDC_TAPS];
+  float _tapsQ[SONAR_DDC_TAPS];
+
+  // e^{-jwn} at the input index of each output, over one period
+  float _rotI[SONAR_DDC_MAX_PERIOD];
+  float _rotQ[SONAR_DDC_MAX_PERIOD];
+  uint32_t _period;
+  uint32_t _phase;
+
+  float _block[SONAR_DDC_MAX_BLOCK];
+  float _outI[SONAR_DDC_MAX_BLOCK / SONAR_DDC_DECIMATION];
+  float _outQ[SONAR_DDC_MAX_BLOCK / SONAR_DDC_DECIMATION];
+
+#ifdef SONAR_DDC_CMSIS
+  // CMSIS wants the taps time reversed
+  float _revI[SONAR_DDC_TAPS];
+  float _revQ[SONAR_DDC_TAPS];
+  float _stateI[SONAR_DDC_TAPS - 1 + SONAR_DDC_MAX_BLOCK];
+  float _stateQ[SONAR_DDC_TAPS - 1 + SONAR_DDC_MAX_BLOCK];
+  arm_fir_decimate_instance_f32 _firI;
+  arm_fir_decimate_instance_f32 _firQ;
+#else
+  // the last SONAR_DDC_TAPS - 1 inputs, then the block being filtered
+  float _history[SONAR_DDC_TAPS - 1 + SONAR_DDC_MAX_BLOCK];
+#endif
+};
+
+#endif
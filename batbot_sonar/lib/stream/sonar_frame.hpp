@@ -0,0 +1,254 @@
+/**
+ * @file
+ * @brief Framing of the listener sample stream, shared by the firmware and the host
+ *
+ * Every DMA block goes out as one frame:
+ *
+ *   [ 32 byte header ][ SONAR_FRAME_SAMPLES x ADC 0 ][ SONAR_FRAME_SAMPLES x ADC 1 ]
+ *
+ * all little endian, 4096 bytes in total so a frame is exactly 8 high speed USB packets.
+ * The header costs 32 of those bytes, 0.8% of the stream.
+ *
+ * The sequence numbers count DMA blocks since START_LISTEN, including blocks the
+ * firmware had to skip, so the host can tell a lost block from a late one and keep the
+ * time base. The CRC is the zlib CRC-32 (reflected 0xEDB88320, init and final xor
+ * 0xFFFFFFFF) over the header up to the crc field and then the samples, so
+ * zlib.crc32() checks a frame in Python.
+ *
+ * A frame can instead carry its ears packed, see sonar_pack.hpp. It is then shorter:
+ * the header gives the payload length, and the CRC covers the packed bytes.
+ *
+ * A triggered capture is sent as a SonarCaptureHeader and then the frames holding the
+ * capture window, oldest first, exactly as they were stored.
+ *
+ * The frame the chirp trigger fell in is flagged with the trigger's sample offset, read
+ * from the ADC 0 DMA address at the trigger, so the host can place the trigger to the
+ * sample in a plain stream as well as in a capture.
+ *
+ * Written against C++11 so it also builds with the Arduino toolchains.
+ */
+#ifndef SONAR_FRAME_HPP
+#define SONAR_FRAME_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "crc_tables.hpp"
+
+/**
+ * @brief "BBSF" as it appears on the wire
+ */
+#define SONAR_FRAME_MAGIC 0x46534242u
+
+/**
+ * @brief Header layout version
+ */
+#define SONAR_FRAME_VERSION 1
+
+/**
+ * @brief Samples per ear in each frame, the firmware's DMA buffer size
+ */
+#define SONAR_FRAME_SAMPLES 1016
+
+#define SONAR_FRAME_HEADER_BYTES 32
+#define SONAR_FRAME_PAYLOAD_BYTES (SONAR_FRAME_SAMPLES * 2 * 2)
+#define SONAR_FRAME_BYTES (SONAR_FRAME_HEADER_BYTES + SONAR_FRAME_PAYLOAD_BYTES)
+
+/**
+ * @brief The frame header
+ */
+typedef struct
+{
+  uint32_t magic;     // SONAR_FRAME_MAGIC
+  uint32_t seq;       // ADC 0 DMA blocks completed since START_LISTEN, minus one
+  uint32_t seq_adc1;  // the same for ADC 1, differs from seq if the ears came from different blocks
+  uint32_t cycles;    // ARM_DWT_CYCCNT when the block was picked up
+  uint32_t micros;    // micros() when the block was picked up
+  uint16_t count;     // samples per ear, SONAR_FRAME_SAMPLES
+  uint16_t version;   // SONAR_FRAME_VERSION
+  uint16_t flags;     // SONAR_FRAME_FLAG_*
+  uint16_t payload;   // bytes after the header when packed, 0 for plain 16 bit ears
+  uint32_t crc;       // CRC-32 of the 28 bytes above and the samples
+} SonarFrameHeader;
+
+static_assert(sizeof(SonarFrameHeader) == SONAR_FRAME_HEADER_BYTES, "sonar frame header must be 32 bytes");
+
+/**
+ * @brief The samples are complex baseband: each ear is count int16 values, I and Q
+ * interleaved, instead of count raw ADC samples. Such a frame holds
+ * SONAR_DDC_DECIMATION / 2 DMA blocks and seq counts frames, not blocks.
+ */
+#define SONAR_FRAME_FLAG_IQ 0x1
+
+/**
+ * @brief Each ear is count samples of 10 bits, 4 samples in 5 bytes
+ */
+#define SONAR_FRAME_FLAG_PACK10 0x2
+
+/**
+ * @brief Each ear is delta and variable length coded, see sonarDeltaEncode()
+ */
+#define SONAR_FRAME_FLAG_DELTA 0x4
+
+/**
+ * @brief Both ADCs were started off one timer, and when the block was picked up both
+ * DMA streams had written the same number of samples into it
+ *
+ * This is a count check, not a timing measurement: it catches an ear that lost or gained
+ * a transfer, but the trigger routing that puts both conversions on the same timer edge
+ * is only set up once at start and is not read back for each block. Nothing measures
+ * the skew between the ears.
+ */
+#define SONAR_FRAME_FLAG_SAME_COUNT 0x8
+
+/**
+ * @brief The chirp trigger fell in this frame, at the sample given by the top bits of
+ * the flags, see sonarFrameTriggerOffset()
+ */
+#define SONAR_FRAME_FLAG_TRIGGER 0x10
+
+/**
+ * @brief The trigger's sample offset into the frame sits in flags bits 6 to 15
+ */
+#define SONAR_FRAME_TRIGGER_SHIFT 6
+
+/**
+ * @brief Number of header bytes covered by the CRC
+ */
+#define SONAR_FRAME_CRC_OFFSET 28
+
+/**
+ * @brief "BBSC" as it appears on the wire
+ */
+#define SONAR_CAPTURE_MAGIC 0x43534242u
+
+/**
+ * @brief Sent ahead of the frames of a triggered capture
+ *
+ * The window is pre_samples before the trigger and post_samples from it, starting
+ * window_offset samples into the first frame. The trigger is sample pre_samples of the
+ * window.
+ */
+typedef struct
+{
+  uint32_t magic;           // SONAR_CAPTURE_MAGIC
+  uint32_t first_seq;       // sequence number of the first frame that follows
+  uint32_t num_frames;      // number of frames that follow
+  uint32_t window_offset;   // samples per ear into the first frame where the window starts
+  uint32_t pre_samples;
+  uint32_t post_samples;
+  uint32_t trigger_cycles;  // ARM_DWT_CYCCNT when the trigger was seen
+  uint32_t crc;             // CRC-32 of the 28 bytes above
+} SonarCaptureHeader;
+
+static_assert(sizeof(SonarCaptureHeader) == 32, "sonar capture header must be 32 bytes");
+
+namespace sonar_crc32_detail {
+
+// zlib's polynomial, bit reversed
+typedef crc_tables::CrcTables<uint32_t, 0xEDB88320u, true> Tables;
+
+template<int K> inline const uint32_t* slice() { return Tables::slice<K>(); }
+
+} // namespace sonar_crc32_detail
+
+/**
+ * @brief Continues a CRC-32 over more data, slicing-by-8
+ *
+ * @param crc the CRC so far, 0 to start
+ * @param data the data to add
+ * @param len the number of bytes
+ * @return uint32_t the CRC including data
+ */
+inline uint32_t sonarCRC32(uint32_t crc, const uint8_t* data, size_t len)
+{
+  using sonar_crc32_detail::slice;
+  const uint32_t* t0 = slice<0>();
+  const uint32_t* t1 = slice<1>();
+  const uint32_t* t2 = slice<2>();
+  const uint32_t* t3 = slice<3>();
+  const uint32_t* t4 = slice<4>();
+  const uint32_t* t5 = slice<5>();
+  const uint32_t* t6 = slice<6>();
+  const uint32_t* t7 = slice<7>();
+
+  crc = ~crc;
+  for (; len >= 8; len -= 8, data += 8)
+  {
+    uint32_t lo = crc ^ ((uint32_t)data[0] | (uint32_t)data[1] << 8 | (uint32_t)data[2] << 16 | (uint32_t)data[3] << 24);
+    crc = t7[lo & 0xFF] ^ t6[(lo >> 8) & 0xFF] ^ t5[(lo >> 16) & 0xFF] ^ t4[lo >> 24] ^
+          t3[data[4]] ^ t2[data[5]] ^ t1[data[6]] ^ t0[data[7]];
+  }
+  for (; len > 0; --len, ++data)
+  {
+    crc = (crc >> 8) ^ t0[(crc ^ *data) & 0xFF];
+  }
+  return ~crc;
+}
+
+/**
+ * @brief CRC of a frame whose header and two ears may sit in separate buffers
+ *
+ * @param header the header, crc is not read
+ * @param first the ADC 0 samples
+ * @param second the ADC 1 samples
+ * @return uint32_t the value for header->crc
+ */
+inline uint32_t sonarFrameCRC(const SonarFrameHeader* header, const void* first, const void* second)
+{
+  uint32_t crc = sonarCRC32(0, (const uint8_t*)header, SONAR_FRAME_CRC_OFFSET);
+  crc = sonarCRC32(crc, (const uint8_t*)first, header->count * 2);
+  return sonarCRC32(crc, (const uint8_t*)second, header->count * 2);
+}
+
+/**
+ * @brief Flags marking the trigger at sample offset of a frame, offset below 1024
+ */
+inline uint16_t sonarFrameTriggerFlags(uint32_t offset)
+{
+  return (uint16_t)(SONAR_FRAME_FLAG_TRIGGER | offset << SONAR_FRAME_TRIGGER_SHIFT);
+}
+
+/**
+ * @brief Sample offset of the chirp trigger into a frame, -1 if it is not in this frame
+ *
+ * Counted in the frame's own samples, so for a baseband frame in int16 values, two per
+ * I/Q pair.
+ */
+inline int sonarFrameTriggerOffset(const SonarFrameHeader* header)
+{
+  if ((header->flags & SONAR_FRAME_FLAG_TRIGGER) == 0)
+    return -1;
+  return header->flags >> SONAR_FRAME_TRIGGER_SHIFT;
+}
+
+/**
+ * @brief Number of bytes following a frame header
+ */
+inline size_t sonarFramePayloadBytes(const SonarFrameHeader* header)
+{
+  return header->payload != 0 ? header->payload : (size_t)header->count * 2 * 2;
+}
+
+/**
+ * @brief CRC of a packed frame
+ *
+ * @param header the header, crc is not read
+ * @param payload header->payload packed bytes
+ * @return uint32_t the value for header->crc
+ */
+inline uint32_t sonarPackedFrameCRC(const SonarFrameHeader* header, const uint8_t* payload)
+{
+  uint32_t crc = sonarCRC32(0, (const uint8_t*)header, SONAR_FRAME_CRC_OFFSET);
+  return sonarCRC32(crc, payload, header->payload);
+}
+
+/**
+ * @brief The value for a capture header's crc
+ */
+inline uint32_t sonarCaptureCRC(const SonarCaptureHeader* header)
+{
+  return sonarCRC32(0, (const uint8_t*)header, offsetof(SonarCaptureHeader, crc));
+}
+
+#endif
@@ -0,0 +1,192 @@
+/**
+ * @file
+ * @brief Packed forms of the listener ears, shared by the firmware and the host
+ *
+ * The ADCs convert at 10 bits, so a plain frame wastes 6 of every 16 bits it sends.
+ * Two packed forms cut that down:
+ *
+ * PACK10: the samples as a little endian bit stream, sample i in bits 10i to 10i + 9, so
+ * 4 samples take 5 bytes and an ear of SONAR_FRAME_SAMPLES takes 1270 bytes, not 2032.
+ *
+ * DELTA: each sample minus the one before it, the first minus SONAR_PACK_DELTA_START,
+ * zigzag mapped to unsigned and coded in groups of SONAR_PACK_DELTA_GROUP. A group is
+ * stored at the bit width w of its largest value, 8 values of w bits in exactly w bytes.
+ * The widths of all groups go first, two per byte, low nibble first. Slow or quiet
+ * stretches cost a few bits a sample and a loud echo up to 11, so the firmware falls
+ * back to PACK10 for any block DELTA would not shrink further.
+ *
+ * Both ears of a frame are packed the same way, ADC 0 first, each a whole number of
+ * bytes. Samples are 10 bits, anything above that is dropped.
+ *
+ * The decoders here are the plain reference versions, the host has vectorised ones.
+ *
+ * Written against C++11 so it also builds with the Arduino toolchains.
+ */
+#ifndef SONAR_PACK_HPP
+#define SONAR_PACK_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @brief Bytes of n samples packed to 10 bits, n a multiple of 4
+ */
+#define SONAR_PACK10_BYTES(n) ((n) / 4 * 5)
+
+/**
+ * @brief Samples per delta group, one width each
+ */
+#define SONAR_PACK_DELTA_GROUP 8
+
+/**
+ * @brief Widest delta group, a full scale step zigzag maps to 2046
+ */
+#define SONAR_PACK_DELTA_MAX_WIDTH 11
+
+/**
+ * @brief The first delta is taken from mid scale
+ */
+#define SONAR_PACK_DELTA_START 512
+
+/**
+ * @brief Bytes of the group widths for n samples
+ */
+#define SONAR_PACK_DELTA_WIDTH_BYTES(n) (((n) / SONAR_PACK_DELTA_GROUP + 1) / 2)
+
+/**
+ * @brief Packs samples to 10 bits
+ *
+ * @param in n samples
+ * @param n a multiple of 4
+ * @param out SONAR_PACK10_BYTES(n) bytes
+ * @return size_t the number of bytes written
+ */
+inline size_t sonarPack10(const uint16_t* in, size_t n, uint8_t* out)
+{
+  uint8_t* start = out;
+  for (size_t i = 0; i + 4 <= n; i += 4, in += 4, out += 5)
+  {
+    uint64_t v = (uint64_t)(in[0] & 0x3FF) | (uint64_t)(in[1] & 0x3FF) << 10 |
+                 (uint64_t)(in[2] & 0x3FF) << 20 | (uint64_t)(in[3] & 0x3FF) << 30;
+    out[0] = (uint8_t)v;
+    out[1] = (uint8_t)(v >> 8);
+    out[2] = (uint8_t)(v >> 16);
+    out[3] = (uint8_t)(v >> 24);
+    out[4] = (uint8_t)(v >> 32);
+  }
+  return out - start;
+}
+
+/**
+ * @brief Reverses sonarPack10()
+ *
+ * @param in SONAR_PACK10_BYTES(n) bytes
+ * @param n a multiple of 4
+ * @param out n samples
+ */
+inline void sonarPack10Decode(const uint8_t* in, size_t n, uint16_t* out)
+{
+  for (size_t i = 0; i + 4 <= n; i += 4, in += 5, out += 4)
+  {
+    uint64_t v = (uint64_t)in[0] | (uint64_t)in[1] << 8 | (uint64_t)in[2] << 16 |
+                 (uint64_t)in[3] << 24 | (uint64_t)in[4] << 32;
+    out[0] = v & 0x3FF;
+    out[1] = (v >> 10) & 0x3FF;
+    out[2] = (v >> 20) & 0x3FF;
+    out[3] = (v >> 30) & 0x3FF;
+  }
+}
+
+/**
+ * @brief Delta and variable length codes samples
+ *
+ * @param in n samples
+ * @param n a multiple of SONAR_PACK_DELTA_GROUP
+ * @param out up to maxBytes bytes
+ * @param maxBytes the most the coded samples may take
+ * @return size_t the number of bytes written, 0 if they would not fit in maxBytes
+ */
+inline size_t sonarDeltaEncode(const uint16_t* in, size_t n, uint8_t* out, size_t maxBytes)
+{
+  size_t groups = n / SONAR_PACK_DELTA_GROUP;
+  size_t pos = SONAR_PACK_DELTA_WIDTH_BYTES(n);
+  if (pos > maxBytes)
+    return 0;
+  memset(out, 0, pos);
+
+  int32_t prev = SONAR_PACK_DELTA_START;
+  for (size_t g = 0; g < groups; ++g, in += SONAR_PACK_DELTA_GROUP)
+  {
+    uint32_t zz[SONAR_PACK_DELTA_GROUP];
+    uint32_t all = 0;
+    for (int k = 0; k < SONAR_PACK_DELTA_GROUP; ++k)
+    {
+      int32_t x = in[k] & 0x3FF;
+      int32_t d = x - prev;
+      prev = x;
+      zz[k] = ((uint32_t)d << 1) ^ (uint32_t)(d >> 31);
+      all |= zz[k];
+    }
+
+    uint32_t w = 0;
+    while (all >> w)
+      w++;
+    out[g / 2] |= (uint8_t)(w << (4 * (g & 1)));
+
+    if (pos + w > maxBytes)
+      return 0;
+
+    // 8 values of w bits end on a byte boundary
+    uint32_t acc = 0;
+    uint32_t bits = 0;
+    for (int k = 0; k < SONAR_PACK_DELTA_GROUP; ++k)
+    {
+      acc |= zz[k] << bits;
+      for (bits += w; bits >= 8; bits -= 8, acc >>= 8)
+        out[pos++] = (uint8_t)acc;
+    }
+  }
+  return pos;
+}
+
+/**
+ * @brief Reverses sonarDeltaEncode()
+ *
+ * @param in the coded samples
+ * @param len bytes available at in
+ * @param out n samples
+ * @param n a multiple of SONAR_PACK_DELTA_GROUP
+ * @return int the number of bytes read, -1 if in is not a valid coding of n samples
+ */
+inline int sonarDeltaDecode(const uint8_t* in, size_t len, uint16_t* out, size_t n)
+{
+  size_t groups = n / SONAR_PACK_DELTA_GROUP;
+  size_t pos = SONAR_PACK_DELTA_WIDTH_BYTES(n);
+  if (pos > len)
+    return -1;
+
+  uint32_t prev = SONAR_PACK_DELTA_START;
+  for (size_t g = 0; g < groups; ++g, out += SONAR_PACK_DELTA_GROUP)
+  {
+    uint32_t w = (in[g / 2] >> (4 * (g & 1))) & 0xF;
+    if (w > SONAR_PACK_DELTA_MAX_WIDTH || pos + w > len)
+      return -1;
+
+    uint32_t acc = 0;
+    uint32_t bits = 0;
+    for (int k = 0; k < SONAR_PACK_DELTA_GROUP; ++k)
+    {
+      for (; bits < w; bits += 8)
+        acc |= (uint32_t)in[pos++] << bits;
+      uint32_t zz = acc & ((1u << w) - 1);
+      acc >>= w;
+      bits -= w;
+      prev += (zz >> 1) ^ (0u - (zz & 1));
+      out[k] = (uint16_t)prev;
+    }
+  }
+  return (int)pos;
+}
+
+#endif
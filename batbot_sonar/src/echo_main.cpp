@@ -11,10 +11,21 @@
 #include <ml_tc2.h>
 #include <CRC32.h>
 
+#include "chirp_bank.hpp"
+#include "chirp_stream.hpp"
+#include "chirp_synth.hpp"
+
 // 2**15
 #define EMIT_BUF_LEN 65000
 
+// chirp upload: the host streams the samples in blocks of this many bytes and may have
+// a few of them in flight, each one is ACKed once it is in chirp_out_buffer
+#define CHIRP_UPLOAD_BLOCK 4096
+// how long the host may go quiet in the middle of a command
+#define WAIT_TIME 2000
+
 
+// the CRC32 library one sample at a time, kept to compare the DSU against
 uint32_t calcHashCRC32(uint16_t* array, size_t length){
   CRC32 crc;
   for (size_t i = 0; i < length; i++){
@@ -23,9 +34,77 @@ uint32_t calcHashCRC32(uint16_t* array, size_t length){
   return crc.finalize();
 }
 
+// CRC32 on the DSU, the same digest as the CRC32 library and zlib.crc32. it runs over
+// SRAM on its own while the CPU goes on. the DSU only takes whole aligned words, so an
+// unaligned first half word and a last odd one are done here, bit by bit
+static bool dsu_crc_running = false;
+static uint32_t dsu_crc_state;
+static const uint8_t* dsu_crc_tail;
+static size_t dsu_crc_tail_len;
 
+uint32_t crc32_bits(uint32_t state, const uint8_t* data, size_t len)
+{
+  while (len--){
+    state ^= *data++;
+    for (int k = 0; k < 8; k++){
+      state = (state >> 1) ^ (0xEDB88320 & -(state & 1));
+    }
+  }
+  return state;
+}
 
-static uint16_t chirp_out_buffer[EMIT_BUF_LEN];
+void dsu_crc_start(const void* data, size_t len)
+{
+  const uint8_t* p = (const uint8_t*)data;
+  size_t head = min(len, (size_t)((4 - ((uint32_t)p & 3)) & 3));
+  dsu_crc_state = crc32_bits(0xFFFFFFFF, p, head);
+  p += head;
+  len -= head;
+
+  size_t words = len & ~(size_t)3;
+  dsu_crc_tail = p + words;
+  dsu_crc_tail_len = len - words;
+  dsu_crc_running = words > 0;
+  if (!dsu_crc_running){
+    return;
+  }
+
+  // DATA carries the running CRC in and out, not yet inverted
+  DSU->STATUSA.reg = DSU_STATUSA_DONE | DSU_STATUSA_BERR;
+  DSU->ADDR.reg = (uint32_t)p;
+  DSU->LENGTH.reg = words;
+  DSU->DATA.reg = dsu_crc_state;
+  DSU->CTRL.reg = DSU_CTRL_CRC;
+}
+
+bool dsu_crc_done(void)
+{
+  return !dsu_crc_running || DSU->STATUSA.bit.DONE;
+}
+
+uint32_t dsu_crc_finish(void)
+{
+  if (dsu_crc_running){
+    while (!DSU->STATUSA.bit.DONE);
+    dsu_crc_state = DSU->DATA.reg;
+    DSU->STATUSA.reg = DSU_STATUSA_DONE;
+    dsu_crc_running = false;
+  }
+  return ~crc32_bits(dsu_crc_state, dsu_crc_tail, dsu_crc_tail_len);
+}
+
+uint32_t dsu_crc32(const void* data, size_t len)
+{
+  dsu_crc_start(data, len);
+  return dsu_crc_finish();
+}
+
+
+
+// the chirp bank's slots, one more sample than the longest chirp for the silence after it
+static uint16_t chirp_out_buffer[EMIT_BUF_LEN + 1];
+static ChirpBank chirp_bank;
+static uint16_t dac_silence = 0;
 
 uint32_t init_chirp_buffer(void)
 {
@@ -113,8 +192,11 @@ void dac_init(void)
   );
 
 
-  //check when testing evsys
-  DMAC_channel_intenset(DAC_DMAC_CHANNEL, DMAC_2_IRQn, DMAC_CHINTENSET_TCMPL, 0);
+  // the end of each emission, where a staged chirp is swapped in
+  DMAC_channel_intenset(DAC_DMAC_CHANNEL, DMAC_0_IRQn, DMAC_CHINTENSET_TCMPL, 0);
+
+  // an event resumes the channel like EMIT_CHIRP does, the ping train's timer sends them
+  DMAC->Channel[DAC_DMAC_CHANNEL].CHEVCTRL.reg = DMAC_CHEVCTRL_EVIE | DMAC_CHEVCTRL_EVACT_RESUME;
 
   DMAC_descriptor_init
   (
@@ -129,6 +211,167 @@ void dac_init(void)
   peripheral_port_init(&dac_pin);
 }
 
+// ping train: TC2 and TC3 as one 32 bit timer that overflows every pulse repetition
+// interval. the overflow goes through the event system straight to DAC_DMAC_CHANNEL's
+// resume, so the chirps start on the timer without the CPU. its interrupt only counts
+// the pings, timestamps them and stops the timer after the last one
+// GCLK0, 120 MHz, / 8
+#define PING_TIMER_TICKS_PER_US 15
+#define PING_EVSYS_CHANNEL 0
+// the chirp has to be done, and a staged one swapped in, before the next resume or that
+// ping is lost
+#define PING_MIN_GAP_US 50
+#define PING_LOG_LEN 64
+
+static volatile bool ping_running = false;
+static volatile uint32_t ping_count = 0;
+// 0 until PING_TRAIN_STOP
+static volatile uint32_t ping_target = 0;
+// micros() of each ping, by ping number modulo PING_LOG_LEN
+static volatile uint32_t ping_log[PING_LOG_LEN];
+
+void ping_timer_init(void)
+{
+  MCLK->APBBMASK.reg |= MCLK_APBBMASK_TC2 | MCLK_APBBMASK_TC3 | MCLK_APBBMASK_EVSYS;
+  GCLK->PCHCTRL[TC2_GCLK_ID].reg = GCLK_PCHCTRL_GEN_GCLK0 | GCLK_PCHCTRL_CHEN;
+  while (!GCLK->PCHCTRL[TC2_GCLK_ID].bit.CHEN);
+
+  TC2->COUNT32.CTRLA.bit.SWRST = 1;
+  while (TC2->COUNT32.SYNCBUSY.bit.SWRST);
+  TC2->COUNT32.CTRLA.reg = TC_CTRLA_MODE_COUNT32 | TC_CTRLA_PRESCALER_DIV8 | TC_CTRLA_PRESCSYNC_PRESC;
+  TC2->COUNT32.WAVE.reg = TC_WAVE_WAVEGEN_MFRQ;
+  TC2->COUNT32.EVCTRL.reg = TC_EVCTRL_OVFEO;
+  TC2->COUNT32.INTENSET.reg = TC_INTENSET_OVF;
+
+  EVSYS->Channel[PING_EVSYS_CHANNEL].CHANNEL.reg = EVSYS_CHANNEL_EVGEN(EVSYS_ID_GEN_TC2_OVF) |
+                                                   EVSYS_CHANNEL_PATH_ASYNCHRONOUS;
+  EVSYS->USER[EVSYS_ID_USER_DMAC_CH_0].reg = PING_EVSYS_CHANNEL + 1;
+
+  NVIC_SetPriority(TC2_IRQn, 0);
+  NVIC_EnableIRQ(TC2_IRQn);
+}
+
+void ping_train_stop(void)
+{
+  TC2->COUNT32.CTRLA.bit.ENABLE = 0;
+  while (TC2->COUNT32.SYNCBUSY.bit.ENABLE);
+  TC2->COUNT32.INTFLAG.reg = TC_INTFLAG_OVF;
+  ping_running = false;
+}
+
+// count pings of the active chirp, 0 for until stopped, every period_us. the first one
+// goes a tick after the start. false without a chirp or if it would not be done in time
+bool ping_train_start(uint32_t period_us, uint32_t count)
+{
+  if (chirp_bank.active < 0){
+    return false;
+  }
+  const ChirpSlot* slot = &chirp_bank.slots[chirp_bank.active];
+  if (period_us < slot->len + 1 + PING_MIN_GAP_US || period_us > UINT32_MAX / PING_TIMER_TICKS_PER_US){
+    return false;
+  }
+
+  ping_train_stop();
+  ping_count = 0;
+  ping_target = count;
+
+  uint32_t top = period_us * PING_TIMER_TICKS_PER_US - 1;
+  TC2->COUNT32.CC[0].reg = top;
+  while (TC2->COUNT32.SYNCBUSY.bit.CC0);
+  TC2->COUNT32.COUNT.reg = top;
+  while (TC2->COUNT32.SYNCBUSY.bit.COUNT);
+
+  ping_running = true;
+  TC2->COUNT32.CTRLA.bit.ENABLE = 1;
+  while (TC2->COUNT32.SYNCBUSY.bit.ENABLE);
+  return true;
+}
+
+void TC2_Handler(void)
+{
+  TC2->COUNT32.INTFLAG.reg = TC_INTFLAG_OVF;
+  ping_log[ping_count % PING_LOG_LEN] = micros();
+  ping_count = ping_count + 1;
+  if (ping_target && ping_count >= ping_target){
+    ping_train_stop();
+  }
+}
+
+// the DMA plays one slot while the next one is staged. the swap only happens between
+// emissions: right away when the DAC is idle, else in the block interrupt at the end of
+// the emission in progress, so changing the chirp never cuts a ping short or makes the
+// ping train miss one. both slots stay pinned in the bank until then
+static volatile int dac_playing = -1;
+static volatile int dac_staged = -1;
+static volatile bool dac_swap_pending = false;
+
+// points the DAC's DMA at a slot's chirp and the silent sample after it, only silence
+// for -1. cuts short an emission in progress
+void dac_point(int slot)
+{
+  DMAC->Channel[DAC_DMAC_CHANNEL].CHCTRLA.bit.ENABLE = 0;
+  while (DMAC->Channel[DAC_DMAC_CHANNEL].CHCTRLA.bit.ENABLE);
+
+  if (slot < 0){
+    base_descriptor[DAC_DMAC_CHANNEL].BTCNT.reg = 1;
+    base_descriptor[DAC_DMAC_CHANNEL].SRCADDR.reg = (uint32_t)(&dac_silence + 1);
+  }
+  else{
+    const ChirpSlot* s = &chirp_bank.slots[slot];
+    base_descriptor[DAC_DMAC_CHANNEL].BTCNT.reg = s->len + 1;
+    base_descriptor[DAC_DMAC_CHANNEL].SRCADDR.reg = (uint32_t)&chirp_out_buffer[s->offset + s->len + 1];
+  }
+
+  ML_DMAC_CHANNEL_ENABLE(DAC_DMAC_CHANNEL);
+  ML_DMAC_CHANNEL_SUSPEND(DAC_DMAC_CHANNEL);
+  dac_playing = slot;
+}
+
+// swaps in the staged slot if nothing plays and no ping train can start an emission
+void dac_swap_if_idle(void)
+{
+  __disable_irq();
+  if (dac_swap_pending && !ping_running && !DMAC->Channel[DAC_DMAC_CHANNEL].CHSTATUS.bit.BUSY){
+    dac_point(dac_staged);
+    dac_swap_pending = false;
+  }
+  __enable_irq();
+}
+
+// stages the bank's active slot, silence if there is none
+void dac_play_active(void)
+{
+  __disable_irq();
+  dac_staged = chirp_bank.active;
+  dac_swap_pending = dac_staged != dac_playing;
+  __enable_irq();
+  dac_swap_if_idle();
+}
+
+// a new slot for a chirp. it goes beside the slot playing and the one staged if it fits,
+// else the DAC goes silent and the chirp takes whatever room it needs
+int dac_alloc_slot(uint16_t len)
+{
+  __disable_irq();
+  for (int i = 0; i < CHIRP_BANK_SLOTS; i++){
+    chirp_bank.slots[i].pinned = i == dac_playing || (dac_swap_pending && i == dac_staged);
+  }
+  __enable_irq();
+
+  int slot = chirpBankAlloc(&chirp_bank, len);
+  if (slot < 0){
+    __disable_irq();
+    dac_point(-1);
+    dac_swap_pending = false;
+    __enable_irq();
+    for (int i = 0; i < CHIRP_BANK_SLOTS; i++){
+      chirp_bank.slots[i].pinned = false;
+    }
+    slot = chirpBankAlloc(&chirp_bank, len);
+  }
+  return slot;
+}
+
 
 
 enum ECHO_SERIAL_CMD{
@@ -142,7 +385,17 @@ enum ECHO_SERIAL_CMD{
   GET_MAX_UINT16_CHIRP_LEN = 7,
   START_AMP = 8,
   STOP_AMP = 9,
-  CLEAR_SERIAL = 10
+  CLEAR_SERIAL = 10,
+  CHIRP_SYNTH = 11,
+  CHIRP_BANK_QUERY = 12,
+  CHIRP_SELECT = 13,
+  EMIT_SLOT = 14,
+  CHIRP_CRC_START = 15,
+  CHIRP_CRC_POLL = 16,
+  PING_TRAIN_START = 17,
+  PING_TRAIN_STOP = 18,
+  PING_TRAIN_STATUS = 19,
+  STREAM_START = 20
 };
 
 ECHO_SERIAL_CMD cmd = ECHO_SERIAL_CMD::NONE;
@@ -158,7 +411,9 @@ void drain_buffer(){
 void setup()
 {
   Serial.begin(960000);
+  Serial.setTimeout(WAIT_TIME);
   chirp_out_source_address = init_chirp_buffer();
+  chirpBankInit(&chirp_bank, EMIT_BUF_LEN + 1);
 
   MCLK_init();
   GCLK_init();
@@ -166,11 +421,13 @@ void setup()
   DMAC_init(&base_descriptor[DAC_DMAC_CHANNEL],&wb_descriptor[DAC_DMAC_CHANNEL]);
   dotstar_init();
 
-
+  // the DSU is write protected out of reset, its CRC needs it open
+  PAC->WRCTRL.reg = PAC_WRCTRL_PERID(ID_DSU) | PAC_WRCTRL_KEY_CLR;
 
   dac_init();
   dac_sample_timer_init();
   DAC_enable();
+  ping_timer_init();
 
  TCC_enable(TCC2);
  TCC_force_stop(TCC2);
@@ -187,12 +444,206 @@ void setup()
 }
 
 bool serial_error = false;
-#define WAIT_TIME 2000
 #define ACK_SEND_SIZE 250
+
+// CHIRP_CRC_START and CHIRP_CRC_POLL: the active chirp's CRC on the DSU in the background,
+// or with the CRC32 library to compare, and how long it took
+enum CRC_ENGINE{
+  CRC_ENGINE_DSU = 0,
+  CRC_ENGINE_SOFTWARE = 1
+};
+static bool crc_check_pending = false;
+static uint32_t crc_check_result = 0;
+static unsigned long crc_check_start_us = 0;
+static unsigned long crc_check_us = 0;
+
+// wait if the DSU is needed for something else
+void crc_check_update(bool wait)
+{
+  if (crc_check_pending && (wait || dsu_crc_done())){
+    crc_check_us = micros() - crc_check_start_us;
+    crc_check_result = dsu_crc_finish();
+    crc_check_pending = false;
+  }
+}
+
+// reads len bytes, as many as have arrived at a time. false if the host goes quiet for
+// WAIT_TIME
+bool receive_block(uint8_t* dst, size_t len)
+{
+  size_t got = 0;
+  unsigned long recv_time = millis();
+  while (got < len){
+    int avail = Serial.available();
+    if (avail <= 0){
+      if (millis() - recv_time > WAIT_TIME){
+        return false;
+      }
+      continue;
+    }
+
+    got += Serial.readBytes((char*)dst + got, min((size_t)avail, len - got));
+    recv_time = millis();
+  }
+  return true;
+}
+
+// reads len samples straight into a slot of chirp_out_buffer, ACKing each block, then has
+// the DSU CRC them. false if the host goes quiet for WAIT_TIME
+bool receive_chirp(uint16_t* samples, uint16_t len, uint32_t* crc_out)
+{
+  uint8_t* dst = (uint8_t*)samples;
+  size_t total = (size_t)len * sizeof(uint16_t);
+  for (size_t got = 0; got < total; got += CHIRP_UPLOAD_BLOCK){
+    if (!receive_block(dst + got, min(total - got, (size_t)CHIRP_UPLOAD_BLOCK))){
+      return false;
+    }
+    Serial.write(ECHO_SERIAL_CMD::ACK);
+  }
+
+  crc_check_update(true);
+  *crc_out = dsu_crc32(dst, total);
+  return true;
+}
+
+// STREAM_START: waveforms of any length, played while the host sends them. the DAC's DMA
+// goes round a ring of linked descriptors, one per block of stream_buffer, and the block
+// interrupt points each one back at silence once it has played, until the host fills it
+// again. chirp_stream.hpp keeps track of which block is which
+static_assert(CHIRP_STREAM_BLOCK_LEN * sizeof(uint16_t) == CHIRP_UPLOAD_BLOCK, "a stream block is an upload block");
+static uint16_t stream_buffer[CHIRP_STREAM_BLOCKS][CHIRP_STREAM_BLOCK_LEN + 1];
+static DmacDescriptor stream_descriptor[CHIRP_STREAM_BLOCKS] __attribute__((aligned(16)));
+static ChirpStream stream;
+static volatile bool stream_running = false;
+
+// a block's worth of silence, the source address stays on dac_silence
+void stream_block_silence(int block)
+{
+  DmacDescriptor* d = &stream_descriptor[block];
+  d->BTCTRL.reg = DMAC_BTCTRL_VALID | DMAC_BTCTRL_BLOCKACT_INT | DMAC_BTCTRL_BEATSIZE_HWORD;
+  d->BTCNT.reg = CHIRP_STREAM_BLOCK_LEN;
+  d->SRCADDR.reg = (uint32_t)&dac_silence;
+  d->DSTADDR.reg = (uint32_t)&DAC->DATA[0].reg;
+  d->DESCADDR.reg = (uint32_t)&stream_descriptor[(block + 1) % CHIRP_STREAM_BLOCKS];
+}
+
+// len of the host's samples in a block. the last block also plays a silent sample after
+// them, and suspends the channel
+void stream_block_play(int block, uint32_t len, bool last)
+{
+  DmacDescriptor* d = &stream_descriptor[block];
+  if (last){
+    stream_buffer[block][len++] = 0;
+  }
+  d->BTCNT.reg = len;
+  d->SRCADDR.reg = (uint32_t)&stream_buffer[block][len];
+  d->BTCTRL.reg = DMAC_BTCTRL_VALID | (last ? DMAC_BTCTRL_BLOCKACT_BOTH : DMAC_BTCTRL_BLOCKACT_INT) |
+                  DMAC_BTCTRL_BEATSIZE_HWORD | DMAC_BTCTRL_SRCINC;
+}
+
+// the channel starts on block 0 right away, on the sample timer's triggers
+void stream_dma_start(void)
+{
+  DMAC->Channel[DAC_DMAC_CHANNEL].CHCTRLA.bit.ENABLE = 0;
+  while (DMAC->Channel[DAC_DMAC_CHANNEL].CHCTRLA.bit.ENABLE);
+
+  memcpy(&base_descriptor[DAC_DMAC_CHANNEL], &stream_descriptor[0], sizeof(DmacDescriptor));
+  chirpStreamStart(&stream);
+  stream_running = true;
+  ML_DMAC_CHANNEL_ENABLE(DAC_DMAC_CHANNEL);
+}
+
+// back to the bank's chirp at 1 MHz, whether the stream played out or not
+void stream_stop(void)
+{
+  __disable_irq();
+  stream_running = false;
+  base_descriptor[DAC_DMAC_CHANNEL].BTCTRL.reg = chirp_out_dmac_descriptor_settings;
+  base_descriptor[DAC_DMAC_CHANNEL].DESCADDR.reg = (uint32_t)&base_descriptor[DAC_DMAC_CHANNEL];
+  dac_point(dac_playing);
+  __enable_irq();
+  TCC_set_period(TCC0, 11);
+}
+
+// total samples from the host at 1 MHz / divider, each block ACKed once it is in the ring.
+// false if the host goes quiet for WAIT_TIME
+bool stream_play(uint32_t total, uint8_t divider)
+{
+  // whatever the DAC plays finishes first
+  while (DMAC->Channel[DAC_DMAC_CHANNEL].CHSTATUS.bit.BUSY);
+  dac_swap_if_idle();
+
+  chirpStreamInit(&stream, total);
+  for (int i = 0; i < CHIRP_STREAM_BLOCKS; i++){
+    stream_block_silence(i);
+  }
+  // 12 timer ticks per sample at 1 MHz
+  TCC_set_period(TCC0, 12 * divider - 1);
+
+  // the host starts sending on this ACK, up to its window of blocks ahead
+  Serial.write(ECHO_SERIAL_CMD::ACK);
+  Serial.flush();
+
+  unsigned long wait_start = millis();
+  while (stream.received < stream.total){
+    if (chirpStreamReady(&stream)){
+      stream_dma_start();
+    }
+
+    // a full ring frees a block each time one plays
+    __disable_irq();
+    int block = chirpStreamWriteBlock(&stream);
+    __enable_irq();
+    if (block < 0){
+      if (millis() - wait_start > WAIT_TIME){
+        stream_stop();
+        return false;
+      }
+      continue;
+    }
+
+    uint32_t len = chirpStreamBlockLen(&stream);
+    if (!receive_block((uint8_t*)stream_buffer[block], len * sizeof(uint16_t))){
+      stream_stop();
+      return false;
+    }
+
+    // the DMA may have caught up meanwhile, then the samples go further ahead
+    __disable_irq();
+    int now = chirpStreamWriteBlock(&stream);
+    if (now != block){
+      memcpy(stream_buffer[now], stream_buffer[block], len * sizeof(uint16_t));
+    }
+    stream_block_play(now, len, stream.received + len >= stream.total);
+    chirpStreamCommit(&stream, now, len);
+    __enable_irq();
+
+    Serial.write(ECHO_SERIAL_CMD::ACK);
+    wait_start = millis();
+  }
+
+  if (chirpStreamReady(&stream)){
+    stream_dma_start();
+  }
+
+  // the rest of the ring plays out, the block interrupt clears stream_running after the
+  // last one
+  bool played = true;
+  while (stream_running){
+    if (millis() - wait_start > WAIT_TIME + (unsigned long)CHIRP_STREAM_BLOCKS * CHIRP_STREAM_BLOCK_LEN * divider / 1000){
+      played = false;
+      break;
+    }
+  }
+  stream_stop();
+  return played;
+}
+
 void loop()
 {
   // put your main code here, to run repeatedly:
   // Serial.println("running");
+  crc_check_update(false);
 
   if (Serial.available() >= 1){
     cmd = (ECHO_SERIAL_CMD)Serial.read();
@@ -214,9 +665,8 @@ void loop()
     case ECHO_SERIAL_CMD::CHIRP_DATA:{
       // DOTSTAR_SET_PINK();
 
-      unsigned long recv_time = millis();
-      while(Serial.available() < 1 && millis() - recv_time < WAIT_TIME);
-      if (millis() - recv_time > WAIT_TIME+100 && Serial.available() <= 1){
+      uint8_t len_bytes[2];
+      if (Serial.readBytes((char*)len_bytes, 2) != 2){
         Serial.write(ECHO_SERIAL_CMD::ERROR);
         Serial.flush();
         DOTSTAR_SET_ORANGE();
@@ -227,8 +677,7 @@ void loop()
       // DOTSTAR_SET_LIGHT_BLUE();
 
   
-      uint16_t chirp_len = (uint8_t)Serial.read();
-      chirp_len |= Serial.read()<<8;
+      uint16_t chirp_len = len_bytes[0] | (uint16_t)len_bytes[1] << 8;
       if (chirp_len > (uint16_t) EMIT_BUF_LEN){
         Serial.write(ECHO_SERIAL_CMD::CHIRP_DATA_TOO_LONG);
         Serial.flush();
@@ -237,82 +686,277 @@ void loop()
         return;
       }
 
+      // the chirp goes into a new slot while the DAC goes on playing, whatever it
+      // overwrites is dropped from the bank
+      int slot = dac_alloc_slot(chirp_len);
+      if (slot < 0){
+        Serial.write(ECHO_SERIAL_CMD::ERROR);
+        Serial.flush();
+        DOTSTAR_SET_RED();
+        serial_error = true;
+        return;
+      }
+      uint16_t* samples = &chirp_out_buffer[chirp_bank.slots[slot].offset];
+
       Serial.write(chirp_len&0xff);
       Serial.write((chirp_len>>8)&0xff);
       Serial.flush();
 
       // DOTSTAR_SET_LIGHT_BLUE();
-      // pi waits for ack before flooding with data since serial buffer is so small
+      // the host starts streaming on this ACK, up to its window of blocks ahead
       Serial.write(ECHO_SERIAL_CMD::ACK);
       Serial.flush();
 
-      for (int i = 0; i < EMIT_BUF_LEN; i++){
-        chirp_out_buffer[i] = 0;
+      uint32_t crc_hash;
+      if (!receive_chirp(samples, chirp_len, &crc_hash)){
+        Serial.write(ECHO_SERIAL_CMD::ERROR);
+        Serial.flush();
+        DOTSTAR_SET_YELLOW();
+        serial_error = true;
+        return;
       }
-      
 
-      recv_time = millis();
-      for(int i = 0; i < chirp_len;i++){
-
-        while(Serial.available() < 2 && millis() - recv_time < WAIT_TIME);
-        if(millis() - recv_time+100 > WAIT_TIME){
-          Serial.flush();
-          Serial.write(ECHO_SERIAL_CMD::ERROR);
-          Serial.flush();
-          DOTSTAR_SET_YELLOW();
-          serial_error = true;
-          return;
-        }
-        recv_time = millis();
-        chirp_out_buffer[i] = (uint8_t)Serial.read();
-        chirp_out_buffer[i] |= (uint8_t) Serial.read() <<8;
-      }
+      // silence after the chirp, and it plays from the next emission on
+      samples[chirp_len] = 0;
+      chirpBankCommit(&chirp_bank, slot, chirp_len, crc_hash);
+      dac_play_active();
 
-      DOTSTAR_SET_LIGHT_GREEN();
+      DOTSTAR_SET_PINK();
+      // the CRC follows the last block's ACK, it is the same as zlib.crc32 of the bytes
+      Serial.write(crc_hash&0xff);
+      Serial.write((crc_hash >>8)&0xff);
+      Serial.write((crc_hash >>16)&0xff);
+      Serial.write((crc_hash >>24)&0xff);
+      Serial.flush();
+      // for(int i = 0; i < chirp_len; i++){
+      //   Serial.write(chirp_out_buffer[i]&0xff);
+      //   Serial.write(chirp_out_buffer[i]>>8&0xff);
+      //   if (i%64 == 0){
+      //     Serial.flush();
+      //   }
+      // }
+ 
 
-      recv_time = millis();
-      while(Serial.available() == 0 && millis() - recv_time < WAIT_TIME);
-      if (millis() - recv_time+100 > WAIT_TIME){
-        Serial.flush();
+      DOTSTAR_SET_GREEN();
+    break;
+    }
+    case ECHO_SERIAL_CMD::CHIRP_SYNTH:{
+      // the host sends the chirp's parameters instead of its samples, the waveform is
+      // made here to within 1 LSB of what gen_chirp would have uploaded
+      ChirpParams params;
+      if (Serial.readBytes((char*)&params, sizeof(params)) != sizeof(params)){
         Serial.write(ECHO_SERIAL_CMD::ERROR);
         Serial.flush();
-        DOTSTAR_SET_RED();
+        DOTSTAR_SET_ORANGE();
         serial_error = true;
         return;
       }
 
       DOTSTAR_SET_PINK();
-      cmd = (ECHO_SERIAL_CMD)Serial.read();
-      if (cmd != ECHO_SERIAL_CMD::ACK_REQ){
-        Serial.flush();
+      int chirp_len = chirpSynthLength(&params, EMIT_BUF_LEN);
+      int slot = chirp_len < 0 ? -1 : dac_alloc_slot(chirp_len);
+      if (slot < 0){
         Serial.write(ECHO_SERIAL_CMD::ERROR);
         Serial.flush();
         DOTSTAR_SET_RED();
         serial_error = true;
         return;
       }
-
+      uint16_t* samples = &chirp_out_buffer[chirp_bank.slots[slot].offset];
+      chirpSynth(&params, samples, chirp_len);
+      samples[chirp_len] = 0;
+
+      // ACK and the CRC of the samples, as after CHIRP_DATA
+      crc_check_update(true);
+      uint32_t crc_hash = dsu_crc32(samples, chirp_len * sizeof(uint16_t));
+      chirpBankCommit(&chirp_bank, slot, chirp_len, crc_hash);
+      dac_play_active();
       Serial.write(ECHO_SERIAL_CMD::ACK);
-      Serial.flush();
-      uint32_t crc_hash = calcHashCRC32(chirp_out_buffer,chirp_len);
       Serial.write(crc_hash&0xff);
       Serial.write((crc_hash >>8)&0xff);
       Serial.write((crc_hash >>16)&0xff);
       Serial.write((crc_hash >>24)&0xff);
       Serial.flush();
-      // for(int i = 0; i < chirp_len; i++){
-      //   Serial.write(chirp_out_buffer[i]&0xff);
-      //   Serial.write(chirp_out_buffer[i]>>8&0xff);
-      //   if (i%64 == 0){
-      //     Serial.flush();
-      //   }
-      // }
- 
 
       DOTSTAR_SET_GREEN();
-    break;
+      break;
+    }
+    case ECHO_SERIAL_CMD::CHIRP_BANK_QUERY:{
+      // every slot's CRC and length, 0 when empty, and the active slot, 0xFF if none
+      Serial.write(ECHO_SERIAL_CMD::CHIRP_BANK_QUERY);
+      Serial.write(CHIRP_BANK_SLOTS);
+      Serial.write(chirp_bank.active < 0 ? 0xFF : chirp_bank.active);
+      for (int i = 0; i < CHIRP_BANK_SLOTS; i++){
+        const ChirpSlot* slot = &chirp_bank.slots[i];
+        Serial.write(slot->crc&0xff);
+        Serial.write((slot->crc >>8)&0xff);
+        Serial.write((slot->crc >>16)&0xff);
+        Serial.write((slot->crc >>24)&0xff);
+        Serial.write(slot->len&0xff);
+        Serial.write((slot->len >>8)&0xff);
+      }
+      Serial.flush();
+      break;
+    }
+    case ECHO_SERIAL_CMD::CHIRP_SELECT:
+    case ECHO_SERIAL_CMD::EMIT_SLOT:{
+      // the chirp by its CRC, EMIT_SLOT plays it right away
+      uint8_t crc_bytes[4];
+      if (Serial.readBytes((char*)crc_bytes, 4) != 4 ||
+          chirpBankSelect(&chirp_bank, crc_bytes[0] | crc_bytes[1] << 8 | crc_bytes[2] << 16 | (uint32_t)crc_bytes[3] << 24) < 0){
+        Serial.write(ECHO_SERIAL_CMD::ERROR);
+        Serial.flush();
+        DOTSTAR_SET_ORANGE();
+        serial_error = true;
+        return;
+      }
+      dac_play_active();
+      if (cmd == ECHO_SERIAL_CMD::EMIT_SLOT){
+        dac_swap_if_idle();
+        ML_DMAC_CHANNEL_RESUME(DAC_DMAC_CHANNEL);
+      }
+      Serial.write(ECHO_SERIAL_CMD::ACK);
+
+      DOTSTAR_SET_LIGHT_GREEN();
+      break;
+    }
+    case ECHO_SERIAL_CMD::CHIRP_CRC_START:{
+      uint8_t engine;
+      if (Serial.readBytes((char*)&engine, 1) != 1 || chirp_bank.active < 0 || crc_check_pending){
+        Serial.write(ECHO_SERIAL_CMD::ERROR);
+        Serial.flush();
+        DOTSTAR_SET_ORANGE();
+        serial_error = true;
+        return;
+      }
+      const ChirpSlot* slot = &chirp_bank.slots[chirp_bank.active];
+      uint16_t* samples = &chirp_out_buffer[slot->offset];
+
+      crc_check_start_us = micros();
+      if (engine == CRC_ENGINE_SOFTWARE){
+        crc_check_result = calcHashCRC32(samples, slot->len);
+        crc_check_us = micros() - crc_check_start_us;
+      }
+      else{
+        dsu_crc_start(samples, slot->len * sizeof(uint16_t));
+        crc_check_pending = true;
+      }
+      Serial.write(ECHO_SERIAL_CMD::ACK);
+      break;
+    }
+    case ECHO_SERIAL_CMD::CHIRP_CRC_POLL:{
+      // 1 once done, the CRC and the microseconds it took
+      crc_check_update(false);
+      Serial.write(ECHO_SERIAL_CMD::CHIRP_CRC_POLL);
+      Serial.write(crc_check_pending ? 0 : 1);
+      Serial.write(crc_check_result&0xff);
+      Serial.write((crc_check_result >>8)&0xff);
+      Serial.write((crc_check_result >>16)&0xff);
+      Serial.write((crc_check_result >>24)&0xff);
+      Serial.write(crc_check_us&0xff);
+      Serial.write((crc_check_us >>8)&0xff);
+      Serial.write((crc_check_us >>16)&0xff);
+      Serial.write((crc_check_us >>24)&0xff);
+      Serial.flush();
+      break;
+    }
+    case ECHO_SERIAL_CMD::PING_TRAIN_START:{
+      // pulse repetition interval in us and the number of pings, 0 until stopped
+      uint8_t args[8];
+      if (Serial.readBytes((char*)args, 8) != 8 ||
+          !ping_train_start(args[0] | args[1] << 8 | args[2] << 16 | (uint32_t)args[3] << 24,
+                            args[4] | args[5] << 8 | args[6] << 16 | (uint32_t)args[7] << 24)){
+        Serial.write(ECHO_SERIAL_CMD::ERROR);
+        Serial.flush();
+        DOTSTAR_SET_ORANGE();
+        serial_error = true;
+        return;
+      }
+      Serial.write(ECHO_SERIAL_CMD::ACK);
+      DOTSTAR_SET_LIGHT_GREEN();
+      break;
+    }
+    case ECHO_SERIAL_CMD::PING_TRAIN_STOP:{
+      ping_train_stop();
+      dac_swap_if_idle();
+      Serial.write(ECHO_SERIAL_CMD::ACK);
+      DOTSTAR_SET_GREEN();
+      break;
+    }
+    case ECHO_SERIAL_CMD::PING_TRAIN_STATUS:{
+      // the host asks from which ping on it wants timestamps. it gets whether the train
+      // runs, the pings so far and the timestamps the log still holds from there on, at
+      // most half of it so a ping coming in meanwhile can't overwrite them
+      uint8_t args[4];
+      if (Serial.readBytes((char*)args, 4) != 4){
+        Serial.write(ECHO_SERIAL_CMD::ERROR);
+        Serial.flush();
+        DOTSTAR_SET_ORANGE();
+        serial_error = true;
+        return;
+      }
+      uint32_t pings = ping_count;
+      uint32_t first = args[0] | args[1] << 8 | args[2] << 16 | (uint32_t)args[3] << 24;
+      if (pings > PING_LOG_LEN / 2 && first < pings - PING_LOG_LEN / 2){
+        first = pings - PING_LOG_LEN / 2;
+      }
+      uint8_t n = first < pings ? pings - first : 0;
+
+      uint8_t reply[11 + 4 * PING_LOG_LEN / 2];
+      reply[0] = ECHO_SERIAL_CMD::PING_TRAIN_STATUS;
+      reply[1] = ping_running;
+      memcpy(&reply[2], &pings, 4);
+      memcpy(&reply[6], &first, 4);
+      reply[10] = n;
+      for (uint8_t i = 0; i < n; i++){
+        uint32_t t = ping_log[(first + i) % PING_LOG_LEN];
+        memcpy(&reply[11 + 4 * i], &t, 4);
+      }
+      Serial.write(reply, 11 + 4 * n);
+      Serial.flush();
+      break;
+    }
+    case ECHO_SERIAL_CMD::STREAM_START:{
+      // samples in the waveform and the divider of the DAC's 1 MHz, then the samples in
+      // blocks as for CHIRP_DATA. once it has played, the blocks of silence the DAC had to
+      // play because the host was late
+      uint8_t args[5];
+      if (Serial.readBytes((char*)args, 5) != 5 || ping_running){
+        Serial.write(ECHO_SERIAL_CMD::ERROR);
+        Serial.flush();
+        DOTSTAR_SET_ORANGE();
+        serial_error = true;
+        return;
+      }
+      uint32_t total = args[0] | args[1] << 8 | args[2] << 16 | (uint32_t)args[3] << 24;
+      if (total == 0 || args[4] == 0){
+        Serial.write(ECHO_SERIAL_CMD::ERROR);
+        Serial.flush();
+        DOTSTAR_SET_RED();
+        serial_error = true;
+        return;
+      }
+
+      DOTSTAR_SET_PINK();
+      if (!stream_play(total, args[4])){
+        Serial.write(ECHO_SERIAL_CMD::ERROR);
+        Serial.flush();
+        DOTSTAR_SET_YELLOW();
+        serial_error = true;
+        return;
+      }
+      Serial.write(ECHO_SERIAL_CMD::STREAM_START);
+      Serial.write(stream.underruns&0xff);
+      Serial.write((stream.underruns >>8)&0xff);
+      Serial.write((stream.underruns >>16)&0xff);
+      Serial.write((stream.underruns >>24)&0xff);
+      Serial.flush();
+
+      DOTSTAR_SET_GREEN();
+      break;
     }
     case ECHO_SERIAL_CMD::EMIT_CHIRP:{
+      dac_swap_if_idle();
       ML_DMAC_CHANNEL_RESUME(DAC_DMAC_CHANNEL);
       // DMAC->SWTRIGCTRL.bit.SWTRIG0 = 0x01;
       
@@ -354,7 +998,7 @@ void loop()
 }
 
 
-void DMAC_2_Handler(void)
+void DMAC_0_Handler(void)
 {
   
   if(DMAC->Channel[DAC_DMAC_CHANNEL].CHINTFLAG.bit.TCMPL)
@@ -365,6 +1009,21 @@ void DMAC_2_Handler(void)
     ML_DMAC_CHANNEL_CLR_SUSP_INTFLAG(DAC_DMAC_CHANNEL);
     DMAC->Channel[DAC_DMAC_CHANNEL].CHINTFLAG.bit.TCMPL = 0x01;
 
+    // a stream's block has played, the host can fill it again
+    if (stream_running){
+      int block = chirpStreamBlockDone(&stream);
+      if (stream.done){
+        stream_running = false;
+      }
+      else{
+        stream_block_silence(block);
+      }
+    }
+    // the emission is done, the staged chirp plays from the next one on
+    else if (dac_swap_pending){
+      dac_point(dac_staged);
+      dac_swap_pending = false;
+    }
   }
 
 }
\ No newline at end of file
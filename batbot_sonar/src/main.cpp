@@ -10,8 +10,16 @@
 #include <AnalogBufferDMA.h>
 #include <DMAChannel.h>
 
+#include "sonar_ddc.hpp"
+#include "sonar_frame.hpp"
+#include "sonar_pack.hpp"
+
 #define ADC_DUAL_ADCS
 
+// both ADCs convert on the edges of one timer, see StartSynchronizedTimer(). Without it
+// each ADC runs off its own timer and the ears sit an unknown fraction of a sample apart.
+#define ADC_SYNCHRONIZED
+
 const int readPin_adc_0 = A0; /** The pin for adc 0 */
 const int readPin_adc_1 = A2; /** The pin for adc 1 */
 const int emit_chirp_pin = 17;  /** This pin does something */
@@ -22,7 +30,9 @@ ADC *adc = new ADC();
 extern void dumpDMA_structures(DMABaseClass *dmabc);
 
 // Going to try two buffers here  using 2 dmaSettings and a DMAChannel
-const uint32_t buffer_size = 1000;
+// a frame of both halves plus its header is 4096 bytes, exactly 8 high speed USB
+// packets of 512 bytes, so frames go out as whole packets with no short packet in between
+const uint32_t buffer_size = SONAR_FRAME_SAMPLES;
 DMAMEM static volatile uint16_t __attribute__((aligned(32)))
 dma_adc_buff1[buffer_size];
 DMAMEM static volatile uint16_t __attribute__((aligned(32)))
@@ -35,11 +45,88 @@ DMAMEM static volatile uint16_t __attribute__((aligned(32)))
 dma_adc_buff2_2[buffer_size];
 AnalogBufferDMA abdma2(dma_adc_buff2_1, buffer_size, dma_adc_buff2_2, buffer_size);
 
-#define UART_BUF_SIZE buffer_size * 2
-volatile uint16_t uart_send_buffer[UART_BUF_SIZE];
+// sampling rate of each ADC, also used to turn cycle counts into sample counts
+const uint32_t adc_sample_rate = 2000000;
 
 void GetData(bool);
 
+// DMA block counts at START_LISTEN, frame sequence numbers count from here
+uint32_t seq_base_adc0 = 0;
+uint32_t seq_base_adc1 = 0;
+
+// The chirp trigger, placed to the sample by the ADC 0 DMA address when it was seen.
+// The frame of its block goes out with SONAR_FRAME_FLAG_TRIGGER.
+bool trigger_pending = false;  /** the trigger's frame has not gone out yet */
+uint32_t trigger_block = 0;    /** sequence number of the block the trigger fell in */
+uint32_t trigger_offset = 0;   /** sample of the trigger in that block */
+
+bool adc_synchronized = false; /** both ADCs run off one timer */
+
+// The chirp trigger line is latched by ChirpTriggerISR() while armed. Whoever armed it
+// gives up with an ERROR reply if the emitter has not answered in time.
+#define CHIRP_TRIGGER_TIMEOUT_MS 200
+volatile bool trigger_armed = false;       /** the next rising edge is the trigger */
+volatile bool trigger_seen = false;        /** the edge came, the values below hold it */
+volatile uint32_t trigger_taken_adc0 = 0;  /** ADC 0 sample count at the edge */
+volatile uint32_t trigger_taken_adc1 = 0;  /** ADC 1 sample count at the edge */
+volatile uint32_t trigger_cycles = 0;      /** ARM_DWT_CYCCNT at the edge */
+uint32_t trigger_armed_ms = 0;             /** millis() when the chirp was requested */
+bool listen_armed = false;                 /** START_LISTEN is waiting for the trigger */
+
+// Triggered capture: frames go into a ring instead of out over USB, and the window
+// around the chirp trigger is sent once it is complete, so a USB stall cannot cost
+// echo data and the window can be longer than USB sustains live.
+// at 2 MS/s, 8 MB of PSRAM holds about 1 s of both ears, RAM2 holds 48 ms when no PSRAM is fitted
+#define CAPTURE_EXT_FRAMES 2000
+#define CAPTURE_RAM_FRAMES 96
+EXTMEM static uint8_t capture_ext[CAPTURE_EXT_FRAMES * SONAR_FRAME_BYTES];
+DMAMEM static uint8_t __attribute__((aligned(32))) capture_ram[CAPTURE_RAM_FRAMES * SONAR_FRAME_BYTES];
+extern "C" uint8_t external_psram_size;
+uint8_t *capture_ring = capture_ram;
+uint32_t capture_ring_frames = CAPTURE_RAM_FRAMES;
+
+enum CAPTURE_STATE
+{
+  CAPTURE_IDLE,   /** streaming or doing nothing */
+  CAPTURE_PRE,    /** filling the pre-trigger window */
+  CAPTURE_ARMED,  /** chirp requested, waiting for the trigger */
+  CAPTURE_POST    /** filling the post-trigger window */
+};
+
+CAPTURE_STATE capture_state = CAPTURE_IDLE;
+uint32_t capture_pre = 0;             /** samples per ear before the trigger */
+uint32_t capture_post = 0;            /** samples per ear from the trigger on */
+uint32_t capture_frames = 0;          /** frames stored since the capture started */
+uint32_t capture_trigger = 0;         /** sample index of the trigger */
+uint32_t capture_trigger_cycles = 0;  /** ARM_DWT_CYCCNT when the trigger was seen */
+
+// Baseband streaming: each ear is bandpass filtered around the echo band and decimated
+// to complex I/Q as its DMA block comes in. A block gives buffer_size / 8 I/Q pairs, so
+// 4 blocks fill one frame and the stream shrinks 4x.
+#define IQ_BLOCKS_PER_FRAME (SONAR_DDC_DECIMATION / 2)
+bool baseband = false;
+SonarDDC ddc_adc0;
+SonarDDC ddc_adc1;
+static int16_t iq_adc0[buffer_size];
+static int16_t iq_adc1[buffer_size];
+uint32_t iq_fill = 0;        /** I/Q values per ear accumulated for the next frame */
+uint32_t iq_next_block = 0;  /** ADC 0 block the filter history runs up to */
+uint32_t iq_cycles = 0;      /** ARM_DWT_CYCCNT of the first block of the frame */
+uint32_t iq_micros = 0;      /** micros() of the first block of the frame */
+uint16_t iq_flags = 0;       /** flags of the frame being accumulated */
+
+// Packed streaming: the raw ears go out cut to the ADCs' 10 bits, see sonar_pack.hpp.
+// With delta coding each block is coded twice at most, falling back to 10 bit packing
+// when the deltas would not come out smaller.
+enum LISTENER_PACKING
+{
+  PACKING_NONE = 0,   /** 16 bit samples straight from the DMA buffers */
+  PACKING_10BIT = 1,  /** SONAR_FRAME_FLAG_PACK10 */
+  PACKING_DELTA = 2   /** SONAR_FRAME_FLAG_DELTA where it is smaller, else PACK10 */
+};
+uint8_t packing = PACKING_NONE;
+static uint8_t pack_buff[SONAR_FRAME_PAYLOAD_BYTES];
+
 // void print_debug_information();
 
 // void ProcessAnalogData(AnalogBufferDMA *pabdma, int8_t adc_num);
@@ -50,83 +137,513 @@ void GetData(bool);
 enum LISTENER_SERIAL_CMD
 {
   NONE = 0,           /** No command from host */
-  START_LISTEN = 1,   /** start recording */
+  START_LISTEN = 1,   /** request the chirp and stream from its trigger, ERROR if it never comes */
   STOP_LISTEN = 2,    /** stop recording */
   ACK_REQ = 3,        /** acknowledge request */
   ACK = 4,            /** acknowledge */
+  CAPTURE = 5,        /** triggered capture, followed by uint32 pre and post samples per ear */
+  BASEBAND = 6,       /** followed by 1 to stream complex baseband, 0 for raw samples */
+  PACKING = 7,        /** followed by a LISTENER_PACKING for raw streaming */
   ERROR = 100         /** error */
 };
 
 /**
- * @brief
- * 
- * Long description
+ * @brief Returns the capture ring slot of a frame
+ */
+uint8_t *CaptureSlot(uint32_t seq)
+{
+  return capture_ring + (seq % capture_ring_frames) * SONAR_FRAME_BYTES;
+}
+
+/**
+ * @brief Copies a frame into the capture ring
  * 
- * @param send a bool
+ * Slots of blocks that were skipped get their magic cleared, so stale frames from an
+ * earlier lap of the ring are never sent as part of this capture.
  */
-void GetData(bool send)
+void StoreFrame(const SonarFrameHeader *header, volatile uint16_t *adc0, volatile uint16_t *adc1)
 {
-  volatile uint16_t *adc0_pbuffer = abdma1.bufferLastISRFilled();
-  volatile uint16_t *adc0_end_pbuffer = abdma1.bufferCountLastISRFilled() + adc0_pbuffer;
+  for (uint32_t seq = capture_frames; seq < header->seq; seq++)
+    memset(CaptureSlot(seq), 0, sizeof(SonarFrameHeader));
 
-  volatile uint16_t *adc1_pbuffer = abdma2.bufferLastISRFilled();
-  volatile uint16_t *adc1_end_pbuffer = abdma2.bufferCountLastISRFilled() + adc1_pbuffer;
+  uint8_t *slot = CaptureSlot(header->seq);
+  memcpy(slot, header, sizeof(SonarFrameHeader));
+  slot += sizeof(SonarFrameHeader);
+  memcpy(slot, (const void *)adc0, header->count * sizeof(uint16_t));
+  memcpy(slot + header->count * sizeof(uint16_t), (const void *)adc1, header->count * sizeof(uint16_t));
 
-  if ((uint32_t)adc0_pbuffer >= 0x20200000u)
-    arm_dcache_delete((void *)adc0_pbuffer, sizeof(dma_adc_buff1));
-  if ((uint32_t)adc1_pbuffer >= 0x20200000u)
-    arm_dcache_delete((void *)adc1_pbuffer, sizeof(dma_adc_buff1));
+  capture_frames = header->seq + 1;
+}
 
-  // uart_send_buffer[0] = 0x00;
-  // uart_send_buffer[1] = ('L' << 8) | 'E';
-  // size_t index = 3;
-  size_t index = 0;
+/**
+ * @brief Samples one ADC has written since its DMA started, from the live DMA address
+ * 
+ * AnalogBufferDMA fills its first buffer while its interrupt count is even. Right after a
+ * block completes the DMA is already in the next buffer but the interrupt may not have
+ * been counted yet, so the buffer the address is in settles which block it is.
+ */
+uint32_t SamplesTaken(AnalogBufferDMA &abdma, volatile uint16_t *first, volatile uint16_t *second)
+{
+  uint32_t blocks = abdma.interruptCount();
+  uint32_t addr = (uint32_t)abdma._dmachannel_adc.TCD->DADDR;
+
+  uint32_t in_second = addr - (uint32_t)first >= buffer_size * sizeof(uint16_t);
+  uint32_t offset = (addr - (uint32_t)(in_second ? second : first)) / sizeof(uint16_t);
+  if ((blocks & 1) != in_second)
+    blocks++;
+  return blocks * buffer_size + offset;
+}
 
-  while (adc0_pbuffer < adc0_end_pbuffer)
+/**
+ * @brief Checks that both ADCs have written the same number of samples into their block
+ * 
+ * Only the counts are compared. That the two conversions of a pair happen on the same
+ * timer edge rests on the ADC_ETC routing StartSynchronizedTimer() set up, which is not
+ * checked here.
+ * 
+ * The two DMA addresses are read twice over; if a transfer landed in between the reads
+ * are repeated, so a conversion pair caught half way is not taken for skew. Whole
+ * blocks are left to the sequence numbers.
+ */
+bool EarCountsMatch()
+{
+  for (int tries = 0; tries < 8; tries++)
   {
-    uart_send_buffer[index] = *adc0_pbuffer;
-    adc0_pbuffer++;
-    index += 2;
+    uint32_t taken0 = SamplesTaken(abdma1, dma_adc_buff1, dma_adc_buff2);
+    uint32_t taken1 = SamplesTaken(abdma2, dma_adc_buff2_1, dma_adc_buff2_2);
+    if (taken0 != SamplesTaken(abdma1, dma_adc_buff1, dma_adc_buff2) ||
+        taken1 != SamplesTaken(abdma2, dma_adc_buff2_1, dma_adc_buff2_2))
+      continue;
+    return (taken1 - taken0) % buffer_size == 0;
   }
-  // uart_send_buffer[2] = index;
+  return false;
+}
+
+/**
+ * @brief Makes the block holding ADC sample counts taken0 and taken1 sequence number 0
+ * of both ears
+ * 
+ * Blocks completed before it come out with negative sequence numbers, which GetData()
+ * throws away.
+ * 
+ * @return uint32_t taken0
+ */
+uint32_t StartSequence(uint32_t taken0, uint32_t taken1)
+{
+  seq_base_adc0 = taken0 / buffer_size;
+  // the same block of ADC 1, a transfer landing between the two reads must not tip it over
+  seq_base_adc1 = (taken1 - taken0 % buffer_size + buffer_size / 2) / buffer_size;
+  trigger_pending = false;
+  return taken0;
+}
+
+/**
+ * @brief Makes the block being filled right now sequence number 0 of both ears
+ */
+uint32_t StartSequence()
+{
+  uint32_t taken0 = SamplesTaken(abdma1, dma_adc_buff1, dma_adc_buff2);
+  uint32_t taken1 = SamplesTaken(abdma2, dma_adc_buff2_1, dma_adc_buff2_2);
+  return StartSequence(taken0, taken1);
+}
+
+/**
+ * @brief Notes where the chirp trigger fell so its frame goes out flagged
+ * 
+ * @param taken the ADC 0 sample count when the trigger was seen
+ * @return uint32_t the trigger's sample index from the start of sequence number 0
+ */
+uint32_t MarkTrigger(uint32_t taken)
+{
+  trigger_block = taken / buffer_size - seq_base_adc0;
+  trigger_offset = taken % buffer_size;
+  trigger_pending = true;
+  return taken - seq_base_adc0 * buffer_size;
+}
+
+/**
+ * @brief Latches where both ADCs and the cycle counter are on the chirp trigger edge
+ * 
+ * A few dozen cycles after the edge, well under one sample, so the trigger lands on the
+ * sample that was being converted when it came.
+ */
+void ChirpTriggerISR()
+{
+  if (!trigger_armed)
+    return;
+  trigger_taken_adc0 = SamplesTaken(abdma1, dma_adc_buff1, dma_adc_buff2);
+  trigger_taken_adc1 = SamplesTaken(abdma2, dma_adc_buff2_1, dma_adc_buff2_2);
+  trigger_cycles = ARM_DWT_CYCCNT;
+  trigger_armed = false;
+  trigger_seen = true;
+}
 
-  // index = UART_BUF_SIZE/2;
-  // uart_send_buffer[index] = ('R'<<8)
-  index = 1;
-  while (adc1_pbuffer < adc1_end_pbuffer)
+/**
+ * @brief Requests the chirp and arms the trigger interrupt for its answer
+ */
+void ArmTrigger()
+{
+  trigger_seen = false;
+  trigger_armed_ms = millis();
+  trigger_armed = true;
+  digitalWriteFast(emit_chirp_pin, HIGH);
+
+  // an emitter already holding the line high sends no edge, take it as the trigger
+  noInterrupts();
+  if (digitalReadFast(itsy_emitting_chirp) == HIGH)
+    ChirpTriggerISR();
+  interrupts();
+}
+
+/**
+ * @brief True once an armed trigger has waited longer than CHIRP_TRIGGER_TIMEOUT_MS
+ */
+bool TriggerTimedOut()
+{
+  return !trigger_seen && millis() - trigger_armed_ms > CHIRP_TRIGGER_TIMEOUT_MS;
+}
+
+#ifndef ADC_ETC_TRIG_CTRL_SYNC_MODE
+#define ADC_ETC_TRIG_CTRL_SYNC_MODE ((uint32_t)(1 << 16))
+#endif
+
+/**
+ * @brief Routes an XBAR1 input to an output
+ */
+void XbarConnect(unsigned int input, unsigned int output)
+{
+  volatile uint16_t *xbar = &XBARA1_SEL0 + (output / 2);
+  if (output & 1)
+    *xbar = (*xbar & 0x00FF) | (input << 8);
+  else
+    *xbar = (*xbar & 0xFF00) | input;
+}
+
+/**
+ * @brief Starts both ADCs converting on the edges of one QuadTimer
+ * 
+ * Instead of a timer per ADC, TMR4 channel 0 drives ADC_ETC trigger 0 through the XBAR,
+ * and trigger 0 runs in sync mode, which fires trigger 4, the ADC 1 chain, on the same
+ * edge. Both ADCs have the same settings, so their conversions take equally long and
+ * their DMA requests come in pairs. EarCountsMatch() catches an ear that lost a transfer;
+ * the timing of the two conversions is not measured.
+ * 
+ * Call once startSingleRead() has picked each ADC's pin and DMA is running. The timer
+ * starts last, so its first edge finds both chains armed.
+ */
+void StartSynchronizedTimer(uint32_t freq)
+{
+  // let the conversions startSingleRead() started land, one sample in each ear, before
+  // HC0 is rewritten and would abort them
+  delayMicroseconds(10);
+
+  uint32_t ch0 = ADC1_HC0 & 0x1F;
+  uint32_t ch1 = ADC2_HC0 & 0x1F;
+
+  // conversions are started by ADC_ETC from here on
+  ADC1_CFG |= ADC_CFG_ADTRG;
+  ADC2_CFG |= ADC_CFG_ADTRG;
+  ADC1_HC0 = ADC_HC_ADCH(16);
+  ADC2_HC0 = ADC_HC_ADCH(16);
+
+  IMXRT_ADC_ETC.CTRL &= ~ADC_ETC_CTRL_SOFTRST;
+  IMXRT_ADC_ETC.CTRL |= ADC_ETC_CTRL_TSC_BYPASS | ADC_ETC_CTRL_DMA_MODE_SEL | ADC_ETC_CTRL_TRIG_ENABLE(0x11);
+  IMXRT_ADC_ETC.TRIG[0].CTRL = ADC_ETC_TRIG_CTRL_TRIG_CHAIN(0) | ADC_ETC_TRIG_CTRL_SYNC_MODE;
+  IMXRT_ADC_ETC.TRIG[0].CHAIN_1_0 = ADC_ETC_TRIG_CHAIN_HWTS0(1) | ADC_ETC_TRIG_CHAIN_CSEL0(ch0) | ADC_ETC_TRIG_CHAIN_B2B0;
+  IMXRT_ADC_ETC.TRIG[4].CTRL = ADC_ETC_TRIG_CTRL_TRIG_CHAIN(0);
+  IMXRT_ADC_ETC.TRIG[4].CHAIN_1_0 = ADC_ETC_TRIG_CHAIN_HWTS0(1) | ADC_ETC_TRIG_CHAIN_CSEL0(ch1) | ADC_ETC_TRIG_CHAIN_B2B0;
+
+  CCM_CCGR2 |= CCM_CCGR2_XBAR1(CCM_CCGR_ON);
+  CCM_CCGR6 |= CCM_CCGR6_QTIMER4(CCM_CCGR_ON);
+  XbarConnect(XBARA1_IN_QTIMER4_TIMER0, XBARA1_OUT_ADC_ETC_TRIG00);
+
+  // the output toggles on alternate compares, high for COMP1 + 1 ticks then low for
+  // COMP2 + 1, so one period is exactly F_BUS_ACTUAL / freq ticks
+  uint32_t ticks = F_BUS_ACTUAL / freq;
+  TMR4_CTRL0 = 0;
+  TMR4_CNTR0 = 0;
+  TMR4_LOAD0 = 0;
+  TMR4_COMP10 = ticks / 2 - 1;
+  TMR4_CMPLD10 = ticks / 2 - 1;
+  TMR4_COMP20 = ticks - ticks / 2 - 1;
+  TMR4_CMPLD20 = ticks - ticks / 2 - 1;
+  TMR4_CSCTRL0 = 0;
+  TMR4_SCTRL0 = TMR_SCTRL_OEN;
+  TMR4_CTRL0 = TMR_CTRL_CM(1) | TMR_CTRL_PCS(8) | TMR_CTRL_LENGTH | TMR_CTRL_OUTMODE(4);
+
+  adc_synchronized = true;
+}
+
+/**
+ * @brief Sends the capture window: a SonarCaptureHeader, then the frames holding it
+ */
+void SendCapture()
+{
+  uint32_t start = capture_trigger - capture_pre;
+  uint32_t end = capture_trigger + capture_post;
+
+  SonarCaptureHeader header;
+  header.magic = SONAR_CAPTURE_MAGIC;
+  header.first_seq = start / buffer_size;
+  header.num_frames = (end + buffer_size - 1) / buffer_size - header.first_seq;
+  header.window_offset = start - header.first_seq * buffer_size;
+  header.pre_samples = capture_pre;
+  header.post_samples = capture_post;
+  header.trigger_cycles = capture_trigger_cycles;
+  header.crc = sonarCaptureCRC(&header);
+
+  Serial.write((const uint8_t *)&header, sizeof(header));
+  for (uint32_t i = 0; i < header.num_frames; i++)
+    Serial.write(CaptureSlot(header.first_seq + i), SONAR_FRAME_BYTES);
+  Serial.send_now();
+}
+
+/**
+ * @brief Moves a triggered capture along, called every loop
+ * 
+ * The chirp is only requested once the pre-trigger window is full. The trigger is
+ * placed by the ADC 0 DMA address latched in ChirpTriggerISR(), so it is exact to the
+ * sample that was being converted then. If the emitter never answers the capture is
+ * dropped with an ERROR reply.
+ */
+void RunCapture()
+{
+  switch (capture_state)
   {
-    uart_send_buffer[index] = *adc1_pbuffer;
-    adc1_pbuffer++;
-    index += 2;
+  case CAPTURE_PRE:
+    if ((uint64_t)capture_frames * buffer_size >= capture_pre)
+    {
+      ArmTrigger();
+      capture_state = CAPTURE_ARMED;
+    }
+    break;
+  case CAPTURE_ARMED:
+    if (trigger_seen)
+    {
+      trigger_seen = false;
+      capture_trigger_cycles = trigger_cycles;
+      capture_trigger = MarkTrigger(trigger_taken_adc0);
+      capture_state = CAPTURE_POST;
+    }
+    else if (TriggerTimedOut())
+    {
+      trigger_armed = false;
+      capture_state = CAPTURE_IDLE;
+      digitalWriteFast(emit_chirp_pin, LOW);
+      digitalWriteFast(LED_BUILTIN, LOW);
+      Serial.write(LISTENER_SERIAL_CMD::ERROR);
+      Serial.send_now();
+    }
+    break;
+  case CAPTURE_POST:
+    if ((uint64_t)capture_frames * buffer_size >= (uint64_t)capture_trigger + capture_post)
+    {
+      capture_state = CAPTURE_IDLE;
+      digitalWriteFast(emit_chirp_pin, LOW);
+      SendCapture();
+      digitalWriteFast(LED_BUILTIN, LOW);
+    }
+    break;
+  default:
+    break;
   }
+}
 
-  index = UART_BUF_SIZE;
+/**
+ * @brief Clears the baseband filters and the frame being accumulated
+ */
+void ResetBaseband()
+{
+  ddc_adc0.reset();
+  ddc_adc1.reset();
+  iq_fill = 0;
+  iq_next_block = 0;
+}
 
-  // Serial.println(abdma1.interruptDeltaTime());
+/**
+ * @brief Packs both ears into pack_buff and sends them behind the header
+ *
+ * @param header filled in except for the packing flag, payload and crc
+ */
+void SendPacked(SonarFrameHeader *header, const uint16_t *adc0, const uint16_t *adc1, uint16_t count)
+{
+  size_t budget = SONAR_PACK10_BYTES(count);
+  size_t len = 0;
+  if (packing == PACKING_DELTA)
+  {
+    size_t len0 = sonarDeltaEncode(adc0, count, pack_buff, budget);
+    size_t len1 = len0 ? sonarDeltaEncode(adc1, count, pack_buff + len0, budget) : 0;
+    if (len1)
+    {
+      len = len0 + len1;
+      header->flags |= SONAR_FRAME_FLAG_DELTA;
+    }
+  }
+  if (len == 0)
+  {
+    len = sonarPack10(adc0, count, pack_buff);
+    len += sonarPack10(adc1, count, pack_buff + len);
+    header->flags |= SONAR_FRAME_FLAG_PACK10;
+  }
 
-  abdma1.clearInterrupt();
-  abdma2.clearInterrupt();
+  header->payload = len;
+  header->crc = sonarPackedFrameCRC(header, pack_buff);
+  Serial.write((const uint8_t *)header, sizeof(*header));
+  Serial.write(pack_buff, len);
+}
 
-  // send data
-  if (!send)
+/**
+ * @brief Filters the DMA halves down to baseband and sends a frame once 4 blocks filled it
+ * 
+ * Frame n holds blocks 4n to 4n + 3, so the frame sequence number keeps the time base.
+ * A skipped block breaks the filter history: the filters start over and the blocks up to
+ * the next frame boundary are dropped, so the host sees whole missing frames.
+ * 
+ * About 65k multiply-adds per block of both ears, well inside the 508 us a block lasts.
+ * 
+ * The frame is only flagged SONAR_FRAME_FLAG_SAME_COUNT if all its blocks were, and the
+ * trigger moves to the I/Q pair whose window starts at or before it.
+ * 
+ * @param flags SONAR_FRAME_FLAG_SAME_COUNT if both ears' sample counts matched for the block
+ * @param trigger true if the chirp trigger fell in this block
+ */
+void SendBaseband(uint32_t block, uint32_t block_adc1, volatile uint16_t *adc0, volatile uint16_t *adc1, uint16_t count,
+                  uint16_t flags, bool trigger)
+{
+  if (block != iq_next_block)
   {
-    // clear flags
-    Serial.flush();
-    return;
+    ddc_adc0.reset();
+    ddc_adc1.reset();
+    iq_fill = 0;
   }
+  iq_next_block = block + 1;
 
-  for (size_t i = 0; i < index; i++)
+  if (iq_fill == 0)
   {
-    Serial.write(uart_send_buffer[i] & 0xff);
-    Serial.write(uart_send_buffer[i] >> 8 & 0xff);
-    if (i % 64 == 0)
+    if (block % IQ_BLOCKS_PER_FRAME != 0)
+      return;
+    iq_cycles = ARM_DWT_CYCCNT;
+    iq_micros = micros();
+    iq_flags = SONAR_FRAME_FLAG_IQ | SONAR_FRAME_FLAG_SAME_COUNT;
+  }
+
+  iq_flags &= flags | ~SONAR_FRAME_FLAG_SAME_COUNT;
+  if (trigger)
+    iq_flags |= sonarFrameTriggerFlags(iq_fill + 2 * (trigger_offset / SONAR_DDC_DECIMATION));
+
+  size_t pairs = ddc_adc0.process((const uint16_t *)adc0, count, iq_adc0 + iq_fill);
+  ddc_adc1.process((const uint16_t *)adc1, count, iq_adc1 + iq_fill);
+  iq_fill += 2 * pairs;
+  if (iq_fill < buffer_size)
+    return;
+
+  SonarFrameHeader header;
+  header.magic = SONAR_FRAME_MAGIC;
+  header.seq = block / IQ_BLOCKS_PER_FRAME;
+  header.seq_adc1 = block_adc1 / IQ_BLOCKS_PER_FRAME;
+  header.cycles = iq_cycles;
+  header.micros = iq_micros;
+  header.count = iq_fill;
+  header.version = SONAR_FRAME_VERSION;
+  header.flags = iq_flags;
+  header.payload = 0;
+  header.crc = sonarFrameCRC(&header, iq_adc0, iq_adc1);
+
+  Serial.write((const uint8_t *)&header, sizeof(header));
+  Serial.write((const uint8_t *)iq_adc0, iq_fill * sizeof(int16_t));
+  Serial.write((const uint8_t *)iq_adc1, iq_fill * sizeof(int16_t));
+  iq_fill = 0;
+}
+
+/**
+ * @brief Sends the DMA halves both ADCs just filled as one frame
+ * 
+ * A frame is a SonarFrameHeader followed by buffer_size samples of ADC 0 and then
+ * buffer_size samples of ADC 1, little endian uint16, see sonar_frame.hpp. Each half is
+ * handed to the USB stack in one write straight from the DMA buffer, which fills whole
+ * 512 byte packets and lets them go out back to back. The USB stack sends full packets
+ * on its own, so there is no send_now() or flush() per block.
+ * 
+ * The sequence numbers come from the DMA interrupt counts, so a block this loop was too
+ * late to pick up shows up on the host as a gap. With the ADCs synchronized each frame
+ * is also checked for both ears' DMA streams being at the same sample count, and the
+ * frame the chirp trigger fell in carries its sample offset.
+ * 
+ * During a triggered capture the frame is stored in the capture ring instead. With
+ * baseband on, a stream goes through SendBaseband(), with packing on through SendPacked();
+ * captures stay raw.
+ * 
+ * @param send false to only acknowledge the halves while not listening
+ */
+void GetData(bool send)
+{
+  volatile uint16_t *adc0_pbuffer = abdma1.bufferLastISRFilled();
+  uint16_t adc0_count = abdma1.bufferCountLastISRFilled();
+
+  volatile uint16_t *adc1_pbuffer = abdma2.bufferLastISRFilled();
+  uint16_t adc1_count = abdma2.bufferCountLastISRFilled();
+
+  if (send || capture_state != CAPTURE_IDLE)
+  {
+    if ((uint32_t)adc0_pbuffer >= 0x20200000u)
+      arm_dcache_delete((void *)adc0_pbuffer, sizeof(dma_adc_buff1));
+    if ((uint32_t)adc1_pbuffer >= 0x20200000u)
+      arm_dcache_delete((void *)adc1_pbuffer, sizeof(dma_adc_buff1));
+
+    uint32_t seq = abdma1.interruptCount() - seq_base_adc0 - 1;
+    uint32_t seq_adc1 = abdma2.interruptCount() - seq_base_adc1 - 1;
+
+    // finished before sequence number 0, not part of this stream
+    if ((int32_t)seq < 0)
     {
-      Serial.send_now();
-      Serial.flush();
+      abdma1.clearInterrupt();
+      abdma2.clearInterrupt();
+      return;
+    }
+
+    uint16_t flags = adc_synchronized && seq == seq_adc1 && EarCountsMatch() ? SONAR_FRAME_FLAG_SAME_COUNT : 0;
+    bool trigger = trigger_pending && seq == trigger_block;
+    if (trigger_pending && (int32_t)(seq - trigger_block) >= 0)
+      trigger_pending = false;
+
+    if (send && baseband)
+    {
+      SendBaseband(seq, seq_adc1, adc0_pbuffer, adc1_pbuffer, adc0_count, flags, trigger);
+    }
+    else
+    {
+      SonarFrameHeader header;
+      header.magic = SONAR_FRAME_MAGIC;
+      header.seq = seq;
+      header.seq_adc1 = seq_adc1;
+      header.cycles = ARM_DWT_CYCCNT;
+      header.micros = micros();
+      header.count = adc0_count;
+      header.version = SONAR_FRAME_VERSION;
+      header.flags = flags | (trigger ? sonarFrameTriggerFlags(trigger_offset) : 0);
+      header.payload = 0;
+
+      if (send && packing != PACKING_NONE)
+      {
+        SendPacked(&header, (const uint16_t *)adc0_pbuffer, (const uint16_t *)adc1_pbuffer, adc0_count);
+      }
+      else if (send)
+      {
+        header.crc = sonarFrameCRC(&header, (const void *)adc0_pbuffer, (const void *)adc1_pbuffer);
+        Serial.write((const uint8_t *)&header, sizeof(header));
+        Serial.write((const uint8_t *)adc0_pbuffer, adc0_count * sizeof(uint16_t));
+        Serial.write((const uint8_t *)adc1_pbuffer, adc1_count * sizeof(uint16_t));
+      }
+      else
+      {
+        header.crc = sonarFrameCRC(&header, (const void *)adc0_pbuffer, (const void *)adc1_pbuffer);
+        StoreFrame(&header, adc0_pbuffer, adc1_pbuffer);
+      }
     }
   }
-  Serial.send_now();
-  Serial.flush();
+
+  abdma1.clearInterrupt();
+  abdma2.clearInterrupt();
 }
 
 void setup()
@@ -138,6 +655,17 @@ void setup()
   pinMode(readPin_adc_1, INPUT_DISABLE);
   pinMode(emit_chirp_pin,OUTPUT);
   pinMode(itsy_emitting_chirp,INPUT_PULLDOWN);
+  attachInterrupt(digitalPinToInterrupt(itsy_emitting_chirp), ChirpTriggerISR, RISING);
+
+  // capture into PSRAM when it is fitted
+  if (external_psram_size > 0)
+  {
+    capture_ring = capture_ext;
+    capture_ring_frames = CAPTURE_EXT_FRAMES;
+  }
+
+  ddc_adc0.init(adc_sample_rate);
+  ddc_adc1.init(adc_sample_rate);
   
 
   // Setup both ADCs
@@ -160,19 +688,23 @@ void setup()
 
   abdma2.init(adc, ADC_1 /*, DMAMUX_SOURCE_ADC_ETC*/);
 
+#ifdef ADC_SYNCHRONIZED
+  adc->adc0->startSingleRead(readPin_adc_0);
+  adc->adc1->startSingleRead(readPin_adc_1);
+  StartSynchronizedTimer(adc_sample_rate);
+#else
   // Start the dma operation..
   adc->adc0->startSingleRead(
       readPin_adc_0);             // call this to setup everything before the Timer starts,
                                   // differential is also possible
-  adc->adc0->startTimer(2000000); // frequency in Hz
+  adc->adc0->startTimer(adc_sample_rate); // frequency in Hz
 
   // // Start the dma operation..
   adc->adc1->startSingleRead(
       readPin_adc_1); // call this to setup everything before the Timer starts,
   //                                // differential is also possible
-  adc->adc1->startTimer(2000000); // frequency in Hz
-
-  // adc->startSynchronizedSingleRead(readPin_adc_0,readPin_adc_1);
+  adc->adc1->startTimer(adc_sample_rate); // frequency in Hz
+#endif
 
   digitalWriteFast(LED_BUILTIN, LOW);
 }
@@ -183,8 +715,40 @@ unsigned long sendStartTime = 0;
 uint16_t times_to_send = 0;
 volatile uint16_t times_sent = 0;
 
+/**
+ * @brief Starts the stream once START_LISTEN's trigger is in, or gives up on it
+ * 
+ * Frame 0 is the block the trigger fell in. This runs ahead of GetData() in the loop, so
+ * that block has not been picked up yet when the stream starts, and the loop keeps
+ * serving commands while the emitter gets going.
+ */
+void RunListen()
+{
+  if (!listen_armed)
+    return;
+
+  if (trigger_seen)
+  {
+    trigger_seen = false;
+    listen_armed = false;
+    MarkTrigger(StartSequence(trigger_taken_adc0, trigger_taken_adc1));
+    ResetBaseband();
+    sendData = true;
+  }
+  else if (TriggerTimedOut())
+  {
+    trigger_armed = false;
+    listen_armed = false;
+    digitalWriteFast(emit_chirp_pin, LOW);
+    digitalWriteFast(LED_BUILTIN, LOW);
+    Serial.write(LISTENER_SERIAL_CMD::ERROR);
+    Serial.send_now();
+  }
+}
+
 void loop()
 {
+  RunListen();
 
   // Maybe only when both have triggered?
   if (abdma1.interrupted() && abdma2.interrupted())
@@ -192,6 +756,8 @@ void loop()
     GetData(sendData);
   }
 
+  RunCapture();
+
 
   if (Serial.available())
   {
@@ -210,6 +776,9 @@ void loop()
       Serial.send_now();
       Serial.flush();
       sendData = false;
+      capture_state = CAPTURE_IDLE;
+      trigger_armed = false;
+      listen_armed = false;
       digitalWriteFast(emit_chirp_pin,LOW);
       digitalWriteFast(LED_BUILTIN, LOW);
       abdma1.clearInterrupt();
@@ -219,29 +788,73 @@ void loop()
     break;
     case LISTENER_SERIAL_CMD::START_LISTEN:
     {
-      sendData = true;
+      // the stream starts in RunListen() once the chirp trigger is in, frame 0 holds it
+      sendData = false;
+      capture_state = CAPTURE_IDLE;
       digitalWriteFast(LED_BUILTIN, HIGH);
-      digitalWriteFast(emit_chirp_pin,HIGH);
-
+      listen_armed = true;
+      ArmTrigger();
+      sendStartTime = millis();
+    }
+    break;
+    case LISTENER_SERIAL_CMD::CAPTURE:
+    {
+      // pre and post samples per ear, the whole window plus partial frames at either end
+      // has to fit in the ring
+      uint32_t window[2];
+      if (Serial.readBytes((char *)window, sizeof(window)) != sizeof(window) ||
+          (uint64_t)window[0] + window[1] + 3 * buffer_size > (uint64_t)capture_ring_frames * buffer_size)
+      {
+        Serial.write(LISTENER_SERIAL_CMD::ERROR);
+        Serial.send_now();
+        break;
+      }
 
+      sendData = false;
+      listen_armed = false;
+      capture_pre = window[0];
+      capture_post = window[1];
+      capture_frames = 0;
+      digitalWriteFast(LED_BUILTIN, HIGH);
 
-      while (true)
+      StartSequence();
+      capture_state = CAPTURE_PRE;
+    }
+    break;
+    case LISTENER_SERIAL_CMD::BASEBAND:
+    {
+      uint8_t on;
+      if (Serial.readBytes((char *)&on, 1) != 1)
       {
-        if(digitalReadFast(itsy_emitting_chirp) == HIGH){
-          break;
-        }
+        Serial.write(LISTENER_SERIAL_CMD::ERROR);
+        Serial.send_now();
+        break;
       }
-      
-
-      abdma1.clearInterrupt();
-      abdma2.clearInterrupt();
-      // Serial.flush();
-      sendStartTime = millis();
+      baseband = on != 0;
+      Serial.write(LISTENER_SERIAL_CMD::ACK);
+      Serial.send_now();
+    }
+    break;
+    case LISTENER_SERIAL_CMD::PACKING:
+    {
+      uint8_t mode;
+      if (Serial.readBytes((char *)&mode, 1) != 1 || mode > PACKING_DELTA)
+      {
+        Serial.write(LISTENER_SERIAL_CMD::ERROR);
+        Serial.send_now();
+        break;
+      }
+      packing = mode;
+      Serial.write(LISTENER_SERIAL_CMD::ACK);
+      Serial.send_now();
     }
     break;
     case LISTENER_SERIAL_CMD::STOP_LISTEN:
     {
       sendData = false;
+      capture_state = CAPTURE_IDLE;
+      trigger_armed = false;
+      listen_armed = false;
       digitalWriteFast(LED_BUILTIN, LOW);
       digitalWriteFast(emit_chirp_pin,LOW);
       abdma1.clearInterrupt();
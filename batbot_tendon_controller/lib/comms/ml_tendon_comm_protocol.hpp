@@ -39,11 +39,30 @@
  */
 #define TENDON_CONTROL_PKT_NUM_CRC_BYTES 2
 
+/**
+ * @brief Number of bytes used for the sequence number
+ */
+#define TENDON_CONTROL_PKT_NUM_SEQ_BYTES 1
+
+/**
+ * @brief Number of bytes counted by the length field on top of the params
+ */
+#define TENDON_CONTROL_PKT_LEN_OVERHEAD  (TENDON_CONTROL_PKT_NUM_SEQ_BYTES + \
+                                          TENDON_CONTROL_PKT_NUM_ID_BYTES + \
+                                          TENDON_CONTROL_PKT_NUM_OPCODE_BYTES + \
+                                          TENDON_CONTROL_PKT_NUM_CRC_BYTES)
+
+/**
+ * @brief Number of params in a packet with the given length field
+ */
+#define TENDON_CONTROL_PKT_NUM_PARAMS(len) ((len) - TENDON_CONTROL_PKT_LEN_OVERHEAD)
+
 /**
  * @brief Maximum number of bytes in the parameters array
  */
 #define TENDON_CONTROL_PKT_MAX_NUM_PARAM_BYTES    TENDON_CONTROL_PKT_MAX_NUM_BYTES_IN_FRAME - \
                                                     TENDON_CONTROL_PKT_NUM_HEADER_BYTES - \
+                                                    TENDON_CONTROL_PKT_NUM_SEQ_BYTES - \
                                                     TENDON_CONTROL_PKT_NUM_OPCODE_BYTES - \
                                                     TENDON_CONTROL_PKT_NUM_ID_BYTES - \
                                                     TENDON_CONTROL_PKT_NUM_LEN_BYTES
@@ -145,12 +164,14 @@ typedef enum {
  * This struct defines the data packets defined by the tendon control communication protocol
  * The structure of a packet is as follows:
  * 
- * [ HEADER 1 ][ HEADER 2 ][ LENGTH ][ MOTOR ID ][ OPCODE ][ PARAMS ][ CRC HIGH ][ CRC LOW ]
+ * [ HEADER 1 ][ HEADER 2 ][ LENGTH ][ SEQ ][ MOTOR ID ][ OPCODE ][ PARAMS ][ CRC HIGH ][ CRC LOW ]
  * 
  * HEADER 1+2: Used as a packet delimiter to signifify the start of a new packet. Always the bytes 0xFF 0x00.
  * LENGTH: 8-bit integer used to specify the length of the packet. The header and length fields
  *          are not taken into account when calculating length, so the length is calculated as
- *          4 + number of params (4 comes from opcode, params, and both CRC fields).
+ *          5 + number of params (5 comes from seq, motor id, opcode, and both CRC fields).
+ * SEQ: 8-bit sequence number chosen by the host. The response to a request echoes its
+ *         sequence number, so several requests can be outstanding at once.
  * MOTOR ID: The id of the motor to read/write. Motors are assumed to be 1 indexed, so 0x00
  *            is used to read/write all motors.
  * OPCODE: 8-bit integer used to command the tendon controller to perform a certain action
@@ -173,6 +194,7 @@ typedef struct
     struct {
       uint8_t header[TENDON_CONTROL_PKT_NUM_HEADER_BYTES];
       uint8_t len;
+      uint8_t seq;
       uint8_t motorId;
       uint8_t opcode;
       uint8_t pkt_params[TENDON_CONTROL_PKT_MAX_NUM_PARAM_BYTES];
@@ -210,7 +232,7 @@ typedef void (TendonInstructionHandler)(TendonControl_packet_handler_t*, TendonC
  * @param data_blk_size The number of bytes in the data
  * @return The 16-bit CRC as a uint16_t 
  */
-uint16_t updateCRC(uint16_t crc_accum, uint8_t *data, uint16_t data_blk_size);
+uint16_t updateCRC(uint16_t crc_accum, const uint8_t *data, uint16_t data_blk_size);
 
 /**
  * @brief This function parses an rx packet from a stream of bytes and validates CRC
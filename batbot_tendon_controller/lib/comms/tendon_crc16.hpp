@@ -0,0 +1,115 @@
+/**
+ * @file
+ * @brief CRC-16 used by the tendon control protocol, shared by the firmware and the host
+ *
+ * Polynomial 0x8005, initial value 0, MSB first, no final xor (CRC-16/BUYPASS). Every
+ * table is generated by the compiler from crc_tables.hpp, so there is nothing hand-pasted
+ * to drift out of sync. The implementations all give identical results and differ only in table size
+ * and speed:
+ *
+ * - tendonCRC16Nibble: 16 entry table (32 bytes), two lookups per byte. For the Cortex-M4,
+ *   where frames are at most 32 bytes and the table can sit next to the code.
+ * - tendonCRC16: the classic 256 entry table, one lookup per byte.
+ * - tendonCRC16Slice4/8: 4 or 8 tables of 256 entries, 4 or 8 bytes per iteration with
+ *   independent lookups. For the host.
+ *
+ * Written against C++11 so it also builds with the Arduino toolchains.
+ */
+#ifndef TENDON_CRC16_HPP
+#define TENDON_CRC16_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "crc_tables.hpp"
+
+/**
+ * @brief The generator polynomial
+ */
+#define TENDON_CRC16_POLY 0x8005
+
+namespace tendon_crc16_detail {
+
+typedef crc_tables::CrcTables<uint16_t, TENDON_CRC16_POLY, false> Tables;
+
+template<int K> inline const uint16_t* slice() { return Tables::slice<K>(); }
+
+} // namespace tendon_crc16_detail
+
+/**
+ * @brief CRC-16 with a 16 entry table, for memory constrained targets
+ *
+ * @param crc_accum Used to input running crc
+ * @param data The data to check
+ * @param data_blk_size The number of bytes in the data
+ * @return The 16-bit CRC as a uint16_t
+ */
+inline uint16_t tendonCRC16Nibble(uint16_t crc_accum, const uint8_t* data, uint16_t data_blk_size)
+{
+  const uint16_t* t = tendon_crc16_detail::Tables::nibble();
+
+  for (uint16_t j = 0; j < data_blk_size; j++)
+  {
+    crc_accum = (uint16_t)(crc_accum << 4) ^ t[((crc_accum >> 12) ^ (data[j] >> 4)) & 0x0F];
+    crc_accum = (uint16_t)(crc_accum << 4) ^ t[((crc_accum >> 12) ^ data[j]) & 0x0F];
+  }
+  return crc_accum;
+}
+
+/**
+ * @brief CRC-16 with a 256 entry table, one byte per iteration
+ */
+inline uint16_t tendonCRC16(uint16_t crc_accum, const uint8_t* data, uint16_t data_blk_size)
+{
+  const uint16_t* t0 = tendon_crc16_detail::slice<0>();
+
+  for (uint16_t j = 0; j < data_blk_size; j++)
+  {
+    crc_accum = (uint16_t)(crc_accum << 8) ^ t0[((crc_accum >> 8) ^ data[j]) & 0xFF];
+  }
+  return crc_accum;
+}
+
+/**
+ * @brief CRC-16 using slicing-by-4, four bytes per iteration
+ */
+inline uint16_t tendonCRC16Slice4(uint16_t crc_accum, const uint8_t* data, uint16_t data_blk_size)
+{
+  using tendon_crc16_detail::slice;
+  const uint16_t* t0 = slice<0>();
+  const uint16_t* t1 = slice<1>();
+  const uint16_t* t2 = slice<2>();
+  const uint16_t* t3 = slice<3>();
+
+  for (; data_blk_size >= 4; data_blk_size -= 4, data += 4)
+  {
+    crc_accum = t3[(crc_accum >> 8) ^ data[0]] ^ t2[(crc_accum & 0xFF) ^ data[1]] ^
+                t1[data[2]] ^ t0[data[3]];
+  }
+  return tendonCRC16(crc_accum, data, data_blk_size);
+}
+
+/**
+ * @brief CRC-16 using slicing-by-8, eight bytes per iteration
+ */
+inline uint16_t tendonCRC16Slice8(uint16_t crc_accum, const uint8_t* data, uint16_t data_blk_size)
+{
+  using tendon_crc16_detail::slice;
+  const uint16_t* t0 = slice<0>();
+  const uint16_t* t1 = slice<1>();
+  const uint16_t* t2 = slice<2>();
+  const uint16_t* t3 = slice<3>();
+  const uint16_t* t4 = slice<4>();
+  const uint16_t* t5 = slice<5>();
+  const uint16_t* t6 = slice<6>();
+  const uint16_t* t7 = slice<7>();
+
+  for (; data_blk_size >= 8; data_blk_size -= 8, data += 8)
+  {
+    crc_accum = t7[(crc_accum >> 8) ^ data[0]] ^ t6[(crc_accum & 0xFF) ^ data[1]] ^
+                t5[data[2]] ^ t4[data[3]] ^ t3[data[4]] ^ t2[data[5]] ^ t1[data[6]] ^ t0[data[7]];
+  }
+  return tendonCRC16Slice4(crc_accum, data, data_blk_size);
+}
+
+#endif
@@ -0,0 +1,154 @@
+#include "tendon_frame_decoder.hpp"
+
+#include <string.h>
+
+static inline bool validLenField(uint8_t len)
+{
+  return len >= TENDON_FRAME_MIN_LEN_FIELD && len + TENDON_FRAME_PREFIX_LEN <= TENDON_FRAME_MAX_FRAME_LEN;
+}
+
+static inline bool validCRC(TendonControl_frame_decoder_t* dec, const uint8_t* frame, size_t frame_len)
+{
+  uint16_t crc = ((uint16_t)frame[frame_len - 2] << 8) | frame[frame_len - 1];
+  return dec->crc(0, frame, frame_len - 2) == crc;
+}
+
+static void dropBuffered(TendonControl_frame_decoder_t* dec, uint8_t n)
+{
+  memmove(dec->buf, dec->buf + n, dec->buf_len - n);
+  dec->buf_len -= n;
+}
+
+/**
+ * @brief Drops bytes from the front of the buffer until it holds the start of a plausible frame
+ *
+ * @return true if the buffer starts with a complete, valid frame
+ */
+static bool checkBuffered(TendonControl_frame_decoder_t* dec)
+{
+  while (dec->buf_len > 0) {
+    uint8_t* b = dec->buf;
+    bool bad = false;
+
+    if (b[0] != TENDON_FRAME_HEADER_1) {
+      bad = true;
+    } else if (dec->buf_len >= 2 && b[1] != TENDON_FRAME_HEADER_2) {
+      bad = true;
+    } else if (dec->buf_len >= 3 && !validLenField(b[2])) {
+      dec->len_errors++;
+      bad = true;
+    } else if (dec->buf_len >= 3 && dec->buf_len >= b[2] + TENDON_FRAME_PREFIX_LEN) {
+      if (validCRC(dec, b, b[2] + TENDON_FRAME_PREFIX_LEN))
+        return true;
+      dec->crc_errors++;
+      bad = true;
+    }
+
+    if (!bad)
+      return false;
+
+    // skip straight to the next candidate header
+    uint8_t skip = 1;
+    while (skip < dec->buf_len && dec->buf[skip] != TENDON_FRAME_HEADER_1)
+      skip++;
+    dec->bytes_dropped += skip;
+    dropBuffered(dec, skip);
+  }
+  return false;
+}
+
+void tendonDecoderInit(TendonControl_frame_decoder_t* dec, TendonFrameCRCFunction* crc)
+{
+  memset(dec, 0, sizeof *dec);
+  dec->crc = crc;
+}
+
+void tendonDecoderReset(TendonControl_frame_decoder_t* dec)
+{
+  dec->buf_len = 0;
+  dec->emitted_len = 0;
+}
+
+size_t tendonDecoderFeed(TendonControl_frame_decoder_t* dec, const uint8_t* data, size_t len,
+                         const uint8_t** frame, size_t* frame_len)
+{
+  size_t i = 0;
+
+  *frame = NULL;
+  *frame_len = 0;
+
+  if (dec->emitted_len > 0) {
+    dropBuffered(dec, dec->emitted_len);
+    dec->emitted_len = 0;
+  }
+
+  // finish whatever frame was left over from earlier chunks, taking only the bytes it needs
+  while (dec->buf_len > 0) {
+    if (checkBuffered(dec)) {
+      dec->emitted_len = dec->buf[2] + TENDON_FRAME_PREFIX_LEN;
+      dec->frames++;
+      *frame = dec->buf;
+      *frame_len = dec->emitted_len;
+      return i;
+    }
+    if (dec->buf_len == 0 || i == len)
+      break;
+
+    size_t need = dec->buf_len < TENDON_FRAME_PREFIX_LEN ?
+      TENDON_FRAME_PREFIX_LEN - dec->buf_len :
+      dec->buf[2] + TENDON_FRAME_PREFIX_LEN - dec->buf_len;
+    if (need > len - i)
+      need = len - i;
+
+    memcpy(dec->buf + dec->buf_len, data + i, need);
+    dec->buf_len += need;
+    i += need;
+  }
+
+  if (dec->buf_len > 0)
+    return i;
+
+  // nothing buffered, look for frames directly in the caller's bytes
+  while (i < len) {
+    const uint8_t* h = (const uint8_t*)memchr(data + i, TENDON_FRAME_HEADER_1, len - i);
+    if (h == NULL) {
+      dec->bytes_dropped += len - i;
+      return len;
+    }
+    dec->bytes_dropped += (h - data) - i;
+    i = h - data;
+
+    size_t avail = len - i;
+    if (avail >= 2 && h[1] != TENDON_FRAME_HEADER_2) {
+      dec->bytes_dropped++;
+      i++;
+      continue;
+    }
+    if (avail >= 3 && !validLenField(h[2])) {
+      dec->len_errors++;
+      dec->bytes_dropped++;
+      i++;
+      continue;
+    }
+    if (avail >= 3 && avail >= (size_t)h[2] + TENDON_FRAME_PREFIX_LEN) {
+      size_t flen = h[2] + TENDON_FRAME_PREFIX_LEN;
+      if (validCRC(dec, h, flen)) {
+        dec->frames++;
+        *frame = h;
+        *frame_len = flen;
+        return i + flen;
+      }
+      dec->crc_errors++;
+      dec->bytes_dropped++;
+      i++;
+      continue;
+    }
+
+    // the start of a frame that the next chunk completes, at most one frame long
+    memcpy(dec->buf, h, avail);
+    dec->buf_len = avail;
+    return len;
+  }
+
+  return len;
+}
@@ -0,0 +1,109 @@
+/**
+ * @file
+ * @brief Streaming decoder for tendon control frames
+ *
+ * Serial reads hand back arbitrary chunks of the byte stream: part of a frame, several
+ * frames, or line noise. The decoder is fed those chunks as they arrive and cuts
+ * complete, CRC checked frames out of them. Frames that sit entirely inside a chunk are
+ * returned in place; only a frame split across chunks is assembled in the decoder's own
+ * buffer, so at most one frame is ever copied.
+ *
+ * After a bad header, length or CRC the decoder drops one byte and searches for the next
+ * 0xFF 0x00 header, including inside the bytes it has already buffered, so a corrupted
+ * frame costs only that frame.
+ *
+ * This file has no dependencies beyond stdint/stddef so the same decoder is built into
+ * the SAMD51 firmware and the host library.
+ */
+#ifndef TENDON_FRAME_DECODER_HPP
+#define TENDON_FRAME_DECODER_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief The two bytes that start every frame
+ */
+#define TENDON_FRAME_HEADER_1 0xFF
+#define TENDON_FRAME_HEADER_2 0x00
+
+/**
+ * @brief Number of bytes before the length field's count starts (header + length)
+ */
+#define TENDON_FRAME_PREFIX_LEN 3
+
+/**
+ * @brief Smallest valid length field: seq, motor id, opcode and two CRC bytes.
+ * Must match TENDON_CONTROL_PKT_LEN_OVERHEAD.
+ */
+#define TENDON_FRAME_MIN_LEN_FIELD 5
+
+/**
+ * @brief Largest complete frame. Must match TENDON_CONTROL_PKT_MAX_NUM_BYTES_IN_FRAME.
+ */
+#define TENDON_FRAME_MAX_FRAME_LEN 32
+
+/**
+ * @brief CRC used to validate frames, called over everything but the two trailing CRC bytes
+ */
+typedef uint16_t (TendonFrameCRCFunction)(uint16_t crc_accum, const uint8_t* data, uint16_t data_blk_size);
+
+/**
+ * @brief Decoder state. Treat as opaque apart from the counters.
+ */
+typedef struct
+{
+  TendonFrameCRCFunction* crc;
+
+  uint8_t buf[TENDON_FRAME_MAX_FRAME_LEN];
+  uint8_t buf_len;
+
+  // length of a frame returned out of buf, removed on the next call
+  uint8_t emitted_len;
+
+  uint32_t frames;
+  uint32_t bytes_dropped;
+  uint32_t len_errors;
+  uint32_t crc_errors;
+
+} TendonControl_frame_decoder_t;
+
+/**
+ * @brief Initializes a decoder
+ *
+ * @param dec the decoder
+ * @param crc the CRC function frames are checked with
+ */
+void tendonDecoderInit(TendonControl_frame_decoder_t* dec, TendonFrameCRCFunction* crc);
+
+/**
+ * @brief Discards any partially received frame, keeps the counters
+ *
+ * @param dec the decoder
+ */
+void tendonDecoderReset(TendonControl_frame_decoder_t* dec);
+
+/**
+ * @brief Feeds bytes to the decoder, stopping at the first complete frame
+ *
+ * @param dec the decoder
+ * @param data the received bytes
+ * @param len the number of received bytes
+ * @param frame set to the start of the complete frame, or NULL if there is none yet
+ * @param frame_len set to the length of the complete frame including header and CRC
+ * @return size_t the number of bytes of data consumed
+ *
+ * The frame points either into data or into the decoder, and stays valid until the
+ * next call. Call again with the unconsumed remainder until everything is consumed
+ * and no frame is returned, e.g.
+ *
+ *   while (len > 0 || frame != NULL) {
+ *     size_t n = tendonDecoderFeed(&dec, data, len, &frame, &frame_len);
+ *     data += n; len -= n;
+ *     if (frame != NULL) handle(frame, frame_len);
+ *   }
+ */
+size_t tendonDecoderFeed(TendonControl_frame_decoder_t* dec, const uint8_t* data, size_t len,
+                         const uint8_t** frame, size_t* frame_len);
+
+#endif
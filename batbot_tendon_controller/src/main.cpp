@@ -1,5 +1,6 @@
 #include <Arduino.h>
 #include "ml_tendon_comm_protocol.hpp"
+#include "tendon_frame_decoder.hpp"
 #include <tcc/ml_tcc_common.h>
 #include <eic/ml_eic.h>
 #include <clocks/ml_clocks.h>
@@ -67,6 +68,7 @@ const uint8_t rx_dmac_chnum = spi_s.rx_dmac_s.ex_chnum;
 const uint8_t tx_dmac_chnum = spi_s.tx_dmac_s.ex_chnum;
 
 TendonControl_packet_handler_t pkt_handler;
+TendonControl_frame_decoder_t frame_decoder;
 
 void dstack_a_init(void)
 {
@@ -226,23 +228,35 @@ void attach_tendons()
   // tendons[6].Attach_EncB_Pin(PORT_GRP_C, 1, PF_A);
 }
 
+/**
+ * @brief Number of bytes pulled from the USB serial buffer per decoder call
+ */
+#define UART_RX_CHUNK_LEN 64
+
 void uart_controlled()
 {
+  uint8_t chunk[UART_RX_CHUNK_LEN];
 
-  if (Serial.available())
+  // never read more than fits, anything left stays in the serial buffer until the next pass
+  size_t len = 0;
+  while (len < UART_RX_CHUNK_LEN && Serial.available())
   {
-    char buff[TENDON_CONTROL_PKT_MAX_NUM_BYTES_IN_FRAME];
+    chunk[len++] = Serial.read();
+  }
 
-    size_t i = 0;
-    while (Serial.available())
-    {
-      buff[i++] = Serial.read();
-    }
+  const uint8_t* data = chunk;
+  const uint8_t* frame = NULL;
+  size_t frame_len = 0;
 
-    if (i > 0)
-    {
+  while (len > 0 || frame != NULL)
+  {
+    size_t n = tendonDecoderFeed(&frame_decoder, data, len, &frame, &frame_len);
+    data += n;
+    len -= n;
 
-      parsePacket(&pkt_handler, buff);
+    if (frame != NULL)
+    {
+      parsePacket(&pkt_handler, (const char*)frame);
 
       execute(&pkt_handler, tendons, target_motor_angles, NUM_TENDONS);
 
@@ -259,6 +273,8 @@ void setup()
   // while(!Serial);;
   Serial.println("Starting");
 
+  tendonDecoderInit(&frame_decoder, updateCRC);
+
   // start clocks
   MCLK_init();
   GCLK_init();